@@ -121,7 +121,8 @@ cc26xx_aes_decrypt(uint8_t *cyphertext_and_result)
 /*---------------------------------------------------------------------------*/
 const struct aes_128_driver cc26xx_aes_128_driver = {
   cc26xx_aes_set_key,
-  cc26xx_aes_encrypt
+  cc26xx_aes_encrypt,
+  NULL
 };
 
 /** @} */
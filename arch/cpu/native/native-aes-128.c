@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         AES-128 driver for the native CPU. Uses the AES-NI instructions
+ *         of x86 CPUs that have them, and the T-table software AES
+ *         otherwise.
+ */
+#include "contiki.h"
+#include "lib/aes-128.h"
+
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NATIVE_AES_NI 1
+#include <immintrin.h>
+#else
+#define NATIVE_AES_NI 0
+#endif
+/*---------------------------------------------------------------------------*/
+#if NATIVE_AES_NI
+#define AES_NI __attribute__((target("aes,sse2")))
+
+/* Blocks that are encrypted together to hide the AESENC latency */
+#define INTERLEAVE 4
+
+static __m128i round_keys[11];
+static bool have_aes_ni;
+/*---------------------------------------------------------------------------*/
+static void AES_NI
+set_key_aes_ni(const uint8_t *key)
+{
+  uint8_t keys[11][AES_128_BLOCK_SIZE];
+  int i;
+
+  aes_128_expand_key(key, keys);
+  for(i = 0; i < 11; i++) {
+    round_keys[i] = _mm_loadu_si128((const __m128i *)keys[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void AES_NI
+encrypt_aes_ni(uint8_t *blocks, uint8_t num_blocks)
+{
+  __m128i s[INTERLEAVE];
+  int round;
+  int n;
+  int i;
+
+  for(; num_blocks; num_blocks -= n, blocks += n * AES_128_BLOCK_SIZE) {
+    n = num_blocks < INTERLEAVE ? num_blocks : INTERLEAVE;
+    for(i = 0; i < n; i++) {
+      s[i] = _mm_xor_si128(
+        _mm_loadu_si128((const __m128i *)(blocks + i * AES_128_BLOCK_SIZE)),
+        round_keys[0]);
+    }
+    for(round = 1; round < 10; round++) {
+      for(i = 0; i < n; i++) {
+        s[i] = _mm_aesenc_si128(s[i], round_keys[round]);
+      }
+    }
+    for(i = 0; i < n; i++) {
+      s[i] = _mm_aesenclast_si128(s[i], round_keys[10]);
+      _mm_storeu_si128((__m128i *)(blocks + i * AES_128_BLOCK_SIZE), s[i]);
+    }
+  }
+}
+#endif /* NATIVE_AES_NI */
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+#if NATIVE_AES_NI
+  have_aes_ni = __builtin_cpu_supports("aes");
+  if(have_aes_ni) {
+    set_key_aes_ni(key);
+    return;
+  }
+#endif /* NATIVE_AES_NI */
+  aes_128_ttable_driver.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt_blocks(uint8_t *blocks, uint8_t num_blocks)
+{
+#if NATIVE_AES_NI
+  if(have_aes_ni) {
+    encrypt_aes_ni(blocks, num_blocks);
+    return;
+  }
+#endif /* NATIVE_AES_NI */
+  for(; num_blocks; num_blocks--, blocks += AES_128_BLOCK_SIZE) {
+    aes_128_ttable_driver.encrypt(blocks);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *plaintext_and_result)
+{
+  encrypt_blocks(plaintext_and_result, 1);
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver native_aes_128_driver = {
+  set_key,
+  encrypt,
+  encrypt_blocks
+};
+/*---------------------------------------------------------------------------*/
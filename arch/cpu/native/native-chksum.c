@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*---------------------------------------------------------------------------*/
+/**
+ * \file
+ *         Internet checksum kernel for the native CPU, vectorised with
+ *         AVX2 or SSE2 when the compiler targets them.
+ *
+ *         16-bit words are zero-extended into 32-bit lanes, so no
+ *         carries are lost before the final fold. The lanes cannot
+ *         overflow for any buffer uIP can checksum.
+ */
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-chksum.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+/*---------------------------------------------------------------------------*/
+/* Below this length, spilling the vector lanes costs more than it saves */
+#define SIMD_MIN_LEN 64
+/*---------------------------------------------------------------------------*/
+#if defined(__SSE2__)
+/* Add the sum of the 32-bit lanes in native word order to sum */
+static uint16_t
+add_lanes(uint16_t sum, const uint32_t *lanes, int num_lanes)
+{
+  uint64_t acc = 0;
+  int i;
+
+  for(i = 0; i < num_lanes; i++) {
+    acc += lanes[i];
+  }
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+  acc = ((acc >> 8) | (acc << 8)) & 0xffff;
+#endif /* UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN */
+  acc += sum;
+  return (uint16_t)((acc & 0xffff) + (acc >> 16));
+}
+#endif /* __SSE2__ */
+/*---------------------------------------------------------------------------*/
+uint16_t
+native_chksum_add(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+#if defined(__AVX2__)
+  if(len >= SIMD_MIN_LEN) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i vacc = zero;
+    __m256i vacc2 = zero;
+    uint32_t lanes[8];
+
+    for(; len >= 32; len -= 32, data += 32) {
+      __m256i v = _mm256_loadu_si256((const __m256i *)data);
+      vacc = _mm256_add_epi32(vacc, _mm256_unpacklo_epi16(v, zero));
+      vacc2 = _mm256_add_epi32(vacc2, _mm256_unpackhi_epi16(v, zero));
+    }
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi32(vacc, vacc2));
+    sum = add_lanes(sum, lanes, 8);
+  }
+#elif defined(__SSE2__)
+  if(len >= SIMD_MIN_LEN) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vacc = zero;
+    __m128i vacc2 = zero;
+    uint32_t lanes[4];
+
+    for(; len >= 32; len -= 32, data += 32) {
+      __m128i v = _mm_loadu_si128((const __m128i *)data);
+      __m128i v2 = _mm_loadu_si128((const __m128i *)(data + 16));
+      vacc = _mm_add_epi32(vacc, _mm_unpacklo_epi16(v, zero));
+      vacc2 = _mm_add_epi32(vacc2, _mm_unpackhi_epi16(v, zero));
+      vacc = _mm_add_epi32(vacc, _mm_unpacklo_epi16(v2, zero));
+      vacc2 = _mm_add_epi32(vacc2, _mm_unpackhi_epi16(v2, zero));
+    }
+    _mm_storeu_si128((__m128i *)lanes, _mm_add_epi32(vacc, vacc2));
+    sum = add_lanes(sum, lanes, 4);
+  }
+#endif /* __SSE2__ */
+
+  /* The remainder, and short buffers, go to the scalar 64-bit kernel */
+  return uip_chksum_add_acc64(sum, data, len);
+}
+/*---------------------------------------------------------------------------*/
@@ -199,6 +199,23 @@ radio_read(void *buf, unsigned short bufsize)
 }
 /*---------------------------------------------------------------------------*/
 static int
+radio_read_batch(struct radio_rx_frame *frames, int count)
+{
+  /* Cooja delivers at most one frame per tick, hand it over in place */
+  if(simInSize == 0 || count < 1) {
+    return 0;
+  }
+
+  frames[0].data = (const uint8_t *)simInDataBuffer;
+  frames[0].len = simInSize;
+  frames[0].rssi = simSignalStrength;
+  frames[0].link_quality = simLQI;
+  simInSize = 0;
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
 channel_clear(void)
 {
   if(simSignalStrength > CCA_SS_THRESHOLD) {
@@ -267,6 +284,20 @@ radio_send(const void *payload, unsigned short payload_len)
 }
 /*---------------------------------------------------------------------------*/
 static int
+radio_send_batch(struct radio_tx_frame *frames, int count)
+{
+  int i;
+
+  for(i = 0; i < count; i++) {
+    frames[i].result = radio_send(frames[i].payload, frames[i].payload_len);
+    if(frames[i].result != RADIO_TX_OK) {
+      return i + 1;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+static int
 prepare_packet(const void *data, unsigned short len)
 {
   if(len > COOJA_RADIO_BUFSIZE) {
@@ -300,8 +331,6 @@ pending_packet(void)
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(cooja_radio_process, ev, data)
 {
-  int len;
-
   PROCESS_BEGIN();
 
   while(1) {
@@ -310,12 +339,7 @@ PROCESS_THREAD(cooja_radio_process, ev, data)
       continue;
     }
 
-    packetbuf_clear();
-    len = radio_read(packetbuf_dataptr(), PACKETBUF_SIZE);
-    if(len > 0) {
-      packetbuf_set_datalen(len);
-      NETSTACK_MAC.input();
-    }
+    netstack_radio_input();
   }
 
   PROCESS_END();
@@ -443,7 +467,9 @@ const struct radio_driver cooja_radio_driver =
     get_value,
     set_value,
     get_object,
-    set_object
+    set_object,
+    radio_read_batch,
+    radio_send_batch
 };
 /*---------------------------------------------------------------------------*/
 SIM_INTERFACE(radio_interface,
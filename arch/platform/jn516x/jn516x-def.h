@@ -60,6 +60,11 @@
 #define MIRCOMAC_CONF_BUF_NUM 2
 #endif
 
+/* Micromac computes the FCS in software: spend 512 bytes on a CRC table */
+#ifndef CRC16_CONF_SLICES
+#define CRC16_CONF_SLICES 1
+#endif
+
 /* 32kHz or 16MHz rtimers? */
 #ifdef RTIMER_CONF_USE_32KHZ
 #define RTIMER_USE_32KHZ  RTIMER_CONF_USE_32KHZ
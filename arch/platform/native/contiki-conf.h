@@ -66,6 +66,11 @@ typedef unsigned int uip_stats_t;
 #define UIP_CONF_BYTE_ORDER      UIP_LITTLE_ENDIAN
 #endif
 
+/* AES-NI when the CPU has it, T-table software AES otherwise */
+#ifndef AES_128_CONF
+#define AES_128_CONF native_aes_128_driver
+#endif /* AES_128_CONF */
+
 #if NETSTACK_CONF_WITH_IPV6
 
 #ifndef NETSTACK_CONF_NETWORK
@@ -94,6 +99,11 @@ typedef unsigned int uip_stats_t;
 #define UIP_CONF_IPV6_QUEUE_PKT  1
 #define UIP_ARCH_IPCHKSUM        1
 
+/* Use the vectorised Internet checksum kernel of the native CPU */
+#ifndef UIP_CONF_CHKSUM_ADD
+#define UIP_CONF_CHKSUM_ADD      native_chksum_add
+#endif /* UIP_CONF_CHKSUM_ADD */
+
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
 #include <ctype.h>
@@ -101,6 +101,22 @@ set_object(radio_param_t param, const void *src, size_t size)
   return RADIO_RESULT_NOT_SUPPORTED;
 }
 /*---------------------------------------------------------------------------*/
+static int
+read_batch(struct radio_rx_frame *frames, int count)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_batch(struct radio_tx_frame *frames, int count)
+{
+  int i;
+  for(i = 0; i < count; i++) {
+    frames[i].result = send(frames[i].payload, frames[i].payload_len);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
 const struct radio_driver nullradio_driver =
   {
     init,
@@ -116,6 +132,8 @@ const struct radio_driver nullradio_driver =
     get_value,
     set_value,
     get_object,
-    set_object
+    set_object,
+    read_batch,
+    send_batch
   };
 /*---------------------------------------------------------------------------*/
@@ -58,6 +58,7 @@
 #define RADIO_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 /**
  * Each radio has a set of parameters that designate the current
@@ -279,6 +280,30 @@ enum {
   RADIO_TX_NOACK,
 };
 
+/**
+ * A received frame and its metadata, as returned by the read_batch()
+ * function of a radio driver. The frame data is owned by the driver and
+ * remains valid until the next call to read_batch() or until the calling
+ * process yields, whichever comes first.
+ */
+struct radio_rx_frame {
+  const uint8_t *data;
+  unsigned short len;
+  radio_value_t rssi;
+  radio_value_t link_quality;
+};
+
+/**
+ * A frame to transmit with the send_batch() function of a radio driver.
+ * The driver stores the outcome of the transmission (RADIO_TX_OK, etc.)
+ * in 'result'.
+ */
+struct radio_tx_frame {
+  const void *payload;
+  unsigned short payload_len;
+  int result;
+};
+
 /**
  * The structure of a device driver for a radio in Contiki.
  */
@@ -334,6 +359,20 @@ struct radio_driver {
   radio_result_t (* set_object)(radio_param_t param, const void *src,
                                 size_t size);
 
+  /**
+   * Read up to 'count' received frames at once, along with their
+   * metadata. Returns the number of frames read. Optional: NULL if the
+   * driver can only read one frame at a time with read().
+   */
+  int (* read_batch)(struct radio_rx_frame *frames, int count);
+
+  /**
+   * Prepare & transmit up to 'count' frames back to back. Stops at the
+   * first frame whose transmission fails, and returns the number of
+   * frames for which a result was stored. Optional: NULL if the driver
+   * can only transmit one frame at a time with send().
+   */
+  int (* send_batch)(struct radio_tx_frame *frames, int count);
 };
 
 #endif /* RADIO_H_ */
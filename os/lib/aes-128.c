@@ -75,28 +75,35 @@ galois_mul2(uint8_t value)
   return ((value << 1) ^ xor_val);
 }
 /*---------------------------------------------------------------------------*/
-static void
-set_key(const uint8_t *key)
+void
+aes_128_expand_key(const uint8_t *key,
+                   uint8_t keys[11][AES_128_BLOCK_SIZE])
 {
   uint8_t i;
   uint8_t j;
   uint8_t rcon;
   
   rcon = 0x01;
-  memcpy(round_keys[0], key, AES_128_KEY_LENGTH);
+  memcpy(keys[0], key, AES_128_KEY_LENGTH);
   for(i = 1; i <= 10; i++) {
-    round_keys[i][0] = sbox[round_keys[i - 1][13]] ^ round_keys[i - 1][0] ^ rcon;
-    round_keys[i][1] = sbox[round_keys[i - 1][14]] ^ round_keys[i - 1][1];
-    round_keys[i][2] = sbox[round_keys[i - 1][15]] ^ round_keys[i - 1][2];
-    round_keys[i][3] = sbox[round_keys[i - 1][12]] ^ round_keys[i - 1][3];
+    keys[i][0] = sbox[keys[i - 1][13]] ^ keys[i - 1][0] ^ rcon;
+    keys[i][1] = sbox[keys[i - 1][14]] ^ keys[i - 1][1];
+    keys[i][2] = sbox[keys[i - 1][15]] ^ keys[i - 1][2];
+    keys[i][3] = sbox[keys[i - 1][12]] ^ keys[i - 1][3];
     for(j = 4; j < AES_128_BLOCK_SIZE; j++) {
-      round_keys[i][j] = round_keys[i - 1][j] ^ round_keys[i][j - 4];
+      keys[i][j] = keys[i - 1][j] ^ keys[i][j - 4];
     }
     rcon = galois_mul2(rcon);
   }
 }
 /*---------------------------------------------------------------------------*/
 static void
+set_key(const uint8_t *key)
+{
+  aes_128_expand_key(key, round_keys);
+}
+/*---------------------------------------------------------------------------*/
+static void
 encrypt(uint8_t *state)
 {
   uint8_t buf1, buf2, buf3, buf4, round, i;
@@ -168,6 +175,7 @@ encrypt(uint8_t *state)
 /*---------------------------------------------------------------------------*/
 const struct aes_128_driver aes_128_driver = {
   set_key,
-  encrypt
+  encrypt,
+  NULL
 };
 /*---------------------------------------------------------------------------*/
@@ -65,8 +65,44 @@ struct aes_128_driver {
    * \brief Encrypts.
    */
   void (* encrypt)(uint8_t *plaintext_and_result);
+
+  /**
+   * \brief Encrypts num_blocks independent, contiguous blocks in place.
+   *
+   * Lets a driver interleave or pipeline the blocks. Drivers that
+   * leave this NULL are called once per block through encrypt().
+   */
+  void (* encrypt_blocks)(uint8_t *blocks, uint8_t num_blocks);
 };
 
 extern const struct aes_128_driver AES_128;
 
+/** Byte-oriented software AES-128, the smallest one */
+extern const struct aes_128_driver aes_128_driver;
+
+/** Software AES-128 with 32-bit table lookups, using 1 KB more flash */
+extern const struct aes_128_driver aes_128_ttable_driver;
+
+/**
+ * \brief Encrypts num_blocks blocks in place with AES_128, using its
+ *        encrypt_blocks() function if it has one.
+ */
+static inline void
+aes_128_encrypt_blocks(uint8_t *blocks, uint8_t num_blocks)
+{
+  if(AES_128.encrypt_blocks) {
+    AES_128.encrypt_blocks(blocks, num_blocks);
+    return;
+  }
+  for(; num_blocks; num_blocks--, blocks += AES_128_BLOCK_SIZE) {
+    AES_128.encrypt(blocks);
+  }
+}
+
+/**
+ * \brief Computes the 11 round keys of AES-128 for a software driver.
+ */
+void aes_128_expand_key(const uint8_t *key,
+                        uint8_t keys[11][AES_128_BLOCK_SIZE]);
+
 #endif /* AES_128_H_ */
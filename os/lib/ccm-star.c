@@ -64,94 +64,38 @@ set_iv(uint8_t *iv,
   iv[15] = counter;
 }
 /*---------------------------------------------------------------------------*/
-/* XORs the block m[pos] ... m[pos + 15] with K_{counter} */
 static void
-ctr_step(const uint8_t *nonce,
-    uint16_t pos,
-    uint8_t *m_and_result,
-    uint16_t m_len,
-    uint16_t counter)
+xor_block(uint8_t *dst, const uint8_t *src, uint16_t len)
 {
-  uint8_t a[AES_128_BLOCK_SIZE];
   uint8_t i;
 
-  set_iv(a, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter);
-  AES_128.encrypt(a);
-
-  for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-    m_and_result[pos + i] ^= a[i];
+  for(i = 0; i < len && i < AES_128_BLOCK_SIZE; i++) {
+    dst[i] ^= src[i];
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Runs X_{i+1} = E(X_i ^ B_i) over the additional authenticated data */
 static void
-mic(const uint8_t *nonce,
-    const uint8_t *m, uint16_t m_len,
-    const uint8_t *a, uint16_t a_len,
-    uint8_t *result,
-    uint8_t mic_len)
+mic_a(uint8_t *x, const uint8_t *a, uint16_t a_len)
 {
-  uint8_t x[AES_128_BLOCK_SIZE];
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint8_t i;
+  uint32_t pos; /* 32-bits as can need to exceed a_len to reach end of loop */
 
-  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
+  x[0] = x[0] ^ (a_len >> 8);
+  x[1] = x[1] ^ a_len;
+  xor_block(x + 2, a, a_len < 14 ? a_len : 14);
   AES_128.encrypt(x);
 
-  if(a_len) {
-    x[0] = x[0] ^ (a_len >> 8);
-    x[1] = x[1] ^ a_len;
-    for(i = 2; (i - 2 < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-      x[i] ^= a[i - 2];
-    }
-
+  for(pos = 14; pos < a_len; pos += AES_128_BLOCK_SIZE) {
+    xor_block(x, a + pos, a_len - pos);
     AES_128.encrypt(x);
-
-    pos = 14;
-    while(pos < a_len) {
-      for(i = 0; (pos + i < a_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= a[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
-  }
-
-  if(m_len) {
-    pos = 0;
-    while(pos < m_len) {
-      for(i = 0; (pos + i < m_len) && (i < AES_128_BLOCK_SIZE); i++) {
-        x[i] ^= m[pos + i];
-      }
-      pos += AES_128_BLOCK_SIZE;
-      AES_128.encrypt(x);
-    }
   }
-
-  ctr_step(nonce, 0, x, AES_128_BLOCK_SIZE, 0);
-
-  memcpy(result, x, mic_len);
-}
-/*---------------------------------------------------------------------------*/
-static void
-ctr(const uint8_t *nonce, uint8_t *m, uint16_t m_len)
-{
-  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
-  uint16_t counter;
-
-  pos = 0;
-  counter = 1;
-  while(pos < m_len) {
-    ctr_step(nonce, pos, m, m_len, counter++);
-    pos += AES_128_BLOCK_SIZE;
-  }
-}
-/*---------------------------------------------------------------------------*/
-static void
-set_key(const uint8_t *key)
-{
-  AES_128.set_key(key);
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * The CBC-MAC blocks depend on each other but the CTR blocks do not, so
+ * each CBC-MAC block is encrypted together with a CTR block. Drivers with
+ * encrypt_blocks() can then process the two in parallel.
+ */
 static void
 aead(const uint8_t* nonce,
     uint8_t* m, uint16_t m_len,
@@ -159,25 +103,59 @@ aead(const uint8_t* nonce,
     uint8_t *result, uint8_t mic_len,
     int forward)
 {
+  /* The CBC-MAC state X, followed by the counter block A_i */
+  uint8_t x[2 * AES_128_BLOCK_SIZE];
+  uint8_t *ctr = x + AES_128_BLOCK_SIZE;
+  uint8_t s0[AES_128_BLOCK_SIZE];
+  uint32_t pos; /* 32-bits as can need to exceed m_len to reach end of loop */
+  uint16_t counter;
+
   if(a_len > MAX_A_LEN || !MIC_LEN_VALID(mic_len)) {
     return;
   }
 
-  if(!forward) {
-    /* decrypt */
-    ctr(nonce, m, m_len);
-  }
+  /* B_0 and A_0, whose key stream S_0 encrypts the MIC */
+  set_iv(x, CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len), nonce, m_len);
+  set_iv(ctr, CCM_STAR_ENCRYPTION_FLAGS, nonce, 0);
+  aes_128_encrypt_blocks(x, 2);
+  memcpy(s0, ctr, AES_128_BLOCK_SIZE);
 
-  mic(nonce,
-    m, m_len,
-    a, a_len,
-    result,
-    mic_len);
+  if(a_len) {
+    mic_a(x, a, a_len);
+  }
 
+  counter = 1;
   if(forward) {
-    /* encrypt */
-    ctr(nonce, m, m_len);
+    /* Authenticate block i of the plaintext while computing S_{i+1} */
+    for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+      xor_block(x, m + pos, m_len - pos);
+      set_iv(ctr, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+      aes_128_encrypt_blocks(x, 2);
+      xor_block(m + pos, ctr, m_len - pos);
+    }
+  } else if(m_len) {
+    /* Authentication needs the plaintext, so it lags one block behind */
+    set_iv(ctr, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+    AES_128.encrypt(ctr);
+    xor_block(m, ctr, m_len);
+    xor_block(x, m, m_len);
+    for(pos = AES_128_BLOCK_SIZE; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+      set_iv(ctr, CCM_STAR_ENCRYPTION_FLAGS, nonce, counter++);
+      aes_128_encrypt_blocks(x, 2);
+      xor_block(m + pos, ctr, m_len - pos);
+      xor_block(x, m + pos, m_len - pos);
+    }
+    AES_128.encrypt(x);
   }
+
+  xor_block(x, s0, AES_128_BLOCK_SIZE);
+  memcpy(result, x, mic_len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  AES_128.set_key(key);
 }
 /*---------------------------------------------------------------------------*/
 const struct ccm_star_driver ccm_star_driver = {
@@ -55,6 +55,32 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+#include "contiki.h"
+
+/**
+ * \brief Number of 512-byte lookup tables used by crc16_data(),
+ * trading flash for speed:
+ *
+ * - 0: bitwise, with crc16_add() and no table
+ * - 1: one table lookup per byte
+ * - 4: slice-by-4, four bytes per iteration
+ * - 8: slice-by-8, eight bytes per iteration
+ *
+ * A CPU with a CRC peripheral can instead set CRC16_CONF_DATA to a
+ * function with the signature of crc16_data(), which is then used
+ * for all block computations.
+ */
+#ifdef CRC16_CONF_SLICES
+#define CRC16_SLICES CRC16_CONF_SLICES
+#else
+#define CRC16_SLICES 0
+#endif
+
+#if CRC16_SLICES != 0 && CRC16_SLICES != 1 && CRC16_SLICES != 4 && \
+  CRC16_SLICES != 8
+#error "CRC16_CONF_SLICES must be 0, 1, 4 or 8"
+#endif
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -82,10 +108,9 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note Unless CRC16_CONF_SLICES selects a table-driven
+ *             algorithm, or CRC16_CONF_DATA a hardware one, this
+ *             function calls crc16_add() once per byte.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
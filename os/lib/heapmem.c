@@ -103,6 +103,31 @@
 #define HEAPMEM_ALIGNMENT sizeof(int)
 #endif /* HEAPMEM_CONF_ALIGNMENT */
 
+/*
+ * The HEAPMEM_CONF_TLSF parameter selects a two-level segregated fit
+ * (TLSF) allocator instead of the default first-fit allocator. Free chunks
+ * are kept in one list per size class, and two levels of bitmaps tell
+ * which lists are non-empty. Allocations and deallocations then run in
+ * bounded time, and free chunks are always merged with their neighbors.
+ */
+#ifdef HEAPMEM_CONF_TLSF
+#define HEAPMEM_TLSF HEAPMEM_CONF_TLSF
+#else
+#define HEAPMEM_TLSF 0
+#endif /* HEAPMEM_CONF_TLSF */
+
+/*
+ * The HEAPMEM_CONF_TLSF_SL_LOG2 parameter sets the number of size classes
+ * between two powers of two (2^HEAPMEM_CONF_TLSF_SL_LOG2). More classes
+ * waste less memory per allocation, at the cost of a larger table of
+ * free lists.
+ */
+#ifdef HEAPMEM_CONF_TLSF_SL_LOG2
+#define SL_LOG2 HEAPMEM_CONF_TLSF_SL_LOG2
+#else
+#define SL_LOG2 2
+#endif /* HEAPMEM_CONF_TLSF_SL_LOG2 */
+
 #define ALIGN(size)						\
   (((size) + (HEAPMEM_ALIGNMENT - 1)) & ~(HEAPMEM_ALIGNMENT - 1))
 
@@ -137,6 +162,11 @@ typedef struct chunk {
   struct chunk *next;
   size_t size;
   uint8_t flags;
+#if HEAPMEM_TLSF
+  /* The chunk that precedes this one in memory, used to merge free
+     chunks in constant time. */
+  struct chunk *prev_phys;
+#endif /* HEAPMEM_TLSF */
 #if HEAPMEM_DEBUG
   const char *file;
   unsigned line;
@@ -149,7 +179,9 @@ static char heap_base[HEAPMEM_ARENA_SIZE] CC_ALIGN(HEAPMEM_ALIGNMENT);
 static size_t heap_usage;
 
 static chunk_t *first_chunk = (chunk_t *)heap_base;
+#if !HEAPMEM_TLSF
 static chunk_t *free_list;
+#endif /* !HEAPMEM_TLSF */
 
 /* extend_space: Increases the current footprint used in the heap, and
    returns a pointer to the old end. */
@@ -168,6 +200,274 @@ extend_space(size_t size)
   return old_usage;
 }
 
+#if HEAPMEM_TLSF
+/*
+ * Size classes. Sizes below SMALL_SIZE are split into SL_COUNT classes
+ * of equal width in the first level. Every following first-level class
+ * covers a power of two, which is split into SL_COUNT second-level
+ * classes.
+ */
+#define SL_COUNT (1 << SL_LOG2)
+#define FL_SHIFT (SL_LOG2 + 2)
+#define SMALL_SIZE (1 << FL_SHIFT)
+
+/* An upper bound of log2(HEAPMEM_ARENA_SIZE), which bounds the number
+   of first-level classes. */
+#define ARENA_LOG2 (HEAPMEM_ARENA_SIZE <= (1UL << 8) ? 8 :      \
+                    HEAPMEM_ARENA_SIZE <= (1UL << 10) ? 10 :    \
+                    HEAPMEM_ARENA_SIZE <= (1UL << 12) ? 12 :    \
+                    HEAPMEM_ARENA_SIZE <= (1UL << 14) ? 14 :    \
+                    HEAPMEM_ARENA_SIZE <= (1UL << 16) ? 16 :    \
+                    HEAPMEM_ARENA_SIZE <= (1UL << 20) ? 20 :    \
+                    HEAPMEM_ARENA_SIZE <= (1UL << 24) ? 24 : 31)
+#define FL_COUNT (ARENA_LOG2 - FL_SHIFT + 1)
+
+static chunk_t *free_lists[FL_COUNT][SL_COUNT];
+static uint32_t fl_bitmap;
+static uint32_t sl_bitmap[FL_COUNT];
+
+/* The chunk that ends at the current heap footprint. */
+static chunk_t *last_chunk;
+
+/* highest_bit: Get the index of the most significant bit set. */
+static int
+highest_bit(size_t size)
+{
+#ifdef __GNUC__
+  return (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl((unsigned long)size);
+#else
+  int bit;
+
+  for(bit = -1; size != 0; size >>= 1) {
+    bit++;
+  }
+  return bit;
+#endif /* __GNUC__ */
+}
+
+/* lowest_bit: Get the index of the least significant bit set. */
+static int
+lowest_bit(uint32_t bits)
+{
+#ifdef __GNUC__
+  return __builtin_ctzl(bits);
+#else
+  int bit;
+
+  for(bit = 0; (bits & 1) == 0; bits >>= 1) {
+    bit++;
+  }
+  return bit;
+#endif /* __GNUC__ */
+}
+
+/* mapping: Get the size class of a chunk size. */
+static void
+mapping(size_t size, int *fl, int *sl)
+{
+  int bit;
+
+  if(size < SMALL_SIZE) {
+    *fl = 0;
+    *sl = size >> (FL_SHIFT - SL_LOG2);
+  } else {
+    bit = highest_bit(size);
+    *fl = bit - FL_SHIFT + 1;
+    *sl = (size >> (bit - SL_LOG2)) - SL_COUNT;
+  }
+}
+
+/* insert_free: Put a free chunk on the list of its size class. */
+static void
+insert_free(chunk_t * const chunk)
+{
+  int fl, sl;
+
+  mapping(chunk->size, &fl, &sl);
+  chunk->prev = NULL;
+  chunk->next = free_lists[fl][sl];
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk;
+  }
+  free_lists[fl][sl] = chunk;
+  fl_bitmap |= 1UL << fl;
+  sl_bitmap[fl] |= 1UL << sl;
+}
+
+/* remove_free: Remove a free chunk from the list of its size class. */
+static void
+remove_free(chunk_t * const chunk)
+{
+  int fl, sl;
+
+  mapping(chunk->size, &fl, &sl);
+  if(chunk->prev != NULL) {
+    chunk->prev->next = chunk->next;
+  } else {
+    free_lists[fl][sl] = chunk->next;
+    if(chunk->next == NULL) {
+      sl_bitmap[fl] &= ~(1UL << sl);
+      if(sl_bitmap[fl] == 0) {
+        fl_bitmap &= ~(1UL << fl);
+      }
+    }
+  }
+  if(chunk->next != NULL) {
+    chunk->next->prev = chunk->prev;
+  }
+}
+
+/* merge_chunks: Merge a chunk with the one that follows it in memory. */
+static void
+merge_chunks(chunk_t * const chunk, chunk_t * const next)
+{
+  chunk->size += sizeof(chunk_t) + next->size;
+  if(IS_LAST_CHUNK(chunk)) {
+    last_chunk = chunk;
+  } else {
+    NEXT_CHUNK(chunk)->prev_phys = chunk;
+  }
+}
+
+/* free_chunk: Mark a chunk as being free, merge it with its free
+   neighbors, and put it on the free list of its size class. */
+static void
+free_chunk(chunk_t *chunk)
+{
+  chunk_t *neighbor;
+
+  chunk->flags &= ~CHUNK_FLAG_ALLOCATED;
+
+  if(!IS_LAST_CHUNK(chunk)) {
+    neighbor = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(neighbor)) {
+      remove_free(neighbor);
+      merge_chunks(chunk, neighbor);
+    }
+  }
+
+  neighbor = chunk->prev_phys;
+  if(neighbor != NULL && CHUNK_FREE(neighbor)) {
+    remove_free(neighbor);
+    merge_chunks(neighbor, chunk);
+    chunk = neighbor;
+  }
+
+  if(IS_LAST_CHUNK(chunk)) {
+    /* Release the chunk back into the wilderness. */
+    heap_usage -= sizeof(chunk_t) + chunk->size;
+    last_chunk = chunk->prev_phys;
+  } else {
+    insert_free(chunk);
+  }
+}
+
+/*
+ * split_chunk: When allocating a chunk, we may have found one that is
+ * larger than needed, so this function is called to keep the rest of
+ * the original chunk free.
+ */
+static void
+split_chunk(chunk_t * const chunk, size_t offset)
+{
+  chunk_t *new_chunk;
+
+  offset = ALIGN(offset);
+
+  if(offset + sizeof(chunk_t) < chunk->size) {
+    new_chunk = (chunk_t *)(GET_PTR(chunk) + offset);
+    new_chunk->size = chunk->size - sizeof(chunk_t) - offset;
+    new_chunk->flags = CHUNK_FLAG_ALLOCATED;
+    new_chunk->prev_phys = chunk;
+    chunk->size = offset;
+    if(IS_LAST_CHUNK(new_chunk)) {
+      last_chunk = new_chunk;
+    } else {
+      NEXT_CHUNK(new_chunk)->prev_phys = new_chunk;
+    }
+    free_chunk(new_chunk);
+  }
+}
+
+/* coalesce_chunks: Merge a chunk with the free chunk that follows it,
+   if any. Free chunks are always merged, so there is at most one. */
+static void
+coalesce_chunks(chunk_t *chunk)
+{
+  chunk_t *next;
+
+  if(!IS_LAST_CHUNK(chunk)) {
+    next = NEXT_CHUNK(chunk);
+    if(CHUNK_FREE(next)) {
+      remove_free(next);
+      merge_chunks(chunk, next);
+    }
+  }
+}
+
+/*
+ * get_free_chunk: Find a free chunk to satisfy an allocation request.
+ *
+ * The request is rounded up to the next size class, so that any chunk
+ * in that class or above is large enough. The bitmaps then give the
+ * first non-empty list in constant time. If no such list exists, at
+ * most CHUNK_SEARCH_MAX chunks of the class of the request are examined,
+ * as some of them may be large enough.
+ */
+static chunk_t *
+get_free_chunk(const size_t size)
+{
+  int i, fl, sl;
+  uint32_t bits;
+  chunk_t *chunk;
+
+  chunk = NULL;
+  if(size < SMALL_SIZE) {
+    mapping(size + (1 << (FL_SHIFT - SL_LOG2)) - 1, &fl, &sl);
+  } else {
+    mapping(size + (1UL << (highest_bit(size) - SL_LOG2)) - 1, &fl, &sl);
+  }
+
+  if(fl < FL_COUNT) {
+    bits = sl_bitmap[fl] & (~0UL << sl);
+    if(bits == 0) {
+      bits = fl_bitmap & (~0UL << (fl + 1));
+      if(bits != 0) {
+        fl = lowest_bit(bits);
+        bits = sl_bitmap[fl];
+      }
+    }
+    if(bits != 0) {
+      chunk = free_lists[fl][lowest_bit(bits)];
+    }
+  }
+
+  if(chunk == NULL) {
+    mapping(size, &fl, &sl);
+    if(fl < FL_COUNT) {
+      i = CHUNK_SEARCH_MAX;
+      for(chunk = free_lists[fl][sl];
+          chunk != NULL && chunk->size < size;
+          chunk = chunk->next) {
+        if(--i == 0) {
+          chunk = NULL;
+          break;
+        }
+      }
+    }
+  }
+
+  if(chunk != NULL) {
+    /* We found a chunk for the allocation. Split it if necessary. */
+    remove_free(chunk);
+    chunk->flags |= CHUNK_FLAG_ALLOCATED;
+    split_chunk(chunk, size);
+  }
+
+  return chunk;
+}
+#else /* HEAPMEM_TLSF */
+
 /* free_chunk: Mark a chunk as being free, and put it on the free list. */
 static void
 free_chunk(chunk_t * const chunk)
@@ -307,6 +607,7 @@ get_free_chunk(const size_t size)
 
   return best;
 }
+#endif /* HEAPMEM_TLSF */
 
 /*
  * heapmem_alloc: Allocate an object of the specified size, returning
@@ -340,6 +641,10 @@ heapmem_alloc(size_t size)
       return NULL;
     }
     chunk->size = size;
+#if HEAPMEM_TLSF
+    chunk->prev_phys = last_chunk;
+    last_chunk = chunk;
+#endif /* HEAPMEM_TLSF */
   }
 
   chunk->flags = CHUNK_FLAG_ALLOCATED;
@@ -485,6 +790,20 @@ heapmem_realloc(void *ptr, size_t size)
 }
 #endif /* HEAPMEM_REALLOC */
 
+/* size_class: Get the statistics size class of a chunk size. */
+static int
+size_class(size_t size)
+{
+  int class;
+
+  for(class = 0; class < HEAPMEM_SIZE_CLASSES - 1; class++) {
+    if(size <= (16UL << class)) {
+      break;
+    }
+  }
+  return class;
+}
+
 /* heapmem_stats: Calculate statistics regarding memory usage. */
 void
 heapmem_stats(heapmem_stats_t *stats)
@@ -498,13 +817,24 @@ heapmem_stats(heapmem_stats_t *stats)
       chunk = NEXT_CHUNK(chunk)) {
     if(CHUNK_ALLOCATED(chunk)) {
       stats->allocated += chunk->size;
+      stats->allocated_chunks[size_class(chunk->size)]++;
     } else {
       coalesce_chunks(chunk);
       stats->available += chunk->size;
+      stats->free_chunks[size_class(chunk->size)]++;
+      if(chunk->size > stats->largest_free) {
+        stats->largest_free = chunk->size;
+      }
     }
     stats->overhead += sizeof(chunk_t);
   }
   stats->available += HEAPMEM_ARENA_SIZE - heap_usage;
+  if(HEAPMEM_ARENA_SIZE - heap_usage > stats->largest_free) {
+    stats->largest_free = HEAPMEM_ARENA_SIZE - heap_usage;
+  }
+  if(stats->available > 0) {
+    stats->fragmentation = 100 - stats->largest_free * 100 / stats->available;
+  }
   stats->footprint = heap_usage;
   stats->chunks = stats->overhead / sizeof(chunk_t);
 }
@@ -42,6 +42,12 @@
  * only 1 bytes, which entails that this parameter must be set
  * explicitly in order to be possible to use this module.
  *
+ * Setting HEAPMEM_CONF_TLSF to 1 selects a two-level segregated fit
+ * allocator, which keeps one free list per size class and finds a
+ * suitable chunk in constant time. Freed chunks are merged with their
+ * neighbors immediately, which bounds the latency of heapmem_free() as
+ * well.
+ *
  * Each allocated memory object is referred to as a "chunk". The
  * allocator manages free chunks in a double-linked list. While this
  * adds some memory overhead compared to a single-linked list, it
@@ -76,12 +82,26 @@
 
 #include <stdlib.h>
 
+/* The number of size classes reported by heapmem_stats(). Class 0
+   counts chunks of up to 16 bytes, and each following class doubles the
+   upper bound, except the last one which counts all larger chunks. */
+#define HEAPMEM_SIZE_CLASSES 8
+
 typedef struct heapmem_stats {
   size_t allocated;
   size_t overhead;
   size_t available;
   size_t footprint;
   size_t chunks;
+  /* The size of the largest free chunk, or of the unused space at the
+     end of the heap if larger. */
+  size_t largest_free;
+  /* The share of available memory that lies outside the largest free
+     chunk, in percent. */
+  unsigned fragmentation;
+  /* The number of allocated and free chunks per size class. */
+  size_t allocated_chunks[HEAPMEM_SIZE_CLASSES];
+  size_t free_chunks[HEAPMEM_SIZE_CLASSES];
 } heapmem_stats_t;
 
 #if HEAPMEM_DEBUG
@@ -157,6 +177,10 @@ void heapmem_free(void *ptr);
  * and the number of chunks allocated. By using this information, developers
  * can tune their software to use the heapmem allocator more efficiently.
  *
+ * The fragmentation and per-size-class counters show whether free
+ * memory is usable for large allocations, and which allocation sizes
+ * dominate.
+ *
  */
 
 void heapmem_stats(heapmem_stats_t *stats);
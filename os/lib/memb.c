@@ -47,11 +47,50 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+/*---------------------------------------------------------------------------*/
+#if MEMB_BITMAP
+#ifdef __GNUC__
+#define first_set_bit(word) __builtin_ctz(word)
+#define count_set_bits(word) __builtin_popcount(word)
+#else /* __GNUC__ */
+static int
+first_set_bit(memb_used_t word)
+{
+  int bit;
+
+  for(bit = 0; (word & 1) == 0; bit++) {
+    word >>= 1;
+  }
+  return bit;
+}
+/*---------------------------------------------------------------------------*/
+static int
+count_set_bits(memb_used_t word)
+{
+  int count;
+
+  for(count = 0; word != 0; count++) {
+    word &= word - 1;
+  }
+  return count;
+}
+#endif /* __GNUC__ */
+
+#define USED_WORD(i) ((i) / MEMB_USED_WORD_BITS)
+#define USED_MASK(i) ((memb_used_t)1 << ((i) % MEMB_USED_WORD_BITS))
+#define IS_USED(m, i) (((m)->used[USED_WORD(i)] & USED_MASK(i)) != 0)
+#define SET_USED(m, i) ((m)->used[USED_WORD(i)] |= USED_MASK(i))
+#define SET_FREE(m, i) ((m)->used[USED_WORD(i)] &= ~USED_MASK(i))
+#else /* MEMB_BITMAP */
+#define IS_USED(m, i) ((m)->used[i])
+#define SET_USED(m, i) ((m)->used[i] = true)
+#define SET_FREE(m, i) ((m)->used[i] = false)
+#endif /* MEMB_BITMAP */
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
-  memset(m->used, 0, m->num);
+  memset(m->used, 0, MEMB_USED_LEN(m->num) * sizeof(memb_used_t));
   memset(m->mem, 0, m->size * m->num);
 }
 /*---------------------------------------------------------------------------*/
@@ -60,6 +99,23 @@ memb_alloc(struct memb *m)
 {
   int i;
 
+#if MEMB_BITMAP
+  memb_used_t free_bits;
+  int w;
+
+  for(w = 0; w < MEMB_USED_LEN(m->num); ++w) {
+    free_bits = ~m->used[w];
+    if(free_bits != 0) {
+      i = w * MEMB_USED_WORD_BITS + first_set_bit(free_bits);
+      if(i >= m->num) {
+        /* Only the padding bits of the last word are free */
+        break;
+      }
+      SET_USED(m, i);
+      return (void *)((char *)m->mem + (i * m->size));
+    }
+  }
+#else /* MEMB_BITMAP */
   for(i = 0; i < m->num; ++i) {
     if(m->used[i] == false) {
       /* If this block was unused, we set the used flag on
@@ -68,6 +124,7 @@ memb_alloc(struct memb *m)
       return (void *)((char *)m->mem + (i * m->size));
     }
   }
+#endif /* MEMB_BITMAP */
 
   /* No free block was found, so we return NULL to indicate failure to
      allocate block. */
@@ -78,23 +135,27 @@ int
 memb_free(struct memb *m, void *ptr)
 {
   int i;
-  char *ptr2;
+  size_t offset;
 
-  /* Walk through the list of blocks and try to find the block to
-     which the pointer "ptr" points to. */
-  ptr2 = (char *)m->mem;
-  for(i = 0; i < m->num; ++i) {
-    if(ptr2 == (char *)ptr) {
-      /* We've found the block to which "ptr" points, so we check the allocation
-         status to detect the double-free error and free the block. */
-      if (m->used[i] == false)
-        return -1;
-      m->used[i] = false;
-      return 0;
-    }
-    ptr2 += m->size;
+  if(!memb_inmemb(m, ptr)) {
+    return -1;
   }
-  return -1;
+
+  /* Compute the index of the block to which "ptr" points, rejecting
+     pointers that do not point to the start of a block. */
+  offset = (char *)ptr - (char *)m->mem;
+  if(offset % m->size != 0) {
+    return -1;
+  }
+  i = offset / m->size;
+
+  /* Check the allocation status to detect the double-free error and
+     free the block. */
+  if(!IS_USED(m, i)) {
+    return -1;
+  }
+  SET_FREE(m, i);
+  return 0;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -110,11 +171,18 @@ memb_numfree(struct memb *m)
   int i;
   int num_free = 0;
 
+#if MEMB_BITMAP
+  for(i = 0; i < MEMB_USED_LEN(m->num); ++i) {
+    num_free += count_set_bits(m->used[i]);
+  }
+  num_free = m->num - num_free;
+#else /* MEMB_BITMAP */
   for(i = 0; i < m->num; ++i) {
     if(m->used[i] == false) {
       ++num_free;
     }
   }
+#endif /* MEMB_BITMAP */
 
   return num_free;
 }
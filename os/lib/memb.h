@@ -66,6 +66,26 @@
 #include <stdbool.h>
 #include "sys/cc.h"
 
+#ifdef MEMB_CONF_BITMAP
+#define MEMB_BITMAP MEMB_CONF_BITMAP
+#else /* MEMB_CONF_BITMAP */
+#define MEMB_BITMAP 0
+#endif /* MEMB_CONF_BITMAP */
+
+#if MEMB_BITMAP
+/*
+ * Allocation flags are packed into machine words, so that a free block
+ * is found with a single count-trailing-zeros per word of flags.
+ */
+typedef unsigned int memb_used_t;
+#define MEMB_USED_WORD_BITS (sizeof(memb_used_t) * 8)
+#define MEMB_USED_LEN(num) \
+        (((num) + MEMB_USED_WORD_BITS - 1) / MEMB_USED_WORD_BITS)
+#else /* MEMB_BITMAP */
+typedef bool memb_used_t;
+#define MEMB_USED_LEN(num) (num)
+#endif /* MEMB_BITMAP */
+
 /**
  * Declare a memory block.
  *
@@ -88,7 +108,7 @@ MEMB(connections, struct connection, 16);
  *
  */
 #define MEMB(name, structure, num) \
-        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static memb_used_t CC_CONCAT(name,_memb_used)[MEMB_USED_LEN(num)]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
@@ -97,7 +117,7 @@ MEMB(connections, struct connection, 16);
 struct memb {
   unsigned short size;
   unsigned short num;
-  bool *used;
+  memb_used_t *used;
   void *mem;
 };
 
@@ -112,5 +112,22 @@
 #define COAP_OBSERVER_URL_LEN 20
 #endif
 
+/* Number of hash buckets used to look up resources by URI path. With 0,
+   every request is matched against the list of resources in turn. */
+#ifdef COAP_CONF_RESOURCE_HASH_BUCKETS
+#define COAP_RESOURCE_HASH_BUCKETS COAP_CONF_RESOURCE_HASH_BUCKETS
+#else
+#define COAP_RESOURCE_HASH_BUCKETS 0
+#endif /* COAP_CONF_RESOURCE_HASH_BUCKETS */
+
+/* Number of hash buckets used to find the observers of a resource
+   without sub-resources. With 0, every notification scans all
+   observers. */
+#ifdef COAP_CONF_OBSERVER_HASH_BUCKETS
+#define COAP_OBSERVER_HASH_BUCKETS COAP_CONF_OBSERVER_HASH_BUCKETS
+#else
+#define COAP_OBSERVER_HASH_BUCKETS 0
+#endif /* COAP_CONF_OBSERVER_HASH_BUCKETS */
+
 #endif /* COAP_CONF_H_ */
 /** @} */
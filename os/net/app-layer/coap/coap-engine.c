@@ -72,6 +72,20 @@ LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
 
+#if COAP_RESOURCE_HASH_BUCKETS
+/*
+ * Resources hashed on their whole URI path. A request is looked up once
+ * with its whole path and, for resources with sub-resources, once per
+ * prefix ending before a '/'.
+ */
+static coap_resource_t *resource_hash[COAP_RESOURCE_HASH_BUCKETS];
+static uint16_t activation_count;
+
+/* FNV-1a, so that the hash of every prefix comes for free */
+#define HASH_INIT         2166136261UL
+#define HASH_STEP(h, c)   (((h) ^ (uint8_t)(c)) * 16777619UL)
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
+
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -379,12 +393,57 @@ coap_engine_init(void)
 
   list_init(coap_handlers);
   list_init(coap_resource_services);
+#if COAP_RESOURCE_HASH_BUCKETS
+  memset(resource_hash, 0, sizeof(resource_hash));
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
 
   coap_activate_resource(&res_well_known_core, ".well-known/core");
 
   coap_transport_init();
   coap_init_connection();
 }
+#if COAP_RESOURCE_HASH_BUCKETS
+/*---------------------------------------------------------------------------*/
+static coap_resource_t **
+hash_bucket(const char *path, int len)
+{
+  uint32_t h = HASH_INIT;
+
+  while(len-- > 0) {
+    h = HASH_STEP(h, *path++);
+  }
+  return &resource_hash[h % COAP_RESOURCE_HASH_BUCKETS];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(coap_resource_t *resource)
+{
+  coap_resource_t **r;
+
+  if(resource->url == NULL) {
+    return;
+  }
+  for(r = hash_bucket(resource->url, resource->url_len); *r != NULL;
+      r = &(*r)->hash_next) {
+    if(*r == resource) {
+      *r = resource->hash_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(coap_resource_t *resource)
+{
+  coap_resource_t **bucket;
+
+  resource->url_len = strlen(resource->url);
+  resource->order = activation_count++;
+  bucket = hash_bucket(resource->url, resource->url_len);
+  resource->hash_next = *bucket;
+  *bucket = resource;
+}
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
 /*---------------------------------------------------------------------------*/
 /**
  * \brief Makes a resource available under the given URI path
@@ -399,8 +458,17 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+#if COAP_RESOURCE_HASH_BUCKETS
+  /* list_add() moves a resource activated twice to the end of the list */
+  if(list_contains(coap_resource_services, resource)) {
+    hash_remove(resource);
+  }
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
   resource->url = path;
   list_add(coap_resource_services, resource);
+#if COAP_RESOURCE_HASH_BUCKETS
+  hash_add(resource);
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
 
   LOG_INFO("Activating: %s\n", resource->url);
 
@@ -431,20 +499,51 @@ coap_get_next_resource(coap_resource_t *resource)
 {
   return list_item_next(resource);
 }
+#if COAP_RESOURCE_HASH_BUCKETS
 /*---------------------------------------------------------------------------*/
-static int
-invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
-                             uint8_t *buffer, uint16_t buffer_size,
-                             int32_t *offset)
+/* Look for an earlier activated resource than best, with the given path */
+static coap_resource_t *
+lookup_bucket(uint32_t h, const char *url, int len, int sub,
+              coap_resource_t *best)
 {
-  uint8_t found = 0;
-  uint8_t allowed = 1;
-
+  coap_resource_t *r;
+
+  for(r = resource_hash[h % COAP_RESOURCE_HASH_BUCKETS];
+      r != NULL; r = r->hash_next) {
+    if(r->url_len == len
+       && (!sub || (r->flags & HAS_SUB_RESOURCES))
+       && (best == NULL || r->order < best->order)
+       && strncmp(r->url, url, len) == 0) {
+      best = r;
+    }
+  }
+  return best;
+}
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
+/*---------------------------------------------------------------------------*/
+/*
+ * Find the resource handling url. When several resources match, because
+ * of HAS_SUB_RESOURCES, the one activated first wins.
+ */
+static coap_resource_t *
+find_resource(const char *url, int url_len)
+{
+#if COAP_RESOURCE_HASH_BUCKETS
   coap_resource_t *resource = NULL;
-  const char *url = NULL;
-  int url_len, res_url_len;
+  uint32_t h = HASH_INIT;
+  int i;
+
+  for(i = 0; i < url_len; i++) {
+    if(url[i] == '/') {
+      resource = lookup_bucket(h, url, i, 1, resource);
+    }
+    h = HASH_STEP(h, url[i]);
+  }
+  return lookup_bucket(h, url, url_len, 0, resource);
+#else /* COAP_RESOURCE_HASH_BUCKETS */
+  coap_resource_t *resource;
+  int res_url_len;
 
-  url_len = coap_get_header_uri_path(request, &url);
   for(resource = list_head(coap_resource_services);
       resource; resource = resource->next) {
 
@@ -455,31 +554,51 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
             && (resource->flags & HAS_SUB_RESOURCES)
             && url[res_url_len] == '/'))
        && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+      return resource;
+    }
+  }
+  return NULL;
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
+}
+/*---------------------------------------------------------------------------*/
+static int
+invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
+                             uint8_t *buffer, uint16_t buffer_size,
+                             int32_t *offset)
+{
+  uint8_t found = 0;
+  uint8_t allowed = 1;
+
+  coap_resource_t *resource = NULL;
+  const char *url = NULL;
+  int url_len;
+
+  url_len = coap_get_header_uri_path(request, &url);
+  resource = find_resource(url, url_len);
+  if(resource != NULL) {
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
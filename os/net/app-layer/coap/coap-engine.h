@@ -111,6 +111,11 @@ struct coap_resource_s {
     coap_resource_trigger_handler_t trigger;
     coap_resource_trigger_handler_t resume;
   };
+#if COAP_RESOURCE_HASH_BUCKETS
+  coap_resource_t *hash_next;       /* next resource in the same bucket */
+  uint16_t url_len;                 /* length of url */
+  uint16_t order;                   /* activation order, to break ties */
+#endif /* COAP_RESOURCE_HASH_BUCKETS */
 };
 
 struct coap_periodic_resource_s {
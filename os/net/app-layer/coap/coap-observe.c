@@ -56,6 +56,57 @@
 /*---------------------------------------------------------------------------*/
 MEMB(observers_memb, coap_observer_t, COAP_MAX_OBSERVERS);
 LIST(observers_list);
+
+#if COAP_OBSERVER_HASH_BUCKETS
+/*
+ * Observers hashed on their URI path. Notifications from resources
+ * without sub-resources only look at the observers of that very path.
+ */
+static coap_observer_t *observers_hash[COAP_OBSERVER_HASH_BUCKETS];
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
+
+/*
+ * A notification is built and serialized once, without token and with an
+ * empty observe option. Each observer gets a copy with its own token, MID
+ * and observe sequence number.
+ */
+static uint8_t notification_buffer[COAP_MAX_PACKET_SIZE + 1];
+static size_t notification_len;
+/* Offset of the observe option in notification_buffer, or -1 */
+static int notification_observe;
+
+#if COAP_OBSERVER_HASH_BUCKETS
+#define NEXT_IN_BUCKET(o) ((o)->hash_next)
+#else /* COAP_OBSERVER_HASH_BUCKETS */
+#define NEXT_IN_BUCKET(o) NULL
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
+/*---------------------------------------------------------------------------*/
+#if COAP_OBSERVER_HASH_BUCKETS
+static coap_observer_t **
+hash_bucket(const char *url)
+{
+  /* FNV-1a */
+  uint32_t h = 2166136261UL;
+
+  while(*url != '\0') {
+    h = (h ^ (uint8_t)*url++) * 16777619UL;
+  }
+  return &observers_hash[h % COAP_OBSERVER_HASH_BUCKETS];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(coap_observer_t *o)
+{
+  coap_observer_t **r;
+
+  for(r = hash_bucket(o->url); *r != NULL; r = &(*r)->hash_next) {
+    if(*r == o) {
+      *r = o->hash_next;
+      return;
+    }
+  }
+}
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
 /*---------------------------------------------------------------------------*/
 /*- Internal API ------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -75,6 +126,7 @@ add_observer(const coap_endpoint_t *endpoint, const uint8_t *token,
     }
     memcpy(o->url, uri, max);
     o->url[max] = 0;
+    o->url_len = max;
     coap_endpoint_copy(&o->endpoint, endpoint);
     o->token_len = token_len;
     memcpy(o->token, token, token_len);
@@ -84,6 +136,13 @@ add_observer(const coap_endpoint_t *endpoint, const uint8_t *token,
              list_length(observers_list) + 1, COAP_MAX_OBSERVERS,
              o->url, o->token[0], o->token[1]);
     list_add(observers_list, o);
+#if COAP_OBSERVER_HASH_BUCKETS
+    {
+      coap_observer_t **bucket = hash_bucket(o->url);
+      o->hash_next = *bucket;
+      *bucket = o;
+    }
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
   }
 
   return o;
@@ -97,6 +156,9 @@ coap_remove_observer(coap_observer_t *o)
   LOG_INFO("Removing observer for /%s [0x%02X%02X]\n", o->url, o->token[0],
            o->token[1]);
 
+#if COAP_OBSERVER_HASH_BUCKETS
+  hash_remove(o);
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
   memb_free(&observers_memb, o);
   list_remove(observers_list, o);
 }
@@ -185,18 +247,195 @@ coap_notify_observers(coap_resource_t *resource)
 {
   coap_notify_observers_sub(resource, NULL);
 }
+/*---------------------------------------------------------------------------*/
+/* Find the observe option in the serialized notification */
+static int
+find_observe_option(void)
+{
+  size_t i = COAP_HEADER_LEN;
+  size_t j;
+  unsigned int number = 0;
+  unsigned int delta;
+  unsigned int length;
+
+  while(i < notification_len && notification_buffer[i] != 0xFF) {
+    delta = notification_buffer[i] >> 4;
+    length = notification_buffer[i] & COAP_HEADER_OPTION_SHORT_LENGTH_MASK;
+    j = i + 1;
+    if(delta == 13) {
+      delta += notification_buffer[j++];
+    } else if(delta == 14) {
+      delta = 269 + (notification_buffer[j] << 8) + notification_buffer[j + 1];
+      j += 2;
+    }
+    if(length == 13) {
+      length += notification_buffer[j++];
+    } else if(length == 14) {
+      length = 269 + (notification_buffer[j] << 8) + notification_buffer[j + 1];
+      j += 2;
+    }
+    number += delta;
+    if(number == COAP_OPTION_OBSERVE) {
+      return i;
+    } else if(number > COAP_OPTION_OBSERVE) {
+      break;
+    }
+    i = j + length;
+  }
+  return -1;
+}
+/*---------------------------------------------------------------------------*/
+/* Call the handler once and serialize its response in notification_buffer.
+   Returns 0 if the response could not be serialized. */
+static int
+build_notification(coap_resource_t *resource, const char *url)
+{
+  coap_message_t notification[1]; /* this way the message can be treated as pointer as usual */
+  coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
+  int32_t new_offset = 0;
+
+  coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
+  /* create a "fake" request for the URI */
+  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
+  coap_set_header_uri_path(request, url);
+
+  /* Either old style get_handler or the full handler */
+  if(coap_call_handlers(request, notification, notification_buffer +
+                        COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
+                        &new_offset) > 0) {
+    LOG_DBG("Notification on new handlers\n");
+  } else {
+    if(resource != NULL) {
+      resource->get_handler(request, notification,
+                            notification_buffer + COAP_MAX_HEADER_SIZE,
+                            COAP_MAX_CHUNK_SIZE, &new_offset);
+    } else {
+      /* What to do here? */
+      notification->code = BAD_REQUEST_4_00;
+    }
+  }
+
+  if(notification->code < BAD_REQUEST_4_00) {
+    /* Placeholder for the sequence number of each observer */
+    coap_set_header_observe(notification, 0);
+  }
+
+  if(new_offset != 0) {
+    coap_set_header_block2(notification,
+                           0,
+                           new_offset != -1,
+                           COAP_MAX_BLOCK_SIZE);
+    coap_set_payload(notification,
+                     notification->payload,
+                     MIN(notification->payload_len,
+                         COAP_MAX_BLOCK_SIZE));
+  }
+
+  notification_len = coap_serialize_message(notification, notification_buffer);
+  if(notification_len < COAP_HEADER_LEN) {
+    LOG_WARN("Failed to serialize notification\n");
+    return 0;
+  }
+  notification_observe = -1;
+  if(notification->code < BAD_REQUEST_4_00) {
+    notification_observe = find_observe_option();
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Send a copy of the notification to one observer */
+static void
+send_notification(coap_observer_t *obs)
+{
+  coap_transaction_t *transaction;
+  coap_message_type_t type = COAP_TYPE_NON;
+  uint8_t *out;
+  size_t len;
+  size_t tail;
+  uint32_t seq;
+  uint8_t seq_len;
+
+  if(notification_len + COAP_TOKEN_LEN + 3 > COAP_MAX_PACKET_SIZE) {
+    LOG_WARN("Notification too large (%u bytes)\n",
+             (unsigned)notification_len);
+    return;
+  }
+
+  /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
+
+  if((transaction = coap_new_transaction(coap_get_mid(), &obs->endpoint)) == NULL) {
+    return;
+  }
+
+  /* if COAP_OBSERVE_REFRESH_INTERVAL is zero, never send observations as confirmable messages */
+  if(COAP_OBSERVE_REFRESH_INTERVAL != 0
+     && (obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0)) {
+    LOG_DBG("           Force Confirmable for\n");
+    type = COAP_TYPE_CON;
+  }
+
+  LOG_DBG("           Observer ");
+  LOG_DBG_COAP_EP(&obs->endpoint);
+  LOG_DBG_("\n");
+
+  /* update last MID for RST matching */
+  obs->last_mid = transaction->mid;
+
+  /* Header, with the type, token length and MID of this observer */
+  out = transaction->message;
+  out[0] = (notification_buffer[0] & COAP_HEADER_VERSION_MASK)
+    | (COAP_HEADER_TYPE_MASK & type << COAP_HEADER_TYPE_POSITION)
+    | (COAP_HEADER_TOKEN_LEN_MASK & obs->token_len << COAP_HEADER_TOKEN_LEN_POSITION);
+  out[1] = notification_buffer[1];
+  out[2] = (uint8_t)(transaction->mid >> 8);
+  out[3] = (uint8_t)(transaction->mid);
+  memcpy(out + COAP_HEADER_LEN, obs->token, obs->token_len);
+  len = COAP_HEADER_LEN + obs->token_len;
+
+  if(notification_observe < 0) {
+    memcpy(out + len, notification_buffer + COAP_HEADER_LEN,
+           notification_len - COAP_HEADER_LEN);
+    len += notification_len - COAP_HEADER_LEN;
+  } else {
+    /* Options before observe */
+    memcpy(out + len, notification_buffer + COAP_HEADER_LEN,
+           notification_observe - COAP_HEADER_LEN);
+    len += notification_observe - COAP_HEADER_LEN;
+
+    /* Observe option, with the shortest encoding of the sequence number */
+    seq = obs->obs_counter;
+    seq_len = seq > 0xFFFF ? 3 : seq > 0xFF ? 2 : seq > 0 ? 1 : 0;
+    out[len++] = (notification_buffer[notification_observe]
+                  & COAP_HEADER_OPTION_DELTA_MASK) | seq_len;
+    while(seq_len > 0) {
+      seq_len--;
+      out[len++] = (uint8_t)(seq >> (8 * seq_len));
+    }
+    (obs->obs_counter)++;
+    /* mask out to keep the CoAP observe option length <= 3 bytes */
+    obs->obs_counter &= 0xffffff;
+
+    /* Remaining options and payload */
+    tail = notification_len - notification_observe - 1;
+    memcpy(out + len, notification_buffer + notification_observe + 1, tail);
+    len += tail;
+  }
+
+  transaction->message_len = len;
+  coap_send_transaction(transaction);
+}
+/*---------------------------------------------------------------------------*/
 /* Can be used either for sub - or when there is not resource - just
    a handler */
 void
 coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
 {
-  /* build notification */
-  coap_message_t notification[1]; /* this way the message can be treated as pointer as usual */
-  coap_message_t request[1]; /* this way the message can be treated as pointer as usual */
   coap_observer_t *obs = NULL;
-  int url_len, obs_url_len;
+  int url_len;
   char url[COAP_OBSERVER_URL_LEN];
   uint8_t sub_ok = 0;
+  uint8_t indexed = 0;
+  uint8_t built = 0;
 
   if(resource != NULL) {
     url_len = strlen(resource->url);
@@ -216,92 +455,40 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   /* url now contains the notify URL that needs to match the observer */
   LOG_INFO("Notification from %s\n", url);
 
-  coap_init_message(notification, COAP_TYPE_NON, CONTENT_2_05, 0);
-  /* create a "fake" request for the URI */
-  coap_init_message(request, COAP_TYPE_CON, COAP_GET, 0);
-  coap_set_header_uri_path(request, url);
-
   /* iterate over observers */
   url_len = strlen(url);
   /* Assumes lazy evaluation... */
   sub_ok = (resource == NULL) || (resource->flags & HAS_SUB_RESOURCES);
-  for(obs = (coap_observer_t *)list_head(observers_list); obs;
-      obs = obs->next) {
-    obs_url_len = strlen(obs->url);
+#if COAP_OBSERVER_HASH_BUCKETS
+  /* Observers of sub-resources have other paths: those need a full scan */
+  indexed = !sub_ok;
+  if(indexed) {
+    obs = *hash_bucket(url);
+  } else
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
+  {
+    obs = (coap_observer_t *)list_head(observers_list);
+  }
+  for(; obs; obs = indexed ? NEXT_IN_BUCKET(obs) : obs->next) {
 
     /* Do a match based on the parent/sub-resource match so that it is
        possible to do parent-node observe */
 
     /***** TODO fix here so that we handle the notofication correctly ******/
     /* All the new-style ... is assuming that the URL might be within */
-    if((obs_url_len == url_len
-        || (obs_url_len > url_len
+    if((obs->url_len == url_len
+        || (obs->url_len > url_len
             && sub_ok
             && obs->url[url_len] == '/'))
        && strncmp(url, obs->url, url_len) == 0) {
-      coap_transaction_t *transaction = NULL;
-
-      /*TODO implement special transaction for CON, sharing the same buffer to allow for more observers */
-
-      if((transaction = coap_new_transaction(coap_get_mid(), &obs->endpoint))) {
-        /* if COAP_OBSERVE_REFRESH_INTERVAL is zero, never send observations as confirmable messages */
-        if(COAP_OBSERVE_REFRESH_INTERVAL != 0
-            && (obs->obs_counter % COAP_OBSERVE_REFRESH_INTERVAL == 0)) {
-          LOG_DBG("           Force Confirmable for\n");
-          notification->type = COAP_TYPE_CON;
-        }
-
-        LOG_DBG("           Observer ");
-        LOG_DBG_COAP_EP(&obs->endpoint);
-        LOG_DBG_("\n");
-
-        /* update last MID for RST matching */
-        obs->last_mid = transaction->mid;
-
-        /* prepare response */
-        notification->mid = transaction->mid;
-
-	int32_t new_offset = 0;
-
-        /* Either old style get_handler or the full handler */
-        if(coap_call_handlers(request, notification, transaction->message +
-                              COAP_MAX_HEADER_SIZE, COAP_MAX_CHUNK_SIZE,
-                              &new_offset) > 0) {
-          LOG_DBG("Notification on new handlers\n");
-        } else {
-          if(resource != NULL) {
-            resource->get_handler(request, notification,
-                                  transaction->message + COAP_MAX_HEADER_SIZE,
-                                  COAP_MAX_CHUNK_SIZE, &new_offset);
-          } else {
-            /* What to do here? */
-            notification->code = BAD_REQUEST_4_00;
-          }
-        }
-
-        if(notification->code < BAD_REQUEST_4_00) {
-          coap_set_header_observe(notification, (obs->obs_counter)++);
-          /* mask out to keep the CoAP observe option length <= 3 bytes */
-          obs->obs_counter &= 0xffffff;
+      if(!built) {
+        /* The representation is the same for every observer */
+        if(!build_notification(resource, url)) {
+          return;
         }
-        coap_set_token(notification, obs->token, obs->token_len);
-
-	if(new_offset != 0) {
-	  coap_set_header_block2(notification,
-				 0,
-				 new_offset != -1,
-				 COAP_MAX_BLOCK_SIZE);
-	  coap_set_payload(notification,
-			   notification->payload,
-			   MIN(notification->payload_len,
-			       COAP_MAX_BLOCK_SIZE));
-	}
-
-        transaction->message_len =
-          coap_serialize_message(notification, transaction->message);
-
-        coap_send_transaction(transaction);
+        built = 1;
       }
+      send_notification(obs);
     }
   }
 }
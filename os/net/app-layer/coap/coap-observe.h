@@ -50,8 +50,12 @@
 
 typedef struct coap_observer {
   struct coap_observer *next;   /* for LIST */
+#if COAP_OBSERVER_HASH_BUCKETS
+  struct coap_observer *hash_next; /* next observer in the same bucket */
+#endif /* COAP_OBSERVER_HASH_BUCKETS */
 
   char url[COAP_OBSERVER_URL_LEN];
+  uint8_t url_len;
   coap_endpoint_t endpoint;
   uint8_t token_len;
   uint8_t token[COAP_TOKEN_LEN];
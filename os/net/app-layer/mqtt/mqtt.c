@@ -77,6 +77,7 @@ typedef enum {
   MQTT_FHDR_QOS_LEVEL_0            = 0x00,
   MQTT_FHDR_QOS_LEVEL_1            = 0x02,
   MQTT_FHDR_QOS_LEVEL_2            = 0x04,
+  MQTT_FHDR_QOS_LEVEL_MASK         = 0x06,
 
   MQTT_FHDR_RETAIN_FLAG            = 0x01,
 } mqtt_fhdr_fields_t;
@@ -179,6 +180,15 @@ typedef enum {
   while(write_byte(conn, data)) {                                              \
     PT_WAIT_UNTIL(pt, (conn)->out_buffer_sent);                                \
   }
+
+#define PT_MQTT_WRITE_BYTES_REF(conn, data, len)                               \
+  conn->out_write_pos = 0;                                                     \
+  while(write_bytes_ref(conn, data, len)) {                                    \
+    if((conn)->state != MQTT_CONN_STATE_CONNECTED_TO_BROKER) {                 \
+      PT_EXIT(pt);                                                             \
+    }                                                                          \
+    PT_WAIT_UNTIL(pt, (conn)->out_buffer_sent);                                \
+  }
 /*---------------------------------------------------------------------------*/
 /*
  * Sends the continue send event and wait for that event.
@@ -350,7 +360,7 @@ write_byte(struct mqtt_connection *conn, uint8_t data)
 }
 /*---------------------------------------------------------------------------*/
 static int
-write_bytes(struct mqtt_connection *conn, uint8_t *data, uint16_t len)
+write_bytes(struct mqtt_connection *conn, const uint8_t *data, uint16_t len)
 {
   uint16_t write_bytes;
   write_bytes =
@@ -373,6 +383,52 @@ write_bytes(struct mqtt_connection *conn, uint8_t *data, uint16_t len)
   }
 }
 /*---------------------------------------------------------------------------*/
+#if MQTT_ZERO_COPY
+static int
+write_bytes_ref(struct mqtt_connection *conn, const uint8_t *data,
+                uint32_t len)
+{
+  int queued;
+
+  if(len - conn->out_write_pos == 0) {
+    conn->out_write_pos = 0;
+    return 0;
+  }
+
+  /*
+   * The data is sent from where it is, right after what has been written to
+   * the output buffer so far. The output buffer and the data are held by the
+   * TCP socket until they have been acknowledged, so wait for that before
+   * writing anything else.
+   */
+  send_out_buffer(conn);
+  queued = tcp_socket_send_ref(&conn->socket, &data[conn->out_write_pos],
+                               MIN(len - conn->out_write_pos, 0xffff));
+  if(queued <= 0) {
+    tcp_socket_event_t event = TCP_SOCKET_ABORTED;
+
+    /*
+     * The headers of the PUBLISH have gone out already, so the broker would
+     * take whatever comes next as the rest of the payload. Drop the
+     * connection instead.
+     */
+    PRINTF("MQTT - Error, could not queue payload\n");
+    conn->out_write_pos = 0;
+    ctimer_stop(&conn->keep_alive_timer);
+    call_event(conn, MQTT_EVENT_DISCONNECTED, &event);
+    abort_connection(conn);
+    return -1;
+  }
+  conn->out_write_pos += queued;
+  conn->out_buffer_sent = 0;
+
+  DBG("MQTT - (write_bytes_ref) len: %lu write_pos: %lu\n",
+      (unsigned long)len, (unsigned long)conn->out_write_pos);
+
+  return 1;
+}
+#endif /* MQTT_ZERO_COPY */
+/*---------------------------------------------------------------------------*/
 uint8_t
 mqtt_decode_var_byte_int(const uint8_t *input_data_ptr,
                          int input_data_len,
@@ -891,9 +947,23 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
 #endif
 
   /* Write Payload */
-  PT_MQTT_WRITE_BYTES(conn,
-                      conn->out_packet.payload,
-                      conn->out_packet.payload_size);
+  for(conn->out_packet.payload_frag_pos = 0;
+      conn->out_packet.payload_frag_pos < conn->out_packet.payload_frag_count;
+      conn->out_packet.payload_frag_pos++) {
+#if MQTT_ZERO_COPY
+    if(conn->out_packet.payload_frags[conn->out_packet.payload_frag_pos].len >
+       (uint32_t)(&conn->out_buffer[MQTT_TCP_OUTPUT_BUFF_SIZE] -
+                  conn->out_buffer_ptr)) {
+      PT_MQTT_WRITE_BYTES_REF(conn,
+        conn->out_packet.payload_frags[conn->out_packet.payload_frag_pos].data,
+        conn->out_packet.payload_frags[conn->out_packet.payload_frag_pos].len);
+      continue;
+    }
+#endif
+    PT_MQTT_WRITE_BYTES(conn,
+      conn->out_packet.payload_frags[conn->out_packet.payload_frag_pos].data,
+      conn->out_packet.payload_frags[conn->out_packet.payload_frag_pos].len);
+  }
 
   send_out_buffer(conn);
   timer_set(&conn->t, RESPONSE_WAIT_TIMEOUT);
@@ -905,6 +975,7 @@ PT_THREAD(publish_pt(struct pt *pt, struct mqtt_connection *conn))
    * Also notify the app will not be notified via PUBACK or PUBCOMP
    */
   if(conn->out_packet.qos == 0) {
+    PT_WAIT_UNTIL(pt, conn->out_buffer_sent);
     process_post(conn->app_process, mqtt_update_event, NULL);
   } else if(conn->out_packet.qos == 1) {
     /* Wait for PUBACK */
@@ -1202,21 +1273,19 @@ parse_publish_vhdr(struct mqtt_connection *conn,
 {
   uint16_t copy_bytes;
 
-  /* Read out topic length */
-  if(conn->in_packet.topic_len_received == 0) {
-    conn->in_packet.topic_pos = 0;
-    conn->in_packet.topic_len = (input_data_ptr[(*pos)++] << 8);
+  /* Read out topic length, which may be split between two reads */
+  while(conn->in_packet.topic_len_received == 0 && *pos < input_data_len) {
+    conn->in_packet.topic_len = (conn->in_packet.topic_len << 8) |
+      input_data_ptr[(*pos)++];
     conn->in_packet.byte_counter++;
-    if(*pos >= input_data_len) {
-      return;
+    if(++conn->in_packet.topic_pos < MQTT_STRING_LEN_SIZE) {
+      continue;
     }
-    conn->in_packet.topic_len |= input_data_ptr[(*pos)++];
-    conn->in_packet.byte_counter++;
+    conn->in_packet.topic_pos = 0;
     conn->in_packet.topic_len_received = 1;
-    /* Abort if topic is longer than our topic buffer */
+    /* A topic longer than our topic buffer is cut short */
     if(conn->in_packet.topic_len > MQTT_MAX_TOPIC_LENGTH) {
       DBG("MQTT - topic too long %u/%u\n", conn->in_packet.topic_len, MQTT_MAX_TOPIC_LENGTH);
-      return;
     }
     DBG("MQTT - Read PUBLISH topic len %i\n", conn->in_packet.topic_len);
     /* WARNING: Check here if TOPIC fits in payload area, otherwise error */
@@ -1229,9 +1298,12 @@ parse_publish_vhdr(struct mqtt_connection *conn,
                      input_data_len - *pos);
     DBG("MQTT - topic_pos: %i copy_bytes: %i\n", conn->in_packet.topic_pos,
         copy_bytes);
-    memcpy(&conn->in_publish_msg.topic[conn->in_packet.topic_pos],
-           &input_data_ptr[*pos],
-           copy_bytes);
+    if(conn->in_packet.topic_pos < MQTT_MAX_TOPIC_LENGTH) {
+      memcpy(&conn->in_publish_msg.topic[conn->in_packet.topic_pos],
+             &input_data_ptr[*pos],
+             MIN(copy_bytes,
+                 MQTT_MAX_TOPIC_LENGTH - conn->in_packet.topic_pos));
+    }
     (*pos) += copy_bytes;
     conn->in_packet.byte_counter += copy_bytes;
     conn->in_packet.topic_pos += copy_bytes;
@@ -1239,7 +1311,8 @@ parse_publish_vhdr(struct mqtt_connection *conn,
     if(conn->in_packet.topic_len - conn->in_packet.topic_pos == 0) {
       DBG("MQTT - Got topic '%s'", conn->in_publish_msg.topic);
       conn->in_packet.topic_received = 1;
-      conn->in_publish_msg.topic[conn->in_packet.topic_pos] = '\0';
+      conn->in_publish_msg.topic[MIN(conn->in_packet.topic_pos,
+                                     MQTT_MAX_TOPIC_LENGTH)] = '\0';
       conn->in_publish_msg.payload_length =
         conn->in_packet.remaining_length - conn->in_packet.topic_len - 2;
       conn->in_publish_msg.payload_left = conn->in_publish_msg.payload_length;
@@ -1337,6 +1410,118 @@ parse_vhdr(struct mqtt_connection *conn)
 #endif
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * The number of bytes between the topic and the payload of an incoming
+ * PUBLISH, as far as it can be told from what is in the payload buffer.
+ */
+static uint16_t
+publish_vhdr_len(struct mqtt_connection *conn)
+{
+  uint16_t len = 0;
+#if MQTT_5
+  uint16_t properties_len = 0;
+  uint8_t properties_enc_len;
+#endif
+
+  /* Packet identifier */
+  if(conn->in_packet.fhdr & MQTT_FHDR_QOS_LEVEL_MASK) {
+    len += MQTT_MID_SIZE;
+  }
+
+#if MQTT_5
+  if(conn->in_packet.payload_pos <= len) {
+    return len + 1;
+  }
+  properties_enc_len =
+    mqtt_decode_var_byte_int(&conn->in_packet.payload[len],
+                             conn->in_packet.payload_pos - len,
+                             NULL, NULL, &properties_len);
+  if(properties_enc_len == 0) {
+    /* The property length has not been received in full */
+    return conn->in_packet.payload_pos + 1;
+  }
+  len += properties_enc_len + properties_len;
+#endif
+
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Hands the payload of an incoming PUBLISH to the stream callback straight
+ * from the TCP input buffer. Only the part of the VHDR after the topic is
+ * copied to the payload buffer, so that it can be parsed as usual.
+ *
+ * Returns 1 when the whole packet has been read, 0 if more data is needed
+ * and -1 if the packet cannot be handled.
+ */
+static int
+stream_publish(struct mqtt_connection *conn,
+               uint32_t *pos,
+               const uint8_t *input_data_ptr,
+               int input_data_len)
+{
+  uint16_t vhdr_len;
+  uint16_t copy_bytes;
+
+  if(!conn->in_packet.streaming) {
+    vhdr_len = publish_vhdr_len(conn);
+    while(conn->in_packet.payload_pos < vhdr_len) {
+      if(vhdr_len > MQTT_INPUT_BUFF_SIZE ||
+         vhdr_len - conn->in_packet.payload_pos >
+         conn->in_publish_msg.payload_left) {
+        PRINTF("MQTT - Error, unsupported PUBLISH VHDR\n");
+        return -1;
+      }
+      if(*pos >= input_data_len) {
+        return 0;
+      }
+      copy_bytes = MIN(vhdr_len - conn->in_packet.payload_pos,
+                       input_data_len - *pos);
+      memcpy(&conn->in_packet.payload[conn->in_packet.payload_pos],
+             &input_data_ptr[*pos],
+             copy_bytes);
+      (*pos) += copy_bytes;
+      conn->in_packet.byte_counter += copy_bytes;
+      conn->in_packet.payload_pos += copy_bytes;
+      conn->in_publish_msg.payload_left -= copy_bytes;
+      vhdr_len = publish_vhdr_len(conn);
+    }
+
+#if MQTT_PROTOCOL_VERSION >= MQTT_PROTOCOL_VERSION_3_1_1
+    if(strlen(conn->in_publish_msg.topic) < conn->in_packet.topic_len) {
+      DBG("NULL detected in received PUBLISH topic\n");
+      return -1;
+    }
+#endif
+
+    conn->in_packet.streaming = 1;
+    conn->in_publish_msg.payload_length = conn->in_publish_msg.payload_left;
+    conn->in_packet.payload_start = conn->in_packet.payload;
+    if(conn->in_packet.fhdr & MQTT_FHDR_QOS_LEVEL_MASK) {
+      conn->in_publish_msg.mid = (conn->in_packet.payload[0] << 8) |
+        conn->in_packet.payload[1];
+      conn->in_packet.payload_start += MQTT_MID_SIZE;
+    }
+#if MQTT_5
+    mqtt_prop_decode_input_props(conn);
+#endif
+  }
+
+  copy_bytes = MIN(conn->in_publish_msg.payload_left, input_data_len - *pos);
+  if(copy_bytes > 0 || conn->in_publish_msg.payload_length == 0) {
+    conn->in_publish_msg.payload_chunk = (uint8_t *)&input_data_ptr[*pos];
+    conn->in_publish_msg.payload_chunk_length = copy_bytes;
+    conn->in_publish_msg.payload_left -= copy_bytes;
+    (*pos) += copy_bytes;
+    conn->in_packet.byte_counter += copy_bytes;
+
+    conn->in_stream_callback(conn, &conn->in_publish_msg);
+    conn->in_publish_msg.first_chunk = 0;
+  }
+
+  return conn->in_publish_msg.payload_left == 0;
+}
+/*---------------------------------------------------------------------------*/
 static int
 tcp_input(struct tcp_socket *s,
           void *ptr,
@@ -1347,8 +1532,10 @@ tcp_input(struct tcp_socket *s,
   uint32_t pos = 0;
   uint32_t copy_bytes = 0;
   mqtt_pub_status_t pub_status;
-  uint8_t remaining_length_bytes;
+  uint8_t remaining_length_byte;
+  int stream_status;
 
+next_packet:
   if(input_data_len == 0) {
     return 0;
   }
@@ -1371,20 +1558,28 @@ tcp_input(struct tcp_socket *s,
     }
   }
 
-  /* Read the Remaining Length field, if we do not have it */
-  if(!conn->in_packet.has_remaining_length) {
-    remaining_length_bytes =
-      mqtt_decode_var_byte_int(input_data_ptr, input_data_len, &pos,
-                               &conn->in_packet.byte_counter,
-                               &conn->in_packet.remaining_length);
-
-    if(remaining_length_bytes == 0) {
+  /*
+   * Read the Remaining Length field, if we do not have it. The field may be
+   * split between two reads, the bytes read so far are counted by the
+   * byte counter.
+   */
+  while(!conn->in_packet.has_remaining_length) {
+    if(pos >= input_data_len) {
+      return 0;
+    }
+    if(conn->in_packet.byte_counter - MQTT_FHDR_SIZE ==
+       MQTT_MAX_REMAINING_LENGTH_BYTES) {
       call_event(conn, MQTT_EVENT_ERROR, NULL);
       return 0;
     }
-
-    DBG("MQTT - Finished reading remaining length byte\n");
-    conn->in_packet.has_remaining_length = 1;
+    remaining_length_byte = input_data_ptr[pos++];
+    conn->in_packet.remaining_length |= (remaining_length_byte & 0x7F) <<
+      (7 * (conn->in_packet.byte_counter - MQTT_FHDR_SIZE));
+    conn->in_packet.byte_counter++;
+    if((remaining_length_byte & 0x80) == 0) {
+      DBG("MQTT - Finished reading remaining length byte\n");
+      conn->in_packet.has_remaining_length = 1;
+    }
   }
 
   /*
@@ -1420,6 +1615,32 @@ tcp_input(struct tcp_socket *s,
       parse_publish_vhdr(conn, &pos, input_data_ptr, input_data_len);
     }
 
+    if(conn->in_stream_callback != NULL &&
+       (conn->in_packet.fhdr & 0xF0) == MQTT_FHDR_MSG_TYPE_PUBLISH &&
+       conn->in_packet.topic_received) {
+      stream_status = stream_publish(conn, &pos, input_data_ptr,
+                                     input_data_len);
+      if(stream_status < 0) {
+#if MQTT_5
+        mqtt_disconnect(conn, MQTT_PROP_LIST_NONE);
+#else
+        mqtt_disconnect(conn);
+#endif
+        return 0;
+      }
+      if(stream_status == 0) {
+        return 0;
+      }
+
+      /* Unlike the buffered path, this knows where the packet ends: carry
+         on with the next one in the input. */
+      conn->in_packet.packet_received = 1;
+      input_data_ptr += pos;
+      input_data_len -= pos;
+      pos = 0;
+      goto next_packet;
+    }
+
     /* Read in as much as we can into the packet payload */
     copy_bytes = MIN(input_data_len - pos,
                      MQTT_INPUT_BUFF_SIZE - conn->in_packet.payload_pos);
@@ -1605,7 +1826,7 @@ tcp_event(struct tcp_socket *s, void *ptr, tcp_socket_event_t event)
   case TCP_SOCKET_DATA_SENT: {
     DBG("MQTT - Got TCP_DATA_SENT\n");
 
-    if(conn->socket.output_data_len == 0) {
+    if(tcp_socket_queuelen(&conn->socket) == 0) {
       conn->out_buffer_sent = 1;
       conn->out_buffer_ptr = conn->out_buffer;
     }
@@ -1975,16 +2196,15 @@ mqtt_unsubscribe(struct mqtt_connection *conn, uint16_t *mid,
   return MQTT_STATUS_OK;
 }
 /*----------------------------------------------------------------------------*/
-mqtt_status_t
-mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
-             uint8_t *payload, uint32_t payload_size,
-             mqtt_qos_level_t qos_level,
+static mqtt_status_t
+prepare_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+                mqtt_qos_level_t qos_level,
 #if MQTT_5
-             mqtt_retain_t retain,
-             uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
-             struct mqtt_prop_list *prop_list)
+                mqtt_retain_t retain,
+                uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
+                struct mqtt_prop_list *prop_list)
 #else
-             mqtt_retain_t retain)
+                mqtt_retain_t retain)
 #endif
 {
   if(conn->state != MQTT_CONN_STATE_CONNECTED_TO_BROKER) {
@@ -2020,8 +2240,6 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
   conn->out_packet.topic = topic;
   conn->out_packet.topic_length = strlen(topic);
 #endif
-  conn->out_packet.payload = payload;
-  conn->out_packet.payload_size = payload_size;
   conn->out_packet.qos = qos_level;
   conn->out_packet.qos_state = MQTT_QOS_STATE_NO_ACK;
 
@@ -2033,9 +2251,91 @@ mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
   conn->out_props = prop_list;
 #endif
 
+  return MQTT_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_publish(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+             uint8_t *payload, uint32_t payload_size,
+             mqtt_qos_level_t qos_level,
+#if MQTT_5
+             mqtt_retain_t retain,
+             uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
+             struct mqtt_prop_list *prop_list)
+#else
+             mqtt_retain_t retain)
+#endif
+{
+  mqtt_status_t status;
+
+#if MQTT_5
+  status = prepare_publish(conn, mid, topic, qos_level, retain,
+                           topic_alias, topic_alias_en, prop_list);
+#else
+  status = prepare_publish(conn, mid, topic, qos_level, retain);
+#endif
+  if(status != MQTT_STATUS_OK) {
+    return status;
+  }
+
+  conn->out_packet.payload = payload;
+  conn->out_packet.payload_size = payload_size;
+  conn->out_packet.payload_frag.data = payload;
+  conn->out_packet.payload_frag.len = payload_size;
+  conn->out_packet.payload_frags = &conn->out_packet.payload_frag;
+  conn->out_packet.payload_frag_count = 1;
+
   process_post(&mqtt_process, mqtt_do_publish_event, conn);
   return MQTT_STATUS_OK;
 }
+/*---------------------------------------------------------------------------*/
+mqtt_status_t
+mqtt_publish_frags(struct mqtt_connection *conn, uint16_t *mid, char *topic,
+                   const struct mqtt_payload_frag *frags, uint8_t frag_count,
+                   mqtt_qos_level_t qos_level,
+#if MQTT_5
+                   mqtt_retain_t retain,
+                   uint8_t topic_alias, mqtt_topic_alias_en_t topic_alias_en,
+                   struct mqtt_prop_list *prop_list)
+#else
+                   mqtt_retain_t retain)
+#endif
+{
+  mqtt_status_t status;
+  uint8_t i;
+
+  if(frags == NULL && frag_count > 0) {
+    return MQTT_STATUS_INVALID_ARGS_ERROR;
+  }
+
+#if MQTT_5
+  status = prepare_publish(conn, mid, topic, qos_level, retain,
+                           topic_alias, topic_alias_en, prop_list);
+#else
+  status = prepare_publish(conn, mid, topic, qos_level, retain);
+#endif
+  if(status != MQTT_STATUS_OK) {
+    return status;
+  }
+
+  conn->out_packet.payload = NULL;
+  conn->out_packet.payload_size = 0;
+  for(i = 0; i < frag_count; i++) {
+    conn->out_packet.payload_size += frags[i].len;
+  }
+  conn->out_packet.payload_frags = frags;
+  conn->out_packet.payload_frag_count = frag_count;
+
+  process_post(&mqtt_process, mqtt_do_publish_event, conn);
+  return MQTT_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_set_stream_callback(struct mqtt_connection *conn,
+                         mqtt_topic_callback_t callback)
+{
+  conn->in_stream_callback = callback;
+}
 /*----------------------------------------------------------------------------*/
 void
 mqtt_set_username_password(struct mqtt_connection *conn, char *username,
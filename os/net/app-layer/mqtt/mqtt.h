@@ -139,6 +139,17 @@
 
 #define MQTT_TOPIC_MAX_LENGTH 128
 
+/*
+ * Send PUBLISH payloads that do not fit in the TCP output buffer straight
+ * from the application's memory instead of copying them into the buffer
+ * in MQTT_TCP_OUTPUT_BUFF_SIZE pieces.
+ */
+#ifdef MQTT_CONF_ZERO_COPY
+#define MQTT_ZERO_COPY MQTT_CONF_ZERO_COPY
+#else
+#define MQTT_ZERO_COPY 1
+#endif /* MQTT_CONF_ZERO_COPY */
+
 #if MQTT_PROTOCOL_VERSION >= MQTT_PROTOCOL_VERSION_3_1_1
 #ifdef MQTT_CONF_SUPPORTS_EMPTY_CLIENT_ID
 #define MQTT_SRV_SUPPORTS_EMPTY_CLIENT_ID MQTT_CONF_SUPPORTS_EMPTY_CLIENT_ID
@@ -419,6 +430,12 @@ struct mqtt_message {
   uint16_t payload_left;
 };
 
+/* A piece of the payload of an outgoing PUBLISH, see mqtt_publish_frags() */
+struct mqtt_payload_frag {
+  const uint8_t *data;
+  uint32_t len;
+};
+
 /* This struct represents a packet received from the MQTT server. */
 struct mqtt_in_packet {
   /* Used by the list interface, must be first in the struct. */
@@ -451,6 +468,9 @@ struct mqtt_in_packet {
   uint8_t topic_len_received;
   uint8_t topic_received;
 
+  /* The payload is being handed to the stream callback */
+  uint8_t streaming;
+
   /* Properties */
 #if MQTT_5
   uint8_t has_reason_code;
@@ -475,6 +495,10 @@ struct mqtt_out_packet {
   uint16_t topic_length;
   uint8_t *payload;
   uint32_t payload_size;
+  const struct mqtt_payload_frag *payload_frags;
+  struct mqtt_payload_frag payload_frag;
+  uint8_t payload_frag_count;
+  uint8_t payload_frag_pos;
   mqtt_qos_level_t qos;
   mqtt_qos_state_t qos_state;
   mqtt_retain_t retain;
@@ -557,6 +581,7 @@ struct mqtt_connection {
   uint8_t in_buffer[MQTT_TCP_INPUT_BUFF_SIZE];
   struct mqtt_in_packet in_packet;
   struct mqtt_message in_publish_msg;
+  mqtt_topic_callback_t in_stream_callback;
 
   /* TCP related information */
   char *server_host;
@@ -714,6 +739,65 @@ mqtt_status_t mqtt_publish(struct mqtt_connection *conn,
                            mqtt_retain_t retain);
 #endif
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief Publish to a MQTT topic, with the payload in several pieces.
+ * \param conn A pointer to the MQTT connection.
+ * \param mid A pointer to message ID.
+ * \param topic A pointer to the topic to subscribe to.
+ * \param frags An array of payload fragments, sent in order.
+ * \param frag_count The number of fragments in the array.
+ * \param qos_level Quality Of Service level to use. Currently supports 0, 1.
+ * \param retain The RETAIN flag, as for mqtt_publish().
+ * \param topic_alias Topic alias to send (MQTTv5-only).
+ * \param topic_alias_en Control whether or not to discard topic and only send
+ *        topic alias s(MQTTv5-only).
+ * \param prop_list Output properties (MQTTv5-only).
+ * \return MQTT_STATUS_OK or some error status
+ *
+ * This function works like mqtt_publish(), but gathers the payload from
+ * several places in memory, so that the application does not have to
+ * assemble it in a buffer first. With MQTT_ZERO_COPY, fragments that do
+ * not fit in the TCP output buffer are sent straight from the
+ * application's memory.
+ *
+ * The fragment array and the data it points to must stay untouched until
+ * the publish has completed, that is, until mqtt_ready() is true again.
+ * The same applies to the payload of mqtt_publish().
+ */
+mqtt_status_t mqtt_publish_frags(struct mqtt_connection *conn,
+                                 uint16_t *mid,
+                                 char *topic,
+                                 const struct mqtt_payload_frag *frags,
+                                 uint8_t frag_count,
+                                 mqtt_qos_level_t qos_level,
+#if MQTT_5
+                                 mqtt_retain_t retain,
+                                 uint8_t topic_alias,
+                                 mqtt_topic_alias_en_t topic_alias_en,
+                                 struct mqtt_prop_list *prop_list);
+#else
+                                 mqtt_retain_t retain);
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Receive the payload of incoming PUBLISH messages as a stream.
+ * \param conn A pointer to the MQTT connection.
+ * \param callback The function to call with each piece of payload, or NULL
+ *        to go back to MQTT_EVENT_PUBLISH.
+ *
+ * By default, the payload of an incoming PUBLISH is collected in a buffer
+ * of MQTT_INPUT_BUFF_SIZE bytes and handed to the application with
+ * MQTT_EVENT_PUBLISH once per buffer full. With a stream callback, the
+ * payload is handed to the callback as it arrives, straight from the TCP
+ * input buffer, and MQTT_EVENT_PUBLISH is not called for PUBLISH messages.
+ *
+ * The fields of the message are the same as with MQTT_EVENT_PUBLISH, but
+ * the pieces follow the TCP segments, so even a short payload may come in
+ * more than one piece. The payload chunk is only valid during the call.
+ */
+void mqtt_set_stream_callback(struct mqtt_connection *conn,
+                              mqtt_topic_callback_t callback);
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Set the user name and password for a MQTT client.
  * \param conn A pointer to the MQTT connection.
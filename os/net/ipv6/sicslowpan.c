@@ -231,6 +231,23 @@ static uint16_t my_tag;
 #define SICSLOWPAN_FRAGMENT_SIZE (127 - 2 - 15)
 #endif
 
+/* With fragment forwarding, a router relays the fragments of the
+ * packets it routes as they arrive, instead of reassembling the
+ * packets and fragmenting them again (RFC 8930 virtual reassembly
+ * buffers). Only the first fragment is decompressed on the way. */
+#ifdef SICSLOWPAN_CONF_FRAG_FORWARDING
+#define SICSLOWPAN_FRAG_FORWARDING (SICSLOWPAN_CONF_FRAG_FORWARDING && UIP_CONF_ROUTER)
+#else
+#define SICSLOWPAN_FRAG_FORWARDING 0
+#endif
+
+/* The number of packets whose fragments can be forwarded at the same time */
+#ifdef SICSLOWPAN_CONF_VRB_ENTRIES
+#define SICSLOWPAN_VRB_ENTRIES SICSLOWPAN_CONF_VRB_ENTRIES
+#else
+#define SICSLOWPAN_VRB_ENTRIES 4
+#endif
+
 /* Check the selected fragment size, since we use 8-bit integers to handle it. */
 #if SICSLOWPAN_FRAGMENT_SIZE > 255
 #error Too large SICSLOWPAN_FRAGMENT_SIZE set.
@@ -239,6 +256,20 @@ static uint16_t my_tag;
 /* Assuming that the worst growth for uncompression is 38 bytes */
 #define SICSLOWPAN_FIRST_FRAGMENT_SIZE (SICSLOWPAN_FRAGMENT_SIZE + 38)
 
+#if SICSLOWPAN_FRAGMENT_BUFFERS > 254
+#error SICSLOWPAN_FRAGMENT_BUFFERS must be at most 254
+#endif
+
+#if SICSLOWPAN_REASS_CONTEXTS > 127
+#error SICSLOWPAN_REASS_CONTEXTS must be at most 127
+#endif
+
+/* Terminates the fragment buffer chains */
+#define FRAG_NONE 0xff
+
+/* Fragment offsets are in 8-byte units; one bit per unit of uip_buf */
+#define REASS_UNITS ((UIP_BUFSIZE + 7) / 8)
+
 /* all information needed for reassembly */
 struct sicslowpan_frag_info {
   /** When reassembling, the source address of the fragments being merged */
@@ -249,11 +280,16 @@ struct sicslowpan_frag_info {
   uint16_t tag;
   /** Total length of the fragmented packet */
   uint16_t len;
-  /** Current length of reassembled fragments */
-  uint16_t reassembled_len;
+  /** Number of distinct 8-byte units of the packet received so far */
+  uint16_t received_units;
   /** Reassembly %process %timer. */
   struct timer reass_timer;
 
+  /** The first buffer in the chain of N-fragments of this packet */
+  uint8_t frags;
+  /** One bit per 8-byte unit of the packet received so far */
+  uint8_t received[(REASS_UNITS + 7) / 8];
+
   /** Fragment size of first fragment */
   uint16_t first_frag_len;
   /** First fragment - needs a larger buffer since the size is uncompressed size
@@ -264,8 +300,8 @@ struct sicslowpan_frag_info {
 static struct sicslowpan_frag_info frag_info[SICSLOWPAN_REASS_CONTEXTS];
 
 struct sicslowpan_frag_buf {
-  /* the index of the frag_info */
-  uint8_t index;
+  /* The next buffer of the same packet, or of the free list */
+  uint8_t next;
   /* Fragment offset */
   uint8_t offset;
   /* Length of this fragment (if zero this buffer is not allocated) */
@@ -274,21 +310,80 @@ struct sicslowpan_frag_buf {
 };
 
 static struct sicslowpan_frag_buf frag_buf[SICSLOWPAN_FRAGMENT_BUFFERS];
+/* The chain of unallocated fragment buffers */
+static uint8_t free_frags;
+
+static struct sicslowpan_reass_stats reass_stats;
+
+#if SICSLOWPAN_FRAG_FORWARDING
+/* A virtual reassembly buffer: where to relay the fragments of a packet */
+struct sicslowpan_vrb {
+  /** The link-layer source of the fragments */
+  linkaddr_t sender;
+  /** The link-layer next hop the fragments are relayed to */
+  linkaddr_t nexthop;
+  /** Fragment tag, as received */
+  uint16_t tag;
+  /** Fragment tag, as relayed */
+  uint16_t out_tag;
+  /** Total length of the fragmented packet (if zero the entry is unused) */
+  uint16_t len;
+  /** The upper-layer protocol of the packet, as NETWORK_ID of the
+      relayed fragments */
+  uint8_t network_id;
+  /** Number of distinct 8-byte units of the packet relayed so far */
+  uint16_t forwarded_units;
+  /** One bit per 8-byte unit of the packet relayed so far */
+  uint8_t forwarded[(REASS_UNITS + 7) / 8];
+  /** The entry expires like a reassembly */
+  struct timer timer;
+};
+
+static struct sicslowpan_vrb vrb[SICSLOWPAN_VRB_ENTRIES];
+/* The relayed fragment is prepared here while the received one is still
+   in packetbuf */
+static uint8_t vrb_frame[PACKETBUF_SIZE];
+/* The attributes of a received first fragment, restored if it cannot be
+   relayed after all */
+static struct packetbuf_attr vrb_attrs[PACKETBUF_NUM_ATTRS];
+static struct packetbuf_addr vrb_addrs[PACKETBUF_NUM_ADDRS];
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 
+/*---------------------------------------------------------------------------*/
+static void
+init_fragments(void)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
+    frag_buf[i].len = 0;
+    frag_buf[i].next = i + 1 < SICSLOWPAN_FRAGMENT_BUFFERS ? i + 1 : FRAG_NONE;
+  }
+  free_frags = SICSLOWPAN_FRAGMENT_BUFFERS > 0 ? 0 : FRAG_NONE;
+  for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
+    frag_info[i].len = 0;
+    frag_info[i].frags = FRAG_NONE;
+  }
+}
 /*---------------------------------------------------------------------------*/
 static int
 clear_fragments(uint8_t frag_info_index)
 {
-  int i, clear_count;
+  int clear_count;
+  uint8_t i;
+  uint8_t next;
+
   clear_count = 0;
   frag_info[frag_info_index].len = 0;
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len > 0 && frag_buf[i].index == frag_info_index) {
-      /* deallocate the buffer */
-      frag_buf[i].len = 0;
-      clear_count++;
-    }
+  /* Return the chain of this context to the free list */
+  for(i = frag_info[frag_info_index].frags; i != FRAG_NONE; i = next) {
+    next = frag_buf[i].next;
+    frag_buf[i].len = 0;
+    frag_buf[i].next = free_frags;
+    free_frags = i;
+    clear_count++;
   }
+  frag_info[frag_info_index].frags = FRAG_NONE;
   return clear_count;
 }
 /*---------------------------------------------------------------------------*/
@@ -301,16 +396,60 @@ timeout_fragments(int not_context)
     if(frag_info[i].len > 0 && i != not_context &&
        timer_expired(&frag_info[i].reass_timer)) {
       /* This context can be freed */
+      reass_stats.timed_out++;
       count += clear_fragments(i);
     }
   }
   return count;
 }
 /*---------------------------------------------------------------------------*/
+/* Marks the units covered by len bytes at offset as received in the
+   bitmap of a packet of packet_len bytes, and returns how many of them
+   had not been received before */
+static int
+mark_units(uint8_t *received, uint16_t packet_len, uint16_t offset,
+           uint16_t len)
+{
+  uint16_t unit;
+  uint16_t end;
+  int new_units;
+
+  end = offset + (len + 7) / 8;
+  if(end > (packet_len + 7) / 8) {
+    /* Extraneous bytes at the end of the packet */
+    end = (packet_len + 7) / 8;
+  }
+  new_units = 0;
+  for(unit = offset; unit < end; unit++) {
+    if(!(received[unit / 8] & (1 << (unit % 8)))) {
+      received[unit / 8] |= 1 << (unit % 8);
+      new_units++;
+    }
+  }
+  return new_units;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mark_received(struct sicslowpan_frag_info *info, uint16_t offset,
+              uint16_t len)
+{
+  int new_units;
+
+  new_units = mark_units(info->received, info->len, offset, len);
+  info->received_units += new_units;
+  return new_units;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+is_reassembled(int context)
+{
+  return frag_info[context].received_units >= (frag_info[context].len + 7) / 8;
+}
+/*---------------------------------------------------------------------------*/
 static int
 store_fragment(uint8_t index, uint8_t offset)
 {
-  int i;
+  uint8_t i;
   int len;
 
   len = packetbuf_datalen() - packetbuf_hdr_len;
@@ -320,20 +459,22 @@ store_fragment(uint8_t index, uint8_t offset)
     return -1;
   }
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    if(frag_buf[i].len == 0) {
-      /* copy over the data from packetbuf into the fragment buffer,
-         and store offset and len */
-      frag_buf[i].offset = offset; /* frag offset */
-      frag_buf[i].len = len;
-      frag_buf[i].index = index;
-      memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
-      /* return the length of the stored fragment */
-      return len;
-    }
+  i = free_frags;
+  if(i == FRAG_NONE) {
+    /* failed */
+    return -1;
   }
-  /* failed */
-  return -1;
+
+  /* copy over the data from packetbuf into the fragment buffer,
+     and store offset and len */
+  free_frags = frag_buf[i].next;
+  frag_buf[i].offset = offset; /* frag offset */
+  frag_buf[i].len = len;
+  memcpy(frag_buf[i].data, packetbuf_ptr + packetbuf_hdr_len, len);
+  frag_buf[i].next = frag_info[index].frags;
+  frag_info[index].frags = i;
+  /* return the length of the stored fragment */
+  return len;
 }
 /*---------------------------------------------------------------------------*/
 /* add a new fragment to the buffer */
@@ -349,6 +490,7 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
     for(i = 0; i < SICSLOWPAN_REASS_CONTEXTS; i++) {
       /* clear all fragment info with expired timer to free all fragment buffers */
       if(frag_info[i].len > 0 && timer_expired(&frag_info[i].reass_timer)) {
+        reass_stats.timed_out++;
         clear_fragments(i);
       }
 
@@ -362,12 +504,23 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 
     if(found < 0) {
       LOG_WARN("reassembly: failed to store new fragment session - tag: %d\n", tag);
+      reass_stats.no_context++;
+      return -1;
+    }
+
+    if(frag_size > UIP_BUFSIZE) {
+      LOG_WARN("reassembly: fragmented packet too large - tag: %d len: %d\n",
+               tag, frag_size);
+      reass_stats.invalid++;
       return -1;
     }
 
     /* Found a free fragment info to store data in */
     frag_info[found].len = frag_size;
     frag_info[found].tag = tag;
+    frag_info[found].frags = FRAG_NONE;
+    frag_info[found].received_units = 0;
+    memset(frag_info[found].received, 0, sizeof(frag_info[found].received));
     linkaddr_copy(&frag_info[found].sender,
                   packetbuf_addr(PACKETBUF_ADDR_SENDER));
     timer_set(&frag_info[found].reass_timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
@@ -389,21 +542,39 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
   if(found < 0) {
     /* no entry found for storing the new fragment */
     LOG_WARN("reassembly: failed to store N-fragment - could not find session - tag: %d offset: %d\n", tag, offset);
+    reass_stats.no_session++;
     return -1;
   }
 
   /* i is the index of the reassembly context */
+  len = packetbuf_datalen() - packetbuf_hdr_len;
+  if(((uint16_t)offset << 3) >= frag_info[i].len) {
+    /* The fragment starts past the end of the datagram it claims to be
+       part of. Extraneous bytes at the end of the last fragment are
+       fine, they are just not marked as received. */
+    LOG_WARN("reassembly: fragment beyond datagram size - tag: %d offset: %d\n",
+             tag, offset);
+    reass_stats.invalid++;
+    clear_fragments(i);
+    return -1;
+  }
+  if(len > 0 && mark_received(&frag_info[i], offset, len) == 0) {
+    /* A retransmission of a fragment we already have */
+    reass_stats.duplicates++;
+    return i;
+  }
   len = store_fragment(i, offset);
   if(len < 0 && timeout_fragments(i) > 0) {
     len = store_fragment(i, offset);
   }
   if(len > 0) {
-    frag_info[i].reassembled_len += len;
     return i;
   } else {
-    /* should we also clear all fragments since we failed to store
-       this fragment? */
+    /* The packet cannot be reassembled without this fragment, so
+       release the buffers it already holds */
     LOG_WARN("reassembly: failed to store fragment - packet reassembly will fail tag:%d l\n", frag_info[i].tag);
+    reass_stats.no_buffer++;
+    clear_fragments(i);
     return -1;
   }
 }
@@ -413,12 +584,13 @@ add_fragment(uint16_t tag, uint16_t frag_size, uint8_t offset)
 static bool
 copy_frags2uip(int context)
 {
-  int i;
+  uint8_t i;
 
   /* Check length fields before proceeding. */
   if(frag_info[context].len < frag_info[context].first_frag_len ||
      frag_info[context].len > sizeof(uip_buf)) {
     LOG_WARN("input: invalid total size of fragments\n");
+    reass_stats.invalid++;
     clear_fragments(context);
     return false;
   }
@@ -431,20 +603,20 @@ copy_frags2uip(int context)
   memset((uint8_t *)UIP_IP_BUF + frag_info[context].first_frag_len, 0,
          frag_info[context].len - frag_info[context].first_frag_len);
 
-  for(i = 0; i < SICSLOWPAN_FRAGMENT_BUFFERS; i++) {
-    /* And also copy all matching fragments */
-    if(frag_buf[i].len > 0 && frag_buf[i].index == context) {
-      if((frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
-        LOG_WARN("input: invalid fragment offset\n");
-        clear_fragments(context);
-        return false;
-      }
-      memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
-             (uint8_t *)frag_buf[i].data, frag_buf[i].len);
+  /* And also copy all fragments of the chain of this context */
+  for(i = frag_info[context].frags; i != FRAG_NONE; i = frag_buf[i].next) {
+    if((frag_buf[i].offset << 3) + frag_buf[i].len > sizeof(uip_buf)) {
+      LOG_WARN("input: invalid fragment offset\n");
+      reass_stats.invalid++;
+      clear_fragments(context);
+      return false;
     }
+    memcpy((uint8_t *)UIP_IP_BUF + (uint16_t)(frag_buf[i].offset << 3),
+           (uint8_t *)frag_buf[i].data, frag_buf[i].len);
   }
   /* deallocate all the fragments for this context */
   clear_fragments(context);
+  reass_stats.reassembled++;
 
   return true;
 }
@@ -469,26 +641,52 @@ netstack_sniffer_remove(struct netstack_sniffer *s)
   callback = NULL;
 }
 
+/* Returns the upper-layer header of the packet in uip_buf, after any
+   extension headers, or NULL if it is not in the buffer. Its protocol
+   is stored in proto in either case. */
+static uint8_t *
+upper_layer_hdr(uint8_t *proto)
+{
+  return uipbuf_get_last_header(uip_buf, uip_len, proto);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the upper-layer protocol of the packet in uip_buf */
+static uint8_t
+upper_layer_proto(void)
+{
+  uint8_t proto;
+
+  upper_layer_hdr(&proto);
+  return proto;
+}
+/*---------------------------------------------------------------------------*/
 static void
 set_packet_attrs(void)
 {
   int c = 0;
+  uint8_t proto;
+  uint8_t *hdr;
+
   /* set protocol in NETWORK_ID */
-  packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, UIP_IP_BUF->proto);
+  hdr = upper_layer_hdr(&proto);
+  packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, proto);
 
   /* assign values to the channel attribute (port or type + code) */
-  if(UIP_IP_BUF->proto == UIP_PROTO_UDP) {
-    c = UIP_UDP_BUF_POS(0)->srcport;
-    if(UIP_UDP_BUF_POS(0)->destport < c) {
-      c = UIP_UDP_BUF_POS(0)->destport;
+  if(hdr == NULL) {
+    /* No upper-layer header to take the channel from */
+  } else if(proto == UIP_PROTO_UDP) {
+    c = ((struct uip_udp_hdr *)hdr)->srcport;
+    if(((struct uip_udp_hdr *)hdr)->destport < c) {
+      c = ((struct uip_udp_hdr *)hdr)->destport;
     }
-  } else if(UIP_IP_BUF->proto == UIP_PROTO_TCP) {
-    c = UIP_TCP_BUF->srcport;
-    if(UIP_TCP_BUF->destport < c) {
-      c = UIP_TCP_BUF->destport;
+  } else if(proto == UIP_PROTO_TCP) {
+    c = ((struct uip_tcp_hdr *)hdr)->srcport;
+    if(((struct uip_tcp_hdr *)hdr)->destport < c) {
+      c = ((struct uip_tcp_hdr *)hdr)->destport;
     }
-  } else if(UIP_IP_BUF->proto == UIP_PROTO_ICMP6) {
-    c = UIP_ICMP_BUF->type << 8 | UIP_ICMP_BUF->icode;
+  } else if(proto == UIP_PROTO_ICMP6) {
+    c = ((struct uip_icmp_hdr *)hdr)->type << 8 |
+      ((struct uip_icmp_hdr *)hdr)->icode;
   }
 
   packetbuf_set_attr(PACKETBUF_ATTR_CHANNEL, c);
@@ -1541,6 +1739,14 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
   queuebuf_to_packetbuf(q);
   queuebuf_free(q);
 
+  /* The next fragment is written over this one, which the MAC may still
+     have queued. The packetbuf storage may move, so get the pointer again. */
+  if(!packetbuf_make_writable()) {
+    LOG_ERR("output: could not get a writable packetbuf, dropping subsequent fragments.\n");
+    return 0;
+  }
+  packetbuf_ptr = packetbuf_dataptr();
+
   /* Check tx result. */
   if((last_tx_status == MAC_TX_COLLISION) ||
      (last_tx_status == MAC_TX_ERR) ||
@@ -1552,6 +1758,34 @@ fragment_copy_payload_and_send(uint16_t uip_offset, linkaddr_t *dest) {
 }
 #endif /* SICSLOWPAN_CONF_FRAG */
 /*--------------------------------------------------------------------*/
+/**
+ * \brief Compress the headers of the IP packet in uip_buf into packetbuf,
+ * with the configured compression
+ * \param dest the link layer destination address of the packet
+ * \return 1 if success, 0 otherwise
+ */
+static int
+compress_hdr(linkaddr_t *dest)
+{
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
+  compress_hdr_ipv6(dest);
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
+#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
+  /* Add 6LoRH headers before IPHC. Only needed on routed traffic
+  (non link-local). */
+  if(!uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)) {
+    add_paging_dispatch(1);
+    add_6lorh_hdr();
+  }
+#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
+#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
+  if(compress_hdr_iphc(dest) == 0) {
+    return 0;
+  }
+#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
+  return 1;
+}
+/*--------------------------------------------------------------------*/
 /** \brief Take an IP packet and format it to be sent on an 802.15.4
  *  network using 6lowpan.
  *  \param localdest The MAC address of the destination
@@ -1577,6 +1811,10 @@ output(const linkaddr_t *localdest)
   packetbuf_clear();
   packetbuf_ptr = packetbuf_dataptr();
 
+  /* The upper-layer protocol lets the MAC layer tell control traffic,
+     such as RPL messages behind a hop-by-hop header, from data */
+  packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, upper_layer_proto());
+
   if(callback) {
     /* call the attribution when the callback comes, but set attributes
        here ! */
@@ -1621,23 +1859,10 @@ output(const linkaddr_t *localdest)
   }
 
   /* Try to compress the headers */
-#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6
-  compress_hdr_ipv6(&dest);
-#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPV6 */
-#if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH
-  /* Add 6LoRH headers before IPHC. Only needed on routed traffic
-  (non link-local). */
-  if(!uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr)) {
-    add_paging_dispatch(1);
-    add_6lorh_hdr();
-  }
-#endif /* SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_6LORH */
-#if SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC
-  if(compress_hdr_iphc(&dest) == 0) {
+  if(compress_hdr(&dest) == 0) {
     /* Warning should already be issued by function above */
     return 0;
   }
-#endif /* SICSLOWPAN_COMPRESSION >= SICSLOWPAN_COMPRESSION_IPHC */
 
   /* Use the mac_max_payload to understand what is the max payload in a MAC
    * packet. We calculate it here only to make a better decision of whether
@@ -1786,6 +2011,328 @@ output(const linkaddr_t *localdest)
   return 1;
 }
 
+#if SICSLOWPAN_FRAG_FORWARDING
+/*--------------------------------------------------------------------*/
+/* Returns the virtual reassembly buffer of the packet with the given
+   tag from the given sender, or NULL */
+static struct sicslowpan_vrb *
+vrb_lookup(const linkaddr_t *sender, uint16_t tag)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb[i].len > 0 && timer_expired(&vrb[i].timer)) {
+      /* Some fragments were lost: release the entry */
+      vrb[i].len = 0;
+    }
+    if(vrb[i].len > 0 && vrb[i].tag == tag &&
+       linkaddr_cmp(&vrb[i].sender, sender)) {
+      return &vrb[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+static struct sicslowpan_vrb *
+vrb_alloc(void)
+{
+  int i;
+
+  for(i = 0; i < SICSLOWPAN_VRB_ENTRIES; i++) {
+    if(vrb[i].len == 0 || timer_expired(&vrb[i].timer)) {
+      return &vrb[i];
+    }
+  }
+  return NULL;
+}
+/*--------------------------------------------------------------------*/
+/* Returns the link-layer next hop of the packet whose headers are in
+   uip_buf, or NULL if the packet is to be reassembled and left to the
+   IP layer: when it is for this node, when this node is the root (which
+   may add a routing header), or when the next hop is not resolved */
+static const linkaddr_t *
+vrb_nexthop(void)
+{
+  const uip_ipaddr_t *nexthop;
+  uip_ds6_route_t *route;
+  uip_ds6_nbr_t *nbr;
+
+  if(uip_is_addr_mcast(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->destipaddr) ||
+     uip_is_addr_linklocal(&UIP_IP_BUF->srcipaddr) ||
+     uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr) ||
+     uip_ds6_is_my_aaddr(&UIP_IP_BUF->destipaddr) ||
+     UIP_IP_BUF->ttl <= 1 ||
+     NETSTACK_ROUTING.node_is_root()) {
+    return NULL;
+  }
+
+  if(uip_ds6_is_addr_onlink(&UIP_IP_BUF->destipaddr)) {
+    nexthop = &UIP_IP_BUF->destipaddr;
+  } else if((route = uip_ds6_route_lookup(&UIP_IP_BUF->destipaddr)) != NULL) {
+    nexthop = uip_ds6_route_nexthop(route);
+  } else {
+    nexthop = uip_ds6_defrt_choose();
+  }
+  if(nexthop == NULL) {
+    return NULL;
+  }
+
+  nbr = uip_ds6_nbr_lookup(nexthop);
+  if(nbr == NULL || nbr->state == NBR_INCOMPLETE) {
+    return NULL;
+  }
+  return (const linkaddr_t *)uip_ds6_nbr_get_ll(nbr);
+}
+/*--------------------------------------------------------------------*/
+/* Updates the headers in uip_buf as the IP layer does when it forwards
+   the packet. Returns 0 if the packet cannot be relayed as is */
+static int
+vrb_update_headers(void)
+{
+  uint16_t len;
+
+  if(UIP_IP_BUF->proto == UIP_PROTO_HBHO) {
+    /* Only the RPL option is supported, at the start of the header */
+    if(uip_len < UIP_IPH_LEN + 8 ||
+       ((struct uip_ext_hdr_opt *)UIP_IP_PAYLOAD(2))->type != UIP_EXT_HDR_OPT_RPL ||
+       !NETSTACK_ROUTING.ext_header_hbh_update(UIP_IP_PAYLOAD(0), 2)) {
+      return 0;
+    }
+  }
+
+  UIP_IP_BUF->ttl--;
+
+  /* Headers that grow or shrink would move the subsequent fragments */
+  len = uip_len;
+  if(!NETSTACK_ROUTING.ext_header_update() || uip_len != len) {
+    return 0;
+  }
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/* Clears the attributes for a relayed fragment, keeping the link-layer
+   security of the received one */
+static void
+vrb_clear_attrs(void)
+{
+#if LLSEC802154_USES_AUX_HEADER
+  uint16_t security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  packetbuf_attr_clear();
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, security_level);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+}
+/*--------------------------------------------------------------------*/
+/* Clears packetbuf for a fragment relayed through the given entry,
+   keeping the link-layer security of the received one */
+static void
+vrb_clear_packetbuf(const struct sicslowpan_vrb *entry)
+{
+#if LLSEC802154_USES_AUX_HEADER
+  uint16_t security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  packetbuf_clear();
+  packetbuf_ptr = packetbuf_dataptr();
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, security_level);
+#endif /* LLSEC802154_USES_AUX_HEADER */
+  /* Every fragment keeps the class of the packet in the MAC queues */
+  packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, entry->network_id);
+}
+/*--------------------------------------------------------------------*/
+/* Relays the first fragment, looking at its headers in uip_buf */
+static int
+relay_first_fragment(uint8_t context)
+{
+  struct sicslowpan_frag_info *info = &frag_info[context];
+  struct sicslowpan_vrb *entry;
+  const linkaddr_t *nexthop;
+  linkaddr_t dest;
+  int payload_len;
+  int sent_len;
+
+  /* Look at the packet as the IP layer would */
+  memcpy(UIP_IP_BUF, info->first_frag, info->first_frag_len);
+  uip_len = info->first_frag_len;
+
+  nexthop = vrb_nexthop();
+  if(nexthop == NULL) {
+    return 0;
+  }
+  linkaddr_copy(&dest, nexthop);
+
+  /* A retransmitted first fragment is relayed under the same tag */
+  entry = vrb_lookup(&info->sender, info->tag);
+  if(entry == NULL) {
+    entry = vrb_alloc();
+    if(entry == NULL) {
+      LOG_WARN("forward: no free VRB entry - tag: %d\n", info->tag);
+      return 0;
+    }
+    entry->len = 0;
+  }
+
+  if(!vrb_update_headers()) {
+    return 0;
+  }
+
+  /* Compress the headers for the next hop into vrb_frame, with the
+     attributes of the relayed fragment. The received fragment stays in
+     packetbuf until it is known to fit. */
+  packetbuf_attr_copyto(vrb_attrs, vrb_addrs);
+  vrb_clear_attrs();
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &dest);
+  mac_max_payload = NETSTACK_MAC.max_payload();
+  uncomp_hdr_len = 0;
+  packetbuf_hdr_len = 0;
+  payload_len = -1;
+  if(mac_max_payload > 0 && mac_max_payload <= sizeof(vrb_frame)) {
+    packetbuf_ptr = vrb_frame;
+    if(compress_hdr(&dest) != 0) {
+      payload_len = info->first_frag_len - uncomp_hdr_len;
+    }
+    packetbuf_ptr = packetbuf_dataptr();
+  }
+  if(payload_len >= 0 &&
+     packetbuf_hdr_len + SICSLOWPAN_FRAG1_HDR_LEN + payload_len > mac_max_payload) {
+    /* The headers grew, e.g. with a hop limit that no longer compresses:
+       the end of the fragment is sent in a subsequent fragment, which
+       must start on an 8-byte boundary */
+    payload_len = ((mac_max_payload - packetbuf_hdr_len - SICSLOWPAN_FRAG1_HDR_LEN
+                    + uncomp_hdr_len) & ~7) - uncomp_hdr_len;
+    if(payload_len < 0) {
+      LOG_WARN("forward: first fragment does not fit after compression - tag: %d\n",
+               info->tag);
+    }
+  }
+  if(payload_len < 0) {
+    packetbuf_attr_copyfrom(vrb_attrs, vrb_addrs);
+    return 0;
+  }
+
+  if(entry->len == 0) {
+    linkaddr_copy(&entry->sender, &info->sender);
+    linkaddr_copy(&entry->nexthop, &dest);
+    entry->tag = info->tag;
+    entry->out_tag = my_tag++;
+    entry->len = info->len;
+    entry->network_id = upper_layer_proto();
+    memset(entry->forwarded, 0, sizeof(entry->forwarded));
+    entry->forwarded_units = mark_units(entry->forwarded, entry->len, 0,
+                                        info->first_frag_len);
+  }
+  timer_set(&entry->timer, SICSLOWPAN_REASS_MAXAGE * CLOCK_SECOND / 16);
+
+  /* Set FRAG1 header and the compressed headers, and copy the payload
+     of the received fragment */
+  vrb_clear_packetbuf(entry);
+  memcpy(packetbuf_ptr + SICSLOWPAN_FRAG1_HDR_LEN, vrb_frame, packetbuf_hdr_len);
+  packetbuf_hdr_len += SICSLOWPAN_FRAG1_HDR_LEN;
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+        ((SICSLOWPAN_DISPATCH_FRAG1 << 8) | entry->len));
+  SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, entry->out_tag);
+  memcpy(packetbuf_ptr + packetbuf_hdr_len,
+         (uint8_t *)UIP_IP_BUF + uncomp_hdr_len, payload_len);
+  packetbuf_set_datalen(packetbuf_hdr_len + payload_len);
+
+  LOG_INFO("forward: first fragment (tag %d -> %d, len %d)\n",
+           entry->tag, entry->out_tag, entry->len);
+  send_packet(&entry->nexthop);
+  reass_stats.forwarded++;
+
+  sent_len = uncomp_hdr_len + payload_len;
+  if(sent_len < info->first_frag_len) {
+    vrb_clear_packetbuf(entry);
+    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE,
+          ((SICSLOWPAN_DISPATCH_FRAGN << 8) | entry->len));
+    SET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_TAG, entry->out_tag);
+    PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET] = sent_len >> 3;
+    memcpy(packetbuf_ptr + SICSLOWPAN_FRAGN_HDR_LEN,
+           (uint8_t *)UIP_IP_BUF + sent_len, info->first_frag_len - sent_len);
+    packetbuf_set_datalen(SICSLOWPAN_FRAGN_HDR_LEN + info->first_frag_len - sent_len);
+    send_packet(&entry->nexthop);
+    reass_stats.forwarded++;
+  }
+  return 1;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Relay the first fragment of a packet routed by this node
+ * \param context the reassembly context holding the first fragment
+ * \return 1 if the fragment was relayed, 0 if the packet is to be
+ * reassembled
+ *
+ * The headers of the packet are decompressed in the reassembly context.
+ * They are updated for the next hop and compressed again, and a
+ * virtual reassembly buffer is set up to relay the subsequent fragments.
+ */
+static int
+forward_first_fragment(uint8_t context)
+{
+  uint16_t len;
+  int relayed;
+
+  /* uip_buf is only borrowed to look at the headers */
+  len = uip_len;
+  relayed = relay_first_fragment(context);
+  uip_len = len;
+  return relayed;
+}
+/*--------------------------------------------------------------------*/
+/**
+ * \brief Relay a subsequent fragment through its virtual reassembly buffer
+ * \param tag the tag of the fragment
+ * \return 1 if the fragment was relayed, 0 if it is to be reassembled
+ */
+static int
+forward_fragment(uint16_t tag)
+{
+  struct sicslowpan_vrb *entry;
+  uint16_t len;
+  uint8_t offset;
+
+  entry = vrb_lookup(packetbuf_addr(PACKETBUF_ADDR_SENDER), tag);
+  if(entry == NULL) {
+    return 0;
+  }
+
+  len = packetbuf_datalen();
+  offset = PACKETBUF_FRAG_PTR[PACKETBUF_FRAG_OFFSET];
+  if(len <= SICSLOWPAN_FRAGN_HDR_LEN ||
+     ((uint16_t)offset << 3) + len - SICSLOWPAN_FRAGN_HDR_LEN > entry->len) {
+    LOG_WARN("forward: fragment beyond datagram size - tag: %d offset: %d\n",
+             tag, offset);
+    reass_stats.invalid++;
+    return 1;
+  }
+
+  /* The fragment is relayed as is, with the tag of the next hop.
+     Retransmitted fragments are relayed again, as the next hop may have
+     missed them too. */
+  memcpy(vrb_frame, packetbuf_ptr, len);
+  SET16(vrb_frame, PACKETBUF_FRAG_TAG, entry->out_tag);
+  vrb_clear_packetbuf(entry);
+  memcpy(packetbuf_ptr, vrb_frame, len);
+  packetbuf_set_datalen(len);
+
+  LOG_INFO("forward: fragment (tag %d -> %d, offset %d)\n",
+           entry->tag, entry->out_tag, offset << 3);
+  send_packet(&entry->nexthop);
+  reass_stats.forwarded++;
+
+  entry->forwarded_units += mark_units(entry->forwarded, entry->len, offset,
+                                       len - SICSLOWPAN_FRAGN_HDR_LEN);
+  if(entry->forwarded_units >= (entry->len + 7) / 8) {
+    /* Every part of the packet has been relayed */
+    entry->len = 0;
+  }
+  return 1;
+}
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
 /*--------------------------------------------------------------------*/
 /** \brief Process a received 6lowpan packet.
  *
@@ -1879,6 +2426,12 @@ input(void)
       frag_size = GET16(PACKETBUF_FRAG_PTR, PACKETBUF_FRAG_DISPATCH_SIZE) & 0x07ff;
       packetbuf_hdr_len += SICSLOWPAN_FRAGN_HDR_LEN;
 
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(forward_fragment(frag_tag)) {
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+
       /* Add the fragment to the fragmentation context (this will also
          copy the payload) */
       frag_context = add_fragment(frag_tag, frag_size, frag_offset);
@@ -1892,7 +2445,7 @@ input(void)
          we should not store more */
       buffer = NULL;
 
-      if(frag_info[frag_context].reassembled_len >= frag_size) {
+      if(is_reassembled(frag_context)) {
         last_fragment = 1;
       }
       is_fragment = 1;
@@ -1993,13 +2546,23 @@ input(void)
   if(frag_size > 0) {
     /* Add the size of the header only for the first fragment. */
     if(first_fragment != 0) {
-      frag_info[frag_context].reassembled_len = uncomp_hdr_len + packetbuf_payload_len;
       frag_info[frag_context].first_frag_len = uncomp_hdr_len + packetbuf_payload_len;
+      mark_received(&frag_info[frag_context], 0,
+                    frag_info[frag_context].first_frag_len);
+#if SICSLOWPAN_FRAG_FORWARDING
+      if(forward_first_fragment(frag_context)) {
+        /* The subsequent fragments will follow without reassembly */
+        clear_fragments(frag_context);
+        return;
+      }
+#endif /* SICSLOWPAN_FRAG_FORWARDING */
+      if(is_reassembled(frag_context)) {
+        last_fragment = 1;
+      }
     }
     /* For the last fragment, we are OK if there is extrenous bytes at
        the end of the packet. */
     if(last_fragment != 0) {
-      frag_info[frag_context].reassembled_len = frag_size;
       /* copy to uip */
       if(!copy_frags2uip(frag_context)) {
         return;
@@ -2060,12 +2623,25 @@ input(void)
 }
 /** @} */
 
+/*--------------------------------------------------------------------*/
+void
+sicslowpan_get_reass_stats(struct sicslowpan_reass_stats *stats)
+{
+#if SICSLOWPAN_CONF_FRAG
+  *stats = reass_stats;
+#else /* SICSLOWPAN_CONF_FRAG */
+  memset(stats, 0, sizeof(*stats));
+#endif /* SICSLOWPAN_CONF_FRAG */
+}
 /*--------------------------------------------------------------------*/
 /* \brief 6lowpan init function (called by the MAC layer)             */
 /*--------------------------------------------------------------------*/
 void
 sicslowpan_init(void)
 {
+#if SICSLOWPAN_CONF_FRAG
+  init_fragments();
+#endif /* SICSLOWPAN_CONF_FRAG */
 
 #if SICSLOWPAN_COMPRESSION == SICSLOWPAN_COMPRESSION_IPHC
 /* Preinitialize any address contexts for better header compression
@@ -338,6 +338,35 @@ struct sicslowpan_nh_compressor {
 
 int sicslowpan_get_last_rssi(void);
 
+/**
+ * Fragment reassembly statistics.
+ */
+struct sicslowpan_reass_stats {
+  /** Packets reassembled and passed up */
+  unsigned long reassembled;
+  /** First fragments dropped because all reassembly contexts were busy */
+  unsigned long no_context;
+  /** Subsequent fragments dropped because their first fragment had not
+      been received, or its reassembly had been aborted */
+  unsigned long no_session;
+  /** Reassemblies aborted because no fragment buffer was free */
+  unsigned long no_buffer;
+  /** Reassemblies aborted because they did not complete in time */
+  unsigned long timed_out;
+  /** Reassemblies aborted because of inconsistent sizes or offsets */
+  unsigned long invalid;
+  /** Retransmitted fragments that were already held, and ignored */
+  unsigned long duplicates;
+  /** Fragments relayed to the next hop without reassembly */
+  unsigned long forwarded;
+};
+
+/**
+ * \brief Get the fragment reassembly statistics
+ * \param stats A pointer to the structure where to write the statistics
+ */
+void sicslowpan_get_reass_stats(struct sicslowpan_reass_stats *stats);
+
 extern const struct network_driver sicslowpan_driver;
 
 #endif /* SICSLOWPAN_H_ */
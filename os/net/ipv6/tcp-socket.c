@@ -56,6 +56,70 @@ call_event(struct tcp_socket *s, tcp_socket_event_t event)
   }
 }
 /*---------------------------------------------------------------------------*/
+static uint16_t
+queuelen(struct tcp_socket *s)
+{
+  return s->output_data_len + s->output_ref_len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_queued(struct tcp_socket *s, uint16_t offset, uint16_t len)
+{
+  uint8_t *appdata;
+  uint16_t buffered;
+
+  /* The send queue is the output buffer followed by the data passed to
+     tcp_socket_send_ref(). A segment that spans both is gathered
+     directly into the packet buffer, where uIP expects it. */
+  if(offset >= s->output_data_len) {
+    uip_send(&s->output_ref_ptr[offset - s->output_data_len], len);
+  } else if(offset + len <= s->output_data_len) {
+    uip_send(&s->output_data_ptr[offset], len);
+  } else {
+    appdata = &uip_buf[UIP_IPTCPH_LEN];
+    len = MIN(len, UIP_BUFSIZE - UIP_IPTCPH_LEN);
+    buffered = s->output_data_len - offset;
+    memcpy(appdata, &s->output_data_ptr[offset], buffered);
+    memcpy(appdata + buffered, s->output_ref_ptr, len - buffered);
+    uip_send(appdata, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+release_ref(struct tcp_socket *s)
+{
+  /* The connection is gone, so the application's data will not be
+     sent and must not be referenced any longer. */
+  s->output_ref_ptr = NULL;
+  s->output_ref_len = 0;
+  s->output_senddata_len = s->output_data_len;
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP_SEND_WINDOW > 1
+static void
+senddata(struct tcp_socket *s)
+{
+  int len = MIN(s->output_data_max_seg, uip_mss());
+  uint16_t room;
+
+  /* The output buffer doubles as the retransmission queue: it starts
+     with the oldest unacknowledged byte, and the data that is already
+     in flight is skipped. After a retransmission timeout, uIP reports
+     no data in flight and the data is sent again from the start. */
+  s->output_data_send_nxt = uip_outstanding(uip_conn);
+  room = uip_sendroom();
+  if(queuelen(s) > s->output_data_send_nxt && room > 0) {
+    len = MIN(queuelen(s) - s->output_data_send_nxt, len);
+    len = MIN(room, len);
+    send_queued(s, s->output_data_send_nxt, len);
+    if(room > len && queuelen(s) > s->output_data_send_nxt + len) {
+      /* There is more data and more room in the window: ask uIP to
+         call us again to send the next segment. */
+      tcpip_poll_tcp(uip_conn);
+    }
+  }
+}
+#else /* UIP_TCP_SEND_WINDOW > 1 */
 static void
 senddata(struct tcp_socket *s)
 {
@@ -64,34 +128,53 @@ senddata(struct tcp_socket *s)
   if(s->output_senddata_len > 0) {
     len = MIN(s->output_senddata_len, len);
     s->output_data_send_nxt = len;
-    uip_send(s->output_data_ptr, len);
+    send_queued(s, 0, len);
   }
 }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 /*---------------------------------------------------------------------------*/
 static void
 acked(struct tcp_socket *s)
 {
+#if UIP_TCP_SEND_WINDOW > 1
+  /* ACKs are cumulative: release only the acknowledged bytes from the
+     head of the buffer and keep the rest for retransmission. */
+  s->output_data_send_nxt = uip_ackedlen();
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
   if(s->output_senddata_len > 0) {
-    /* Copy the data in the outputbuf down and update outputbufptr and
-       outputbuf_lastsent */
-
-    if(s->output_data_send_nxt > 0) {
-      memmove(&s->output_data_ptr[0],
-              &s->output_data_ptr[s->output_data_send_nxt],
-              s->output_data_maxlen - s->output_data_send_nxt);
-    }
-    if(s->output_data_len < s->output_data_send_nxt) {
-      PRINTF("tcp: acked assertion failed s->output_data_len (%d) < s->output_data_send_nxt (%d)\n",
-             s->output_data_len,
+    if(queuelen(s) < s->output_data_send_nxt) {
+      PRINTF("tcp: acked assertion failed queuelen (%d) < s->output_data_send_nxt (%d)\n",
+             queuelen(s),
              s->output_data_send_nxt);
       tcp_markconn(uip_conn, NULL);
       uip_abort();
+      release_ref(s);
       call_event(s, TCP_SOCKET_ABORTED);
       relisten(s);
       return;
     }
-    s->output_data_len -= s->output_data_send_nxt;
-    s->output_senddata_len = s->output_data_len;
+
+    if(s->output_data_send_nxt > s->output_data_len) {
+      /* The output buffer has been sent in full, and so has the head of
+         the referenced data: step past it */
+      s->output_ref_ptr += s->output_data_send_nxt - s->output_data_len;
+      s->output_ref_len -= s->output_data_send_nxt - s->output_data_len;
+      s->output_data_len = 0;
+    } else {
+      /* Copy the data in the outputbuf down and update outputbufptr and
+         outputbuf_lastsent */
+
+      if(s->output_data_send_nxt > 0) {
+        memmove(&s->output_data_ptr[0],
+                &s->output_data_ptr[s->output_data_send_nxt],
+                s->output_data_maxlen - s->output_data_send_nxt);
+      }
+      s->output_data_len -= s->output_data_send_nxt;
+    }
+    if(s->output_ref_len == 0) {
+      s->output_ref_ptr = NULL;
+    }
+    s->output_senddata_len = queuelen(s);
     s->output_data_send_nxt = 0;
 
     call_event(s, TCP_SOCKET_DATA_SENT);
@@ -184,6 +267,10 @@ appcall(void *state)
     return;
   }
 
+  if(s != NULL && (uip_timedout() || uip_aborted() || uip_closed())) {
+    release_ref(s);
+  }
+
   if(uip_timedout()) {
     call_event(s, TCP_SOCKET_TIMEDOUT);
     relisten(s);
@@ -216,7 +303,7 @@ appcall(void *state)
     senddata(s);
   }
 
-  if(s->output_data_len == 0 && s->flags & TCP_SOCKET_FLAGS_CLOSING) {
+  if(queuelen(s) == 0 && s->flags & TCP_SOCKET_FLAGS_CLOSING) {
     s->flags &= ~TCP_SOCKET_FLAGS_CLOSING;
     uip_close();
     s->c = NULL;
@@ -277,6 +364,8 @@ tcp_socket_register(struct tcp_socket *s, void *ptr,
   s->output_data_len = 0;
   s->output_data_ptr = output_databuf;
   s->output_data_maxlen = output_databuf_len;
+  s->output_ref_ptr = NULL;
+  s->output_ref_len = 0;
   s->input_callback = input_callback;
   s->event_callback = event_callback;
   list_add(socketlist, s);
@@ -348,6 +437,12 @@ tcp_socket_send(struct tcp_socket *s,
     return -1;
   }
 
+  if(s->output_ref_len > 0) {
+    /* Appending to the buffer would put the data ahead of the
+       referenced data in the stream */
+    return 0;
+  }
+
   len = MIN(datalen, s->output_data_maxlen - s->output_data_len);
 
   memmove(&s->output_data_ptr[s->output_data_len], data, len);
@@ -363,6 +458,34 @@ tcp_socket_send(struct tcp_socket *s,
 }
 /*---------------------------------------------------------------------------*/
 int
+tcp_socket_send_ref(struct tcp_socket *s,
+                    const uint8_t *data, int datalen)
+{
+  int len;
+
+  if(s == NULL) {
+    return -1;
+  }
+
+  if(s->output_ref_len > 0) {
+    return 0;
+  }
+
+  len = MIN(datalen, 0xffff - s->output_data_len);
+
+  s->output_ref_ptr = data;
+  s->output_ref_len = len;
+
+  if(s->output_senddata_len == 0) {
+    s->output_senddata_len = queuelen(s);
+  }
+
+  tcpip_poll_tcp(s->c);
+
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+int
 tcp_socket_send_str(struct tcp_socket *s,
              const char *str)
 {
@@ -398,12 +521,15 @@ tcp_socket_unregister(struct tcp_socket *s)
 int
 tcp_socket_max_sendlen(struct tcp_socket *s)
 {
+  if(s->output_ref_len > 0) {
+    return 0;
+  }
   return s->output_data_maxlen - s->output_data_len;
 }
 /*---------------------------------------------------------------------------*/
 int
 tcp_socket_queuelen(struct tcp_socket *s)
 {
-  return s->output_data_len;
+  return queuelen(s);
 }
 /*---------------------------------------------------------------------------*/
@@ -100,6 +100,9 @@ struct tcp_socket {
   uint16_t output_senddata_len;
   uint16_t output_data_max_seg;
 
+  const uint8_t *output_ref_ptr;
+  uint16_t output_ref_len;
+
   uint8_t flags;
   uint16_t listen_port;
   struct uip_conn *c;
@@ -229,6 +232,33 @@ int tcp_socket_send(struct tcp_socket *s,
                     const uint8_t *dataptr,
                     int datalen);
 
+/**
+ * \brief      Send data on a connected TCP socket without copying it
+ * \param s    A pointer to a TCP socket that must have been previously registered with tcp_socket_register()
+ * \param dataptr A pointer to the data to be sent
+ * \param datalen The length of the data to be sent
+ * \retval -1  If an error occurs
+ * \return     The number of bytes that were queued for sending
+ *
+ *             This function queues data for sending after the data
+ *             that is already in the output buffer, but sends it
+ *             straight from the caller's memory instead of copying
+ *             it into the output buffer. The memory must stay
+ *             untouched until the data has been acknowledged by the
+ *             remote host, that is, until tcp_socket_queuelen()
+ *             returns zero in the TCP_SOCKET_DATA_SENT event, or
+ *             until the connection is closed.
+ *
+ *             Only one such block of data can be queued at a
+ *             time. Until it has been sent, tcp_socket_send_ref()
+ *             returns zero and so does tcp_socket_send(), since
+ *             anything added to the output buffer would be sent
+ *             ahead of it.
+ */
+int tcp_socket_send_ref(struct tcp_socket *s,
+                        const uint8_t *dataptr,
+                        int datalen);
+
 /**
  * \brief      Send a string on a connected TCP socket
  * \param s    A pointer to a TCP socket that must have been previously registered with tcp_socket_register()
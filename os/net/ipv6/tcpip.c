@@ -355,7 +355,7 @@ eventhandler(process_event_t ev, process_data_t data)
       for(cptr = &uip_udp_conns[0];
           cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
         if(cptr->appstate.p == p) {
-          cptr->lport = 0;
+          uip_udp_remove(cptr);
         }
       }
     }
@@ -559,13 +559,20 @@ get_nexthop(uip_ipaddr_t *addr)
 static int
 queue_packet(uip_ds6_nbr_t *nbr)
 {
-  /* Copy outgoing pkt in the queuing buffer for later transmit. */
+  /* Copy outgoing pkt at the end of the neighbor's queue for later
+     transmit. */
 #if UIP_CONF_IPV6_QUEUE_PKT
-  if(uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-    memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF, uip_len);
-    uip_packetqueue_set_buflen(&nbr->packethandle, uip_len);
+  struct uip_packetqueue_packet *p;
+
+  p = uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME);
+  if(p != NULL) {
+    memcpy(p->queue_buf, UIP_IP_BUF, uip_len);
+    p->queue_buf_len = uip_len;
     return 0;
   }
+  LOG_WARN("output: queue full, dropping packet to ");
+  LOG_WARN_6ADDR(&nbr->ipaddr);
+  LOG_WARN_("\n");
 #endif
 
   return 1;
@@ -581,11 +588,12 @@ send_queued(uip_ds6_nbr_t *nbr)
    * This happens in a few cases, for example when instead of receiving a
    * NA after sendiong a NS, you receive a NS with SLLAO: the entry moves
    * to STALE, and you must both send a NA and the queued packet.
+   * The packets are sent in the order they were queued.
    */
-  if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
+  while(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_pop(&nbr->packethandle);
     tcpip_output(uip_ds6_nbr_get_ll(nbr));
   }
 #endif /*UIP_CONF_IPV6_QUEUE_PKT*/
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *         Internet checksum kernels and incremental checksum updates
+ *
+ *         The word-wide kernels load the buffer in native byte order
+ *         and fold the carries once at the end. Because the one's
+ *         complement sum is independent of byte order (RFC 1071,
+ *         section 2), a little-endian CPU only has to swap the final
+ *         16-bit result.
+ */
+
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-chksum.h"
+
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+static inline uint16_t
+add_carry(uint16_t a, uint16_t b)
+{
+  uint32_t sum = (uint32_t)a + b;
+
+  return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
+/*---------------------------------------------------------------------------*/
+static inline uint16_t
+fold32(uint32_t acc)
+{
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+  return (uint16_t)acc;
+}
+/*---------------------------------------------------------------------------*/
+/* Add a sum of native-order words to a sum in host order. */
+static inline uint16_t
+add_native(uint16_t sum, uint16_t native)
+{
+#if UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN
+  native = (uint16_t)((native >> 8) | (native << 8));
+#endif /* UIP_BYTE_ORDER == UIP_LITTLE_ENDIAN */
+  return add_carry(sum, native);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add_bytewise(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint16_t t;
+  const uint8_t *dataptr;
+  const uint8_t *last_byte;
+
+  dataptr = data;
+  last_byte = data + len - 1;
+
+  while(dataptr < last_byte) {   /* At least two more bytes */
+    t = (dataptr[0] << 8) + dataptr[1];
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+    dataptr += 2;
+  }
+
+  if(dataptr == last_byte) {
+    t = (dataptr[0] << 8) + 0;
+    sum += t;
+    if(sum < t) {
+      sum++;      /* carry */
+    }
+  }
+
+  /* Return sum in host byte order. */
+  return sum;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add_acc32(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  /* At most 32767 words of 0xffff: the accumulator cannot overflow. */
+  uint32_t acc = 0;
+  uint16_t w;
+
+  for(; len >= 8; len -= 8, data += 8) {
+    memcpy(&w, data, 2);
+    acc += w;
+    memcpy(&w, data + 2, 2);
+    acc += w;
+    memcpy(&w, data + 4, 2);
+    acc += w;
+    memcpy(&w, data + 6, 2);
+    acc += w;
+  }
+  for(; len >= 2; len -= 2, data += 2) {
+    memcpy(&w, data, 2);
+    acc += w;
+  }
+  if(len) {
+    /* Pad the odd byte with a zero byte, in native order. */
+    w = 0;
+    memcpy(&w, data, 1);
+    acc += w;
+  }
+
+  return add_native(sum, fold32(acc));
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_add_acc64(uint16_t sum, const uint8_t *data, uint16_t len)
+{
+  uint64_t acc = 0;
+  uint32_t w;
+
+  for(; len >= 16; len -= 16, data += 16) {
+    memcpy(&w, data, 4);
+    acc += w;
+    memcpy(&w, data + 4, 4);
+    acc += w;
+    memcpy(&w, data + 8, 4);
+    acc += w;
+    memcpy(&w, data + 12, 4);
+    acc += w;
+  }
+  for(; len >= 4; len -= 4, data += 4) {
+    memcpy(&w, data, 4);
+    acc += w;
+  }
+  /* Zero-pad the last one to three bytes to a 32-bit word. */
+  if(len) {
+    w = 0;
+    memcpy(&w, data, len);
+    acc += w;
+  }
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  return add_native(sum, fold32((uint32_t)acc));
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_update16(uint16_t chksum, uint16_t old_word, uint16_t new_word)
+{
+  /* HC' = ~(~HC + ~m + m') */
+  return ~add_carry(add_carry(~chksum, ~old_word), new_word);
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_chksum_update(uint16_t chksum, const uint8_t *old_data,
+                  const uint8_t *new_data, uint16_t len)
+{
+  uint16_t sum;
+
+  sum = add_carry(~uip_ntohs(chksum), ~uip_chksum_add(0, old_data, len));
+  sum = uip_chksum_add(sum, new_data, len);
+  return uip_htons(~sum);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \addtogroup uip
+ * @{
+ *
+ * \file
+ *         Internet checksum kernels and incremental checksum updates
+ */
+
+#ifndef UIP_CHKSUM_H_
+#define UIP_CHKSUM_H_
+
+#include "contiki.h"
+
+/**
+ * \brief The function used by uIP to accumulate the Internet
+ * checksum over a buffer.
+ *
+ * All checksum kernels share the signature of
+ * uip_chksum_add_bytewise() and produce identical results; a
+ * platform picks the one best suited to its word size, or provides
+ * its own (e.g. a SIMD kernel), by setting UIP_CONF_CHKSUM_ADD.
+ */
+#ifdef UIP_CONF_CHKSUM_ADD
+#define UIP_CHKSUM_ADD UIP_CONF_CHKSUM_ADD
+#else
+#define UIP_CHKSUM_ADD uip_chksum_add_bytewise
+#endif
+
+/**
+ * \brief Add the 16-bit words of a buffer to a one's complement sum
+ *        one byte pair at a time
+ * \param sum The sum accumulated so far, in host byte order
+ * \param data The buffer, which does not need to be aligned
+ * \param len The length of the buffer. An odd trailing byte is
+ *        padded with a zero byte.
+ * \return The new sum, in host byte order
+ */
+uint16_t uip_chksum_add_bytewise(uint16_t sum, const uint8_t *data,
+                                 uint16_t len);
+
+/**
+ * \brief Add the 16-bit words of a buffer to a one's complement sum,
+ *        deferring carries to a 32-bit accumulator
+ *
+ * Suited to 16- and 32-bit CPUs. Same parameters and result as
+ * uip_chksum_add_bytewise().
+ */
+uint16_t uip_chksum_add_acc32(uint16_t sum, const uint8_t *data,
+                              uint16_t len);
+
+/**
+ * \brief Add the 32-bit words of a buffer to a one's complement sum,
+ *        deferring carries to a 64-bit accumulator
+ *
+ * Suited to 64-bit CPUs. Same parameters and result as
+ * uip_chksum_add_bytewise().
+ */
+uint16_t uip_chksum_add_acc64(uint16_t sum, const uint8_t *data,
+                              uint16_t len);
+
+#ifdef UIP_CONF_CHKSUM_ADD
+uint16_t UIP_CHKSUM_ADD(uint16_t sum, const uint8_t *data, uint16_t len);
+#endif /* UIP_CONF_CHKSUM_ADD */
+
+/**
+ * \brief Add the 16-bit words of a buffer to a one's complement sum
+ *        using the configured checksum kernel
+ */
+#define uip_chksum_add(sum, data, len) UIP_CHKSUM_ADD(sum, data, len)
+
+/**
+ * \brief Update a checksum after a 16-bit word it covers has changed
+ *
+ * Implements equation 3 of RFC 1624, so a forwarder rewriting a
+ * field does not need to sum the whole packet again.
+ *
+ * \param chksum The checksum, as stored in the packet
+ * \param old_word The old value of the word, as stored in the packet
+ * \param new_word The new value of the word, as stored in the packet
+ * \return The new checksum, as to be stored in the packet
+ */
+uint16_t uip_chksum_update16(uint16_t chksum, uint16_t old_word,
+                             uint16_t new_word);
+
+/**
+ * \brief Update a checksum after a field it covers has been rewritten,
+ *        e.g. an address
+ * \param chksum The checksum, as stored in the packet
+ * \param old_data The old contents of the field
+ * \param new_data The new contents of the field
+ * \param len The length of the field. Must be even, and the field must
+ *        start at an even offset from the start of the checksummed data.
+ * \return The new checksum, as to be stored in the packet
+ *
+ * The caller is responsible for any protocol-specific encoding of the
+ * result, such as UDP transmitting a zero checksum as 0xffff.
+ */
+uint16_t uip_chksum_update(uint16_t chksum, const uint8_t *old_data,
+                           const uint8_t *new_data, uint16_t len);
+
+#endif /* UIP_CHKSUM_H_ */
+/** @} */
@@ -177,6 +177,15 @@ uip_ds6_nbr_add(const uip_ipaddr_t *ipaddr, const uip_lladdr_t *lladdr,
     add_uip_ds6_nbr_to_nbr_entry(nbr, nbr_entry);
   }
 #else
+#if UIP_CONF_IPV6_QUEUE_PKT
+  /* An entry for the same link-layer address is reused, including the
+     single entry without one, so drop the packets queued for it */
+  nbr = nbr_table_get_from_lladdr(ds6_neighbors, lladdr != NULL ?
+                                  (const linkaddr_t *)lladdr : &linkaddr_null);
+  if(nbr != NULL) {
+    uip_packetqueue_free(&nbr->packethandle);
+  }
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
   nbr = nbr_table_add_lladdr(ds6_neighbors, (linkaddr_t*)lladdr, reason, data);
 #endif /* UIP_DS6_NBR_MULTI_IPV6_ADDRS */
 
@@ -364,8 +373,16 @@ uip_ds6_nbr_update_ll(uip_ds6_nbr_t **nbr_pp, const uip_lladdr_t *new_ll_addr)
   }
 
   memcpy(&nbr_backup, *nbr_pp, sizeof(uip_ds6_nbr_t));
+#if UIP_CONF_IPV6_QUEUE_PKT
+  /* Keep the queued packets, which are sent once the address of the
+     neighbor is resolved */
+  uip_packetqueue_move(&nbr_backup.packethandle, &(*nbr_pp)->packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
   if(uip_ds6_nbr_rm(*nbr_pp) == 0) {
     LOG_ERR("%s: input nbr cannot be removed\n", __func__);
+#if UIP_CONF_IPV6_QUEUE_PKT
+    uip_packetqueue_move(&(*nbr_pp)->packethandle, &nbr_backup.packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
     return -1;
   }
 
@@ -373,9 +390,15 @@ uip_ds6_nbr_update_ll(uip_ds6_nbr_t **nbr_pp, const uip_lladdr_t *new_ll_addr)
                                 nbr_backup.isrouter, nbr_backup.state,
                                 NBR_TABLE_REASON_IPV6_ND, NULL)) == NULL) {
     LOG_ERR("%s: cannot allocate a new nbr for new_ll_addr\n", __func__);
+#if UIP_CONF_IPV6_QUEUE_PKT
+    uip_packetqueue_free(&nbr_backup.packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
     return -1;
   }
   memcpy(*nbr_pp, &nbr_backup, sizeof(uip_ds6_nbr_t));
+#if UIP_CONF_IPV6_QUEUE_PKT
+  uip_packetqueue_move(&(*nbr_pp)->packethandle, &nbr_backup.packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
 #endif /* UIP_DS6_NBR_MULTI_IPV6_ADDRS */
 
   return 0;
@@ -117,7 +117,11 @@ typedef struct uip_ds6_nbr {
 #endif /* UIP_ND6_SEND_NS || UIP_ND6_SEND_RA */
 #if UIP_CONF_IPV6_QUEUE_PKT
   struct uip_packetqueue_handle packethandle;
+#ifdef UIP_DS6_NBR_CONF_PACKET_LIFETIME
+#define UIP_DS6_NBR_PACKET_LIFETIME UIP_DS6_NBR_CONF_PACKET_LIFETIME
+#else /* UIP_DS6_NBR_CONF_PACKET_LIFETIME */
 #define UIP_DS6_NBR_PACKET_LIFETIME CLOCK_SECOND * 4
+#endif /* UIP_DS6_NBR_CONF_PACKET_LIFETIME */
 #endif                          /*UIP_CONF_QUEUE_PKT */
 } uip_ds6_nbr_t;
 
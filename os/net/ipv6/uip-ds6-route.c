@@ -91,6 +91,25 @@ MEMB(routememb, uip_ds6_route_t, UIP_DS6_ROUTE_NB);
 static int num_routes = 0;
 static void rm_routelist_callback(nbr_table_item_t *ptr);
 
+#if UIP_DS6_ROUTE_WITH_HASH
+/* Routes are hashed on their prefix, masked to the prefix length, and
+   chained through their hash_next pointer. The prefix lengths in use
+   are kept sorted from longest to shortest, so that a lookup probes
+   one bucket per prefix length in use and stops at the first match. */
+#define ROUTE_HASH_BUCKETS_MIN UIP_DS6_ROUTE_NB
+#define ROUTE_HASH_BUCKETS (ROUTE_HASH_BUCKETS_MIN <= 16 ? 16 : \
+                            ROUTE_HASH_BUCKETS_MIN <= 64 ? 64 : \
+                            ROUTE_HASH_BUCKETS_MIN <= 256 ? 256 : \
+                            ROUTE_HASH_BUCKETS_MIN <= 1024 ? 1024 : \
+                            ROUTE_HASH_BUCKETS_MIN <= 4096 ? 4096 : 16384)
+static uip_ds6_route_t *route_hash[ROUTE_HASH_BUCKETS];
+/* Number of routes per prefix length */
+static uint16_t length_count[129];
+/* Prefix lengths in use, longest first */
+static uint8_t lengths[129];
+static uint8_t num_lengths;
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
+
 #endif /* (UIP_MAX_ROUTES != 0) */
 
 /* Default routes are held on the defaultrouterlist and their
@@ -167,6 +186,86 @@ uip_ds6_notification_rm(struct uip_ds6_notification *n)
   list_remove(notificationlist, n);
 }
 #endif
+#if (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_WITH_HASH
+/*---------------------------------------------------------------------------*/
+static unsigned
+route_hash_index(const uip_ipaddr_t *addr, uint8_t length)
+{
+  uint32_t hash = 2166136261UL ^ length;
+  uint8_t i;
+  uint8_t byte;
+
+  /* FNV-1a over the bytes covered by the prefix, last one masked */
+  for(i = 0; i < (length + 7) / 8; i++) {
+    byte = addr->u8[i];
+    if(i == length / 8) {
+      byte &= 0xff << (8 - length % 8);
+    }
+    hash = (hash ^ byte) * 16777619UL;
+  }
+  return (hash ^ (hash >> 16)) & (ROUTE_HASH_BUCKETS - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_hash_add(uip_ds6_route_t *r)
+{
+  unsigned bucket = route_hash_index(&r->ipaddr, r->length);
+  uint8_t i;
+
+  r->hash_next = route_hash[bucket];
+  route_hash[bucket] = r;
+
+  if(length_count[r->length]++ == 0) {
+    /* New prefix length: insert it, keeping the array sorted */
+    for(i = num_lengths; i > 0 && lengths[i - 1] < r->length; i--) {
+      lengths[i] = lengths[i - 1];
+    }
+    lengths[i] = r->length;
+    num_lengths++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_hash_rm(uip_ds6_route_t *r)
+{
+  uip_ds6_route_t **rp;
+  uint8_t i;
+
+  for(rp = &route_hash[route_hash_index(&r->ipaddr, r->length)];
+      *rp != NULL; rp = &(*rp)->hash_next) {
+    if(*rp == r) {
+      *rp = r->hash_next;
+      break;
+    }
+  }
+  r->hash_next = NULL;
+
+  if(--length_count[r->length] == 0) {
+    for(i = 0; i < num_lengths && lengths[i] != r->length; i++);
+    for(num_lengths--; i < num_lengths; i++) {
+      lengths[i] = lengths[i + 1];
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uip_ds6_route_t *
+route_hash_lookup(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uint8_t i;
+
+  for(i = 0; i < num_lengths; i++) {
+    for(r = route_hash[route_hash_index(addr, lengths[i])];
+        r != NULL; r = r->hash_next) {
+      if(r->length == lengths[i] &&
+         uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+        return r;
+      }
+    }
+  }
+  return NULL;
+}
+#endif /* (UIP_MAX_ROUTES != 0) && UIP_DS6_ROUTE_WITH_HASH */
 /*---------------------------------------------------------------------------*/
 void
 uip_ds6_route_init(void)
@@ -174,8 +273,14 @@ uip_ds6_route_init(void)
 #if (UIP_MAX_ROUTES != 0)
   memb_init(&routememb);
   list_init(routelist);
+  num_routes = 0;
   nbr_table_register(nbr_routes,
                      (nbr_table_callback *)rm_routelist_callback);
+#if UIP_DS6_ROUTE_WITH_HASH
+  memset(route_hash, 0, sizeof(route_hash));
+  memset(length_count, 0, sizeof(length_count));
+  num_lengths = 0;
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 #endif /* (UIP_MAX_ROUTES != 0) */
 
   memb_init(&defaultroutermemb);
@@ -266,9 +371,11 @@ uip_ds6_route_t *
 uip_ds6_route_lookup(const uip_ipaddr_t *addr)
 {
 #if (UIP_MAX_ROUTES != 0)
-  uip_ds6_route_t *r;
   uip_ds6_route_t *found_route;
+#if !UIP_DS6_ROUTE_WITH_HASH
+  uip_ds6_route_t *r;
   uint8_t longestmatch;
+#endif /* !UIP_DS6_ROUTE_WITH_HASH */
 
   LOG_INFO("Looking up route for ");
   LOG_INFO_6ADDR(addr);
@@ -278,6 +385,9 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     return NULL;
   }
 
+#if UIP_DS6_ROUTE_WITH_HASH
+  found_route = route_hash_lookup(addr);
+#else /* UIP_DS6_ROUTE_WITH_HASH */
   found_route = NULL;
   longestmatch = 0;
   for(r = uip_ds6_route_head();
@@ -293,6 +403,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
       }
     }
   }
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 
   if(found_route != NULL) {
     LOG_INFO("Found route: ");
@@ -304,6 +415,10 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     LOG_WARN("No route found\n");
   }
 
+#if !UIP_DS6_ROUTE_WITH_HASH || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED
+  /* With the hash index, the order of the route list only matters
+     when evicting the least recently used route. Do not pay for a
+     list walk on every lookup otherwise. */
   if(found_route != NULL && found_route != list_head(routelist)) {
     /* If we found a route, we put it at the start of the routeslist
        list. The list is ordered by how recently we looked them up:
@@ -313,6 +428,7 @@ uip_ds6_route_lookup(const uip_ipaddr_t *addr)
     list_remove(routelist, found_route);
     list_push(routelist, found_route);
   }
+#endif /* !UIP_DS6_ROUTE_WITH_HASH || UIP_DS6_ROUTE_REMOVE_LEAST_RECENTLY_USED */
 
   return found_route;
 #else /* (UIP_MAX_ROUTES != 0) */
@@ -455,6 +571,9 @@ uip_ds6_route_add(const uip_ipaddr_t *ipaddr, uint8_t length,
 
   uip_ipaddr_copy(&(r->ipaddr), ipaddr);
   r->length = length;
+#if UIP_DS6_ROUTE_WITH_HASH
+  route_hash_add(r);
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 
 #ifdef UIP_DS6_ROUTE_STATE_TYPE
   memset(&r->state, 0, sizeof(UIP_DS6_ROUTE_STATE_TYPE));
@@ -500,6 +619,9 @@ uip_ds6_route_rm(uip_ds6_route_t *route)
 
     /* Remove the route from the route list */
     list_remove(routelist, route);
+#if UIP_DS6_ROUTE_WITH_HASH
+    route_hash_rm(route);
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
 
     /* Find the corresponding neighbor_route and remove it. */
     for(neighbor_route = list_head(route->neighbor_routes->route_list);
@@ -111,6 +111,15 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define UIP_DS6_ROUTE_NB 4
 #endif /* UIP_MAX_ROUTES */
 
+/** \brief Index routes in a hash table keyed by prefix and prefix
+ *  length, so that longest-prefix-match lookups only probe the prefix
+ *  lengths in use instead of scanning every route */
+#ifdef UIP_DS6_ROUTE_CONF_WITH_HASH
+#define UIP_DS6_ROUTE_WITH_HASH UIP_DS6_ROUTE_CONF_WITH_HASH
+#else /* UIP_DS6_ROUTE_CONF_WITH_HASH */
+#define UIP_DS6_ROUTE_WITH_HASH 0
+#endif /* UIP_DS6_ROUTE_CONF_WITH_HASH */
+
 /** \brief define some additional RPL related route state and
  *  neighbor callback for RPL - if not a DS6_ROUTE_STATE is already set */
 #ifndef UIP_DS6_ROUTE_STATE_TYPE
@@ -170,6 +179,10 @@ struct uip_ds6_route_neighbor_routes {
 /** \brief An entry in the routing table */
 typedef struct uip_ds6_route {
   struct uip_ds6_route *next;
+#if UIP_DS6_ROUTE_WITH_HASH
+  /* Next route in the same hash bucket */
+  struct uip_ds6_route *hash_next;
+#endif /* UIP_DS6_ROUTE_WITH_HASH */
   /* Each route entry belongs to a specific neighbor. That neighbor
      holds a list of all routing entries that go through it. The
      routes field point to the uip_ds6_route_neighbor_routes that
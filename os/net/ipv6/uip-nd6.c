@@ -575,7 +575,9 @@ na_input(void)
     }
   }
 #if UIP_CONF_IPV6_QUEUE_PKT
-  /* The nbr is now reachable, check if we had buffered a pkt for it */
+  /* The nbr is now reachable, check if we had buffered a pkt for it.
+     The oldest one is returned in uip_buf, and tcpip_ipv6_output()
+     sends the others after it. */
   /*if(nbr->queue_buf_len != 0) {
     uip_len = nbr->queue_buf_len;
     memcpy(UIP_IP_BUF, nbr->queue_buf, uip_len);
@@ -585,7 +587,7 @@ na_input(void)
   if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_pop(&nbr->packethandle);
     return;
   }
 
@@ -1059,7 +1061,8 @@ ra_input(void)
 
 #if UIP_CONF_IPV6_QUEUE_PKT
   /* If the nbr just became reachable (e.g. it was in NBR_INCOMPLETE state
-   * and we got a SLLAO), check if we had buffered a pkt for it */
+   * and we got a SLLAO), check if we had buffered a pkt for it. The
+   * others are sent by tcpip_ipv6_output() after the oldest one. */
   /*  if((nbr != NULL) && (nbr->queue_buf_len != 0)) {
     uip_len = nbr->queue_buf_len;
     memcpy(UIP_IP_BUF, nbr->queue_buf, uip_len);
@@ -1069,7 +1072,7 @@ ra_input(void)
   if(nbr != NULL && uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_pop(&nbr->packethandle);
     return;
   }
 
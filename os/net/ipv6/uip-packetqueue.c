@@ -6,8 +6,9 @@
 
 #include "net/ipv6/uip-packetqueue.h"
 
-#define MAX_NUM_QUEUED_PACKETS 2
-MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
+MEMB(packets_memb, struct uip_packetqueue_packet, UIP_PACKETQUEUE_SIZE);
+
+static struct uip_packetqueue_stats stats;
 
 #define DEBUG 0
 #if DEBUG
@@ -17,15 +18,30 @@ MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static void
+packet_remove(struct uip_packetqueue_packet *p)
+{
+  struct uip_packetqueue_packet **l;
+
+  for(l = &p->handle->packet; *l != NULL; l = &(*l)->next) {
+    if(*l == p) {
+      *l = p->next;
+      break;
+    }
+  }
+  ctimer_stop(&p->lifetimer);
+  memb_free(&packets_memb, p);
+}
 /*---------------------------------------------------------------------------*/
 static void
 packet_timedout(void *ptr)
 {
-  struct uip_packetqueue_handle *h = ptr;
+  struct uip_packetqueue_packet *p = ptr;
 
-  PRINTF("uip_packetqueue_free timed out %p\n", h);
-  memb_free(&packets_memb, h->packet);
-  h->packet = NULL;
+  PRINTF("uip_packetqueue_free timed out %p\n", p->handle);
+  stats.timed_out++;
+  packet_remove(p);
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -38,29 +54,65 @@ uip_packetqueue_new(struct uip_packetqueue_handle *handle)
 struct uip_packetqueue_packet *
 uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime)
 {
+  struct uip_packetqueue_packet **l;
+  struct uip_packetqueue_packet *p;
+  int n;
+
   PRINTF("uip_packetqueue_alloc %p\n", handle);
-  if(handle->packet != NULL) {
+  n = 0;
+  for(l = &handle->packet; *l != NULL; l = &(*l)->next) {
+    n++;
+  }
+  if(n >= UIP_PACKETQUEUE_MAX_PER_HANDLE) {
     PRINTF("alloced\n");
+    stats.handle_full++;
     return NULL;
   }
-  handle->packet = memb_alloc(&packets_memb);
-  if(handle->packet != NULL) {
-    ctimer_set(&handle->packet->lifetimer, lifetime,
-               packet_timedout, handle);
-  } else {
+  p = memb_alloc(&packets_memb);
+  if(p == NULL) {
     PRINTF("uip_packetqueue_alloc failed\n");
+    stats.no_buffer++;
+    return NULL;
   }
-  return handle->packet;
+  p->next = NULL;
+  p->queue_buf_len = 0;
+  p->handle = handle;
+  ctimer_set(&p->lifetimer, lifetime, packet_timedout, p);
+  *l = p;
+  stats.queued++;
+  return p;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle)
 {
   PRINTF("uip_packetqueue_free %p\n", handle);
+  while(handle->packet != NULL) {
+    stats.discarded++;
+    packet_remove(handle->packet);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_pop(struct uip_packetqueue_handle *handle)
+{
+  PRINTF("uip_packetqueue_pop %p\n", handle);
   if(handle->packet != NULL) {
-    ctimer_stop(&handle->packet->lifetimer);
-    memb_free(&packets_memb, handle->packet);
-    handle->packet = NULL;
+    packet_remove(handle->packet);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_move(struct uip_packetqueue_handle *to,
+                     struct uip_packetqueue_handle *from)
+{
+  struct uip_packetqueue_packet *p;
+
+  PRINTF("uip_packetqueue_move %p %p\n", to, from);
+  to->packet = from->packet;
+  from->packet = NULL;
+  for(p = to->packet; p != NULL; p = p->next) {
+    p->handle = to;
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -77,10 +129,8 @@ uip_packetqueue_buflen(struct uip_packetqueue_handle *h)
 }
 /*---------------------------------------------------------------------------*/
 void
-uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len)
+uip_packetqueue_get_stats(struct uip_packetqueue_stats *s)
 {
-  if(h->packet != NULL) {
-    h->packet->queue_buf_len = len;
-  }
+  *s = stats;
 }
 /*---------------------------------------------------------------------------*/
@@ -3,33 +3,75 @@
 
 #include "sys/ctimer.h"
 
+/* The number of packets that can be queued for all handles together */
+#ifdef UIP_PACKETQUEUE_CONF_SIZE
+#define UIP_PACKETQUEUE_SIZE UIP_PACKETQUEUE_CONF_SIZE
+#else /* UIP_PACKETQUEUE_CONF_SIZE */
+#define UIP_PACKETQUEUE_SIZE 2
+#endif /* UIP_PACKETQUEUE_CONF_SIZE */
+
+/* The number of packets that can be queued for one handle, e.g. one
+   neighbor whose address is being resolved. Packets beyond this are
+   dropped, so that a single neighbor cannot take the whole pool. */
+#ifdef UIP_PACKETQUEUE_CONF_MAX_PER_HANDLE
+#define UIP_PACKETQUEUE_MAX_PER_HANDLE UIP_PACKETQUEUE_CONF_MAX_PER_HANDLE
+#else /* UIP_PACKETQUEUE_CONF_MAX_PER_HANDLE */
+#define UIP_PACKETQUEUE_MAX_PER_HANDLE 1
+#endif /* UIP_PACKETQUEUE_CONF_MAX_PER_HANDLE */
+
 struct uip_packetqueue_handle;
 
 struct uip_packetqueue_packet {
-  struct uip_ds6_queued_packet *next;
+  struct uip_packetqueue_packet *next;
   uint8_t queue_buf[UIP_BUFSIZE];
   uint16_t queue_buf_len;
   struct ctimer lifetimer;
   struct uip_packetqueue_handle *handle;
 };
 
+/* A FIFO of packets, oldest first */
 struct uip_packetqueue_handle {
   struct uip_packetqueue_packet *packet;
 };
 
-void uip_packetqueue_new(struct uip_packetqueue_handle *handle);
+struct uip_packetqueue_stats {
+  /* Packets queued */
+  unsigned long queued;
+  /* Packets dropped because the pool was empty */
+  unsigned long no_buffer;
+  /* Packets dropped because the handle held its maximum */
+  unsigned long handle_full;
+  /* Packets dropped because their lifetime expired */
+  unsigned long timed_out;
+  /* Packets dropped with their handle, e.g. when a neighbor was removed */
+  unsigned long discarded;
+};
 
+void uip_packetqueue_new(struct uip_packetqueue_handle *handle);
 
+/* Append a packet to the queue of a handle. The caller fills in
+   queue_buf and queue_buf_len of the returned packet. */
 struct uip_packetqueue_packet *
 uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime);
 
-
+/* Drop all packets queued for a handle */
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle);
 
+/* Drop the oldest packet of a handle, once it has been sent */
+void
+uip_packetqueue_pop(struct uip_packetqueue_handle *handle);
+
+/* Move the packets of a handle to another one, e.g. when the structure
+   that holds the handle is copied */
+void
+uip_packetqueue_move(struct uip_packetqueue_handle *to,
+                     struct uip_packetqueue_handle *from);
+
+/* The oldest packet of a handle */
 uint8_t *uip_packetqueue_buf(struct uip_packetqueue_handle *h);
 uint16_t uip_packetqueue_buflen(struct uip_packetqueue_handle *h);
-void uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len);
 
+void uip_packetqueue_get_stats(struct uip_packetqueue_stats *stats);
 
 #endif /* UIP_PACKETQUEUE_H */
@@ -58,6 +58,32 @@ static int num_nodes;
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
 
+#if UIP_SR_WITH_HASH
+/* Nodes are also chained in buckets indexed by a hash of their link
+ * identifier. There are at least as many buckets as nodes, rounded up to
+ * a power of two. */
+#define HASH_BITS (UIP_SR_LINK_NUM <= 16 ? 4 : \
+                   UIP_SR_LINK_NUM <= 64 ? 6 : \
+                   UIP_SR_LINK_NUM <= 256 ? 8 : \
+                   UIP_SR_LINK_NUM <= 1024 ? 10 : 12)
+#define HASH_BUCKETS (1 << HASH_BITS)
+static uip_sr_node_t *node_hash[HASH_BUCKETS];
+#endif /* UIP_SR_WITH_HASH */
+
+#if UIP_SR_SRH_CACHE_SIZE
+/* A direct-mapped cache of source routing headers, indexed by a hash of
+ * the destination link identifier */
+struct srh_cache_entry {
+  void *graph;
+  uip_ipaddr_t dest;
+  uip_ipaddr_t first_hop;
+  /* The header length, 0 if the entry is unused */
+  uint8_t len;
+  uint8_t hdr[UIP_SR_SRH_CACHE_MAX_LEN];
+};
+static struct srh_cache_entry srh_cache[UIP_SR_SRH_CACHE_SIZE];
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
 /*---------------------------------------------------------------------------*/
 int
 uip_sr_num_nodes(void)
@@ -65,6 +91,66 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+#if UIP_SR_WITH_HASH || UIP_SR_SRH_CACHE_SIZE
+static uint32_t
+hash_link_identifier(const unsigned char *link_identifier)
+{
+  unsigned i;
+  uint32_t hash = 0;
+
+  for(i = 0; i < 8; i++) {
+    hash = hash * 31 + link_identifier[i];
+  }
+  /* Fibonacci hashing: consecutive identifiers are spread apart. Callers
+   * use the most significant bits. */
+  return (uint32_t)(hash * 2654435769UL);
+}
+#endif /* UIP_SR_WITH_HASH || UIP_SR_SRH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
+#if UIP_SR_WITH_HASH
+static uip_sr_node_t **
+hash_bucket(const unsigned char *link_identifier)
+{
+  return &node_hash[hash_link_identifier(link_identifier) >> (32 - HASH_BITS)];
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(uip_sr_node_t *node)
+{
+  uip_sr_node_t **bucket = hash_bucket(node->link_identifier);
+
+  node->hash_next = *bucket;
+  *bucket = node;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(uip_sr_node_t *node)
+{
+  uip_sr_node_t **l;
+
+  for(l = hash_bucket(node->link_identifier); *l != NULL; l = &(*l)->hash_next) {
+    if(*l == node) {
+      *l = node->hash_next;
+      return;
+    }
+  }
+}
+#endif /* UIP_SR_WITH_HASH */
+/*---------------------------------------------------------------------------*/
+/* Called whenever a child-parent link changes or a node is removed. Any
+ * state derived from the graph must be dropped. */
+static void
+topology_changed(void)
+{
+#if UIP_SR_SRH_CACHE_SIZE
+  int i;
+
+  for(i = 0; i < UIP_SR_SRH_CACHE_SIZE; i++) {
+    srh_cache[i].len = 0;
+  }
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+}
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(void *graph, const uip_sr_node_t *node, const uip_ipaddr_t *addr)
 {
@@ -81,7 +167,14 @@ uip_sr_node_t *
 uip_sr_get_node(void *graph, const uip_ipaddr_t *addr)
 {
   uip_sr_node_t *l;
+#if UIP_SR_WITH_HASH
+  if(addr == NULL) {
+    return NULL;
+  }
+  for(l = *hash_bucket(((const unsigned char *)addr) + 8); l != NULL; l = l->hash_next) {
+#else /* UIP_SR_WITH_HASH */
   for(l = list_head(nodelist); l != NULL; l = list_item_next(l)) {
+#endif /* UIP_SR_WITH_HASH */
     /* Compare prefix and node identifier */
     if(node_matches_address(graph, l, addr)) {
       return l;
@@ -125,6 +218,7 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
   uip_sr_node_t *child_node = uip_sr_get_node(graph, child);
   uip_sr_node_t *parent_node = uip_sr_get_node(graph, parent);
   uip_sr_node_t *old_parent_node;
+  int is_new = 0;
 
   if(parent != NULL) {
     /* No node for the parent, add one with infinite lifetime */
@@ -148,18 +242,23 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
       return NULL;
     }
     child_node->parent = NULL;
+    memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
     list_add(nodelist, child_node);
+#if UIP_SR_WITH_HASH
+    hash_add(child_node);
+#endif /* UIP_SR_WITH_HASH */
     num_nodes++;
+    is_new = 1;
   }
 
   /* Initialize node */
   child_node->graph = graph;
   child_node->lifetime = lifetime;
   memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
+  old_parent_node = child_node->parent;
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
-    old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
@@ -173,6 +272,12 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child, const uip_ipaddr_t *p
     child_node->parent = parent_node;
   }
 
+  /* A new node has no descendant yet, so only existing nodes changing
+   * parent alter the routes to other nodes */
+  if(!is_new && child_node->parent != old_parent_node) {
+    topology_changed();
+  }
+
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
   LOG_INFO_(", parent ");
@@ -188,6 +293,10 @@ uip_sr_init(void)
   num_nodes = 0;
   memb_init(&nodememb);
   list_init(nodelist);
+#if UIP_SR_WITH_HASH
+  memset(node_hash, 0, sizeof(node_hash));
+#endif /* UIP_SR_WITH_HASH */
+  topology_changed();
 }
 /*---------------------------------------------------------------------------*/
 uip_sr_node_t *
@@ -227,8 +336,12 @@ uip_sr_periodic(unsigned seconds)
       }
       /* No child found, deallocate node */
       list_remove(nodelist, l);
+#if UIP_SR_WITH_HASH
+      hash_remove(l);
+#endif /* UIP_SR_WITH_HASH */
       memb_free(&nodememb, l);
       num_nodes--;
+      topology_changed();
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
     }
@@ -246,6 +359,10 @@ uip_sr_free_all(void)
     memb_free(&nodememb, l);
     num_nodes--;
   }
+#if UIP_SR_WITH_HASH
+  memset(node_hash, 0, sizeof(node_hash));
+#endif /* UIP_SR_WITH_HASH */
+  topology_changed();
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -300,4 +417,73 @@ uip_sr_link_snprint(char *buf, int buflen, uip_sr_node_t *link)
   }
   return index;
 }
+/*---------------------------------------------------------------------------*/
+#if UIP_SR_SRH_CACHE_SIZE
+static struct srh_cache_entry *
+srh_cache_entry(const uip_ipaddr_t *dest)
+{
+  return &srh_cache[(hash_link_identifier(((const unsigned char *)dest) + 8) >> 16)
+                    % UIP_SR_SRH_CACHE_SIZE];
+}
+/*---------------------------------------------------------------------------*/
+const uint8_t *
+uip_sr_srh_cache_lookup(void *graph, const uip_ipaddr_t *dest,
+                        uip_ipaddr_t *first_hop, uint8_t *len)
+{
+  struct srh_cache_entry *e = srh_cache_entry(dest);
+
+  if(e->len == 0 || e->graph != graph || !uip_ipaddr_cmp(&e->dest, dest)) {
+    return NULL;
+  }
+  uip_ipaddr_copy(first_hop, &e->first_hop);
+  *len = e->len;
+  return e->hdr;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_sr_srh_cache_add(void *graph, const uip_ipaddr_t *dest,
+                     const uip_ipaddr_t *first_hop,
+                     const uint8_t *hdr, uint8_t len)
+{
+  struct srh_cache_entry *e;
+
+  if(len == 0 || len > UIP_SR_SRH_CACHE_MAX_LEN) {
+    return;
+  }
+  e = srh_cache_entry(dest);
+  e->graph = graph;
+  uip_ipaddr_copy(&e->dest, dest);
+  uip_ipaddr_copy(&e->first_hop, first_hop);
+  memcpy(e->hdr, hdr, len);
+  e->len = len;
+}
+/*---------------------------------------------------------------------------*/
+int
+uip_sr_srh_cache_insert_hdr(void *graph)
+{
+  struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+  const uint8_t *cached_hdr;
+  uip_ipaddr_t first_hop;
+  uint8_t ext_len;
+
+  cached_hdr = uip_sr_srh_cache_lookup(graph, &UIP_IP_BUF->destipaddr,
+                                       &first_hop, &ext_len);
+  if(cached_hdr == NULL) {
+    return 0;
+  }
+  if(uip_len + ext_len > UIP_LINK_MTU) {
+    LOG_ERR("packet too long: impossible to add source routing header (%u bytes)\n", ext_len);
+    return -1;
+  }
+  memmove(uip_buf + UIP_IPH_LEN + uip_ext_len + ext_len,
+          uip_buf + UIP_IPH_LEN + uip_ext_len, uip_len - UIP_IPH_LEN);
+  memcpy(rh_hdr, cached_hdr, ext_len);
+  rh_hdr->next = UIP_IP_BUF->proto;
+  UIP_IP_BUF->proto = UIP_PROTO_ROUTING;
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &first_hop);
+  uipbuf_add_ext_hdr(ext_len);
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  return 1;
+}
+#endif /* UIP_SR_SRH_CACHE_SIZE */
 /** @} */
@@ -85,6 +85,30 @@
 
 #define UIP_SR_INFINITE_LIFETIME           0xFFFFFFFF
 
+/* Index nodes in a hash table keyed by their IPv6 link identifier, so that
+ * node lookups do not scan the whole node list */
+#ifdef UIP_SR_CONF_WITH_HASH
+#define UIP_SR_WITH_HASH UIP_SR_CONF_WITH_HASH
+#else /* UIP_SR_CONF_WITH_HASH */
+#define UIP_SR_WITH_HASH 0
+#endif /* UIP_SR_CONF_WITH_HASH */
+
+/* The number of source routing headers cached at the root. Each entry
+ * holds the header computed for one destination, and all entries are
+ * dropped whenever the topology changes. 0 disables the cache. */
+#ifdef UIP_SR_CONF_SRH_CACHE_SIZE
+#define UIP_SR_SRH_CACHE_SIZE UIP_SR_CONF_SRH_CACHE_SIZE
+#else /* UIP_SR_CONF_SRH_CACHE_SIZE */
+#define UIP_SR_SRH_CACHE_SIZE 0
+#endif /* UIP_SR_CONF_SRH_CACHE_SIZE */
+
+/* The largest source routing header that fits in a cache entry */
+#ifdef UIP_SR_CONF_SRH_CACHE_MAX_LEN
+#define UIP_SR_SRH_CACHE_MAX_LEN UIP_SR_CONF_SRH_CACHE_MAX_LEN
+#else /* UIP_SR_CONF_SRH_CACHE_MAX_LEN */
+#define UIP_SR_SRH_CACHE_MAX_LEN 64
+#endif /* UIP_SR_CONF_SRH_CACHE_MAX_LEN */
+
 /********** Data Structures  **********/
 
 /** \brief A node in a source routing graph, stored at the root and representing
@@ -98,6 +122,10 @@ typedef struct uip_sr_node {
   us with the prefix */
   unsigned char link_identifier[8];
   struct uip_sr_node *parent;
+#if UIP_SR_WITH_HASH
+  /* Next node in the same hash bucket */
+  struct uip_sr_node *hash_next;
+#endif /* UIP_SR_WITH_HASH */
 } uip_sr_node_t;
 
 /********** Public functions **********/
@@ -191,6 +219,46 @@ void uip_sr_free_all(void);
 */
 int uip_sr_link_snprint(char *buf, int buflen, uip_sr_node_t *link);
 
+#if UIP_SR_SRH_CACHE_SIZE
+/**
+ * Looks up the source routing header cached for a destination
+ *
+ * \param graph The graph the destination belongs to
+ * \param dest The IPv6 address of the destination
+ * \param first_hop Where to write the first hop, i.e. the address to use as
+ * IPv6 destination once the header is inserted
+ * \param len Where to write the header length
+ * \return A pointer to the header, or NULL if none is cached
+*/
+const uint8_t *uip_sr_srh_cache_lookup(void *graph, const uip_ipaddr_t *dest,
+                                       uip_ipaddr_t *first_hop, uint8_t *len);
+
+/**
+ * Caches the source routing header computed for a destination. The entry
+ * stays valid until the next topology change.
+ *
+ * \param graph The graph the destination belongs to
+ * \param dest The IPv6 address of the destination
+ * \param first_hop The first hop of the source route
+ * \param hdr The routing header
+ * \param len The header length
+*/
+void uip_sr_srh_cache_add(void *graph, const uip_ipaddr_t *dest,
+                          const uip_ipaddr_t *first_hop,
+                          const uint8_t *hdr, uint8_t len);
+
+/**
+ * Inserts the source routing header cached for the destination of the
+ * packet in uip_buf, as first extension header, and sets the IPv6
+ * destination to the first hop
+ *
+ * \param graph The graph the destination belongs to
+ * \return 1 if the header was inserted, 0 if none is cached for the
+ * destination, -1 if the packet would be too long with the header
+*/
+int uip_sr_srh_cache_insert_hdr(void *graph);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
  /** @} */
 
 #endif /* UIP_SR_H */
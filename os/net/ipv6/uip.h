@@ -487,7 +487,14 @@ void uip_setipid(uint16_t id);
     uip_process(UIP_UDP_TIMER); } while(0)
 #endif /* UIP_UDP */
 
-/** \brief Abandon the reassembly of the current packet */
+/**
+ * \brief Abandon the reassembly of a packet that has timed out
+ *
+ * Called by tcpip_process when uip_reass_timer expires. One packet is
+ * abandoned per call, and an ICMPv6 Time Exceeded message may be left
+ * in uip_buf for tcpip_ipv6_output(). The timer is set again for the
+ * next packet to time out.
+ */
 void uip_reass_over(void);
 
 /**
@@ -736,6 +743,18 @@ void uip_send(const void *data, int len);
  */
 #define uip_acked()   (uip_flags & UIP_ACKDATA)
 
+/**
+ * The number of bytes acknowledged by the incoming segment.
+ *
+ * Only valid when uip_acked() is non-zero. With a send window of
+ * more than one segment (UIP_TCP_SEND_WINDOW), this may be less
+ * than what is outstanding, and the application should only release
+ * this many bytes from the head of its send buffer.
+ *
+ * \hideinitializer
+ */
+#define uip_ackedlen()   (uip_acked_len)
+
 /**
  * Has the connection just been connected?
  *
@@ -825,6 +844,18 @@ void uip_send(const void *data, int len);
  */
 #define uip_mss()             (uip_conn->mss)
 
+/**
+ * Get the number of bytes that can be sent on the current connection
+ * without waiting for an acknowledgement.
+ *
+ * With UIP_TCP_SEND_WINDOW set to 1 this is the MSS when no data is
+ * outstanding and zero otherwise. Data passed to uip_send() beyond
+ * this amount is not sent.
+ *
+ * \hideinitializer
+ */
+#define uip_sendroom()        (uip_tcp_send_room(uip_conn))
+
 /**
  * Set up a new UDP connection.
  *
@@ -861,7 +892,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_WITH_HASH
+#define uip_udp_remove(conn) uip_udp_set_lport(conn, 0)
+#else /* UIP_CONN_WITH_HASH */
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif /* UIP_CONN_WITH_HASH */
 
 /**
  * Bind a UDP connection to a local port.
@@ -873,7 +908,26 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_WITH_HASH
+#define uip_udp_bind(conn, port) uip_udp_set_lport(conn, port)
+#else /* UIP_CONN_WITH_HASH */
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif /* UIP_CONN_WITH_HASH */
+
+/**
+ * Change the local port of a UDP connection and move it to the
+ * matching bucket of the port index.
+ *
+ * Used by uip_udp_bind() and uip_udp_remove() when UIP_CONN_WITH_HASH
+ * is enabled.
+ *
+ * \param conn A pointer to the uip_udp_conn structure for the
+ * connection.
+ *
+ * \param port The local port number, in network byte order, or 0 to
+ * free the connection.
+ */
+void uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port);
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -1311,6 +1365,13 @@ extern uint8_t uip_last_proto;
 extern uint16_t uip_urglen, uip_surglen;
 #endif /* UIP_URGDATA > 0 */
 
+/**
+ * The number of bytes acknowledged by the last incoming TCP segment.
+ *
+ * Applications should use uip_ackedlen() instead.
+ */
+extern uint16_t uip_acked_len;
+
 /**
  * Representation of a uIP TCP connection.
  *
@@ -1331,7 +1392,8 @@ struct uip_conn {
   uint8_t rcv_nxt[4];    /**< The sequence number that we expect to
                               receive next. */
   uint8_t snd_nxt[4];    /**< The sequence number that was last sent by us. */
-  uint16_t len;          /**< Length of the data that was previously sent. */
+  uint16_t len;          /**< Length of the data that was previously sent
+                              and is not yet acknowledged. */
   uint16_t mss;          /**< Current maximum segment size for the connection. */
   uint16_t initialmss;   /**< Initial maximum segment size for the connection. */
   uint8_t sa;            /**< Retransmission time-out calculation state variable. */
@@ -1341,7 +1403,21 @@ struct uip_conn {
   uint8_t timer;         /**< The retransmission timer. */
   uint8_t nrtx;          /**< The number of retransmissions for the last
                               segment sent. */
+#if UIP_TCP_SEND_WINDOW > 1
+  uint16_t snd_wnd;      /**< The window last advertised by the remote host. */
+  uint8_t rtt_timing;    /**< Non-zero while the flight in progress is
+                              being timed for RTT estimation. */
+  uint16_t snd_max;      /**< Length of the data sent after snd_nxt,
+                              including data that a retransmission
+                              time-out has marked for sending again. */
+  uint8_t close_pending; /**< Non-zero if the application has closed the
+                              connection while data was still in flight. */
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
   uip_tcp_appstate_t appstate; /** The application state. */
+#if UIP_CONN_WITH_HASH
+  struct uip_conn *hash_next; /**< The next connection in the same port
+                                   index bucket. */
+#endif /* UIP_CONN_WITH_HASH */
 };
 
 
@@ -1358,6 +1434,15 @@ extern struct uip_conn *uip_conn;
 extern struct uip_conn uip_conns[UIP_TCP_CONNS];
 #endif
 
+/**
+ * Get the number of bytes that may still be sent on a connection
+ * before uIP has to wait for an acknowledgement.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ * \return The number of bytes that fit in the send window.
+ */
+uint16_t uip_tcp_send_room(const struct uip_conn *conn);
+
 /**
  * \addtogroup uiparch
  * @{
@@ -1379,6 +1464,10 @@ struct uip_udp_conn {
   uint8_t  ttl;          /**< Default time-to-live. */
   /** The application state. */
   uip_udp_appstate_t appstate;
+#if UIP_CONN_WITH_HASH
+  /** The next connection in the same port index bucket. */
+  struct uip_udp_conn *hash_next;
+#endif /* UIP_CONN_WITH_HASH */
 };
 
 /**
@@ -1440,6 +1529,10 @@ struct uip_stats {
                                checksum errors. */
     uip_stats_t protoerr; /**< Number of packets dropped because they
                                were neither ICMP, UDP nor TCP. */
+    uip_stats_t reassdrop; /**< Number of fragments dropped because all
+                                reassembly contexts were in use. */
+    uip_stats_t reasstimeout; /**< Number of packets whose reassembly
+                                   timed out. */
   } ip;                   /**< IP statistics. */
   struct {
     uip_stats_t recv;     /**< Number of received ICMP packets. */
@@ -74,6 +74,7 @@
 #include "sys/cc.h"
 #include "net/ipv6/uip.h"
 #include "net/ipv6/uip-arch.h"
+#include "net/ipv6/uip-chksum.h"
 #include "net/ipv6/uipopt.h"
 #include "net/ipv6/uip-icmp6.h"
 #include "net/ipv6/uip-nd6.h"
@@ -132,7 +133,7 @@ uint8_t uip_last_proto = 0;
  * \name Reassembly buffer definition
  * @{
  */
-#define FBUF                                ((struct uip_ip_hdr *)&uip_reassbuf[0])
+#define FBUF(ctx)                           ((struct uip_ip_hdr *)(ctx)->buf)
 
 /** @} */
 /**
@@ -217,6 +218,9 @@ static uint8_t iss[4];
 
 /* Temporary variables. */
 uint8_t uip_acc32[4];
+
+/* The number of bytes acknowledged by the incoming segment. */
+uint16_t uip_acked_len;
 #endif /* UIP_TCP */
 /** @} */
 
@@ -232,6 +236,36 @@ struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
 #endif /* UIP_UDP */
 /** @} */
 
+/*---------------------------------------------------------------------------*/
+/**
+ * \name Port index variables
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+#if UIP_CONN_WITH_HASH
+/* Connections are chained in buckets indexed by a hash of their local
+   port, in the order of the connection arrays, so that demultiplexing
+   finds the same connection as a scan of the whole array would. There
+   are at least as many buckets as connections, rounded up to a power
+   of two. */
+#define PORT_HASH_BITS(n) ((n) <= 4 ? 2 : (n) <= 16 ? 4 : (n) <= 64 ? 6 : 8)
+#define PORT_HASH(port, bits) ((uint16_t)((port) * 40503U) >> (16 - (bits)))
+
+#if UIP_UDP
+#define UDP_HASH_BITS PORT_HASH_BITS(UIP_UDP_CONNS)
+static struct uip_udp_conn *udp_hash[1 << UDP_HASH_BITS];
+/* Indices of the UDP connections that have no local port */
+static uint16_t udp_free[UIP_UDP_CONNS];
+static uint16_t udp_free_count;
+#endif /* UIP_UDP */
+
+#if UIP_TCP
+#define TCP_HASH_BITS PORT_HASH_BITS(UIP_TCP_CONNS)
+static struct uip_conn *tcp_hash[1 << TCP_HASH_BITS];
+#endif /* UIP_TCP */
+#endif /* UIP_CONN_WITH_HASH */
+/** @} */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \name ICMPv6 variables
@@ -278,41 +312,10 @@ uip_add32(uint8_t *op32, uint16_t op16)
 
 #if ! UIP_ARCH_CHKSUM
 /*---------------------------------------------------------------------------*/
-static uint16_t
-chksum(uint16_t sum, const uint8_t *data, uint16_t len)
-{
-  uint16_t t;
-  const uint8_t *dataptr;
-  const uint8_t *last_byte;
-
-  dataptr = data;
-  last_byte = data + len - 1;
-
-  while(dataptr < last_byte) {   /* At least two more bytes */
-    t = (dataptr[0] << 8) + dataptr[1];
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-    dataptr += 2;
-  }
-
-  if(dataptr == last_byte) {
-    t = (dataptr[0] << 8) + 0;
-    sum += t;
-    if(sum < t) {
-      sum++;      /* carry */
-    }
-  }
-
-  /* Return sum in host byte order. */
-  return sum;
-}
-/*---------------------------------------------------------------------------*/
 uint16_t
 uip_chksum(uint16_t *data, uint16_t len)
 {
-  return uip_htons(chksum(0, (uint8_t *)data, len));
+  return uip_htons(uip_chksum_add(0, (uint8_t *)data, len));
 }
 /*---------------------------------------------------------------------------*/
 #ifndef UIP_ARCH_IPCHKSUM
@@ -321,7 +324,7 @@ uip_ipchksum(void)
 {
   uint16_t sum;
 
-  sum = chksum(0, uip_buf, UIP_IPH_LEN);
+  sum = uip_chksum_add(0, uip_buf, UIP_IPH_LEN);
   LOG_DBG("uip_ipchksum: sum 0x%04x\n", sum);
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -351,10 +354,10 @@ upper_layer_chksum(uint8_t proto)
   /* IP protocol and length fields. This addition cannot carry. */
   sum = upper_layer_len + proto;
   /* Sum IP source and destination addresses. */
-  sum = chksum(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
+  sum = uip_chksum_add(sum, (uint8_t *)&UIP_IP_BUF->srcipaddr, 2 * sizeof(uip_ipaddr_t));
 
   /* Sum upper-layer header and data. */
-  sum = chksum(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
+  sum = uip_chksum_add(sum, UIP_IP_PAYLOAD(uip_ext_len), upper_layer_len);
 
   return (sum == 0) ? 0xffff : uip_htons(sum);
 }
@@ -383,6 +386,108 @@ uip_udpchksum(void)
 #endif /* UIP_UDP && UIP_UDP_CHECKSUMS */
 #endif /* UIP_ARCH_CHKSUM */
 /*---------------------------------------------------------------------------*/
+#if UIP_CONN_WITH_HASH && UIP_UDP
+static struct uip_udp_conn **
+udp_bucket(uint16_t lport)
+{
+  return &udp_hash[PORT_HASH(lport, UDP_HASH_BITS)];
+}
+/*---------------------------------------------------------------------------*/
+static void
+udp_hash_add(struct uip_udp_conn *conn)
+{
+  struct uip_udp_conn **l;
+
+  for(l = udp_bucket(conn->lport); *l != NULL && *l < conn;
+      l = &(*l)->hash_next);
+  conn->hash_next = *l;
+  *l = conn;
+}
+/*---------------------------------------------------------------------------*/
+static void
+udp_hash_remove(struct uip_udp_conn *conn)
+{
+  struct uip_udp_conn **l;
+
+  for(l = udp_bucket(conn->lport); *l != NULL; l = &(*l)->hash_next) {
+    if(*l == conn) {
+      *l = conn->hash_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+udp_port_in_use(uint16_t lport)
+{
+  struct uip_udp_conn *conn;
+
+  for(conn = *udp_bucket(lport); conn != NULL; conn = conn->hash_next) {
+    if(conn->lport == lport) {
+      return true;
+    }
+  }
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port)
+{
+  uint16_t i;
+
+  if(conn->lport == port) {
+    return;
+  }
+  if(conn->lport != 0) {
+    udp_hash_remove(conn);
+  } else {
+    /* A free connection is bound without going through uip_udp_new() */
+    for(i = 0; i < udp_free_count; i++) {
+      if(udp_free[i] == conn - uip_udp_conns) {
+        udp_free[i] = udp_free[--udp_free_count];
+        break;
+      }
+    }
+  }
+  conn->lport = port;
+  if(port != 0) {
+    udp_hash_add(conn);
+  } else {
+    udp_free[udp_free_count++] = conn - uip_udp_conns;
+  }
+}
+#endif /* UIP_CONN_WITH_HASH && UIP_UDP */
+/*---------------------------------------------------------------------------*/
+#if UIP_CONN_WITH_HASH && UIP_TCP
+static struct uip_conn **
+tcp_bucket(uint16_t lport)
+{
+  return &tcp_hash[PORT_HASH(lport, TCP_HASH_BITS)];
+}
+/*---------------------------------------------------------------------------*/
+/* TCP connections are closed in many places, so a connection stays in
+   the bucket of the last local port it was given, and lookups check
+   the connection state. */
+static void
+tcp_set_lport(struct uip_conn *conn, uint16_t port)
+{
+  struct uip_conn **l;
+
+  if(conn->lport != 0) {
+    for(l = tcp_bucket(conn->lport); *l != NULL; l = &(*l)->hash_next) {
+      if(*l == conn) {
+        *l = conn->hash_next;
+        break;
+      }
+    }
+  }
+  conn->lport = port;
+  for(l = tcp_bucket(port); *l != NULL && *l < conn; l = &(*l)->hash_next);
+  conn->hash_next = *l;
+  *l = conn;
+}
+#endif /* UIP_CONN_WITH_HASH && UIP_TCP */
+/*---------------------------------------------------------------------------*/
 void
 uip_init(void)
 {
@@ -399,7 +504,13 @@ uip_init(void)
   }
   for(c = 0; c < UIP_TCP_CONNS; ++c) {
     uip_conns[c].tcpstateflags = UIP_CLOSED;
+#if UIP_CONN_WITH_HASH
+    uip_conns[c].lport = 0;
+#endif /* UIP_CONN_WITH_HASH */
   }
+#if UIP_CONN_WITH_HASH
+  memset(tcp_hash, 0, sizeof(tcp_hash));
+#endif /* UIP_CONN_WITH_HASH */
 #endif /* UIP_TCP */
 
 #if UIP_ACTIVE_OPEN || UIP_UDP
@@ -410,6 +521,14 @@ uip_init(void)
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     uip_udp_conns[c].lport = 0;
   }
+#if UIP_CONN_WITH_HASH
+  memset(udp_hash, 0, sizeof(udp_hash));
+  /* The lowest indices are handed out first, as without the index */
+  for(c = 0; c < UIP_UDP_CONNS; ++c) {
+    udp_free[c] = UIP_UDP_CONNS - 1 - c;
+  }
+  udp_free_count = UIP_UDP_CONNS;
+#endif /* UIP_CONN_WITH_HASH */
 #endif /* UIP_UDP */
 
 #if UIP_IPV6_MULTICAST
@@ -434,8 +553,13 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
 
   /* Check if this port is already in use, and if so try to find
      another one. */
+#if UIP_CONN_WITH_HASH
+  for(conn = *tcp_bucket(uip_htons(lastport)); conn != NULL;
+      conn = conn->hash_next) {
+#else /* UIP_CONN_WITH_HASH */
   for(c = 0; c < UIP_TCP_CONNS; ++c) {
     conn = &uip_conns[c];
+#endif /* UIP_CONN_WITH_HASH */
     if(conn->tcpstateflags != UIP_CLOSED &&
        conn->lport == uip_htons(lastport)) {
       goto again;
@@ -481,7 +605,17 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
   conn->rto = UIP_RTO;
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
+#if UIP_TCP_SEND_WINDOW > 1
+  conn->snd_wnd = 0;
+  conn->rtt_timing = 0;
+  conn->snd_max = 0;
+  conn->close_pending = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+#if UIP_CONN_WITH_HASH
+  tcp_set_lport(conn, uip_htons(lastport));
+#else /* UIP_CONN_WITH_HASH */
   conn->lport = uip_htons(lastport);
+#endif /* UIP_CONN_WITH_HASH */
   conn->rport = rport;
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
 
@@ -521,7 +655,9 @@ uip_remove_ext_hdr(void)
 struct uip_udp_conn *
 uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
 {
+#if !UIP_CONN_WITH_HASH
   int c;
+#endif /* !UIP_CONN_WITH_HASH */
   register struct uip_udp_conn *conn;
 
   /* Find an unused local port. */
@@ -532,6 +668,18 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     lastport = 4096;
   }
 
+#if UIP_CONN_WITH_HASH
+  if(udp_port_in_use(uip_htons(lastport))) {
+    goto again;
+  }
+
+  if(udp_free_count == 0) {
+    return 0;
+  }
+  conn = &uip_udp_conns[udp_free[--udp_free_count]];
+  conn->lport = UIP_HTONS(lastport);
+  udp_hash_add(conn);
+#else /* UIP_CONN_WITH_HASH */
   for(c = 0; c < UIP_UDP_CONNS; ++c) {
     if(uip_udp_conns[c].lport == uip_htons(lastport)) {
       goto again;
@@ -551,6 +699,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
   }
 
   conn->lport = UIP_HTONS(lastport);
+#endif /* UIP_CONN_WITH_HASH */
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -593,20 +742,33 @@ uip_listen(uint16_t port)
 #if UIP_CONF_IPV6_REASSEMBLY
 #define UIP_REASS_BUFSIZE (UIP_BUFSIZE)
 
-static uint8_t uip_reassbuf[UIP_REASS_BUFSIZE];
-
-static uint8_t uip_reassbitmap[UIP_REASS_BUFSIZE / (8 * 8)];
 /*the first byte of an IP fragment is aligned on an 8-byte boundary */
-
 static const uint8_t bitmap_bits[8] = {0xff, 0x7f, 0x3f, 0x1f,
                                     0x0f, 0x07, 0x03, 0x01};
-static uint16_t uip_reasslen;
-static uint8_t uip_reassflags;
 
 #define UIP_REASS_FLAG_LASTFRAG 0x01
 #define UIP_REASS_FLAG_FIRSTFRAG 0x02
-#define UIP_REASS_FLAG_ERROR_MSG 0x04
+#define UIP_REASS_FLAG_INUSE 0x04
+
+/* A packet being reassembled, identified by its source and destination
+   addresses (kept in the header at the start of buf) and by the
+   Identification of its fragments */
+struct uip_reass_ctx {
+  uint8_t buf[UIP_REASS_BUFSIZE];
+  /* One bit per 8 bytes, plus room for the bit after a full buffer */
+  uint8_t bitmap[UIP_REASS_BUFSIZE / (8 * 8) + 1];
+  struct timer timer;
+  uint32_t id;
+  uint16_t len;
+  /* Length of the extension headers before the Fragment header */
+  uint16_t hdr_len;
+  uint8_t flags;
+};
+
+static struct uip_reass_ctx uip_reass_ctxs[UIP_REASS_CONTEXTS];
 
+/* Set when uip_reass() leaves an ICMPv6 error message in uip_buf */
+static bool uip_reass_error_msg;
 
 /*
  * See RFC 2460 for a description of fragmentation in IPv6
@@ -618,168 +780,250 @@ static uint8_t uip_reassflags;
  */
 
 
+/* Expires when the oldest packet being reassembled times out */
 struct etimer uip_reass_timer; /**< Timer for reassembly */
-uint8_t uip_reass_on; /* equal to 1 if we are currently reassembling a packet */
 
-static uint32_t uip_id; /* For every packet that is to be fragmented, the source
-                        node generates an Identification value that is present
-                        in all the fragments */
 #define IP_MF   0x0001
 
+/*---------------------------------------------------------------------------*/
+/* Set uip_reass_timer to the earliest timeout of the contexts in use.
+   The timer belongs to tcpip_process, whichever process the fragment
+   arrived in. */
+static void
+uip_reass_set_timer(void)
+{
+  struct uip_reass_ctx *ctx;
+  clock_time_t next;
+  clock_time_t remaining;
+  bool active;
+
+  active = false;
+  next = 0;
+  for(ctx = uip_reass_ctxs; ctx < &uip_reass_ctxs[UIP_REASS_CONTEXTS]; ctx++) {
+    if(ctx->flags & UIP_REASS_FLAG_INUSE) {
+      remaining = timer_expired(&ctx->timer) ? 0 : timer_remaining(&ctx->timer);
+      if(!active || remaining < next) {
+        next = remaining;
+      }
+      active = true;
+    }
+  }
+
+  if(!active) {
+    etimer_stop(&uip_reass_timer);
+    return;
+  }
+  PROCESS_CONTEXT_BEGIN(&tcpip_process);
+  etimer_set(&uip_reass_timer, next);
+  PROCESS_CONTEXT_END(&tcpip_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+uip_reass_free(struct uip_reass_ctx *ctx)
+{
+  ctx->flags = 0;
+  uip_reass_set_timer();
+}
+/*---------------------------------------------------------------------------*/
+/* Find the context of the packet that the fragment in uip_buf belongs
+   to, or start a new one */
+static struct uip_reass_ctx *
+uip_reass_lookup(const struct uip_frag_hdr *frag_buf, uint16_t hdr_len)
+{
+  struct uip_reass_ctx *ctx;
+  struct uip_reass_ctx *free_ctx;
+
+  free_ctx = NULL;
+  for(ctx = uip_reass_ctxs; ctx < &uip_reass_ctxs[UIP_REASS_CONTEXTS]; ctx++) {
+    if(!(ctx->flags & UIP_REASS_FLAG_INUSE)) {
+      if(free_ctx == NULL) {
+        free_ctx = ctx;
+      }
+    } else if(ctx->id == frag_buf->id &&
+              uip_ipaddr_cmp(&FBUF(ctx)->srcipaddr, &UIP_IP_BUF->srcipaddr) &&
+              uip_ipaddr_cmp(&FBUF(ctx)->destipaddr, &UIP_IP_BUF->destipaddr)) {
+      return ctx;
+    }
+  }
+
+  if(free_ctx == NULL) {
+    return NULL;
+  }
+
+  /* We first write the unfragmentable part of IP header into the
+     reassembly buffer. Then reset the other reassembly variables. */
+  LOG_INFO("Starting reassembly\n");
+  ctx = free_ctx;
+  memcpy(FBUF(ctx), UIP_IP_BUF, hdr_len + UIP_IPH_LEN);
+  /* temporary in case we do not receive the fragment with offset 0 first */
+  timer_set(&ctx->timer, UIP_REASS_MAXAGE * CLOCK_SECOND);
+  ctx->flags = UIP_REASS_FLAG_INUSE;
+  ctx->id = frag_buf->id;
+  ctx->hdr_len = hdr_len;
+  /* Clear the bitmap. */
+  memset(ctx->bitmap, 0, sizeof(ctx->bitmap));
+  uip_reass_set_timer();
+  return ctx;
+}
+/*---------------------------------------------------------------------------*/
 static uint16_t
-uip_reass(uint8_t *prev_proto_ptr)
+uip_reass(struct uip_frag_hdr *frag_buf)
 {
   uint16_t offset=0;
   uint16_t len;
   uint16_t i;
-  struct uip_frag_hdr *frag_buf = (struct uip_frag_hdr *)UIP_IP_PAYLOAD(uip_ext_len);
-
-  /* If ip_reasstmr is zero, no packet is present in the buffer */
-  /* We first write the unfragmentable part of IP header into the reassembly
-     buffer. The reset the other reassembly variables. */
-  if(uip_reass_on == 0) {
-    LOG_INFO("Starting reassembly\n");
-    memcpy(FBUF, UIP_IP_BUF, uip_ext_len + UIP_IPH_LEN);
-    /* temporary in case we do not receive the fragment with offset 0 first */
-    etimer_set(&uip_reass_timer, UIP_REASS_MAXAGE*CLOCK_SECOND);
-    uip_reass_on = 1;
-    uip_reassflags = 0;
-    uip_id = frag_buf->id;
-    /* Clear the bitmap. */
-    memset(uip_reassbitmap, 0, sizeof(uip_reassbitmap));
+  /* The unfragmentable part is the IPv6 header and the extension
+     headers that precede the Fragment header */
+  uint16_t hdr_len = (uint8_t *)frag_buf - UIP_IP_PAYLOAD(0);
+  uint8_t *hdr;
+  uint8_t *prev_proto_ptr;
+  struct uip_reass_ctx *ctx;
+
+  uip_reass_error_msg = false;
+
+  ctx = uip_reass_lookup(frag_buf, hdr_len);
+  if(ctx == NULL) {
+    LOG_WARN("No free reassembly context, dropping fragment\n");
+    UIP_STAT(++uip_stat.ip.reassdrop);
+    return 0;
+  }
+  if(ctx->hdr_len != hdr_len) {
+    LOG_WARN("Unfragmentable part changed, dropping fragment\n");
+    return 0;
   }
-  /*
-   * Check if the incoming fragment matches the one currently present
-   * in the reasembly buffer. If so, we proceed with copying the fragment
-   * into the buffer.
-   */
-  if(uip_ipaddr_cmp(&FBUF->srcipaddr, &UIP_IP_BUF->srcipaddr) &&
-     uip_ipaddr_cmp(&FBUF->destipaddr, &UIP_IP_BUF->destipaddr) &&
-     frag_buf->id == uip_id) {
-    len = uip_len - uip_ext_len - UIP_IPH_LEN - UIP_FRAGH_LEN;
-    offset = (uip_ntohs(frag_buf->offsetresmore) & 0xfff8);
-    /* in byte, originaly in multiple of 8 bytes*/
-    LOG_INFO("len %d\n", len);
-    LOG_INFO("offset %d\n", offset);
-    if(offset == 0){
-      uip_reassflags |= UIP_REASS_FLAG_FIRSTFRAG;
-      /*
-       * The Next Header field of the last header of the Unfragmentable
-       * Part is obtained from the Next Header field of the first
-       * fragment's Fragment header.
-       */
-      *prev_proto_ptr = frag_buf->next;
-      memcpy(FBUF, UIP_IP_BUF, uip_ext_len + UIP_IPH_LEN);
-      LOG_INFO("src ");
-      LOG_INFO_6ADDR(&FBUF->srcipaddr);
-      LOG_INFO_("dest ");
-      LOG_INFO_6ADDR(&FBUF->destipaddr);
-      LOG_INFO_("next %d\n", UIP_IP_BUF->proto);
 
+  len = uip_len - hdr_len - UIP_IPH_LEN - UIP_FRAGH_LEN;
+  offset = (uip_ntohs(frag_buf->offsetresmore) & 0xfff8);
+  /* in byte, originaly in multiple of 8 bytes*/
+  LOG_INFO("len %d\n", len);
+  LOG_INFO("offset %d\n", offset);
+  if(offset == 0){
+    ctx->flags |= UIP_REASS_FLAG_FIRSTFRAG;
+    memcpy(FBUF(ctx), UIP_IP_BUF, hdr_len + UIP_IPH_LEN);
+    /*
+     * The Next Header field of the last header of the Unfragmentable
+     * Part is obtained from the Next Header field of the first
+     * fragment's Fragment header.
+     */
+    prev_proto_ptr = &FBUF(ctx)->proto;
+    for(hdr = (uint8_t *)FBUF(ctx) + UIP_IPH_LEN;
+        hdr < (uint8_t *)FBUF(ctx) + UIP_IPH_LEN + hdr_len;
+        hdr += (((struct uip_ext_hdr *)hdr)->len << 3) + 8) {
+      prev_proto_ptr = &((struct uip_ext_hdr *)hdr)->next;
     }
+    *prev_proto_ptr = frag_buf->next;
+    LOG_INFO("src ");
+    LOG_INFO_6ADDR(&FBUF(ctx)->srcipaddr);
+    LOG_INFO_("dest ");
+    LOG_INFO_6ADDR(&FBUF(ctx)->destipaddr);
+    LOG_INFO_("next %d\n", UIP_IP_BUF->proto);
 
-    /* If the offset or the offset + fragment length overflows the
-       reassembly buffer, we discard the entire packet. */
-    if(offset > UIP_REASS_BUFSIZE ||
-       offset + len > UIP_REASS_BUFSIZE) {
-      uip_reass_on = 0;
-      etimer_stop(&uip_reass_timer);
-      return 0;
-    }
+  }
 
-    /* If this fragment has the More Fragments flag set to zero, it is the
-       last fragment*/
-    if((uip_ntohs(frag_buf->offsetresmore) & IP_MF) == 0) {
-      uip_reassflags |= UIP_REASS_FLAG_LASTFRAG;
-      /*calculate the size of the entire packet*/
-      uip_reasslen = offset + len;
-      LOG_INFO("last fragment reasslen %d\n", uip_reasslen);
-    } else {
-      /* If len is not a multiple of 8 octets and the M flag of that fragment
-         is 1, then that fragment must be discarded and an ICMP Parameter
-         Problem, Code 0, message should be sent to the source of the fragment,
-         pointing to the Payload Length field of the fragment packet. */
-      if(len % 8 != 0){
-        uip_icmp6_error_output(ICMP6_PARAM_PROB, ICMP6_PARAMPROB_HEADER, 4);
-        uip_reassflags |= UIP_REASS_FLAG_ERROR_MSG;
-        /* not clear if we should interrupt reassembly, but it seems so from
-           the conformance tests */
-        uip_reass_on = 0;
-        etimer_stop(&uip_reass_timer);
-        return uip_len;
-      }
+  /* If the offset or the offset + fragment length overflows the
+     reassembly buffer, we discard the entire packet. */
+  if(offset > UIP_REASS_BUFSIZE - UIP_IPH_LEN - hdr_len ||
+     offset + len > UIP_REASS_BUFSIZE - UIP_IPH_LEN - hdr_len) {
+    uip_reass_free(ctx);
+    return 0;
+  }
+
+  /* If this fragment has the More Fragments flag set to zero, it is the
+     last fragment*/
+  if((uip_ntohs(frag_buf->offsetresmore) & IP_MF) == 0) {
+    ctx->flags |= UIP_REASS_FLAG_LASTFRAG;
+    /*calculate the size of the entire packet*/
+    ctx->len = offset + len;
+    LOG_INFO("last fragment reasslen %d\n", ctx->len);
+  } else {
+    /* If len is not a multiple of 8 octets and the M flag of that fragment
+       is 1, then that fragment must be discarded and an ICMP Parameter
+       Problem, Code 0, message should be sent to the source of the fragment,
+       pointing to the Payload Length field of the fragment packet. */
+    if(len % 8 != 0){
+      uip_icmp6_error_output(ICMP6_PARAM_PROB, ICMP6_PARAMPROB_HEADER, 4);
+      uip_reass_error_msg = true;
+      /* not clear if we should interrupt reassembly, but it seems so from
+         the conformance tests */
+      uip_reass_free(ctx);
+      return uip_len;
     }
+  }
 
-    /* Copy the fragment into the reassembly buffer, at the right
-       offset. */
-    memcpy((uint8_t *)FBUF + UIP_IPH_LEN + uip_ext_len + offset,
-           (uint8_t *)frag_buf + UIP_FRAGH_LEN, len);
+  /* Copy the fragment into the reassembly buffer, at the right
+     offset. */
+  memcpy((uint8_t *)FBUF(ctx) + UIP_IPH_LEN + hdr_len + offset,
+         (uint8_t *)frag_buf + UIP_FRAGH_LEN, len);
 
-    /* Update the bitmap. */
-    if(offset >> 6 == (offset + len) >> 6) {
-      uip_reassbitmap[offset >> 6] |=
-        bitmap_bits[(offset >> 3) & 7] &
-        ~bitmap_bits[((offset + len) >> 3)  & 7];
-    } else {
-      /* If the two endpoints are in different bytes, we update the
-         bytes in the endpoints and fill the stuff inbetween with
-         0xff. */
-      uip_reassbitmap[offset >> 6] |= bitmap_bits[(offset >> 3) & 7];
+  /* Update the bitmap. */
+  if(offset >> 6 == (offset + len) >> 6) {
+    ctx->bitmap[offset >> 6] |=
+      bitmap_bits[(offset >> 3) & 7] &
+      ~bitmap_bits[((offset + len) >> 3)  & 7];
+  } else {
+    /* If the two endpoints are in different bytes, we update the
+       bytes in the endpoints and fill the stuff inbetween with
+       0xff. */
+    ctx->bitmap[offset >> 6] |= bitmap_bits[(offset >> 3) & 7];
 
-      for(i = (1 + (offset >> 6)); i < ((offset + len) >> 6); ++i) {
-        uip_reassbitmap[i] = 0xff;
-      }
-      uip_reassbitmap[(offset + len) >> 6] |=
-        ~bitmap_bits[((offset + len) >> 3) & 7];
+    for(i = (1 + (offset >> 6)); i < ((offset + len) >> 6); ++i) {
+      ctx->bitmap[i] = 0xff;
     }
+    ctx->bitmap[(offset + len) >> 6] |=
+      ~bitmap_bits[((offset + len) >> 3) & 7];
+  }
 
-    /* Finally, we check if we have a full packet in the buffer. We do
-       this by checking if we have the last fragment and if all bits
-       in the bitmap are set. */
+  /* Finally, we check if we have a full packet in the buffer. We do
+     this by checking if we have the last fragment and if all bits
+     in the bitmap are set. */
 
-    if(uip_reassflags & UIP_REASS_FLAG_LASTFRAG) {
-      /* Check all bytes up to and including all but the last byte in
-         the bitmap. */
-      for(i = 0; i < (uip_reasslen >> 6); ++i) {
-        if(uip_reassbitmap[i] != 0xff) {
-          return 0;
-        }
-      }
-      /* Check the last byte in the bitmap. It should contain just the
-         right amount of bits. */
-      if(uip_reassbitmap[uip_reasslen >> 6] !=
-         (uint8_t)~bitmap_bits[(uip_reasslen >> 3) & 7]) {
+  if(ctx->flags & UIP_REASS_FLAG_LASTFRAG) {
+    /* Check all bytes up to and including all but the last byte in
+       the bitmap. */
+    for(i = 0; i < (ctx->len >> 6); ++i) {
+      if(ctx->bitmap[i] != 0xff) {
         return 0;
       }
+    }
+    /* Check the last byte in the bitmap. It should contain just the
+       right amount of bits. */
+    if(ctx->bitmap[ctx->len >> 6] !=
+       (uint8_t)~bitmap_bits[(ctx->len >> 3) & 7]) {
+      return 0;
+    }
 
-      /* If we have come this far, we have a full packet in the
-         buffer, so we copy it to uip_buf. We also reset the timer. */
-      uip_reass_on = 0;
-      etimer_stop(&uip_reass_timer);
-
-      uip_reasslen += UIP_IPH_LEN + uip_ext_len;
-      memcpy(UIP_IP_BUF, FBUF, uip_reasslen);
-      uipbuf_set_len_field(UIP_IP_BUF, uip_reasslen - UIP_IPH_LEN);
-      LOG_INFO("reassembled packet %d (%d)\n", uip_reasslen, uipbuf_get_len_field(UIP_IP_BUF));
-
-      return uip_reasslen;
+    /* If we have come this far, we have a full packet in the
+       buffer, so we copy it to uip_buf. We also free the context. */
+    len = ctx->len + UIP_IPH_LEN + hdr_len;
+    memcpy(UIP_IP_BUF, FBUF(ctx), len);
+    uipbuf_set_len_field(UIP_IP_BUF, len - UIP_IPH_LEN);
+    uip_reass_free(ctx);
+    LOG_INFO("reassembled packet %d (%d)\n", len, uipbuf_get_len_field(UIP_IP_BUF));
 
-    }
-  } else {
-    LOG_WARN("Already reassembling another paquet\n");
+    return len;
   }
   return 0;
 }
-
+/*---------------------------------------------------------------------------*/
 void
 uip_reass_over(void)
 {
-  /* to late, we abandon the reassembly of the packet */
+  struct uip_reass_ctx *ctx;
+
+  for(ctx = uip_reass_ctxs; ctx < &uip_reass_ctxs[UIP_REASS_CONTEXTS]; ctx++) {
+    if((ctx->flags & UIP_REASS_FLAG_INUSE) && timer_expired(&ctx->timer)) {
+      break;
+    }
+  }
+  if(ctx == &uip_reass_ctxs[UIP_REASS_CONTEXTS]) {
+    uip_reass_set_timer();
+    return;
+  }
 
-  uip_reass_on = 0;
-  etimer_stop(&uip_reass_timer);
+  /* to late, we abandon the reassembly of the packet */
+  UIP_STAT(++uip_stat.ip.reasstimeout);
 
-  if(uip_reassflags & UIP_REASS_FLAG_FIRSTFRAG){
+  if(ctx->flags & UIP_REASS_FLAG_FIRSTFRAG){
     LOG_ERR("fragmentation timeout\n");
     /* If the first fragment has been received, an ICMP Time Exceeded
        -- Fragment Reassembly Time Exceeded message should be sent to the
@@ -791,13 +1035,15 @@ uip_reass_over(void)
      * the packet.
      */
     uipbuf_clear();
-    memcpy(UIP_IP_BUF, FBUF, UIP_IPH_LEN); /* copy the header for src
-                                              and dest address*/
+    memcpy(UIP_IP_BUF, FBUF(ctx), UIP_IPH_LEN); /* copy the header for src
+                                                   and dest address*/
     uip_icmp6_error_output(ICMP6_TIME_EXCEEDED, ICMP6_TIME_EXCEED_REASSEMBLY, 0);
 
     UIP_STAT(++uip_stat.ip.sent);
     uip_flags = 0;
   }
+
+  uip_reass_free(ctx);
 }
 
 #endif /* UIP_CONF_IPV6_REASSEMBLY */
@@ -813,6 +1059,51 @@ uip_add_rcv_nxt(uint16_t n)
   uip_conn->rcv_nxt[2] = uip_acc32[2];
   uip_conn->rcv_nxt[3] = uip_acc32[3];
 }
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP_SEND_WINDOW > 1
+/* Returns a - b for two TCP sequence numbers in network byte order. */
+static uint32_t
+tcp_seq_diff(const uint8_t *a, const uint8_t *b)
+{
+  return (((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) |
+          ((uint32_t)a[2] << 8) | a[3]) -
+         (((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) |
+          ((uint32_t)b[2] << 8) | b[3]);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the length of the data in flight. After a retransmission
+   time-out, this includes the data that has not been sent again yet
+   but may still be acknowledged by the remote host. */
+static uint16_t
+tcp_in_flight(const struct uip_conn *conn)
+{
+  return conn->len > conn->snd_max ? conn->len : conn->snd_max;
+}
+#else /* UIP_TCP_SEND_WINDOW > 1 */
+#define tcp_in_flight(conn) uip_outstanding(conn)
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+/*---------------------------------------------------------------------------*/
+uint16_t
+uip_tcp_send_room(const struct uip_conn *conn)
+{
+#if UIP_TCP_SEND_WINDOW > 1
+  uint32_t limit;
+
+  limit = (uint32_t)UIP_TCP_SEND_WINDOW * conn->initialmss;
+  if(conn->snd_wnd < limit) {
+    limit = conn->snd_wnd;
+  }
+  if(limit == 0 && conn->len == 0) {
+    /* The peer advertises a zero window: allow a single segment to
+       probe the window, which is then retransmitted until the window
+       opens up. */
+    limit = conn->mss;
+  }
+  return limit > conn->len ? limit - conn->len : 0;
+#else /* UIP_TCP_SEND_WINDOW > 1 */
+  return conn->len == 0 ? conn->mss : 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+}
 #endif
 /*---------------------------------------------------------------------------*/
 
@@ -969,7 +1260,8 @@ uip_process(uint8_t flag)
   if(flag == UIP_POLL_REQUEST) {
 #if UIP_TCP
     if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
-       !uip_outstanding(uip_connr)) {
+       uip_tcp_send_room(uip_connr) > 0) {
+      uip_slen = 0;
       uip_flags = UIP_POLL;
       UIP_APPCALL();
       goto appsend;
@@ -1016,7 +1308,7 @@ uip_process(uint8_t flag)
        * connection's timer and see if it has reached the RTO value
        * in which case we retransmit.
        */
-      if(uip_outstanding(uip_connr)) {
+      if(tcp_in_flight(uip_connr)) {
         if(uip_connr->timer-- == 0) {
           if(uip_connr->nrtx == UIP_MAXRTX ||
              ((uip_connr->tcpstateflags == UIP_SYN_SENT ||
@@ -1071,6 +1363,16 @@ uip_process(uint8_t flag)
              * the code for sending out the packet (the apprexmit
              * label).
              */
+#if UIP_TCP_SEND_WINDOW > 1
+            /*
+             * All outstanding data is considered lost: the
+             * application sends again starting from the oldest
+             * unacknowledged byte, and the rest of the window is
+             * refilled as the acknowledgements come in.
+             */
+            uip_connr->len = 0;
+            uip_connr->rtt_timing = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
             uip_flags = UIP_REXMIT;
             UIP_APPCALL();
             goto apprexmit;
@@ -1082,6 +1384,16 @@ uip_process(uint8_t flag)
             goto tcp_send_finack;
           }
         }
+#if UIP_TCP_SEND_WINDOW > 1
+        if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
+           uip_tcp_send_room(uip_connr) > 0) {
+          /* There is room in the send window: poll the application
+             for more data. */
+          uip_flags = UIP_POLL;
+          UIP_APPCALL();
+          goto appsend;
+        }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
       } else if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
         /*
          * If there was no need for a retransmission, we poll the
@@ -1286,6 +1598,9 @@ uip_process(uint8_t flag)
 #endif /* UIP_IPV6_MULTICAST && UIP_CONF_ROUTER */
 
   /* IPv6 extension header processing: loop until reaching upper-layer protocol */
+#if UIP_CONF_IPV6_REASSEMBLY
+  ext_hdr_process:
+#endif /* UIP_CONF_IPV6_REASSEMBLY */
   uip_ext_bitmap = 0;
   for(next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
       next_header != NULL && uip_is_proto_ext_hdr(protocol);
@@ -1384,19 +1699,23 @@ uip_process(uint8_t flag)
       /* Fragmentation header:call the reassembly function, then leave */
 #if UIP_CONF_IPV6_REASSEMBLY
       LOG_INFO("Processing fragmentation header\n");
-      uip_len = uip_reass(&ext_ptr->next);
+      uip_len = uip_reass((struct uip_frag_hdr *)ext_ptr);
       if(uip_len == 0) {
         goto drop;
       }
-      if(uip_reassflags & UIP_REASS_FLAG_ERROR_MSG) {
+      if(uip_reass_error_msg) {
         /* we are not done with reassembly, this is an error message */
         goto send;
       }
       /* packet is reassembled. Restart the parsing of the reassembled pkt */
       LOG_INFO("Processing reassembled packet\n");
-      uip_ext_bitmap = 0;
-      next_header = uipbuf_get_next_header(uip_buf, uip_len, &protocol, true);
-      break;
+      last_header = uipbuf_get_last_header(uip_buf, uip_len, &uip_last_proto);
+      if(last_header == NULL) {
+        LOG_ERR("invalid extension header chain\n");
+        goto drop;
+      }
+      uip_ext_len = last_header - UIP_IP_PAYLOAD(0);
+      goto ext_hdr_process;
 #else /* UIP_CONF_IPV6_REASSEMBLY */
       UIP_STAT(++uip_stat.ip.drop);
       UIP_STAT(++uip_stat.ip.fragerr);
@@ -1523,9 +1842,15 @@ uip_process(uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
+#if UIP_CONN_WITH_HASH
+  for(uip_udp_conn = *udp_bucket(UIP_UDP_BUF->destport);
+      uip_udp_conn != NULL;
+      uip_udp_conn = uip_udp_conn->hash_next) {
+#else /* UIP_CONN_WITH_HASH */
   for(uip_udp_conn = &uip_udp_conns[0];
       uip_udp_conn < &uip_udp_conns[UIP_UDP_CONNS];
       ++uip_udp_conn) {
+#endif /* UIP_CONN_WITH_HASH */
     /* If the local UDP port is non-zero, the connection is considered
        to be used. If so, the local port number is checked against the
        destination port number in the received packet. If the two port
@@ -1627,8 +1952,13 @@ uip_process(uint8_t flag)
 
   /* Demultiplex this segment. */
   /* First check any active connections. */
+#if UIP_CONN_WITH_HASH
+  for(uip_connr = *tcp_bucket(UIP_TCP_BUF->destport); uip_connr != NULL;
+      uip_connr = uip_connr->hash_next) {
+#else /* UIP_CONN_WITH_HASH */
   for(uip_connr = &uip_conns[0]; uip_connr <= &uip_conns[UIP_TCP_CONNS - 1];
       ++uip_connr) {
+#endif /* UIP_CONN_WITH_HASH */
     if(uip_connr->tcpstateflags != UIP_CLOSED &&
        UIP_TCP_BUF->destport == uip_connr->lport &&
        UIP_TCP_BUF->srcport == uip_connr->rport &&
@@ -1748,7 +2078,17 @@ uip_process(uint8_t flag)
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
+#if UIP_TCP_SEND_WINDOW > 1
+  uip_connr->snd_wnd = 0;
+  uip_connr->rtt_timing = 0;
+  uip_connr->snd_max = 0;
+  uip_connr->close_pending = 0;
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
+#if UIP_CONN_WITH_HASH
+  tcp_set_lport(uip_connr, UIP_TCP_BUF->destport);
+#else /* UIP_CONN_WITH_HASH */
   uip_connr->lport = UIP_TCP_BUF->destport;
+#endif /* UIP_CONN_WITH_HASH */
   uip_connr->rport = UIP_TCP_BUF->srcport;
   uip_ipaddr_copy(&uip_connr->ripaddr, &UIP_IP_BUF->srcipaddr);
   uip_connr->tcpstateflags = UIP_SYN_RCVD;
@@ -1886,6 +2226,55 @@ uip_process(uint8_t flag)
      data. If so, we update the sequence number, reset the length of
      the outstanding data, calculate RTT estimations, and reset the
      retransmission timer. */
+#if UIP_TCP_SEND_WINDOW > 1
+  if(UIP_TCP_BUF->flags & TCP_ACK) {
+    uip_connr->snd_wnd = ((uint16_t)UIP_TCP_BUF->wnd[0] << 8) +
+      (uint16_t)UIP_TCP_BUF->wnd[1];
+  }
+
+  /* With several segments in flight, ACKs are cumulative: any
+     acknowledgement that covers part of the outstanding data moves
+     snd_nxt, the oldest unacknowledged sequence number, forward. The
+     data sent before a retransmission time-out counts as well, as the
+     remote host may have received it after all. */
+  if((UIP_TCP_BUF->flags & TCP_ACK) && tcp_in_flight(uip_connr) > 0) {
+    uint32_t acked;
+
+    acked = tcp_seq_diff(UIP_TCP_BUF->ackno, uip_connr->snd_nxt);
+    if(acked > 0 && acked <= tcp_in_flight(uip_connr)) {
+      uip_add32(uip_connr->snd_nxt, (uint16_t)acked);
+      uip_connr->snd_nxt[0] = uip_acc32[0];
+      uip_connr->snd_nxt[1] = uip_acc32[1];
+      uip_connr->snd_nxt[2] = uip_acc32[2];
+      uip_connr->snd_nxt[3] = uip_acc32[3];
+
+      /* Only the first segment of a flight is timed, as the timer is
+         restarted by every ACK that acknowledges new data. */
+      if(uip_connr->nrtx == 0 && uip_connr->rtt_timing) {
+        signed char m;
+        m = uip_connr->rto - uip_connr->timer;
+        m = m - (uip_connr->sa >> 3);
+        uip_connr->sa += m;
+        if(m < 0) {
+          m = -m;
+        }
+        m = m - (uip_connr->sv >> 2);
+        uip_connr->sv += m;
+        uip_connr->rto = (uip_connr->sa >> 3) + uip_connr->sv;
+      }
+      uip_connr->rtt_timing = 0;
+      uip_connr->nrtx = 0;
+
+      uip_flags = UIP_ACKDATA;
+      uip_connr->timer = uip_connr->rto;
+      uip_acked_len = (uint16_t)acked;
+      uip_connr->len = uip_connr->len > uip_acked_len ?
+        uip_connr->len - uip_acked_len : 0;
+      uip_connr->snd_max = uip_connr->snd_max > uip_acked_len ?
+        uip_connr->snd_max - uip_acked_len : 0;
+    }
+  }
+#else /* UIP_TCP_SEND_WINDOW > 1 */
   if((UIP_TCP_BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
     uip_add32(uip_connr->snd_nxt, uip_connr->len);
 
@@ -1920,10 +2309,12 @@ uip_process(uint8_t flag)
       uip_connr->timer = uip_connr->rto;
 
       /* Reset length of outstanding data. */
+      uip_acked_len = uip_connr->len;
       uip_connr->len = 0;
     }
 
   }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 
   /* Do different things depending on in what state the connection is. */
   switch(uip_connr->tcpstateflags & UIP_TS_MASK) {
@@ -2028,7 +2419,7 @@ uip_process(uint8_t flag)
          sequence numbers will be screwed up. */
 
     if(UIP_TCP_BUF->flags & TCP_FIN && !(uip_connr->tcpstateflags & UIP_STOPPED)) {
-      if(uip_outstanding(uip_connr)) {
+      if(tcp_in_flight(uip_connr)) {
         goto drop;
       }
       uip_add_rcv_nxt(1 + uip_len);
@@ -2128,7 +2519,16 @@ uip_process(uint8_t flag)
         goto tcp_send_nodata;
       }
 
+#if UIP_TCP_SEND_WINDOW > 1
+      /* The FIN follows the data in flight, so it is sent only once
+         all of that data has been acknowledged. */
       if(uip_flags & UIP_CLOSE) {
+        uip_connr->close_pending = 1;
+      }
+      if(uip_connr->close_pending && tcp_in_flight(uip_connr) == 0) {
+#else /* UIP_TCP_SEND_WINDOW > 1 */
+      if(uip_flags & UIP_CLOSE) {
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
         uip_slen = 0;
         uip_connr->len = 1;
         uip_connr->tcpstateflags = UIP_FIN_WAIT_1;
@@ -2137,6 +2537,43 @@ uip_process(uint8_t flag)
         goto tcp_send_nodata;
       }
 
+#if UIP_TCP_SEND_WINDOW > 1
+      apprexmit:
+      uip_appdata = uip_sappdata;
+
+      /* The application may send as much as fits in the send window,
+           up to one MSS per segment. The new segment is placed after
+           the data that is already in flight. */
+      if(uip_slen > 0) {
+        if(uip_slen > uip_connr->mss) {
+          uip_slen = uip_connr->mss;
+        }
+        tmp16 = uip_tcp_send_room(uip_connr);
+        if(uip_slen > tmp16) {
+          uip_slen = tmp16;
+        }
+        if(uip_connr->close_pending) {
+          /* After closing, the application may only send again what a
+             retransmission time-out has marked as lost. */
+          tmp16 = uip_connr->snd_max - uip_connr->len;
+          if(uip_slen > tmp16) {
+            uip_slen = tmp16;
+          }
+        }
+      }
+      if(uip_slen > 0) {
+        if(uip_connr->len == 0 && uip_connr->nrtx == 0) {
+          uip_connr->rtt_timing = 1;
+        }
+        uip_connr->len += uip_slen;
+        if(uip_connr->len > uip_connr->snd_max) {
+          uip_connr->snd_max = uip_connr->len;
+        }
+        uip_len = uip_slen + UIP_IPTCPH_LEN;
+        UIP_TCP_BUF->flags = TCP_ACK | TCP_PSH;
+        goto tcp_send_noopts;
+      }
+#else /* UIP_TCP_SEND_WINDOW > 1 */
       /* If uip_slen > 0, the application has data to be sent. */
       if(uip_slen > 0) {
 
@@ -2183,6 +2620,7 @@ uip_process(uint8_t flag)
         /* Send the packet. */
         goto tcp_send_noopts;
       }
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
       /* If there is no data to send, just send out a pure ACK if
            there is newdata. */
       if(uip_flags & UIP_NEWDATA) {
@@ -2282,10 +2720,27 @@ uip_process(uint8_t flag)
   UIP_TCP_BUF->ackno[2] = uip_connr->rcv_nxt[2];
   UIP_TCP_BUF->ackno[3] = uip_connr->rcv_nxt[3];
 
+#if UIP_TCP_SEND_WINDOW > 1
+  /* snd_nxt is the oldest unacknowledged sequence number. In the
+     ESTABLISHED state, a new segment goes after the data that was in
+     flight before it, and a segment without data carries the sequence
+     number that follows all data in flight. */
+  if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
+    uip_add32(uip_connr->snd_nxt,
+              uip_connr->len - (uip_len - UIP_IPTCPH_LEN));
+  } else {
+    uip_add32(uip_connr->snd_nxt, 0);
+  }
+  UIP_TCP_BUF->seqno[0] = uip_acc32[0];
+  UIP_TCP_BUF->seqno[1] = uip_acc32[1];
+  UIP_TCP_BUF->seqno[2] = uip_acc32[2];
+  UIP_TCP_BUF->seqno[3] = uip_acc32[3];
+#else /* UIP_TCP_SEND_WINDOW > 1 */
   UIP_TCP_BUF->seqno[0] = uip_connr->snd_nxt[0];
   UIP_TCP_BUF->seqno[1] = uip_connr->snd_nxt[1];
   UIP_TCP_BUF->seqno[2] = uip_connr->snd_nxt[2];
   UIP_TCP_BUF->seqno[3] = uip_connr->snd_nxt[3];
+#endif /* UIP_TCP_SEND_WINDOW > 1 */
 
   UIP_TCP_BUF->srcport  = uip_connr->lport;
   UIP_TCP_BUF->destport = uip_connr->rport;
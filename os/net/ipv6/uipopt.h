@@ -195,7 +195,32 @@ void uip_log(char *msg);
  * buffer before it is dropped.
  *
  */
+#ifdef UIP_CONF_REASS_MAXAGE
+#define UIP_REASS_MAXAGE (UIP_CONF_REASS_MAXAGE)
+#else /* UIP_CONF_REASS_MAXAGE */
 #define UIP_REASS_MAXAGE 60 /*60s*/
+#endif /* UIP_CONF_REASS_MAXAGE */
+
+/**
+ * The number of fragmented IPv6 packets that can be reassembled at
+ * the same time.
+ *
+ * Fragments are matched to a reassembly context by source address,
+ * destination address and fragment identification. Each context
+ * holds a buffer of UIP_BUFSIZE bytes and its own timeout, so a
+ * node that receives fragmented packets from several sources at
+ * once needs one context per concurrent packet. Fragments of a new
+ * packet are dropped when all contexts are in use.
+ *
+ * Only used when UIP_CONF_IPV6_REASSEMBLY is enabled.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_REASS_CONTEXTS
+#define UIP_REASS_CONTEXTS (UIP_CONF_REASS_CONTEXTS)
+#else /* UIP_CONF_REASS_CONTEXTS */
+#define UIP_REASS_CONTEXTS 1
+#endif /* UIP_CONF_REASS_CONTEXTS */
 
 /**
  * Turn on support for IP packet reassembly.
@@ -305,6 +330,29 @@ void uip_log(char *msg);
 #define UIP_UDP_CONNS    10
 #endif /* UIP_CONF_UDP_CONNS */
 
+/**
+ * Toggles whether UDP and TCP connections are indexed by local port.
+ *
+ * Without the index, every incoming UDP datagram and TCP segment is
+ * matched against all entries of uip_udp_conns[] or uip_conns[], and
+ * picking an unused local port scans the whole table once per
+ * candidate port. With it, connections are chained in hash buckets
+ * keyed by their local port, and free UDP connections are kept on a
+ * stack, so demultiplexing and port allocation only look at the
+ * connections that share a bucket. This costs a pointer per
+ * connection plus the bucket arrays.
+ *
+ * Applications must change the local port of a UDP connection through
+ * uip_udp_bind() and uip_udp_remove() only.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CONN_WITH_HASH
+#define UIP_CONN_WITH_HASH (UIP_CONF_CONN_WITH_HASH)
+#else /* UIP_CONF_CONN_WITH_HASH */
+#define UIP_CONN_WITH_HASH 0
+#endif /* UIP_CONF_CONN_WITH_HASH */
+
 /**
  * The name of the function that should be called when UDP datagrams arrive.
  *
@@ -440,6 +488,32 @@ void uip_log(char *msg);
 #define UIP_RECEIVE_WINDOW (UIP_CONF_RECEIVE_WINDOW)
 #endif
 
+/**
+ * The number of full-sized segments a TCP connection may have in
+ * flight at the same time.
+ *
+ * With the default of 1, uIP keeps a single unacknowledged segment
+ * per connection and the application retransmits it on
+ * uip_rexmit(). With a larger value, uIP sends new segments until
+ * this many MSS, or the window advertised by the peer, are
+ * outstanding. ACKs are then cumulative: uip_acked() is set whenever
+ * the peer acknowledges new data, uip_ackedlen() tells how many bytes
+ * were acknowledged and uip_outstanding() how many remain in
+ * flight. On a retransmission timeout, all outstanding data is
+ * considered lost and the application is asked to send again
+ * starting from the oldest unacknowledged byte.
+ *
+ * The application must keep unacknowledged data around until it has
+ * been acknowledged; tcp-socket does this using its output buffer.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_SEND_WINDOW
+#define UIP_TCP_SEND_WINDOW (UIP_CONF_TCP_SEND_WINDOW)
+#else
+#define UIP_TCP_SEND_WINDOW 1
+#endif
+
 /**
  * How long a connection should stay in the TIME_WAIT state.
  *
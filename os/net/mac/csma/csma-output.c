@@ -101,6 +101,9 @@ struct neighbor_queue {
   struct ctimer transmit_timer;
   uint8_t transmissions;
   uint8_t collisions;
+#if CSMA_BURST_LIMIT > 1
+  uint8_t burst_len; /* Frames sent since the last channel access */
+#endif /* CSMA_BURST_LIMIT > 1 */
   LIST_STRUCT(packet_queue);
 };
 
@@ -132,6 +135,11 @@ MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
 LIST(neighbor_list);
 
+#if CSMA_BURST_LIMIT > 1
+/* Set when the next packet of a neighbor is to be sent right away */
+static struct neighbor_queue *burst_neighbor;
+#endif /* CSMA_BURST_LIMIT > 1 */
+
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
     int status,
@@ -254,21 +262,45 @@ send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
 }
 /*---------------------------------------------------------------------------*/
 static void
+transmit_first_packet(struct neighbor_queue *n)
+{
+  struct packet_queue *q = list_head(n->packet_queue);
+  if(q != NULL) {
+    LOG_INFO("preparing packet for ");
+    LOG_INFO_LLADDR(&n->addr);
+    LOG_INFO_(", seqno %u, tx %u, queue %d\n",
+      queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
+      n->transmissions, list_length(n->packet_queue));
+    /* Send first packet in the neighbor queue */
+    queuebuf_to_packetbuf(q->buf);
+#if CSMA_BURST_LIMIT > 1
+    /* Tell the receiver when another frame follows right away */
+    n->burst_len++;
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_FRAME_PENDING,
+                       n->burst_len < CSMA_BURST_LIMIT
+                       && list_item_next(q) != NULL
+                       && !packetbuf_holds_broadcast());
+#endif /* CSMA_BURST_LIMIT > 1 */
+    send_one_packet(n, q);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
 transmit_from_queue(void *ptr)
 {
   struct neighbor_queue *n = ptr;
   if(n) {
-    struct packet_queue *q = list_head(n->packet_queue);
-    if(q != NULL) {
-      LOG_INFO("preparing packet for ");
-      LOG_INFO_LLADDR(&n->addr);
-      LOG_INFO_(", seqno %u, tx %u, queue %d\n",
-        queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
-        n->transmissions, list_length(n->packet_queue));
-      /* Send first packet in the neighbor queue */
-      queuebuf_to_packetbuf(q->buf);
-      send_one_packet(n, q);
-    }
+#if CSMA_BURST_LIMIT > 1
+    /* We just won the channel: start a new burst, which free_packet()
+     * continues by setting burst_neighbor */
+    n->burst_len = 0;
+    do {
+      burst_neighbor = NULL;
+      transmit_first_packet(n);
+    } while(burst_neighbor == n);
+#else /* CSMA_BURST_LIMIT > 1 */
+    transmit_first_packet(n);
+#endif /* CSMA_BURST_LIMIT > 1 */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -308,6 +340,16 @@ free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_LIMIT > 1
+      if(status == MAC_TX_OK && n->burst_len > 0
+         && n->burst_len < CSMA_BURST_LIMIT
+         && !linkaddr_cmp(&n->addr, &linkaddr_null)) {
+        /* Keep the channel: transmit_from_queue() sends the next packet
+         * without backoff */
+        burst_neighbor = n;
+        return;
+      }
+#endif /* CSMA_BURST_LIMIT > 1 */
       /* Schedule next transmissions */
       schedule_transmission(n);
     } else {
@@ -470,6 +512,9 @@ csma_output_packet(mac_callback_t sent, void *ptr)
       linkaddr_copy(&n->addr, addr);
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_LIMIT > 1
+      n->burst_len = 0;
+#endif /* CSMA_BURST_LIMIT > 1 */
       /* Init packet queue for this neighbor */
       LIST_STRUCT_INIT(n, packet_queue);
       /* Add neighbor to the neighbor list */
@@ -189,6 +189,13 @@ csma_security_create_frame(void)
     LOG_DBG("\n");
 #endif
 
+    /* The frame is encrypted in place: it must not be shared with the
+       queued copy used for retransmissions */
+    if(!packetbuf_make_writable()) {
+      LOG_ERR("failed to get a writable packetbuf\n");
+      return FRAMER_FAILED;
+    }
+
     if(!aead(hdr_len, 1)) {
       LOG_ERR("failed to encrypt packet to ");
       LOG_ERR_LLADDR(packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
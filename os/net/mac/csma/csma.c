@@ -41,6 +41,7 @@
 #include "net/mac/csma/csma.h"
 #include "net/mac/csma/csma-output.h"
 #include "net/mac/mac-sequence.h"
+#include "net/mac/framer/frame802154.h"
 #include "net/packetbuf.h"
 #include "net/netstack.h"
 
@@ -120,6 +121,44 @@ input_packet(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Tells from its raw header whether a frame is unicast to another node, in
+ * which case input_packet() would drop it anyway */
+static int
+frame_is_for_others(const struct radio_rx_frame *frame)
+{
+  frame802154_index_t idx;
+  uint8_t dest[8];
+
+  if(frame802154_parse_index(frame->data, frame->len, &idx) == 0
+     || idx.fcf.dest_addr_mode != (LINKADDR_SIZE == 2 ?
+                                   FRAME802154_SHORTADDRMODE :
+                                   FRAME802154_LONGADDRMODE)) {
+    /* Leave it to input_packet() */
+    return 0;
+  }
+  frame802154_index_get_dest_addr(frame->data, &idx, dest);
+  return !frame802154_is_broadcast_addr(idx.fcf.dest_addr_mode, dest)
+    && !linkaddr_cmp((linkaddr_t *)dest, &linkaddr_null)
+    && !linkaddr_cmp((linkaddr_t *)dest, &linkaddr_node_addr);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_batch(const struct radio_rx_frame *frames, int count)
+{
+  int i;
+
+  for(i = 0; i < count; i++) {
+    /* Drop acks and frames for other nodes before copying them to packetbuf */
+    if(frames[i].len == CSMA_ACK_LEN) {
+      LOG_DBG("ignored ack\n");
+    } else if(frame_is_for_others(&frames[i])) {
+      LOG_DBG("not for us\n");
+    } else if(netstack_rx_frame_to_packetbuf(&frames[i])) {
+      input_packet();
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
 static int
 on(void)
 {
@@ -190,5 +229,6 @@ const struct mac_driver csma_driver = {
   on,
   off,
   max_payload,
+  input_batch,
 };
 /*---------------------------------------------------------------------------*/
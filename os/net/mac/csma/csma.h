@@ -50,6 +50,7 @@
 
 #include "contiki.h"
 #include "net/mac/mac.h"
+#include "net/mac/csma/csma-conf.h"
 #include "net/packetbuf.h"
 #include "net/netstack.h"
 #include "dev/radio.h"
@@ -634,4 +634,246 @@ frame802154_parse(uint8_t *data, int len, frame802154_t *pf)
   /* return header length if successful */
   return c > len ? 0 : c;
 }
+/*----------------------------------------------------------------------------*/
+/* PAN ID presence for frame version 0b10 (IEEE 802.15.4-2015 Table 7-2),
+ * indexed by PAN ID compression, destination and source address modes.
+ * Bit 1: destination PAN ID, bit 0: source PAN ID. This is the outcome of
+ * frame802154_has_panid() for every FCF of that version. */
+static const uint8_t panid_presence_2015[32] = {
+  0, 0, 1, 1, 2, 0, 2, 0, 2, 2, 3, 3, 2, 0, 3, 2,
+  2, 0, 0, 0, 0, 0, 2, 0, 0, 2, 2, 2, 0, 0, 2, 0
+};
+/* Address length per address mode, reserved mode 1 has no address */
+static const uint8_t addr_len_by_mode[4] = { 0, 0, 2, 8 };
+/*----------------------------------------------------------------------------*/
+/**
+ *   \brief Indexes an input frame. Scans the header once and records the
+ *   offset of each field in a frame802154_index_t structure, without
+ *   decoding any of them. The fields can then be read lazily with the
+ *   frame802154_index_get_*() accessors, or all at once with
+ *   frame802154_index_to_frame().
+ *
+ *   \param data The input data from the radio chip.
+ *   \param len The size of the input data
+ *   \param idx The frame802154_index_t struct to store the offsets in.
+ *
+ *   \return The header length, or 0 on failure, as frame802154_parse()
+ */
+int
+frame802154_parse_index(const uint8_t *data, int len, frame802154_index_t *idx)
+{
+  uint8_t pos;
+  uint8_t panids;
+#if LLSEC802154_USES_AUX_HEADER
+  uint8_t scf;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_id_mode;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  if(len < 2) {
+    return 0;
+  }
+
+  /* Decode the FCF in place */
+  idx->fcf.frame_type = data[0] & 7;
+  idx->fcf.security_enabled = (data[0] >> 3) & 1;
+  idx->fcf.frame_pending = (data[0] >> 4) & 1;
+  idx->fcf.ack_required = (data[0] >> 5) & 1;
+  idx->fcf.panid_compression = (data[0] >> 6) & 1;
+  idx->fcf.sequence_number_suppression = data[1] & 1;
+  idx->fcf.ie_list_present = (data[1] >> 1) & 1;
+  idx->fcf.dest_addr_mode = (data[1] >> 2) & 3;
+  idx->fcf.frame_version = (data[1] >> 4) & 3;
+  idx->fcf.src_addr_mode = (data[1] >> 6) & 3;
+  pos = 2;
+
+  idx->seq_offset = 0;
+  if(idx->fcf.sequence_number_suppression == 0) {
+    idx->seq_offset = pos++;
+  }
+
+  if(idx->fcf.frame_version == FRAME802154_IEEE802154_2015) {
+    panids = panid_presence_2015[((data[0] >> 2) & 0x10) | (data[1] & 0x0c) | (data[1] >> 6)];
+  } else if(idx->fcf.frame_type != FRAME802154_ACKFRAME) {
+    panids = (idx->fcf.dest_addr_mode ? 2 : 0)
+      | (!idx->fcf.panid_compression && idx->fcf.src_addr_mode ? 1 : 0);
+  } else {
+    /* No PAN ID in ACK */
+    panids = 0;
+  }
+
+  idx->dest_pid_offset = 0;
+  idx->dest_addr_offset = 0;
+  if(idx->fcf.dest_addr_mode) {
+    if(panids & 2) {
+      idx->dest_pid_offset = pos;
+      pos += 2;
+    }
+    idx->dest_addr_offset = pos;
+    pos += addr_len_by_mode[idx->fcf.dest_addr_mode];
+  }
+
+  idx->src_pid_offset = 0;
+  idx->src_addr_offset = 0;
+  if(idx->fcf.src_addr_mode) {
+    if(panids & 1) {
+      idx->src_pid_offset = pos;
+      pos += 2;
+    }
+    idx->src_addr_offset = pos;
+    pos += addr_len_by_mode[idx->fcf.src_addr_mode];
+  }
+
+  idx->aux_hdr_offset = 0;
+#if LLSEC802154_USES_AUX_HEADER
+  if(idx->fcf.security_enabled) {
+    if(pos >= len) {
+      return 0;
+    }
+    idx->aux_hdr_offset = pos;
+    scf = data[pos++];
+    if((scf >> 5) == 0) {
+      /* Frame counter present, 4 or 5 bytes */
+      pos += (scf >> 6) == 1 ? 5 : 4;
+    }
+#if LLSEC802154_USES_EXPLICIT_KEYS
+    key_id_mode = (scf >> 3) & 3;
+    if(key_id_mode) {
+      /* Key source and key index */
+      pos += (key_id_mode - 1) * 4 + 1;
+    }
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+  }
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  if(pos > len) {
+    return 0;
+  }
+  idx->hdr_len = pos;
+  idx->frame_len = len;
+
+  return pos;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t
+frame802154_index_get_dest_pid(const uint8_t *data, const frame802154_index_t *idx)
+{
+  if(idx->dest_pid_offset) {
+    return data[idx->dest_pid_offset] + (data[idx->dest_pid_offset + 1] << 8);
+  }
+  /* Elided destination PAN ID: same as the source PAN ID, if any */
+  if(idx->src_pid_offset) {
+    return data[idx->src_pid_offset] + (data[idx->src_pid_offset + 1] << 8);
+  }
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+uint16_t
+frame802154_index_get_src_pid(const uint8_t *data, const frame802154_index_t *idx)
+{
+  if(idx->src_pid_offset) {
+    return data[idx->src_pid_offset] + (data[idx->src_pid_offset + 1] << 8);
+  }
+  /* Elided source PAN ID: same as the destination PAN ID, if any */
+  if(idx->fcf.src_addr_mode) {
+    return frame802154_index_get_dest_pid(data, idx);
+  }
+  return 0;
+}
+/*----------------------------------------------------------------------------*/
+static void
+index_get_addr(const uint8_t *p, uint8_t mode, uint8_t *addr)
+{
+  int c;
+
+  if(mode == FRAME802154_SHORTADDRMODE) {
+    linkaddr_copy((linkaddr_t *)addr, &linkaddr_null);
+    addr[0] = p[1];
+    addr[1] = p[0];
+  } else if(mode == FRAME802154_LONGADDRMODE) {
+    for(c = 0; c < 8; c++) {
+      addr[c] = p[7 - c];
+    }
+  } else if(mode == FRAME802154_NOADDR) {
+    linkaddr_copy((linkaddr_t *)addr, &linkaddr_null);
+  }
+}
+/*----------------------------------------------------------------------------*/
+void
+frame802154_index_get_dest_addr(const uint8_t *data, const frame802154_index_t *idx,
+                                uint8_t *addr)
+{
+  index_get_addr(data + idx->dest_addr_offset, idx->fcf.dest_addr_mode, addr);
+}
+/*----------------------------------------------------------------------------*/
+void
+frame802154_index_get_src_addr(const uint8_t *data, const frame802154_index_t *idx,
+                               uint8_t *addr)
+{
+  index_get_addr(data + idx->src_addr_offset, idx->fcf.src_addr_mode, addr);
+}
+/*----------------------------------------------------------------------------*/
+/**
+ *   \brief Decodes all fields of a frame indexed with
+ *   frame802154_parse_index() into a frame802154_t structure. The result
+ *   is the same as that of frame802154_parse() on the same frame.
+ *
+ *   \param data The input data that was indexed.
+ *   \param idx The index filled by frame802154_parse_index().
+ *   \param pf The frame802154_t struct to store the frame information.
+ */
+void
+frame802154_index_to_frame(const uint8_t *data, const frame802154_index_t *idx,
+                           frame802154_t *pf)
+{
+#if LLSEC802154_USES_AUX_HEADER
+  const uint8_t *p;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  uint8_t key_id_mode;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  memcpy(&pf->fcf, &idx->fcf, sizeof(frame802154_fcf_t));
+  if(idx->seq_offset) {
+    pf->seq = data[idx->seq_offset];
+  }
+  pf->dest_pid = frame802154_index_get_dest_pid(data, idx);
+  pf->src_pid = frame802154_index_get_src_pid(data, idx);
+  frame802154_index_get_dest_addr(data, idx, pf->dest_addr);
+  frame802154_index_get_src_addr(data, idx, pf->src_addr);
+
+#if LLSEC802154_USES_AUX_HEADER
+  if(idx->aux_hdr_offset) {
+    p = data + idx->aux_hdr_offset;
+    pf->aux_hdr.security_control.security_level = p[0] & 7;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+    pf->aux_hdr.security_control.key_id_mode = (p[0] >> 3) & 3;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+    pf->aux_hdr.security_control.frame_counter_suppression = p[0] >> 5;
+    pf->aux_hdr.security_control.frame_counter_size = p[0] >> 6;
+    p += 1;
+
+    if(pf->aux_hdr.security_control.frame_counter_suppression == 0) {
+      memcpy(pf->aux_hdr.frame_counter.u8, p, 4);
+      p += 4;
+      if(pf->aux_hdr.security_control.frame_counter_size == 1) {
+        p++;
+      }
+    }
+
+#if LLSEC802154_USES_EXPLICIT_KEYS
+    key_id_mode = pf->aux_hdr.security_control.key_id_mode;
+    if(key_id_mode) {
+      memcpy(pf->aux_hdr.key_source.u8, p, (key_id_mode - 1) * 4);
+      p += (key_id_mode - 1) * 4;
+      pf->aux_hdr.key_index = p[0];
+    }
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+  }
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  pf->payload_len = idx->frame_len - idx->hdr_len;
+  pf->payload = (uint8_t *)data + idx->hdr_len;
+}
 /** \}   */
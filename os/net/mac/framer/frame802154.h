@@ -210,6 +210,24 @@ typedef struct {
   int payload_len;                /**< Length of payload field */
 } frame802154_t;
 
+/** \brief Offset index of an input frame, filled in a single pass by
+ *  frame802154_parse_index(). Offsets are relative to the start of the
+ *  frame; as the FCF always occupies the first two bytes, an offset of 0
+ *  means that the field is absent. Fields are decoded lazily through the
+ *  frame802154_index_get_*() accessors.
+ */
+typedef struct {
+  frame802154_fcf_t fcf;          /**< Frame control field */
+  uint8_t seq_offset;             /**< Offset of the sequence number */
+  uint8_t dest_pid_offset;        /**< Offset of the destination PAN ID */
+  uint8_t dest_addr_offset;       /**< Offset of the destination address */
+  uint8_t src_pid_offset;         /**< Offset of the source PAN ID */
+  uint8_t src_addr_offset;        /**< Offset of the source address */
+  uint8_t aux_hdr_offset;         /**< Offset of the aux security header */
+  uint8_t hdr_len;                /**< Header length, i.e. offset of the IEs or payload */
+  int frame_len;                  /**< Length of the whole frame */
+} frame802154_index_t;
+
 /* Prototypes */
 
 int frame802154_hdrlen(frame802154_t *p);
@@ -218,6 +236,16 @@ int frame802154_create(frame802154_t *p, uint8_t *buf);
 int frame802154_parse(uint8_t *data, int length, frame802154_t *pf);
 void frame802154_parse_fcf(uint8_t *data, frame802154_fcf_t *pfcf);
 
+/* Index all header fields of a frame in a single pass, without decoding them */
+int frame802154_parse_index(const uint8_t *data, int len, frame802154_index_t *idx);
+/* Lazy accessors over a frame indexed with frame802154_parse_index() */
+uint16_t frame802154_index_get_dest_pid(const uint8_t *data, const frame802154_index_t *idx);
+uint16_t frame802154_index_get_src_pid(const uint8_t *data, const frame802154_index_t *idx);
+void frame802154_index_get_dest_addr(const uint8_t *data, const frame802154_index_t *idx, uint8_t *addr);
+void frame802154_index_get_src_addr(const uint8_t *data, const frame802154_index_t *idx, uint8_t *addr);
+/* Decode an indexed frame; same result as frame802154_parse() */
+void frame802154_index_to_frame(const uint8_t *data, const frame802154_index_t *idx, frame802154_t *pf);
+
 /* Get current PAN ID */
 uint16_t frame802154_get_pan_id(void);
 /* Set current PAN ID */
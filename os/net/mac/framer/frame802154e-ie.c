@@ -45,43 +45,6 @@
 #define LOG_MODULE "Frame 15.4"
 #define LOG_LEVEL LOG_LEVEL_FRAMER
 
-/* c.f. IEEE 802.15.4e Table 4b */
-enum ieee802154e_header_ie_id {
-  HEADER_IE_LE_CSL = 0x1a,
-  HEADER_IE_LE_RIT,
-  HEADER_IE_DSME_PAN_DESCRIPTOR,
-  HEADER_IE_RZ_TIME,
-  HEADER_IE_ACK_NACK_TIME_CORRECTION,
-  HEADER_IE_GACK,
-  HEADER_IE_LOW_LATENCY_NETWORK_INFO,
-  HEADER_IE_LIST_TERMINATION_1 = 0x7e,
-  HEADER_IE_LIST_TERMINATION_2 = 0x7f,
-};
-
-/* c.f. IEEE 802.15.4e Table 4c */
-enum ieee802154e_payload_ie_id {
-  PAYLOAD_IE_ESDU = 0,
-  PAYLOAD_IE_MLME,
-  PAYLOAD_IE_IETF = 0x5,
-  PAYLOAD_IE_LIST_TERMINATION = 0xf,
-};
-
-/* c.f. IEEE 802.15.4e Table 4d */
-enum ieee802154e_mlme_short_subie_id {
-  MLME_SHORT_IE_TSCH_SYNCHRONIZATION = 0x1a,
-  MLME_SHORT_IE_TSCH_SLOFTRAME_AND_LINK,
-  MLME_SHORT_IE_TSCH_TIMESLOT,
-  MLME_SHORT_IE_TSCH_HOPPING_TIMING,
-  MLME_SHORT_IE_TSCH_EB_FILTER,
-  MLME_SHORT_IE_TSCH_MAC_METRICS_1,
-  MLME_SHORT_IE_TSCH_MAC_METRICS_2,
-};
-
-/* c.f. IEEE 802.15.4e Table 4e */
-enum ieee802154e_mlme_long_subie_id {
-  MLME_LONG_IE_TSCH_CHANNEL_HOPPING_SEQUENCE = 0x9,
-};
-
 #include <net/mac/tsch/sixtop/sixtop.h>
 enum ieee802154e_ietf_subie_id {
   IETF_IE_6TOP = SIXTOP_SUBIE_ID,
@@ -629,3 +592,211 @@ frame802154e_parse_information_elements(const uint8_t *buf, uint8_t buf_size,
 
   return buf - start;
 }
+
+/* Record an IE in an IE index */
+static void
+ie_index_add(struct ieee802154_ie_index *idx, uint8_t kind, uint8_t id,
+    uint8_t offset, uint8_t len)
+{
+  struct ieee802154_ie_ref *ref;
+  if(idx->num_ies >= FRAME802154E_IE_INDEX_MAX_IES) {
+    idx->truncated = 1;
+    return;
+  }
+  ref = &idx->ies[idx->num_ies++];
+  ref->kind = kind;
+  ref->id = id;
+  ref->offset = offset;
+  ref->len = len;
+}
+
+/* Index all IEEE 802.15.4e Information Elements (IE) from a frame. Walks the
+ * IE lists exactly as frame802154e_parse_information_elements() does, but
+ * only validates each IE and records where its content is. */
+int
+frame802154e_index_information_elements(const uint8_t *buf, uint8_t buf_size,
+    struct ieee802154_ie_index *idx)
+{
+  const uint8_t *start = buf;
+  uint16_t ie_desc;
+  uint8_t id;
+  uint16_t len = 0;
+  int nested_mlme_len = 0;
+  enum {PARSING_HEADER_IE, PARSING_PAYLOAD_IE, PARSING_MLME_SUBIE} parsing_state;
+
+  if(idx == NULL) {
+    return -1;
+  }
+
+  parsing_state = PARSING_HEADER_IE;
+  idx->buf_size = buf_size;
+  idx->ie_payload_ie_offset = 0;
+  idx->num_ies = 0;
+  idx->truncated = 0;
+
+  while(buf_size > 0) {
+    if(buf_size < 2) { /* Not enough space for IE descriptor */
+      return -1;
+    }
+    READ16(buf, ie_desc);
+    buf_size -= 2;
+    buf += 2;
+
+    switch(parsing_state) {
+      case PARSING_HEADER_IE:
+        if(ie_desc & 0x8000) {
+          return -1;
+        }
+        len = ie_desc & 0x007f; /* b0-b6 */
+        id = (ie_desc & 0x7f80) >> 7; /* b7-b14 */
+        if(id == HEADER_IE_LIST_TERMINATION_1 || id == HEADER_IE_LIST_TERMINATION_2) {
+          if(len != 0) {
+            return -1;
+          }
+          idx->ie_payload_ie_offset = buf - start;
+          if(id == HEADER_IE_LIST_TERMINATION_2) {
+            idx->len = buf - start;
+            return idx->len;
+          }
+          parsing_state = PARSING_PAYLOAD_IE;
+        } else {
+          if(len > buf_size || frame802154e_parse_header_ie(buf, len, id, NULL) == -1) {
+            return -1;
+          }
+          ie_index_add(idx, IEEE802154_IE_KIND_HEADER, id, buf - start, len);
+        }
+        break;
+      case PARSING_PAYLOAD_IE:
+        if(!(ie_desc & 0x8000)) {
+          return -1;
+        }
+        len = ie_desc & 0x7ff; /* b0-b10 */
+        id = (ie_desc & 0x7800) >> 11; /* b11-b14 */
+        switch(id) {
+          case PAYLOAD_IE_MLME:
+            parsing_state = PARSING_MLME_SUBIE;
+            nested_mlme_len = len;
+            len = 0;
+            break;
+#if TSCH_WITH_SIXTOP
+          case PAYLOAD_IE_IETF:
+            /* Also reject IETF IEs that do not fit in the buffer */
+            if(len == 0 || len > buf_size) {
+              return -1;
+            }
+            if(*buf == IETF_IE_6TOP) {
+              ie_index_add(idx, IEEE802154_IE_KIND_IETF, *buf, buf - start, len);
+            }
+            break;
+#endif /* TSCH_WITH_SIXTOP */
+          case PAYLOAD_IE_LIST_TERMINATION:
+            if(len != 0) {
+              return -1;
+            }
+            idx->len = buf - start;
+            return idx->len;
+          default:
+            return -1;
+        }
+        break;
+      case PARSING_MLME_SUBIE:
+        if(!(ie_desc & 0x8000)) {
+          len = ie_desc & 0x00ff; /* b0-b7 */
+          id = (ie_desc & 0x7f00) >> 8; /* b8-b14 */
+          if(len > buf_size || frame802154e_parse_mlme_short_ie(buf, len, id, NULL) == -1) {
+            return -1;
+          }
+          ie_index_add(idx, IEEE802154_IE_KIND_MLME_SHORT, id, buf - start, len);
+        } else {
+          len = ie_desc & 0x7ff; /* b0-b10 */
+          id = (ie_desc & 0x7800) >> 11; /* b11-b14 */
+          if(len > buf_size || frame802154e_parse_mlme_long_ie(buf, len, id, NULL) == -1) {
+            return -1;
+          }
+          ie_index_add(idx, IEEE802154_IE_KIND_MLME_LONG, id, buf - start, len);
+        }
+        nested_mlme_len -= 2 + len;
+        if(nested_mlme_len < 0) {
+          return -1;
+        }
+        if(nested_mlme_len == 0) {
+          parsing_state = PARSING_PAYLOAD_IE;
+        }
+        break;
+    }
+    buf += len;
+    buf_size -= len;
+  }
+
+  if(parsing_state == PARSING_HEADER_IE) {
+    idx->ie_payload_ie_offset = buf - start;
+  }
+
+  idx->len = buf - start;
+  return idx->len;
+}
+
+/* Find the last indexed IE of a given kind and id. The last one is the one
+ * whose content prevails when decoding the whole list. */
+const struct ieee802154_ie_ref *
+frame802154e_ie_index_find(const struct ieee802154_ie_index *idx,
+    uint8_t kind, uint8_t id)
+{
+  int i;
+  if(idx == NULL) {
+    return NULL;
+  }
+  for(i = idx->num_ies - 1; i >= 0; i--) {
+    if(idx->ies[i].kind == kind && idx->ies[i].id == id) {
+      return &idx->ies[i];
+    }
+  }
+  return NULL;
+}
+
+/* Decode a single indexed IE, whose list starts at buf */
+int
+frame802154e_ie_index_decode_ie(const uint8_t *buf, const struct ieee802154_ie_ref *ref,
+    struct ieee802154_ies *ies)
+{
+  if(ref == NULL || ies == NULL) {
+    return -1;
+  }
+  buf += ref->offset;
+  switch(ref->kind) {
+    case IEEE802154_IE_KIND_HEADER:
+      return frame802154e_parse_header_ie(buf, ref->len, ref->id, ies);
+    case IEEE802154_IE_KIND_MLME_SHORT:
+      return frame802154e_parse_mlme_short_ie(buf, ref->len, ref->id, ies);
+    case IEEE802154_IE_KIND_MLME_LONG:
+      return frame802154e_parse_mlme_long_ie(buf, ref->len, ref->id, ies);
+#if TSCH_WITH_SIXTOP
+    case IEEE802154_IE_KIND_IETF:
+      /* Skip the Sub-ID field, c.f. frame802154e_parse_information_elements() */
+      ies->sixtop_ie_content_ptr = buf + 1;
+      ies->sixtop_ie_content_len = ref->len - 1;
+      return ref->len;
+#endif /* TSCH_WITH_SIXTOP */
+  }
+  return -1;
+}
+
+/* Decode all indexed IEs, in list order */
+int
+frame802154e_ie_index_decode(const uint8_t *buf, const struct ieee802154_ie_index *idx,
+    struct ieee802154_ies *ies)
+{
+  int i;
+  if(idx == NULL || ies == NULL) {
+    return -1;
+  }
+  if(idx->truncated) {
+    /* Not all IEs are in the index, parse the list again */
+    return frame802154e_parse_information_elements(buf, idx->buf_size, ies);
+  }
+  ies->ie_payload_ie_offset = idx->ie_payload_ie_offset;
+  for(i = 0; i < idx->num_ies; i++) {
+    frame802154e_ie_index_decode_ie(buf, &idx->ies[i], ies);
+  }
+  return idx->len;
+}
@@ -51,6 +51,43 @@
 
 #define FRAME802154E_IE_MAX_LINKS       4
 
+/* c.f. IEEE 802.15.4e Table 4b */
+enum ieee802154e_header_ie_id {
+  HEADER_IE_LE_CSL = 0x1a,
+  HEADER_IE_LE_RIT,
+  HEADER_IE_DSME_PAN_DESCRIPTOR,
+  HEADER_IE_RZ_TIME,
+  HEADER_IE_ACK_NACK_TIME_CORRECTION,
+  HEADER_IE_GACK,
+  HEADER_IE_LOW_LATENCY_NETWORK_INFO,
+  HEADER_IE_LIST_TERMINATION_1 = 0x7e,
+  HEADER_IE_LIST_TERMINATION_2 = 0x7f,
+};
+
+/* c.f. IEEE 802.15.4e Table 4c */
+enum ieee802154e_payload_ie_id {
+  PAYLOAD_IE_ESDU = 0,
+  PAYLOAD_IE_MLME,
+  PAYLOAD_IE_IETF = 0x5,
+  PAYLOAD_IE_LIST_TERMINATION = 0xf,
+};
+
+/* c.f. IEEE 802.15.4e Table 4d */
+enum ieee802154e_mlme_short_subie_id {
+  MLME_SHORT_IE_TSCH_SYNCHRONIZATION = 0x1a,
+  MLME_SHORT_IE_TSCH_SLOFTRAME_AND_LINK,
+  MLME_SHORT_IE_TSCH_TIMESLOT,
+  MLME_SHORT_IE_TSCH_HOPPING_TIMING,
+  MLME_SHORT_IE_TSCH_EB_FILTER,
+  MLME_SHORT_IE_TSCH_MAC_METRICS_1,
+  MLME_SHORT_IE_TSCH_MAC_METRICS_2,
+};
+
+/* c.f. IEEE 802.15.4e Table 4e */
+enum ieee802154e_mlme_long_subie_id {
+  MLME_LONG_IE_TSCH_CHANNEL_HOPPING_SEQUENCE = 0x9,
+};
+
 /* Structures used for the Slotframe and Links information element */
 struct tsch_slotframe_and_links_link {
   uint16_t timeslot;
@@ -92,6 +129,40 @@ struct ieee802154_ies {
 #endif /* TSCH_WITH_SIXTOP */
 };
 
+/* Maximum number of IEs recorded in an IE index. Lists with more IEs are
+ * still validated, but only their first IEs are indexed */
+#ifdef FRAME802154E_CONF_IE_INDEX_MAX_IES
+#define FRAME802154E_IE_INDEX_MAX_IES FRAME802154E_CONF_IE_INDEX_MAX_IES
+#else
+#define FRAME802154E_IE_INDEX_MAX_IES 8
+#endif
+
+/* The kinds of IEs recorded in an IE index */
+enum ieee802154_ie_kind {
+  IEEE802154_IE_KIND_HEADER,
+  IEEE802154_IE_KIND_MLME_SHORT,
+  IEEE802154_IE_KIND_MLME_LONG,
+  IEEE802154_IE_KIND_IETF,
+};
+
+/* Location of an IE content within an IE list */
+struct ieee802154_ie_ref {
+  uint8_t kind;
+  uint8_t id;
+  uint8_t offset; /* Offset of the content from the start of the IE list */
+  uint8_t len;
+};
+
+/* Offset index of all Information Elements of a frame */
+struct ieee802154_ie_index {
+  uint8_t buf_size; /* Size of the buffer the list was indexed from */
+  uint8_t len; /* Length of the IE list, as returned when indexing it */
+  uint8_t ie_payload_ie_offset;
+  uint8_t num_ies;
+  uint8_t truncated; /* Set if the list had more than FRAME802154E_IE_INDEX_MAX_IES IEs */
+  struct ieee802154_ie_ref ies[FRAME802154E_IE_INDEX_MAX_IES];
+};
+
 /** Insert various Information Elements **/
 /* Header IE. ACK/NACK time correction. Used in enhanced ACKs */
 int frame80215e_create_ie_header_ack_nack_time_correction(uint8_t *buf, int len,
@@ -131,5 +202,18 @@ int frame80215e_create_ie_tsch_channel_hopping_sequence(uint8_t *buf, int len,
 /* Parse all Information Elements of a frame */
 int frame802154e_parse_information_elements(const uint8_t *buf, uint8_t buf_size,
     struct ieee802154_ies *ies);
+/* Index all Information Elements of a frame in a single pass, validating
+ * them without decoding their content */
+int frame802154e_index_information_elements(const uint8_t *buf, uint8_t buf_size,
+    struct ieee802154_ie_index *idx);
+/* Find the last indexed IE of a given kind and id, NULL if none */
+const struct ieee802154_ie_ref *frame802154e_ie_index_find(const struct ieee802154_ie_index *idx,
+    uint8_t kind, uint8_t id);
+/* Decode a single indexed IE into an ieee802154_ies structure */
+int frame802154e_ie_index_decode_ie(const uint8_t *buf, const struct ieee802154_ie_ref *ref,
+    struct ieee802154_ies *ies);
+/* Decode all indexed IEs; same result as frame802154e_parse_information_elements() */
+int frame802154e_ie_index_decode(const uint8_t *buf, const struct ieee802154_ie_index *idx,
+    struct ieee802154_ies *ies);
 
 #endif /* FRAME_802154E_H */
@@ -139,7 +139,11 @@ framer_802154_setup_params(packetbuf_attr_t (*get_attr)(uint8_t type),
 
   /* Build the FCF. */
   params->fcf.frame_type = get_attr(PACKETBUF_ATTR_FRAME_TYPE);
+#if CSMA_BURST_LIMIT > 1
+  params->fcf.frame_pending = get_attr(PACKETBUF_ATTR_MAC_FRAME_PENDING);
+#else /* CSMA_BURST_LIMIT > 1 */
   params->fcf.frame_pending = 0;
+#endif /* CSMA_BURST_LIMIT > 1 */
   if(dest_is_broadcast) {
     params->fcf.ack_required = 0;
     /* Suppress seqno on broadcast if supported (frame v2 or more) */
@@ -241,6 +245,9 @@ parse(void)
   if(hdr_len && packetbuf_hdrreduce(hdr_len)) {
     packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, frame.fcf.frame_type);
     packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, frame.fcf.ack_required);
+#if CSMA_BURST_LIMIT > 1
+    packetbuf_set_attr(PACKETBUF_ATTR_MAC_FRAME_PENDING, frame.fcf.frame_pending);
+#endif /* CSMA_BURST_LIMIT > 1 */
 
     if(frame.fcf.dest_addr_mode) {
       if(frame.dest_pid != frame802154_get_pan_id() &&
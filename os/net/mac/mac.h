@@ -79,6 +79,11 @@ struct mac_driver {
 
   /** Read out estimated max payload size based on payload in packetbuf */
   int (* max_payload)(void);
+
+  /** Callback for getting notified of several incoming frames at once,
+      read with the radio's read_batch(). Optional: when NULL, the frames
+      are passed one by one to input() through packetbuf. */
+  void (* input_batch)(const struct radio_rx_frame *frames, int count);
 };
 
 /* Generic MAC return values. */
@@ -314,6 +314,32 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep bitmaps of the unicast neighbors that have packets pending for
+ * shared links, so that picking a packet for a broadcast link does not
+ * walk all neighbor queues */
+#ifdef TSCH_QUEUE_CONF_WITH_READY_SET
+#define TSCH_QUEUE_WITH_READY_SET TSCH_QUEUE_CONF_WITH_READY_SET
+#else
+#define TSCH_QUEUE_WITH_READY_SET 0
+#endif
+
+/* Queue control frames (keepalives, 6P, ICMPv6 such as RPL and ND)
+ * separately from data and send them first. Also keeps queueing delay
+ * statistics for each of the two classes. */
+#ifdef TSCH_QUEUE_CONF_WITH_PRIORITY
+#define TSCH_QUEUE_WITH_PRIORITY TSCH_QUEUE_CONF_WITH_PRIORITY
+#else
+#define TSCH_QUEUE_WITH_PRIORITY 0
+#endif
+
+/* The maximum number of outgoing control frames towards each neighbor.
+ * Must be power of two. */
+#ifdef TSCH_QUEUE_CONF_NUM_CONTROL_PER_NEIGHBOR
+#define TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR TSCH_QUEUE_CONF_NUM_CONTROL_PER_NEIGHBOR
+#else
+#define TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR 4
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -353,6 +379,16 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep the links of each slotframe in an array sorted by timeslot, so
+ * that the next active link is found with one binary search per
+ * slotframe instead of a walk through all links, at the cost of one
+ * pointer of RAM per link */
+#ifdef TSCH_SCHEDULE_CONF_WITH_INDEX
+#define TSCH_SCHEDULE_WITH_INDEX TSCH_SCHEDULE_CONF_WITH_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_INDEX 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
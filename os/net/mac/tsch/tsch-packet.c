@@ -150,66 +150,123 @@ tsch_packet_create_eack(uint8_t *buf, uint16_t buf_len,
   return ack_len;
 }
 /*---------------------------------------------------------------------------*/
+/* Check the addresses of an indexed EACK as frame802154_extract_linkaddr()
+   does: a unicast source address must fit a linkaddr_t, and the destination
+   must be our address or broadcast */
+static int
+eack_is_for_us(const uint8_t *buf, const frame802154_index_t *index)
+{
+  uint8_t addr[8];
+  uint8_t mode;
+
+  mode = index->fcf.src_addr_mode;
+  if(mode != FRAME802154_NOADDR) {
+    frame802154_index_get_src_addr(buf, index, addr);
+    if(!frame802154_is_broadcast_addr(mode, addr) &&
+       (mode == FRAME802154_SHORTADDRMODE ? 2 : 8) != LINKADDR_SIZE) {
+      return 0;
+    }
+  }
+
+  mode = index->fcf.dest_addr_mode;
+  if(mode != FRAME802154_NOADDR) {
+    frame802154_index_get_dest_addr(buf, index, addr);
+    if(!frame802154_is_broadcast_addr(mode, addr) &&
+       ((mode == FRAME802154_SHORTADDRMODE ? 2 : 8) != LINKADDR_SIZE ||
+        (!linkaddr_cmp((linkaddr_t *)addr, &linkaddr_node_addr)
+         && !linkaddr_cmp((linkaddr_t *)addr, &linkaddr_null)))) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
 /* Parse enhanced ACK packet, extract drift and nack */
 int
 tsch_packet_parse_eack(const uint8_t *buf, int buf_size,
                        uint8_t seqno, frame802154_t *frame, struct ieee802154_ies *ies, uint8_t *hdr_len)
 {
+  frame802154_index_t index;
+  struct ieee802154_ie_index ie_index;
+  const struct ieee802154_ie_ref *ref;
   uint8_t curr_len = 0;
+  uint8_t ie_payload_ie_offset = 0;
+  int has_dest_panid = 0;
+  uint16_t dest_pid;
   int ret;
-  linkaddr_t dest;
 
-  if(frame == NULL || buf_size < 0) {
+  if(buf_size < 0) {
     return 0;
   }
-  /* Parse 802.15.4-2006 frame, i.e. all fields before Information Elements */
-  if((ret = frame802154_parse((uint8_t *)buf, buf_size, frame)) < 3) {
+  /* Index the 802.15.4-2006 frame, i.e. all fields before Information
+     Elements. The ACK is checked on the index, and only what the caller
+     uses is decoded */
+  if((ret = frame802154_parse_index(buf, buf_size, &index)) < 3) {
     return 0;
   }
-  if(hdr_len != NULL) {
-    *hdr_len = ret;
-  }
   curr_len += ret;
 
   /* Check seqno */
-  if(seqno != frame->seq) {
+  if(index.seq_offset == 0 || buf[index.seq_offset] != seqno) {
     return 0;
   }
 
   /* Check destination PAN ID */
-  if(frame802154_check_dest_panid(frame) == 0) {
+  frame802154_has_panid(&index.fcf, NULL, &has_dest_panid);
+  dest_pid = frame802154_index_get_dest_pid(buf, &index);
+  if(!has_dest_panid ||
+     (dest_pid != frame802154_get_pan_id()
+      && dest_pid != FRAME802154_BROADCASTPANDID)) {
     return 0;
   }
 
   /* Check destination address (if any) */
-  if(frame802154_extract_linkaddr(frame, NULL, &dest) == 0 ||
-     (!linkaddr_cmp(&dest, &linkaddr_node_addr)
-      && !linkaddr_cmp(&dest, &linkaddr_null))) {
+  if(!eack_is_for_us(buf, &index)) {
     return 0;
   }
 
+  if(frame != NULL) {
+    frame802154_index_to_frame(buf, &index, frame);
+  }
   if(ies != NULL) {
     memset(ies, 0, sizeof(struct ieee802154_ies));
   }
 
-  if(frame->fcf.ie_list_present) {
+  if(index.fcf.ie_list_present) {
     int mic_len = 0;
 #if LLSEC802154_ENABLED
     /* Check if there is space for the security MIC (if any) */
+    if(frame == NULL) {
+      return 0;
+    }
     mic_len = tsch_security_mic_len(frame);
     if(buf_size < curr_len + mic_len) {
       return 0;
     }
 #endif /* LLSEC802154_ENABLED */
-    /* Parse information elements. We need to substract the MIC length, as the exact payload len is needed while parsing */
-    if((ret = frame802154e_parse_information_elements(buf + curr_len, buf_size - curr_len - mic_len, ies)) == -1) {
+    /* Index information elements. We need to substract the MIC length, as the exact payload len is needed while parsing */
+    if((ret = frame802154e_index_information_elements(buf + curr_len,
+                                                      buf_size - curr_len - mic_len,
+                                                      &ie_index)) == -1) {
       return 0;
     }
+    ie_payload_ie_offset = ie_index.ie_payload_ie_offset;
+    if(ies != NULL) {
+      if(ie_index.truncated) {
+        frame802154e_ie_index_decode(buf + curr_len, &ie_index, ies);
+      } else {
+        /* The time correction IE is all that an EACK carries for us */
+        ref = frame802154e_ie_index_find(&ie_index, IEEE802154_IE_KIND_HEADER,
+                                         HEADER_IE_ACK_NACK_TIME_CORRECTION);
+        frame802154e_ie_index_decode_ie(buf + curr_len, ref, ies);
+        ies->ie_payload_ie_offset = ie_payload_ie_offset;
+      }
+    }
     curr_len += ret;
   }
 
   if(hdr_len != NULL) {
-    *hdr_len += ies->ie_payload_ie_offset;
+    *hdr_len = index.hdr_len + ie_payload_ie_offset;
   }
 
   return curr_len;
@@ -387,6 +444,7 @@ int
 tsch_packet_parse_eb(const uint8_t *buf, int buf_size,
                      frame802154_t *frame, struct ieee802154_ies *ies, uint8_t *hdr_len, int frame_without_mic)
 {
+  frame802154_fcf_t fcf;
   uint8_t curr_len = 0;
   int ret;
 
@@ -394,6 +452,16 @@ tsch_packet_parse_eb(const uint8_t *buf, int buf_size,
     return 0;
   }
 
+  /* While scanning, most frames are not EBs: reject them on their frame
+     control field, before parsing anything else */
+  if(buf_size >= 2) {
+    frame802154_parse_fcf((uint8_t *)buf, &fcf);
+    if((fcf.frame_version < FRAME802154_IEEE802154_2015
+        || fcf.frame_type != FRAME802154_BEACONFRAME) && !LOG_INFO_ENABLED) {
+      return 0;
+    }
+  }
+
   /* Parse 802.15.4-2006 frame, i.e. all fields before Information Elements */
   if((ret = frame802154_parse((uint8_t *)buf, buf_size, frame)) == 0) {
     LOG_ERR("! parse_eb: failed to parse frame\n");
@@ -66,8 +66,9 @@ int tsch_packet_create_eack(uint8_t *buf, uint16_t buf_size,
  * \param buf The buffer where to parse the EACK from
  * \param buf_size The buffer size
  * \param seqno The sequence number we are expecting
- * \param frame The frame structure where to store parsed fields
- * \param ies The IE structure where to store parsed IEs
+ * \param frame The frame structure where to store parsed fields, or NULL
+ * if they are not needed. It is required when LLSEC802154_ENABLED is set
+ * \param ies The IE structure where to store the time correction IE
  * \param hdr_len A pointer where to store the length of the parsed header
  * \return 1 if the EACK is correct and acknowledges the specified frame, 0 otherwise
  */
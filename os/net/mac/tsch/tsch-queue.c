@@ -55,6 +55,11 @@
 #include "net/queuebuf.h"
 #include "net/mac/tsch/tsch.h"
 #include "net/nbr-table.h"
+#include "sys/critical.h"
+#if TSCH_QUEUE_WITH_PRIORITY
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
 #include <string.h>
 
 /* Log configuration */
@@ -66,6 +71,10 @@
 #if (TSCH_QUEUE_NUM_PER_NEIGHBOR & (TSCH_QUEUE_NUM_PER_NEIGHBOR - 1)) != 0
 #error TSCH_QUEUE_NUM_PER_NEIGHBOR must be power of two
 #endif
+#if TSCH_QUEUE_WITH_PRIORITY && \
+  (TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR & (TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR - 1)) != 0
+#error TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR must be power of two
+#endif
 
 /* We have as many packets are there are queuebuf in the system */
 MEMB(packet_memb, struct tsch_packet, QUEUEBUF_NUM);
@@ -75,6 +84,168 @@ NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_READY_SET
+/* Bitmaps of the unicast neighbors we have no Tx link to, i.e., those
+ * served by broadcast links, indexed by position in the neighbor table.
+ * Kept up to date on every queue and backoff change, so that
+ * tsch_queue_get_unicast_packet_for_any() finds a neighbor to serve
+ * without walking the neighbor table. */
+#define READY_SET_WORDS ((NBR_TABLE_MAX_NEIGHBORS + 31) / 32)
+/* Neighbors with packets queued */
+static uint32_t pending_set[READY_SET_WORDS];
+/* Neighbors with packets queued and an expired backoff */
+static uint32_t ready_set[READY_SET_WORDS];
+/* Neighbors with a backoff window running */
+static uint32_t backoff_set[READY_SET_WORDS];
+
+#ifdef __GNUC__
+#define first_set_bit(word) __builtin_ctzl(word)
+#else /* __GNUC__ */
+static int
+first_set_bit(uint32_t word)
+{
+  int bit;
+
+  for(bit = 0; (word & 1) == 0; bit++) {
+    word >>= 1;
+  }
+  return bit;
+}
+#endif /* __GNUC__ */
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+
+#if TSCH_QUEUE_WITH_PRIORITY
+static struct tsch_queue_class_stats class_stats[TSCH_QUEUE_NUM_CLASSES];
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
+
+/*---------------------------------------------------------------------------*/
+/* Is the neighbor queue empty? Lock-free, for internal use */
+static int
+nbr_queue_is_empty(const struct tsch_neighbor *n)
+{
+#if TSCH_QUEUE_WITH_PRIORITY
+  if(!ringbufindex_empty(&n->control_ringbuf)) {
+    return 0;
+  }
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
+  return ringbufindex_empty(&n->tx_ringbuf);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the head packet of a neighbor queue: control frames go first */
+static struct tsch_packet *
+nbr_queue_peek(const struct tsch_neighbor *n)
+{
+  int16_t get_index;
+#if TSCH_QUEUE_WITH_PRIORITY
+  get_index = ringbufindex_peek_get(&n->control_ringbuf);
+  if(get_index != -1) {
+    return n->control_array[get_index];
+  }
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
+  get_index = ringbufindex_peek_get(&n->tx_ringbuf);
+  if(get_index != -1) {
+    return n->tx_array[get_index];
+  }
+  return NULL;
+}
+#if TSCH_QUEUE_WITH_READY_SET
+/*---------------------------------------------------------------------------*/
+static int
+nbr_index(const struct tsch_neighbor *n)
+{
+  return n - (const struct tsch_neighbor *)tsch_neighbors->data;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_bit(uint32_t *set, int index, int value)
+{
+  if(value) {
+    set[index / 32] |= (uint32_t)1 << (index % 32);
+  } else {
+    set[index / 32] &= ~((uint32_t)1 << (index % 32));
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Update the bits of a neighbor. Called from both inside and outside of
+ * interrupts, hence the critical section. */
+static void
+ready_set_update(const struct tsch_neighbor *n)
+{
+  int index = nbr_index(n);
+  int no_tx_link = !n->is_broadcast && n->tx_links_count == 0;
+  int has_packets = no_tx_link && !nbr_queue_is_empty(n);
+  int_master_status_t status;
+
+  status = critical_enter();
+  set_bit(pending_set, index, has_packets);
+  set_bit(ready_set, index, has_packets && n->backoff_window == 0);
+  set_bit(backoff_set, index, no_tx_link && n->backoff_window != 0);
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ready_set_remove(const struct tsch_neighbor *n)
+{
+  int index = nbr_index(n);
+  int_master_status_t status;
+
+  status = critical_enter();
+  set_bit(pending_set, index, 0);
+  set_bit(ready_set, index, 0);
+  set_bit(backoff_set, index, 0);
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the first neighbor of a set, starting from a given index */
+static struct tsch_neighbor *
+ready_set_next(const uint32_t *set, int index)
+{
+  int word;
+  uint32_t bits;
+
+  if(index >= NBR_TABLE_MAX_NEIGHBORS) {
+    return NULL;
+  }
+  word = index / 32;
+  bits = set[word] & (~(uint32_t)0 << (index % 32));
+  while(bits == 0) {
+    if(++word == READY_SET_WORDS) {
+      return NULL;
+    }
+    bits = set[word];
+  }
+  return (struct tsch_neighbor *)tsch_neighbors->data
+    + word * 32 + first_set_bit(bits);
+}
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+#if TSCH_QUEUE_WITH_PRIORITY
+/*---------------------------------------------------------------------------*/
+/* The class of the packet in packetbuf */
+static uint8_t
+packet_class(void)
+{
+  if(packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE) != FRAME802154_DATAFRAME
+     || packetbuf_attr(PACKETBUF_ATTR_MAC_METADATA) /* 6P */
+     || packetbuf_datalen() == 0 /* Keepalive */
+     || packetbuf_attr(PACKETBUF_ATTR_NETWORK_ID) == UIP_PROTO_ICMP6) {
+    return TSCH_QUEUE_CLASS_CONTROL;
+  }
+  return TSCH_QUEUE_CLASS_DATA;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_class_stats(const struct tsch_packet *p)
+{
+  struct tsch_queue_class_stats *stats = &class_stats[p->queue_class];
+  uint32_t delay = TSCH_ASN_DIFF(tsch_current_asn, p->enqueue_asn);
+
+  stats->dequeued++;
+  stats->delay_sum += delay;
+  if(delay > stats->delay_max) {
+    stats->delay_max = delay;
+  }
+}
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -95,6 +266,9 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
         /* Initialize neighbor entry */
         memset(n, 0, sizeof(struct tsch_neighbor));
         ringbufindex_init(&n->tx_ringbuf, TSCH_QUEUE_NUM_PER_NEIGHBOR);
+#if TSCH_QUEUE_WITH_PRIORITY
+        ringbufindex_init(&n->control_ringbuf, TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR);
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
         tsch_queue_backoff_reset(n);
@@ -218,6 +392,10 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
       /* Flush queue */
       tsch_queue_flush_nbr_queue(n);
 
+#if TSCH_QUEUE_WITH_READY_SET
+      ready_set_remove(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+
       /* Free neighbor */
       nbr_table_remove(tsch_neighbors, n);
     }
@@ -245,7 +423,17 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
   if(!tsch_is_locked()) {
     n = tsch_queue_add_nbr(addr);
     if(n != NULL) {
-      put_index = ringbufindex_peek_put(&n->tx_ringbuf);
+#if TSCH_QUEUE_WITH_PRIORITY
+      uint8_t queue_class = packet_class();
+      struct ringbufindex *ring = queue_class == TSCH_QUEUE_CLASS_CONTROL
+        ? &n->control_ringbuf : &n->tx_ringbuf;
+      struct tsch_packet **array = queue_class == TSCH_QUEUE_CLASS_CONTROL
+        ? n->control_array : n->tx_array;
+#else /* TSCH_QUEUE_WITH_PRIORITY */
+      struct ringbufindex *ring = &n->tx_ringbuf;
+      struct tsch_packet **array = n->tx_array;
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
+      put_index = ringbufindex_peek_put(ring);
       if(put_index != -1) {
         p = memb_alloc(&packet_memb);
         if(p != NULL) {
@@ -257,9 +445,16 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             p->ret = MAC_TX_DEFERRED;
             p->transmissions = 0;
             p->max_transmissions = max_transmissions;
+#if TSCH_QUEUE_WITH_PRIORITY
+            p->queue_class = queue_class;
+            p->enqueue_asn = tsch_current_asn;
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
             /* Add to ringbuf (actual add committed through atomic operation) */
-            n->tx_array[put_index] = p;
-            ringbufindex_put(&n->tx_ringbuf);
+            array[put_index] = p;
+            ringbufindex_put(ring);
+#if TSCH_QUEUE_WITH_READY_SET
+            ready_set_update(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
             return p;
@@ -286,7 +481,12 @@ int
 tsch_queue_nbr_packet_count(const struct tsch_neighbor *n)
 {
   if(n != NULL) {
+#if TSCH_QUEUE_WITH_PRIORITY
+    return ringbufindex_elements(&n->control_ringbuf)
+      + ringbufindex_elements(&n->tx_ringbuf);
+#else /* TSCH_QUEUE_WITH_PRIORITY */
     return ringbufindex_elements(&n->tx_ringbuf);
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
   }
   return -1;
 }
@@ -297,13 +497,26 @@ tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
 {
   if(!tsch_is_locked()) {
     if(n != NULL) {
-      /* Get and remove packet from ringbuf (remove committed through an atomic operation */
-      int16_t get_index = ringbufindex_get(&n->tx_ringbuf);
+      struct tsch_packet *p = NULL;
+      int16_t get_index;
+#if TSCH_QUEUE_WITH_PRIORITY
+      /* Control frames go first */
+      get_index = ringbufindex_get(&n->control_ringbuf);
       if(get_index != -1) {
-        return n->tx_array[get_index];
-      } else {
-        return NULL;
+        p = n->control_array[get_index];
       }
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
+      if(p == NULL) {
+        /* Get and remove packet from ringbuf (remove committed through an atomic operation */
+        get_index = ringbufindex_get(&n->tx_ringbuf);
+        if(get_index != -1) {
+          p = n->tx_array[get_index];
+        }
+      }
+#if TSCH_QUEUE_WITH_READY_SET
+      ready_set_update(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+      return p;
     }
   }
   return NULL;
@@ -319,6 +532,29 @@ tsch_queue_free_packet(struct tsch_packet *p)
   }
 }
 /*---------------------------------------------------------------------------*/
+/* Remove a packet that was just sent or dropped */
+static void
+remove_sent_packet(struct tsch_neighbor *n, struct tsch_packet *p)
+{
+#if TSCH_QUEUE_WITH_PRIORITY
+  if(!tsch_is_locked()) {
+    /* A control frame may have been queued since p was picked, so p is not
+     * necessarily the head of the neighbor queue, but is the head of its ring */
+    if(p->queue_class == TSCH_QUEUE_CLASS_CONTROL) {
+      ringbufindex_get(&n->control_ringbuf);
+    } else {
+      ringbufindex_get(&n->tx_ringbuf);
+    }
+    update_class_stats(p);
+#if TSCH_QUEUE_WITH_READY_SET
+    ready_set_update(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+  }
+#else /* TSCH_QUEUE_WITH_PRIORITY */
+  tsch_queue_remove_packet_from_queue(n);
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
+}
+/*---------------------------------------------------------------------------*/
 /* Updates neighbor queue state after a transmission */
 int
 tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
@@ -330,7 +566,7 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
 
   if(mac_tx_status == MAC_TX_OK) {
     /* Successful transmission */
-    tsch_queue_remove_packet_from_queue(n);
+    remove_sent_packet(n, p);
     in_queue = 0;
 
     /* Update CSMA state in the unicast case */
@@ -345,7 +581,7 @@ tsch_queue_packet_sent(struct tsch_neighbor *n, struct tsch_packet *p,
     /* Failed transmission */
     if(p->transmissions >= p->max_transmissions) {
       /* Drop packet */
-      tsch_queue_remove_packet_from_queue(n);
+      remove_sent_packet(n, p);
       in_queue = 0;
     }
     /* Update CSMA state in the unicast case */
@@ -404,7 +640,7 @@ tsch_queue_free_unused_neighbors(void)
 int
 tsch_queue_is_empty(const struct tsch_neighbor *n)
 {
-  return !tsch_is_locked() && n != NULL && ringbufindex_empty(&n->tx_ringbuf);
+  return !tsch_is_locked() && n != NULL && nbr_queue_is_empty(n);
 }
 /*---------------------------------------------------------------------------*/
 /* Returns the first packet from a neighbor queue */
@@ -414,13 +650,13 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
   if(!tsch_is_locked()) {
     int is_shared_link = link != NULL && link->link_options & LINK_OPTION_SHARED;
     if(n != NULL) {
-      int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf);
-      if(get_index != -1 &&
+      struct tsch_packet *p = nbr_queue_peek(n);
+      if(p != NULL &&
           !(is_shared_link && !tsch_queue_backoff_expired(n))) {    /* If this is a shared link,
                                                                     make sure the backoff has expired */
 #if TSCH_WITH_LINK_SELECTOR
-        int packet_attr_slotframe = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
-        int packet_attr_timeslot = queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
+        int packet_attr_slotframe = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME);
+        int packet_attr_timeslot = queuebuf_attr(p->qb, PACKETBUF_ATTR_TSCH_TIMESLOT);
         if(packet_attr_slotframe != 0xffff && packet_attr_slotframe != link->slotframe_handle) {
           return NULL;
         }
@@ -428,7 +664,7 @@ tsch_queue_get_packet_for_nbr(const struct tsch_neighbor *n, struct tsch_link *l
           return NULL;
         }
 #endif
-        return n->tx_array[get_index];
+        return p;
       }
     }
   }
@@ -451,7 +687,15 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_WITH_READY_SET
+    /* Only look up neighbors with packets pending, and, on shared links,
+     * an expired backoff. Same order as a walk through the table. */
+    int is_shared_link = link != NULL && link->link_options & LINK_OPTION_SHARED;
+    const uint32_t *set = is_shared_link ? ready_set : pending_set;
+    struct tsch_neighbor *curr_nbr = ready_set_next(set, 0);
+#else /* TSCH_QUEUE_WITH_READY_SET */
     struct tsch_neighbor *curr_nbr = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
     struct tsch_packet *p = NULL;
     while(curr_nbr != NULL) {
       if(!curr_nbr->is_broadcast && curr_nbr->tx_links_count == 0) {
@@ -464,7 +708,11 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
           return p;
         }
       }
+#if TSCH_QUEUE_WITH_READY_SET
+      curr_nbr = ready_set_next(set, nbr_index(curr_nbr) + 1);
+#else /* TSCH_QUEUE_WITH_READY_SET */
       curr_nbr = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, curr_nbr);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
     }
   }
   return NULL;
@@ -483,6 +731,9 @@ tsch_queue_backoff_reset(struct tsch_neighbor *n)
 {
   n->backoff_window = 0;
   n->backoff_exponent = TSCH_MAC_MIN_BE;
+#if TSCH_QUEUE_WITH_READY_SET
+  ready_set_update(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
 }
 /*---------------------------------------------------------------------------*/
 /* Increment backoff exponent, pick a new window */
@@ -498,6 +749,9 @@ tsch_queue_backoff_inc(struct tsch_neighbor *n)
   /* Add one to the window as we will decrement it at the end of the current slot
    * through tsch_queue_update_all_backoff_windows */
   n->backoff_window++;
+#if TSCH_QUEUE_WITH_READY_SET
+  ready_set_update(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
 }
 /*---------------------------------------------------------------------------*/
 /* Decrement backoff window for all queues directed at dest_addr */
@@ -506,6 +760,25 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 {
   if(!tsch_is_locked()) {
     int is_broadcast = linkaddr_cmp(dest_addr, &tsch_broadcast_address);
+#if TSCH_QUEUE_WITH_READY_SET
+    struct tsch_neighbor *n;
+    if(is_broadcast) {
+      /* Neighbors we have no Tx link to back off on broadcast links */
+      n = ready_set_next(backoff_set, 0);
+      while(n != NULL) {
+        if(n->backoff_window != 0 && n->tx_links_count == 0) {
+          n->backoff_window--;
+          ready_set_update(n);
+        }
+        n = ready_set_next(backoff_set, nbr_index(n) + 1);
+      }
+    }
+    /* The neighbor we have Tx links to at dest_addr, if any */
+    n = (struct tsch_neighbor *)nbr_table_get_from_lladdr(tsch_neighbors, dest_addr);
+    if(n != NULL && n->backoff_window != 0 && n->tx_links_count > 0) {
+      n->backoff_window--;
+    }
+#else /* TSCH_QUEUE_WITH_READY_SET */
     struct tsch_neighbor *n = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
     while(n != NULL) {
       if(n->backoff_window != 0 /* Is the queue in backoff state? */
@@ -515,8 +788,37 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
       }
       n = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
     }
+#endif /* TSCH_QUEUE_WITH_READY_SET */
   }
 }
+#if TSCH_QUEUE_WITH_READY_SET
+/*---------------------------------------------------------------------------*/
+/* Update the ready set after the Tx links to a neighbor changed */
+void
+tsch_queue_update_ready_set(struct tsch_neighbor *n)
+{
+  if(n != NULL) {
+    ready_set_update(n);
+  }
+}
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+#if TSCH_QUEUE_WITH_PRIORITY
+/*---------------------------------------------------------------------------*/
+const struct tsch_queue_class_stats *
+tsch_queue_get_class_stats(enum tsch_queue_class queue_class)
+{
+  if(queue_class < TSCH_QUEUE_NUM_CLASSES) {
+    return &class_stats[queue_class];
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_queue_reset_class_stats(void)
+{
+  memset(class_stats, 0, sizeof(class_stats));
+}
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
 /*---------------------------------------------------------------------------*/
 /* Initialize TSCH queue module */
 void
@@ -47,6 +47,22 @@
 #include "net/linkaddr.h"
 #include "net/mac/mac.h"
 
+/********** Data types **********/
+
+/** \brief The classes of outgoing packets, in order of precedence */
+enum tsch_queue_class {
+  TSCH_QUEUE_CLASS_CONTROL,
+  TSCH_QUEUE_CLASS_DATA,
+  TSCH_QUEUE_NUM_CLASSES
+};
+
+/** \brief Queueing delay statistics of a packet class */
+struct tsch_queue_class_stats {
+  uint32_t dequeued; /* Packets removed from the queues after Tx or drop */
+  uint32_t delay_sum; /* Total time spent in the queues, in timeslots */
+  uint32_t delay_max; /* Longest time spent in the queues, in timeslots */
+};
+
 /***** External Variables *****/
 
 /* Broadcast and EB virtual neighbors */
@@ -179,6 +195,25 @@ void tsch_queue_backoff_inc(struct tsch_neighbor *n);
  * \param dest_addr The target address, &tsch_broadcast_address for broadcast
  */
 void tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr);
+#if TSCH_QUEUE_WITH_READY_SET
+/**
+ * \brief Update the ready set after the Tx links to a neighbor changed
+ * \param n The neighbor queue
+ */
+void tsch_queue_update_ready_set(struct tsch_neighbor *n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+#if TSCH_QUEUE_WITH_PRIORITY
+/**
+ * \brief Get the queueing delay statistics of a packet class
+ * \param queue_class The packet class
+ * \return The statistics, NULL if the class does not exist
+ */
+const struct tsch_queue_class_stats *tsch_queue_get_class_stats(enum tsch_queue_class queue_class);
+/**
+ * \brief Reset the queueing delay statistics of all packet classes
+ */
+void tsch_queue_reset_class_stats(void);
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
 /**
  * \brief Initialize TSCH queue module
  */
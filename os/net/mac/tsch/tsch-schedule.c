@@ -68,6 +68,84 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_INDEX
+/* The links of all slotframes, each slotframe in a contiguous range
+ * sorted by timeslot. Links with the same timeslot keep the order in
+ * which they were added, as in the slotframe's list */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t num_indexed_links;
+
+/*---------------------------------------------------------------------------*/
+/* Returns the position of the first link after timeslot in the range */
+static uint16_t
+index_upper_bound(struct tsch_link **links, uint16_t count, uint16_t timeslot)
+{
+  uint16_t low = 0;
+  uint16_t high = count;
+
+  while(low < high) {
+    uint16_t mid = (low + high) / 2;
+    if(links[mid]->timeslot <= timeslot) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
+{
+  struct tsch_slotframe *sf;
+  uint16_t pos;
+
+  pos = slotframe->first_indexed_link +
+    index_upper_bound(&link_index[slotframe->first_indexed_link],
+                      slotframe->num_indexed_links, l->timeslot);
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (num_indexed_links - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  num_indexed_links++;
+  slotframe->num_indexed_links++;
+
+  /* Shift the ranges of the slotframes that follow */
+  for(sf = list_head(slotframe_list); sf != NULL; sf = list_item_next(sf)) {
+    if(sf != slotframe && sf->first_indexed_link >= pos) {
+      sf->first_indexed_link++;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
+{
+  struct tsch_slotframe *sf;
+  uint16_t pos;
+  uint16_t end;
+
+  pos = slotframe->first_indexed_link;
+  end = pos + slotframe->num_indexed_links;
+  while(pos < end && link_index[pos] != l) {
+    pos++;
+  }
+  if(pos == end) {
+    return;
+  }
+
+  memmove(&link_index[pos], &link_index[pos + 1],
+          (num_indexed_links - pos - 1) * sizeof(link_index[0]));
+  num_indexed_links--;
+  slotframe->num_indexed_links--;
+
+  for(sf = list_head(slotframe_list); sf != NULL; sf = list_item_next(sf)) {
+    if(sf->first_indexed_link > pos) {
+      sf->first_indexed_link--;
+    }
+  }
+}
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -88,6 +166,10 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+      sf->first_indexed_link = num_indexed_links;
+      sf->num_indexed_links = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -256,6 +338,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_INDEX
+        index_add_link(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -274,6 +359,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
             if(!(l->link_options & LINK_OPTION_SHARED)) {
               n->dedicated_tx_links_count++;
             }
+#if TSCH_QUEUE_WITH_READY_SET
+            tsch_queue_update_ready_set(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
           }
         }
       }
@@ -309,6 +397,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_("\n");
 
       list_remove(slotframe->links_list, l);
+#if TSCH_SCHEDULE_WITH_INDEX
+      index_remove_link(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       memb_free(&link_memb, l);
 
       /* Release the lock before we update the neighbor (will take the lock) */
@@ -322,6 +413,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
           if(!(link_options & LINK_OPTION_SHARED)) {
             n->dedicated_tx_links_count--;
           }
+#if TSCH_QUEUE_WITH_READY_SET
+          tsch_queue_update_ready_set(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
         }
       }
 
@@ -390,8 +484,8 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   if(!linkaddr_cmp(&a->addr, &b->addr)) {
     struct tsch_neighbor *an = tsch_queue_get_nbr(&a->addr);
     struct tsch_neighbor *bn = tsch_queue_get_nbr(&b->addr);
-    int a_packet_count = an ? ringbufindex_elements(&an->tx_ringbuf) : 0;
-    int b_packet_count = bn ? ringbufindex_elements(&bn->tx_ringbuf) : 0;
+    int a_packet_count = an ? tsch_queue_nbr_packet_count(an) : 0;
+    int b_packet_count = bn ? tsch_queue_nbr_packet_count(bn) : 0;
     /* Compare the number of packets in the queue */
     return a_packet_count >= b_packet_count ? a : b;
   }
@@ -400,6 +494,57 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Considers link l, which occurs in time_to_timeslot slots, as the next
+ * active link against the current best and backup links */
+static void
+select_link(struct tsch_link *l, uint16_t time_to_timeslot,
+            struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+            struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != (*curr_best)->slotframe_handle) {
+        if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(*curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    if(*curr_backup == NULL) {
+      /* Check if 'l' best can be used as backup */
+      if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+        *curr_backup = l;
+      }
+      /* Check if curr_best can be used as backup */
+      if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
@@ -418,57 +563,40 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_INDEX
+      if(sf->num_indexed_links > 0) {
+        struct tsch_link **links = &link_index[sf->first_indexed_link];
+        uint16_t i;
+        uint16_t next_timeslot;
+        uint16_t time_to_timeslot;
+
+        /* Only the links at the first timeslot after the current one can
+         * be selected; past the last timeslot, wrap around */
+        i = index_upper_bound(links, sf->num_indexed_links, timeslot);
+        if(i == sf->num_indexed_links) {
+          i = 0;
+        }
+        next_timeslot = links[i]->timeslot;
+        time_to_timeslot = next_timeslot > timeslot ?
+          next_timeslot - timeslot :
+          sf->size.val + next_timeslot - timeslot;
+        for(; i < sf->num_indexed_links && links[i]->timeslot == next_timeslot; i++) {
+          select_link(links[i], time_to_timeslot,
+                      &curr_best, &time_to_curr_best, &curr_backup);
+        }
+      }
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          if(curr_backup == NULL) {
-            /* Check if 'l' best can be used as backup */
-            if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-              curr_backup = l;
-            }
-            /* Check if curr_best can be used as backup */
-            if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(l, time_to_timeslot,
+                    &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
@@ -489,6 +617,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+    num_indexed_links = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     tsch_release_lock();
     return 1;
   } else {
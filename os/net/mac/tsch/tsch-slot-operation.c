@@ -602,7 +602,9 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
               int is_time_source;
               struct ieee802154_ies ack_ies;
               uint8_t ack_hdrlen;
+#if LLSEC802154_ENABLED
               frame802154_t frame;
+#endif /* LLSEC802154_ENABLED */
 
 #if TSCH_HW_FRAME_FILTERING
               radio_value_t radio_rx_mode;
@@ -641,8 +643,14 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
               /* The radio driver should return 0 if no valid packets are in the rx buffer */
               if(ack_len > 0) {
                 is_time_source = current_neighbor != NULL && current_neighbor->is_time_source;
+                /* The header fields are only decoded for the security checks */
+#if LLSEC802154_ENABLED
                 if(tsch_packet_parse_eack(ackbuf, ack_len, seqno,
                     &frame, &ack_ies, &ack_hdrlen) == 0) {
+#else /* LLSEC802154_ENABLED */
+                if(tsch_packet_parse_eack(ackbuf, ack_len, seqno,
+                    NULL, &ack_ies, &ack_hdrlen) == 0) {
+#endif /* LLSEC802154_ENABLED */
                   ack_len = 0;
                 }
 
@@ -91,6 +91,11 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+  /* The links of this slotframe in the schedule index, sorted by timeslot */
+  uint16_t first_indexed_link;
+  uint16_t num_indexed_links;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 };
 
 /** \brief TSCH packet information */
@@ -103,6 +108,10 @@ struct tsch_packet {
   uint8_t ret; /* status -- MAC return code */
   uint8_t header_len; /* length of header and header IEs (needed for link-layer security) */
   uint8_t tsch_sync_ie_offset; /* Offset within the frame used for quick update of EB ASN and join priority */
+#if TSCH_QUEUE_WITH_PRIORITY
+  uint8_t queue_class; /* Control or data, see enum tsch_queue_class */
+  struct tsch_asn_t enqueue_asn; /* ASN at which the packet was queued */
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
 };
 
 /** \brief TSCH neighbor information */
@@ -119,6 +128,11 @@ struct tsch_neighbor {
   struct tsch_packet *tx_array[TSCH_QUEUE_NUM_PER_NEIGHBOR];
   /* Circular buffer of pointers to packet. */
   struct ringbufindex tx_ringbuf;
+#if TSCH_QUEUE_WITH_PRIORITY
+  /* Same for control frames, which are sent before any packet of tx_ringbuf */
+  struct tsch_packet *control_array[TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR];
+  struct ringbufindex control_ringbuf;
+#endif /* TSCH_QUEUE_WITH_PRIORITY */
 };
 
 /** \brief TSCH timeslot timing elements. Used to index timeslot timing
@@ -83,6 +83,30 @@ static unsigned num_tables;
 MEMB(neighbor_addr_mem, nbr_table_key_t, NBR_TABLE_MAX_NEIGHBORS);
 LIST(nbr_table_keys);
 
+#if NBR_TABLE_WITH_HASH
+/* The hash index has at least twice as many slots as there are
+ * neighbors, rounded up to a power of two. Each slot holds a neighbor
+ * index plus one, or zero when empty. Collisions are resolved by
+ * linear probing, and removals shift entries back instead of leaving
+ * tombstones, so lookups stay short even after many evictions. */
+#define HASH_SLOTS_MIN (2 * NBR_TABLE_MAX_NEIGHBORS)
+#define HASH_BITS (HASH_SLOTS_MIN <= 16 ? 4 : \
+                   HASH_SLOTS_MIN <= 64 ? 6 : \
+                   HASH_SLOTS_MIN <= 256 ? 8 : \
+                   HASH_SLOTS_MIN <= 1024 ? 10 : 12)
+#define HASH_SLOTS (1 << HASH_BITS)
+#if HASH_SLOTS_MIN > HASH_SLOTS
+/* A fuller table could have no empty slot left to end a probe */
+#error "NBR_TABLE_CONF_WITH_HASH supports at most 2048 neighbors"
+#endif
+#if NBR_TABLE_MAX_NEIGHBORS < 255
+typedef uint8_t hash_slot_t;
+#else
+typedef uint16_t hash_slot_t;
+#endif
+static hash_slot_t hash_index[HASH_SLOTS];
+#endif /* NBR_TABLE_WITH_HASH */
+
 /*---------------------------------------------------------------------------*/
 /* Get a key from a neighbor index */
 static nbr_table_key_t *
@@ -126,6 +150,68 @@ key_from_item(nbr_table_t *table, const nbr_table_item_t *item)
   return key_from_index(index_from_item(table, item));
 }
 /*---------------------------------------------------------------------------*/
+#if NBR_TABLE_WITH_HASH
+static unsigned
+hash_lladdr(const linkaddr_t *lladdr)
+{
+  unsigned i;
+  uint32_t hash = 0;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    hash = hash * 31 + lladdr->u8[i];
+  }
+  /* Fibonacci hashing: consecutive addresses are spread apart */
+  return (uint32_t)(hash * 2654435769UL) >> (32 - HASH_BITS);
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_add(nbr_table_key_t *key)
+{
+  unsigned slot = hash_lladdr(&key->lladdr);
+
+  while(hash_index[slot] != 0) {
+    slot = (slot + 1) & (HASH_SLOTS - 1);
+  }
+  hash_index[slot] = index_from_key(key) + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+hash_remove(nbr_table_key_t *key)
+{
+  unsigned slot;
+  unsigned next;
+  unsigned home;
+  hash_slot_t value = index_from_key(key) + 1;
+
+  for(slot = hash_lladdr(&key->lladdr); hash_index[slot] != value;
+      slot = (slot + 1) & (HASH_SLOTS - 1)) {
+    if(hash_index[slot] == 0) {
+      /* Not indexed */
+      return;
+    }
+  }
+
+  /* Shift back the following entries of the cluster that would no
+   * longer be found once this slot is emptied */
+  next = slot;
+  while(1) {
+    hash_index[slot] = 0;
+    do {
+      next = (next + 1) & (HASH_SLOTS - 1);
+      if(hash_index[next] == 0) {
+        return;
+      }
+      home = hash_lladdr(&key_from_index(hash_index[next] - 1)->lladdr);
+      /* Keep the entry where it is if its home slot lies cyclically
+       * in (slot, next] */
+    } while(slot <= next ? (slot < home && home <= next)
+                         : (slot < home || home <= next));
+    hash_index[slot] = hash_index[next];
+    slot = next;
+  }
+}
+#endif /* NBR_TABLE_WITH_HASH */
+/*---------------------------------------------------------------------------*/
 /* Get the index of a neighbor from its link-layer address */
 static int
 index_from_lladdr(const linkaddr_t *lladdr)
@@ -136,6 +222,19 @@ index_from_lladdr(const linkaddr_t *lladdr)
   if(lladdr == NULL) {
     lladdr = &linkaddr_null;
   }
+#if NBR_TABLE_WITH_HASH
+  {
+    unsigned slot;
+    for(slot = hash_lladdr(lladdr); hash_index[slot] != 0;
+        slot = (slot + 1) & (HASH_SLOTS - 1)) {
+      key = key_from_index(hash_index[slot] - 1);
+      if(linkaddr_cmp(lladdr, &key->lladdr)) {
+        return hash_index[slot] - 1;
+      }
+    }
+    return -1;
+  }
+#endif /* NBR_TABLE_WITH_HASH */
   key = list_head(nbr_table_keys);
   while(key != NULL) {
     if(lladdr && linkaddr_cmp(lladdr, &key->lladdr)) {
@@ -195,6 +294,9 @@ remove_key(nbr_table_key_t *least_used_key)
   used_map[index_from_key(least_used_key)] = 0;
   /* Remove neighbor from list */
   list_remove(nbr_table_keys, least_used_key);
+#if NBR_TABLE_WITH_HASH
+  hash_remove(least_used_key);
+#endif /* NBR_TABLE_WITH_HASH */
 }
 /*---------------------------------------------------------------------------*/
 static nbr_table_key_t *
@@ -381,6 +483,9 @@ nbr_table_add_lladdr(nbr_table_t *table, const linkaddr_t *lladdr, nbr_table_rea
 
     /* Set link-layer address */
     linkaddr_copy(&key->lladdr, lladdr);
+#if NBR_TABLE_WITH_HASH
+    hash_add(key);
+#endif /* NBR_TABLE_WITH_HASH */
   }
 
   /* Get item in the current table */
@@ -38,6 +38,7 @@
  */
 
 #include "net/netstack.h"
+#include "net/packetbuf.h"
 #include "lib/list.h"
 
 /* The list of IP processors that will process IP packets before uip or after */
@@ -82,6 +83,65 @@ uip_ds6_ip_packet_processor_rm(struct netstack_ip_packet_processor *p)
   list_remove(ip_processor_list, p);
 }
 
+/*---------------------------------------------------------------------------*/
+int
+netstack_rx_frame_to_packetbuf(const struct radio_rx_frame *frame)
+{
+  if(frame->len == 0 || frame->len > PACKETBUF_SIZE) {
+    return 0;
+  }
+  packetbuf_clear();
+  packetbuf_copyfrom(frame->data, frame->len);
+  packetbuf_set_attr(PACKETBUF_ATTR_RSSI, frame->rssi);
+  packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY, frame->link_quality);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Read the frames pending in the radio and pass them to the MAC layer. If the
+ * radio supports batched reads, up to NETSTACK_RX_BATCH_SIZE frames are read
+ * at a time, and passed in a single call to MACs that support batched input.
+ * Otherwise, a single frame is read into packetbuf. Returns the number of
+ * frames passed to the MAC layer. */
+int
+netstack_radio_input(void)
+{
+  struct radio_rx_frame frames[NETSTACK_RX_BATCH_SIZE];
+  int count;
+  int total;
+  int i;
+  int len;
+
+  if(NETSTACK_RADIO.read_batch == NULL) {
+    packetbuf_clear();
+    len = NETSTACK_RADIO.read(packetbuf_dataptr(), PACKETBUF_SIZE);
+    if(len <= 0) {
+      return 0;
+    }
+    packetbuf_set_datalen(len);
+    NETSTACK_MAC.input();
+    return 1;
+  }
+
+  total = 0;
+  do {
+    count = NETSTACK_RADIO.read_batch(frames, NETSTACK_RX_BATCH_SIZE);
+    if(count <= 0) {
+      break;
+    }
+    if(NETSTACK_MAC.input_batch != NULL) {
+      NETSTACK_MAC.input_batch(frames, count);
+    } else {
+      for(i = 0; i < count; i++) {
+        if(netstack_rx_frame_to_packetbuf(&frames[i])) {
+          NETSTACK_MAC.input();
+        }
+      }
+    }
+    total += count;
+  } while(count == NETSTACK_RX_BATCH_SIZE);
+
+  return total;
+}
 /*---------------------------------------------------------------------------*/
 void
 netstack_init(void)
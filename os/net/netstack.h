@@ -106,6 +106,14 @@
 #define NETSTACK_FRAMER   framer_802154
 #endif /* NETSTACK_CONF_FRAMER */
 
+/* Maximum number of frames read from the radio in one batch, see
+   netstack_radio_input() */
+#ifdef NETSTACK_CONF_RX_BATCH_SIZE
+#define NETSTACK_RX_BATCH_SIZE NETSTACK_CONF_RX_BATCH_SIZE
+#else /* NETSTACK_CONF_RX_BATCH_SIZE */
+#define NETSTACK_RX_BATCH_SIZE 4
+#endif /* NETSTACK_CONF_RX_BATCH_SIZE */
+
 #include "net/mac/mac.h"
 #include "net/mac/framer/framer.h"
 #include "dev/radio.h"
@@ -135,6 +143,13 @@ extern const struct framer NETSTACK_FRAMER;
 
 void netstack_init(void);
 
+/* Read the frames pending in the radio and pass them to the MAC layer.
+   Meant to be called from the RX process of a radio driver. */
+int netstack_radio_input(void);
+/* Copy a frame read with the radio's read_batch() to packetbuf. Returns 0
+   if the frame does not fit. */
+int netstack_rx_frame_to_packetbuf(const struct radio_rx_frame *frame);
+
 /* Netstack ip_packet_processor - for implementing packet filters, firewalls,
    debuggin info, etc */
 
@@ -54,13 +54,57 @@ struct packetbuf_addr packetbuf_addrs[PACKETBUF_NUM_ADDRS];
 
 static uint16_t buflen, bufptr;
 static uint8_t hdrlen;
+/* Offset of the first header byte in the storage */
+static uint16_t hdroff = PACKETBUF_HEADROOM;
 
+#define PACKETBUF_BUFSIZE (PACKETBUF_HEADROOM + PACKETBUF_SIZE)
+
+#if PACKETBUF_WITH_POOL
+#include "net/queuebuf.h"
+
+#ifdef PACKETBUF_CONF_POOL_SIZE
+#define PACKETBUF_POOL_SIZE PACKETBUF_CONF_POOL_SIZE
+#else
+#define PACKETBUF_POOL_SIZE (QUEUEBUF_NUM + 1)
+#endif
+
+/* Every queuebuf holds at most one block and the packetbuf holds one
+   more, so packetbuf_clear() always finds a free block. */
+#if PACKETBUF_POOL_SIZE < QUEUEBUF_NUM + 1
+#error "PACKETBUF_CONF_POOL_SIZE must be at least QUEUEBUF_NUM + 1"
+#endif
+
+/* A block is held by the packetbuf and at most every queuebuf, plus one
+   more reference while packetbuf_set_block() switches blocks. The count
+   must fit in the 8-bit refcount below. */
+#if QUEUEBUF_NUM + 2 > 255
+#error "QUEUEBUF_CONF_NUM is too large for the packetbuf block refcount"
+#endif
+
+struct packetbuf_block {
+  /* Number of holders, zero when the block is free */
+  uint8_t refcount;
+  /* Lowest offset referenced by a holder other than the packetbuf.
+     Bytes below it are headroom the packetbuf may still write. */
+  uint16_t shared_lo;
+  /* Aligned on a 32-bit boundary, see below */
+  uint32_t data[(PACKETBUF_BUFSIZE + 3) / 4];
+};
+
+/* Block 0 backs the packetbuf at startup */
+static struct packetbuf_block blocks[PACKETBUF_POOL_SIZE] = {
+  { 1, PACKETBUF_BUFSIZE, { 0 } }
+};
+static struct packetbuf_block *current = &blocks[0];
+static uint8_t *packetbuf = (uint8_t *)blocks[0].data;
+#else /* PACKETBUF_WITH_POOL */
 /* The declarations below ensure that the packet buffer is aligned on
    an even 32-bit boundary. On some platforms (most notably the
    msp430 or OpenRISC), having a potentially misaligned packet buffer may lead to
    problems when accessing words. */
-static uint32_t packetbuf_aligned[(PACKETBUF_SIZE + 3) / 4];
+static uint32_t packetbuf_aligned[(PACKETBUF_BUFSIZE + 3) / 4];
 static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
+#endif /* PACKETBUF_WITH_POOL */
 
 #define DEBUG 0
 #if DEBUG
@@ -70,12 +114,128 @@ static uint8_t *packetbuf = (uint8_t *)packetbuf_aligned;
 #define PRINTF(...)
 #endif
 
+#if PACKETBUF_WITH_POOL
+/*---------------------------------------------------------------------------*/
+static struct packetbuf_block *
+block_alloc(void)
+{
+  int i;
+
+  for(i = 0; i < PACKETBUF_POOL_SIZE; i++) {
+    if(blocks[i].refcount == 0) {
+      blocks[i].refcount = 1;
+      blocks[i].shared_lo = PACKETBUF_BUFSIZE;
+      return &blocks[i];
+    }
+  }
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_current(struct packetbuf_block *b)
+{
+  current = b;
+  packetbuf = (uint8_t *)b->data;
+}
+/*---------------------------------------------------------------------------*/
+struct packetbuf_block *
+packetbuf_block_ref(uint16_t *offset, uint16_t *len)
+{
+  if(hdrlen > 0 && bufptr > 0) {
+    /* packetbuf_copyto() skips the reduced bytes between the header and
+       the data: close the gap so that the packet is contiguous */
+    if(!packetbuf_make_writable()) {
+      return NULL;
+    }
+    memmove(packetbuf + hdroff + bufptr, packetbuf + hdroff, hdrlen);
+    hdroff += bufptr;
+    bufptr = 0;
+  }
+
+  *offset = hdroff + bufptr;
+  *len = hdrlen + buflen > PACKETBUF_SIZE ? 0 : hdrlen + buflen;
+  if(*offset < current->shared_lo) {
+    current->shared_lo = *offset;
+  }
+  current->refcount++;
+  return current;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_block_unref(struct packetbuf_block *b)
+{
+  if(b == NULL || b->refcount == 0) {
+    return;
+  }
+  b->refcount--;
+  if(b->refcount == 1 && b == current) {
+    /* The packetbuf is the only holder left */
+    b->shared_lo = PACKETBUF_BUFSIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint8_t *
+packetbuf_block_data(struct packetbuf_block *b)
+{
+  return (uint8_t *)b->data;
+}
+/*---------------------------------------------------------------------------*/
+void
+packetbuf_set_block(struct packetbuf_block *b, uint16_t offset, uint16_t len)
+{
+  struct packetbuf_block *old = current;
+
+  b->refcount++;
+  set_current(b);
+  packetbuf_block_unref(old);
+
+  hdroff = offset;
+  buflen = len;
+  bufptr = 0;
+  hdrlen = 0;
+}
+#endif /* PACKETBUF_WITH_POOL */
+/*---------------------------------------------------------------------------*/
+int
+packetbuf_make_writable(void)
+{
+#if PACKETBUF_WITH_POOL
+  struct packetbuf_block *b;
+
+  if(current->refcount <= 1) {
+    return 1;
+  }
+
+  b = block_alloc();
+  if(b == NULL) {
+    PRINTF("packetbuf_make_writable: no free block\n");
+    return 0;
+  }
+  memcpy((uint8_t *)b->data + hdroff, packetbuf + hdroff, packetbuf_totlen());
+  current->refcount--;
+  set_current(b);
+#endif /* PACKETBUF_WITH_POOL */
+  return 1;
+}
 /*---------------------------------------------------------------------------*/
 void
 packetbuf_clear(void)
 {
+#if PACKETBUF_WITH_POOL
+  if(current->refcount > 1) {
+    /* The packet is still queued: leave it to its other holders */
+    struct packetbuf_block *b = block_alloc();
+    if(b != NULL) {
+      current->refcount--;
+      set_current(b);
+    } else {
+      PRINTF("packetbuf_clear: no free block\n");
+    }
+  }
+#endif /* PACKETBUF_WITH_POOL */
   buflen = bufptr = 0;
   hdrlen = 0;
+  hdroff = PACKETBUF_HEADROOM;
 
   packetbuf_attr_clear();
 }
@@ -87,7 +247,7 @@ packetbuf_copyfrom(const void *from, uint16_t len)
 
   packetbuf_clear();
   l = MIN(PACKETBUF_SIZE, len);
-  memcpy(packetbuf, from, l);
+  memcpy(packetbuf + hdroff, from, l);
   buflen = l;
   return l;
 }
@@ -106,16 +266,26 @@ packetbuf_copyto(void *to)
 int
 packetbuf_hdralloc(int size)
 {
-  int16_t i;
-
   if(size + packetbuf_totlen() > PACKETBUF_SIZE) {
     return 0;
   }
 
-  /* shift data to the right */
-  for(i = packetbuf_totlen() - 1; i >= 0; i--) {
-    packetbuf[i + size] = packetbuf[i];
+#if PACKETBUF_WITH_POOL
+  if(size > hdroff || hdroff > current->shared_lo) {
+    /* Either the headroom belongs to a queued packet or the packet has
+       to be shifted: both need a private copy */
+    if(!packetbuf_make_writable()) {
+      return 0;
+    }
+  }
+#endif /* PACKETBUF_WITH_POOL */
+
+  if(size > hdroff) {
+    /* Not enough headroom: shift data to the right */
+    memmove(packetbuf + size, packetbuf + hdroff, packetbuf_totlen());
+    hdroff = size;
   }
+  hdroff -= size;
   hdrlen += size;
   return 1;
 }
@@ -142,13 +312,13 @@ packetbuf_set_datalen(uint16_t len)
 void *
 packetbuf_dataptr(void)
 {
-  return packetbuf + packetbuf_hdrlen();
+  return packetbuf + hdroff + packetbuf_hdrlen();
 }
 /*---------------------------------------------------------------------------*/
 void *
 packetbuf_hdrptr(void)
 {
-  return packetbuf;
+  return packetbuf + hdroff;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
@@ -55,6 +55,7 @@
 #include "contiki.h"
 #include "net/linkaddr.h"
 #include "net/mac/llsec802154.h"
+#include "net/mac/csma/csma-conf.h"
 #include "net/mac/csma/csma-security.h"
 #include "net/mac/tsch/tsch-conf.h"
 
@@ -67,6 +68,33 @@
 #define PACKETBUF_SIZE 128
 #endif
 
+/**
+ * \brief      Bytes reserved in front of the packet for MAC headers
+ *
+ *             With a non-zero headroom, packetbuf_hdralloc() can
+ *             usually grow the header in place instead of shifting the
+ *             whole packet to the right.
+ */
+#ifdef PACKETBUF_CONF_HEADROOM
+#define PACKETBUF_HEADROOM PACKETBUF_CONF_HEADROOM
+#else
+#define PACKETBUF_HEADROOM 0
+#endif
+
+/**
+ * \brief      Back the packetbuf with a pool of reference-counted blocks
+ *
+ *             When enabled, the packetbuf is a view onto one block of
+ *             a pool. The queuebuf module takes a reference on that
+ *             block instead of copying the packet, and hands it back
+ *             to the packetbuf without copying it again.
+ */
+#ifdef PACKETBUF_CONF_WITH_POOL
+#define PACKETBUF_WITH_POOL PACKETBUF_CONF_WITH_POOL
+#else
+#define PACKETBUF_WITH_POOL 0
+#endif
+
 /**
  * \brief      Clear and reset the packetbuf
  *
@@ -192,6 +220,64 @@ int packetbuf_hdralloc(int size);
  */
 int packetbuf_hdrreduce(int size);
 
+/**
+ * \brief      Make sure the packetbuf may be modified in place
+ * \retval     Non-zero if the packetbuf is writable, zero otherwise
+ *
+ *             Code that modifies a packet that may still be queued
+ *             (e.g. after queuebuf_to_packetbuf()) must call this
+ *             function first. With PACKETBUF_WITH_POOL, a packet
+ *             shared with a queuebuf is copied to a private block;
+ *             otherwise the function does nothing.
+ *
+ */
+int packetbuf_make_writable(void);
+
+#if PACKETBUF_WITH_POOL
+struct packetbuf_block;
+
+/**
+ * \brief      Take a reference on the block holding the packet
+ * \param offset Set to the offset of the packet within the block
+ * \param len  Set to the length of the packet
+ * \retval     The referenced block
+ *
+ *             The referenced bytes are the ones packetbuf_copyto()
+ *             would have copied. The block is not modified while the
+ *             reference is held: the packetbuf moves to a new block
+ *             on the next packetbuf_clear() or packetbuf_make_writable().
+ *
+ */
+struct packetbuf_block *packetbuf_block_ref(uint16_t *offset, uint16_t *len);
+
+/**
+ * \brief      Release a reference taken with packetbuf_block_ref()
+ * \param b    The block
+ */
+void packetbuf_block_unref(struct packetbuf_block *b);
+
+/**
+ * \brief      Get a pointer to the storage of a block
+ * \param b    The block
+ * \return     Pointer to the first byte of the block
+ */
+uint8_t *packetbuf_block_data(struct packetbuf_block *b);
+
+/**
+ * \brief      Make the packetbuf a view onto a referenced block
+ * \param b    The block
+ * \param offset The offset of the packet within the block
+ * \param len  The length of the packet
+ *
+ *             This is the zero-copy counterpart of packetbuf_copyfrom().
+ *             The packetbuf takes its own reference on the block.
+ *             Attributes are left untouched.
+ *
+ */
+void packetbuf_set_block(struct packetbuf_block *b, uint16_t offset,
+                         uint16_t len);
+#endif /* PACKETBUF_WITH_POOL */
+
 /* Packet attributes stuff below: */
 
 typedef uint16_t packetbuf_attr_t;
@@ -224,6 +310,9 @@ enum {
   PACKETBUF_ATTR_MAC_METADATA,
   PACKETBUF_ATTR_MAC_NO_SRC_ADDR,
   PACKETBUF_ATTR_MAC_NO_DEST_ADDR,
+#if CSMA_BURST_LIMIT > 1
+  PACKETBUF_ATTR_MAC_FRAME_PENDING,
+#endif /* CSMA_BURST_LIMIT > 1 */
 #if TSCH_WITH_LINK_SELECTOR
   PACKETBUF_ATTR_TSCH_SLOTFRAME,
   PACKETBUF_ATTR_TSCH_TIMESLOT,
@@ -51,6 +51,16 @@
 
 #include <string.h> /* for memcpy() */
 
+#if PACKETBUF_WITH_POOL
+#if WITH_SWAP
+#error "PACKETBUF_CONF_WITH_POOL cannot be used with swapped queuebufs"
+#endif /* WITH_SWAP */
+#if MAC_CONF_WITH_TSCH
+/* TSCH modifies queued frames in place from its slot operation */
+#error "PACKETBUF_CONF_WITH_POOL cannot be used with TSCH"
+#endif /* MAC_CONF_WITH_TSCH */
+#endif /* PACKETBUF_WITH_POOL */
+
 /* Structure pointing to a buffer either stored
    in RAM or swapped in CFS */
 struct queuebuf {
@@ -73,7 +83,13 @@ struct queuebuf {
 
 /* The actual queuebuf data */
 struct queuebuf_data {
+#if PACKETBUF_WITH_POOL
+  /* The packet is kept in the packetbuf block it was created in */
+  struct packetbuf_block *block;
+  uint16_t offset;
+#else /* PACKETBUF_WITH_POOL */
   uint8_t data[PACKETBUF_SIZE];
+#endif /* PACKETBUF_WITH_POOL */
   uint16_t len;
   struct packetbuf_attr attrs[PACKETBUF_NUM_ATTRS];
   struct packetbuf_addr addrs[PACKETBUF_NUM_ADDRS];
@@ -340,7 +356,17 @@ queuebuf_new_from_packetbuf(void)
     buframptr = buf->ram_ptr;
 #endif
 
+#if PACKETBUF_WITH_POOL
+    buframptr->block = packetbuf_block_ref(&buframptr->offset, &buframptr->len);
+    if(buframptr->block == NULL) {
+      PRINTF("queuebuf_new_from_packetbuf: could not reference packetbuf\n");
+      memb_free(&buframmem, buframptr);
+      memb_free(&bufmem, buf);
+      return NULL;
+    }
+#else /* PACKETBUF_WITH_POOL */
     buframptr->len = packetbuf_copyto(buframptr->data);
+#endif /* PACKETBUF_WITH_POOL */
     packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
 
 #if WITH_SWAP
@@ -384,7 +410,20 @@ queuebuf_update_from_packetbuf(struct queuebuf *buf)
 {
   struct queuebuf_data *buframptr = queuebuf_load_to_ram(buf);
   packetbuf_attr_copyto(buframptr->attrs, buframptr->addrs);
+#if PACKETBUF_WITH_POOL
+  {
+    struct packetbuf_block *old = buframptr->block;
+    buframptr->block = packetbuf_block_ref(&buframptr->offset, &buframptr->len);
+    if(buframptr->block == NULL) {
+      /* Keep the previous contents */
+      buframptr->block = old;
+    } else {
+      packetbuf_block_unref(old);
+    }
+  }
+#else /* PACKETBUF_WITH_POOL */
   buframptr->len = packetbuf_copyto(buframptr->data);
+#endif /* PACKETBUF_WITH_POOL */
 #if WITH_SWAP
   if(buf->location == IN_CFS) {
     queuebuf_flush_tmpdata();
@@ -403,6 +442,9 @@ queuebuf_free(struct queuebuf *buf)
       queuebuf_remove_from_file(buf->swap_id);
     }
 #else
+#if PACKETBUF_WITH_POOL
+    packetbuf_block_unref(buf->ram_ptr->block);
+#endif /* PACKETBUF_WITH_POOL */
     memb_free(&buframmem, buf->ram_ptr);
 #endif
     memb_free(&bufmem, buf);
@@ -421,7 +463,11 @@ queuebuf_to_packetbuf(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if PACKETBUF_WITH_POOL
+    packetbuf_set_block(buframptr->block, buframptr->offset, buframptr->len);
+#else /* PACKETBUF_WITH_POOL */
     packetbuf_copyfrom(buframptr->data, buframptr->len);
+#endif /* PACKETBUF_WITH_POOL */
     packetbuf_attr_copyfrom(buframptr->attrs, buframptr->addrs);
   }
 }
@@ -431,7 +477,11 @@ queuebuf_dataptr(struct queuebuf *b)
 {
   if(memb_inmemb(&bufmem, b)) {
     struct queuebuf_data *buframptr = queuebuf_load_to_ram(b);
+#if PACKETBUF_WITH_POOL
+    return packetbuf_block_data(buframptr->block) + buframptr->offset;
+#else /* PACKETBUF_WITH_POOL */
     return buframptr->data;
+#endif /* PACKETBUF_WITH_POOL */
   }
   return NULL;
 }
@@ -313,6 +313,17 @@ insert_srh_header(void)
     return 0;
   }
 
+#if UIP_SR_SRH_CACHE_SIZE
+  {
+    /* The route to this destination may already have been computed since
+     * the last topology change */
+    int cached = uip_sr_srh_cache_insert_hdr(dag);
+    if(cached != 0) {
+      return cached > 0;
+    }
+  }
+#endif /* UIP_SR_SRH_CACHE_SIZE */
+
   dest_node = uip_sr_get_node(dag, &UIP_IP_BUF->destipaddr);
   if(dest_node == NULL) {
     /* The destination is not found, skip SRH insertion */
@@ -408,6 +419,10 @@ insert_srh_header(void)
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
   NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+#if UIP_SR_SRH_CACHE_SIZE
+  uip_sr_srh_cache_add(dag, &UIP_IP_BUF->destipaddr, &node_addr,
+                       (uint8_t *)rh_hdr, ext_len);
+#endif /* UIP_SR_SRH_CACHE_SIZE */
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field */
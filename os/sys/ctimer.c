@@ -46,6 +46,17 @@
 #include "contiki.h"
 #include "lib/list.h"
 
+#include <stddef.h>
+
+/*
+ * With ETIMER_HEAP, the list only holds the callback timers that were
+ * set before ctimer_process started. Afterwards, timers are tracked
+ * by the etimer heap alone and the active flag tells whether a
+ * callback is pending, so that no operation needs to walk a list.
+ * A timer event that is still queued when its ctimer is stopped or set
+ * again is removed from the event queue, so that ctimer_process never
+ * sees a pointer to a ctimer that may have been freed since.
+ */
 LIST(ctimer_list);
 
 static char initialized;
@@ -69,9 +80,24 @@ PROCESS_THREAD(ctimer_process, ev, data)
     etimer_set(&c->etimer, c->etimer.timer.interval);
   }
   initialized = 1;
+#if ETIMER_HEAP
+  list_init(ctimer_list);
+#endif /* ETIMER_HEAP */
 
   while(1) {
     PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_TIMER);
+#if ETIMER_HEAP
+    /* All event timers owned by this process are embedded in a ctimer */
+    c = (struct ctimer *)((char *)data - offsetof(struct ctimer, etimer));
+    if(c->active) {
+      c->active = 0;
+      PROCESS_CONTEXT_BEGIN(c->p);
+      if(c->f != NULL) {
+        c->f(c->ptr);
+      }
+      PROCESS_CONTEXT_END(c->p);
+    }
+#else /* ETIMER_HEAP */
     for(c = list_head(ctimer_list); c != NULL; c = c->next) {
       if(&c->etimer == data) {
         list_remove(ctimer_list, c);
@@ -83,10 +109,46 @@ PROCESS_THREAD(ctimer_process, ev, data)
         break;
       }
     }
+#endif /* ETIMER_HEAP */
   }
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP
+static void
+cancel_pending(struct ctimer *c)
+{
+  /* The etimer has expired but its event has not been delivered yet */
+  if(initialized && c->active && etimer_expired(&c->etimer)) {
+    process_cancel_event(&ctimer_process, PROCESS_EVENT_TIMER, &c->etimer);
+  }
+}
+#endif /* ETIMER_HEAP */
+/*---------------------------------------------------------------------------*/
+static void
+add_ctimer(struct ctimer *c)
+{
+#if ETIMER_HEAP
+  c->active = 1;
+  if(initialized) {
+    return;
+  }
+#endif /* ETIMER_HEAP */
+  list_add(ctimer_list, c);
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_ctimer(struct ctimer *c)
+{
+#if ETIMER_HEAP
+  c->active = 0;
+  if(initialized) {
+    return;
+  }
+#endif /* ETIMER_HEAP */
+  list_remove(ctimer_list, c);
+}
+/*---------------------------------------------------------------------------*/
 void
 ctimer_init(void)
 {
@@ -110,6 +172,9 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
   c->p = p;
   c->f = f;
   c->ptr = ptr;
+#if ETIMER_HEAP
+  cancel_pending(c);
+#endif /* ETIMER_HEAP */
   if(initialized) {
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_set(&c->etimer, t);
@@ -118,48 +183,63 @@ ctimer_set_with_process(struct ctimer *c, clock_time_t t,
     c->etimer.timer.interval = t;
   }
 
-  list_add(ctimer_list, c);
+  add_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_reset(struct ctimer *c)
 {
+#if ETIMER_HEAP
+  cancel_pending(c);
+#endif /* ETIMER_HEAP */
   if(initialized) {
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_reset(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
   }
 
-  list_add(ctimer_list, c);
+  add_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_restart(struct ctimer *c)
 {
+#if ETIMER_HEAP
+  cancel_pending(c);
+#endif /* ETIMER_HEAP */
   if(initialized) {
     PROCESS_CONTEXT_BEGIN(&ctimer_process);
     etimer_restart(&c->etimer);
     PROCESS_CONTEXT_END(&ctimer_process);
   }
 
-  list_add(ctimer_list, c);
+  add_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 void
 ctimer_stop(struct ctimer *c)
 {
+#if ETIMER_HEAP
+  cancel_pending(c);
+#endif /* ETIMER_HEAP */
   if(initialized) {
     etimer_stop(&c->etimer);
   } else {
     c->etimer.next = NULL;
     c->etimer.p = PROCESS_NONE;
   }
-  list_remove(ctimer_list, c);
+  remove_ctimer(c);
 }
 /*---------------------------------------------------------------------------*/
 int
 ctimer_expired(struct ctimer *c)
 {
+#if ETIMER_HEAP
+  if(initialized) {
+    return etimer_expired(&c->etimer);
+  }
+  return !c->active;
+#else /* ETIMER_HEAP */
   struct ctimer *t;
   if(initialized) {
     return etimer_expired(&c->etimer);
@@ -170,6 +250,7 @@ ctimer_expired(struct ctimer *c)
     }
   }
   return 1;
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
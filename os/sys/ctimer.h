@@ -64,6 +64,9 @@ struct ctimer {
   struct process *p;
   void (*f)(void *);
   void *ptr;
+#if ETIMER_HEAP
+  uint8_t active;
+#endif /* ETIMER_HEAP */
 };
 
 /**
@@ -54,9 +54,154 @@ static clock_time_t next_expiration;
 
 PROCESS(etimer_process, "Event timer");
 /*---------------------------------------------------------------------------*/
+#if ETIMER_HEAP
+/*
+ * With ETIMER_HEAP, timerlist is the root of a pairing heap ordered on
+ * the expiration time. The next pointer links a timer to its next
+ * sibling, child points to its first child and prev points to either
+ * its previous sibling or, for a first child, to its parent. The
+ * on_heap flag tells whether a timer is on the heap, so that membership
+ * is known without following links that may be stale. The links of a
+ * timer are cleared whenever it leaves the heap.
+ */
+#define EXPIRES_BEFORE(a, b) \
+  ((clock_time_t)(etimer_expiration_time(a) - etimer_expiration_time(b)) > \
+   ((clock_time_t)~(clock_time_t)0 >> 1))
+/*---------------------------------------------------------------------------*/
+static int
+heap_contains(struct etimer *t)
+{
+  return t->on_heap;
+}
+/*---------------------------------------------------------------------------*/
+/* Link two heap roots together and return the new root. */
+static struct etimer *
+heap_link(struct etimer *a, struct etimer *b)
+{
+  struct etimer *tmp;
+
+  if(EXPIRES_BEFORE(b, a)) {
+    tmp = a;
+    a = b;
+    b = tmp;
+  }
+
+  b->prev = a;
+  b->next = a->child;
+  if(a->child != NULL) {
+    a->child->prev = b;
+  }
+  a->child = b;
+  a->next = NULL;
+  a->prev = NULL;
+
+  return a;
+}
+/*---------------------------------------------------------------------------*/
+/* Merge a list of siblings into a single heap (two-pass pairing). */
+static struct etimer *
+heap_merge_pairs(struct etimer *first)
+{
+  struct etimer *a, *b, *pairs;
+
+  /* First pass: link siblings pairwise, left to right. The resulting
+     heaps are pushed onto a stack threaded through the next pointers. */
+  pairs = NULL;
+  while(first != NULL) {
+    a = first;
+    b = a->next;
+    if(b == NULL) {
+      first = NULL;
+    } else {
+      first = b->next;
+      a = heap_link(a, b);
+    }
+    a->next = pairs;
+    pairs = a;
+  }
+
+  /* Second pass: link the heaps together, right to left. */
+  first = NULL;
+  while(pairs != NULL) {
+    a = pairs;
+    pairs = a->next;
+    a->next = NULL;
+    first = first == NULL ? a : heap_link(first, a);
+  }
+
+  if(first != NULL) {
+    first->prev = NULL;
+  }
+  return first;
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_insert(struct etimer *t)
+{
+  t->next = NULL;
+  t->prev = NULL;
+  t->child = NULL;
+  t->on_heap = 1;
+  timerlist = timerlist == NULL ? t : heap_link(timerlist, t);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heap_remove(struct etimer *t)
+{
+  struct etimer *sub;
+
+  if(t == timerlist) {
+    timerlist = heap_merge_pairs(t->child);
+  } else {
+    /* Unlink t from its siblings and parent */
+    if(t->prev->child == t) {
+      t->prev->child = t->next;
+    } else {
+      t->prev->next = t->next;
+    }
+    if(t->next != NULL) {
+      t->next->prev = t->prev;
+    }
+    sub = heap_merge_pairs(t->child);
+    if(sub != NULL) {
+      timerlist = heap_link(timerlist, sub);
+    }
+  }
+
+  t->next = NULL;
+  t->prev = NULL;
+  t->child = NULL;
+  t->on_heap = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Return the timer following t in a pre-order walk of the heap. */
+static struct etimer *
+heap_walk_next(struct etimer *t)
+{
+  if(t->child != NULL) {
+    return t->child;
+  }
+  while(t != NULL) {
+    if(t->next != NULL) {
+      return t->next;
+    }
+    /* Go back to the first sibling, then up to the parent */
+    while(t->prev != NULL && t->prev->child != t) {
+      t = t->prev;
+    }
+    t = t->prev;
+  }
+  return NULL;
+}
+#endif /* ETIMER_HEAP */
+/*---------------------------------------------------------------------------*/
 static void
 update_time(void)
 {
+#if ETIMER_HEAP
+  /* The root of the heap always holds the next timer to expire */
+  next_expiration = timerlist == NULL ? 0 : etimer_expiration_time(timerlist);
+#else /* ETIMER_HEAP */
   clock_time_t tdist;
   clock_time_t now;
   struct etimer *t;
@@ -75,11 +220,15 @@ update_time(void)
     }
     next_expiration = now + tdist;
   }
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(etimer_process, ev, data)
 {
-  struct etimer *t, *u;
+  struct etimer *t;
+#if !ETIMER_HEAP
+  struct etimer *u;
+#endif /* !ETIMER_HEAP */
 
   PROCESS_BEGIN();
 
@@ -91,6 +240,18 @@ PROCESS_THREAD(etimer_process, ev, data)
     if(ev == PROCESS_EVENT_EXITED) {
       struct process *p = data;
 
+#if ETIMER_HEAP
+      t = timerlist;
+      while(t != NULL) {
+        if(t->p == p) {
+          heap_remove(t);
+          t = timerlist;
+        } else {
+          t = heap_walk_next(t);
+        }
+      }
+      update_time();
+#else /* ETIMER_HEAP */
       while(timerlist != NULL && timerlist->p == p) {
         timerlist = timerlist->next;
       }
@@ -105,11 +266,26 @@ PROCESS_THREAD(etimer_process, ev, data)
           }
         }
       }
+#endif /* ETIMER_HEAP */
       continue;
     } else if(ev != PROCESS_EVENT_POLL) {
       continue;
     }
 
+#if ETIMER_HEAP
+    /* Expired timers are always found at the root of the heap */
+    while(timerlist != NULL && timer_expired(&timerlist->timer)) {
+      t = timerlist;
+      if(process_post(t->p, PROCESS_EVENT_TIMER, t) == PROCESS_ERR_OK) {
+        t->p = PROCESS_NONE;
+        heap_remove(t);
+      } else {
+        etimer_request_poll();
+        break;
+      }
+    }
+    update_time();
+#else /* ETIMER_HEAP */
 again:
 
     u = NULL;
@@ -136,6 +312,7 @@ again:
       }
       u = t;
     }
+#endif /* ETIMER_HEAP */
   }
 
   PROCESS_END();
@@ -150,6 +327,18 @@ etimer_request_poll(void)
 static void
 add_timer(struct etimer *timer)
 {
+#if ETIMER_HEAP
+  etimer_request_poll();
+
+  /* The expiration time has changed: move the timer to its new place */
+  if(timer->p != PROCESS_NONE && heap_contains(timer)) {
+    heap_remove(timer);
+  }
+  timer->p = PROCESS_CURRENT();
+  heap_insert(timer);
+
+  update_time();
+#else /* ETIMER_HEAP */
   struct etimer *t;
 
   etimer_request_poll();
@@ -171,6 +360,7 @@ add_timer(struct etimer *timer)
   timerlist = timer;
 
   update_time();
+#endif /* ETIMER_HEAP */
 }
 /*---------------------------------------------------------------------------*/
 void
@@ -205,7 +395,17 @@ etimer_restart(struct etimer *et)
 void
 etimer_adjust(struct etimer *et, int timediff)
 {
+#if ETIMER_HEAP
+  if(et->p != PROCESS_NONE && heap_contains(et)) {
+    heap_remove(et);
+    et->timer.start += timediff;
+    heap_insert(et);
+  } else {
+    et->timer.start += timediff;
+  }
+#else /* ETIMER_HEAP */
   et->timer.start += timediff;
+#endif /* ETIMER_HEAP */
   update_time();
 }
 /*---------------------------------------------------------------------------*/
@@ -242,6 +442,12 @@ etimer_next_expiration_time(void)
 void
 etimer_stop(struct etimer *et)
 {
+#if ETIMER_HEAP
+  if(et->p != PROCESS_NONE && heap_contains(et)) {
+    heap_remove(et);
+    update_time();
+  }
+#else /* ETIMER_HEAP */
   struct etimer *t;
 
   /* First check if et is the first event timer on the list. */
@@ -263,6 +469,7 @@ etimer_stop(struct etimer *et)
       update_time();
     }
   }
+#endif /* ETIMER_HEAP */
 
   /* Remove the next pointer from the item to be removed. */
   et->next = NULL;
@@ -65,6 +65,24 @@
 
 #include "contiki.h"
 
+/**
+ * \brief Select the data structure used to keep track of pending
+ * event timers.
+ *
+ * By default, pending timers are kept in an unsorted linked list:
+ * this has the smallest footprint, but setting, stopping or expiring
+ * a timer costs O(n) in the number of pending timers. Setting
+ * ETIMER_CONF_HEAP to 1 keeps them in an intrusive pairing heap
+ * instead, so that the next expiration time is known in O(1) and
+ * timers are added and removed in O(log n) amortized time, at the
+ * cost of two more pointers per event timer.
+ */
+#ifdef ETIMER_CONF_HEAP
+#define ETIMER_HEAP ETIMER_CONF_HEAP
+#else /* ETIMER_CONF_HEAP */
+#define ETIMER_HEAP 0
+#endif /* ETIMER_CONF_HEAP */
+
 /**
  * A timer.
  *
@@ -77,6 +95,11 @@ struct etimer {
   struct timer timer;
   struct etimer *next;
   struct process *p;
+#if ETIMER_HEAP
+  struct etimer *child;
+  struct etimer *prev;
+  uint8_t on_heap;
+#endif /* ETIMER_HEAP */
 };
 
 /**
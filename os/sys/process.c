@@ -44,6 +44,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "contiki.h"
 #include "sys/process.h"
@@ -65,13 +66,39 @@ struct event_data {
   struct process *p;
 };
 
-static process_num_events_t nevents, fevent;
-static struct event_data events[PROCESS_CONF_NUMEVENTS];
+/*
+ * One queue of events per priority class.
+ */
+struct event_queue {
+  process_num_events_t nevents, fevent;
+  struct event_data events[PROCESS_CONF_NUMEVENTS];
+  struct process_event_stats stats;
+};
+
+static struct event_queue queues[PROCESS_CONF_PRIORITIES];
+
+/* The number of events in all queues */
+static unsigned nevents;
 
 #if PROCESS_CONF_STATS
-process_num_events_t process_maxevents;
+unsigned process_maxevents;
 #endif
 
+/*
+ * Subscriptions to events posted to PROCESS_SUBSCRIBERS, hashed by event.
+ */
+static struct process_subscription *subscriptions[PROCESS_CONF_SUBSCRIPTION_BUCKETS];
+#define SUBSCRIPTION_BUCKET(ev) (&subscriptions[(ev) % PROCESS_CONF_SUBSCRIPTION_BUCKETS])
+
+#if PROCESS_CONF_PRIORITIES > 1
+#define PROCESS_PRIORITY(p) ((p) == PROCESS_BROADCAST || \
+                             (p) == PROCESS_ZOMBIE || \
+                             (p) == PROCESS_SUBSCRIBERS ? \
+                             PROCESS_PRIORITY_DEFAULT : (p)->priority)
+#else /* PROCESS_CONF_PRIORITIES > 1 */
+#define PROCESS_PRIORITY(p) PROCESS_PRIORITY_DEFAULT
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+
 static volatile unsigned char poll_requested;
 
 #define PROCESS_STATE_NONE        0
@@ -96,6 +123,58 @@ process_alloc_event(void)
 }
 /*---------------------------------------------------------------------------*/
 void
+process_set_priority(struct process *p, unsigned char priority)
+{
+#if PROCESS_CONF_PRIORITIES > 1
+  p->priority = priority < PROCESS_CONF_PRIORITIES ?
+    priority : PROCESS_CONF_PRIORITIES - 1;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+}
+/*---------------------------------------------------------------------------*/
+void
+process_subscribe(struct process_subscription *s,
+                  struct process *p, process_event_t ev)
+{
+  struct process_subscription **bucket = SUBSCRIPTION_BUCKET(ev);
+
+  process_unsubscribe(s);
+  s->p = p;
+  s->ev = ev;
+  s->next = *bucket;
+  *bucket = s;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_unsubscribe(struct process_subscription *s)
+{
+  struct process_subscription **q;
+
+  for(q = SUBSCRIPTION_BUCKET(s->ev); *q != NULL; q = &(*q)->next) {
+    if(*q == s) {
+      *q = s->next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+unsubscribe_process(struct process *p)
+{
+  struct process_subscription **q;
+  int i;
+
+  for(i = 0; i < PROCESS_CONF_SUBSCRIPTION_BUCKETS; i++) {
+    for(q = &subscriptions[i]; *q != NULL;) {
+      if((*q)->p == p) {
+        *q = (*q)->next;
+      } else {
+        q = &(*q)->next;
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
 process_start(struct process *p, process_data_t data)
 {
   struct process *q;
@@ -150,6 +229,8 @@ exit_process(struct process *p, struct process *fromprocess)
       }
     }
 
+    unsubscribe_process(p);
+
     if(p->thread != NULL && p != fromprocess) {
       /* Post the exit event to the process that is about to exit. */
       process_current = p;
@@ -209,7 +290,9 @@ process_init(void)
 {
   lastevent = PROCESS_EVENT_MAX;
 
-  nevents = fevent = 0;
+  memset(queues, 0, sizeof(queues));
+  memset(subscriptions, 0, sizeof(subscriptions));
+  nevents = 0;
 #if PROCESS_CONF_STATS
   process_maxevents = 0;
 #endif /* PROCESS_CONF_STATS */
@@ -249,6 +332,7 @@ do_event(void)
   process_data_t data;
   struct process *receiver;
   struct process *p;
+  struct event_queue *q;
 
   /*
    * If there are any events in the queue, take the first one and walk
@@ -260,15 +344,19 @@ do_event(void)
 
   if(nevents > 0) {
 
+    /* Take the event from the highest priority class that has one. */
+    for(q = &queues[PROCESS_CONF_PRIORITIES - 1]; q->nevents == 0; q--);
+
     /* There are events that we should deliver. */
-    ev = events[fevent].ev;
+    ev = q->events[q->fevent].ev;
 
-    data = events[fevent].data;
-    receiver = events[fevent].p;
+    data = q->events[q->fevent].data;
+    receiver = q->events[q->fevent].p;
 
     /* Since we have seen the new event, we move pointer upwards
        and decrease the number of events. */
-    fevent = (fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    q->fevent = (q->fevent + 1) % PROCESS_CONF_NUMEVENTS;
+    --q->nevents;
     --nevents;
 
     /* If this is a broadcast event, we deliver it to all events, in
@@ -283,6 +371,20 @@ do_event(void)
         }
         call_process(p, ev, data);
       }
+    } else if(receiver == PROCESS_SUBSCRIBERS) {
+      struct process_subscription *s;
+      struct process_subscription *next;
+
+      /* Deliver the event to the processes that subscribed to it only. */
+      for(s = *SUBSCRIPTION_BUCKET(ev); s != NULL; s = next) {
+        next = s->next;
+        if(s->ev == ev) {
+          if(poll_requested) {
+            do_poll();
+          }
+          call_process(s->p, ev, data);
+        }
+      }
     } else {
       /* This is not a broadcast event, so we deliver it to the
          specified process. */
@@ -320,21 +422,36 @@ process_nevents(void)
 /*---------------------------------------------------------------------------*/
 int
 process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+  return process_post_priority(p, ev, data, PROCESS_PRIORITY(p));
+}
+/*---------------------------------------------------------------------------*/
+int
+process_post_priority(struct process *p, process_event_t ev,
+                      process_data_t data, unsigned char priority)
 {
   process_num_events_t snum;
+  struct event_queue *q;
+
+  if(priority >= PROCESS_CONF_PRIORITIES) {
+    priority = PROCESS_CONF_PRIORITIES - 1;
+  }
+  q = &queues[priority];
 
   if(PROCESS_CURRENT() == NULL) {
-    PRINTF("process_post: NULL process posts event %d to process '%s', nevents %d\n",
+    PRINTF("process_post: NULL process posts event %d to process '%s', nevents %u\n",
            ev, PROCESS_NAME_STRING(p), nevents);
   } else {
-    PRINTF("process_post: Process '%s' posts event %d to process '%s', nevents %d\n",
+    PRINTF("process_post: Process '%s' posts event %d to process '%s', nevents %u\n",
            PROCESS_NAME_STRING(PROCESS_CURRENT()), ev,
-           p == PROCESS_BROADCAST ? "<broadcast>" : PROCESS_NAME_STRING(p), nevents);
+           p == PROCESS_BROADCAST ? "<broadcast>" :
+           p == PROCESS_SUBSCRIBERS ? "<subscribers>" : PROCESS_NAME_STRING(p), nevents);
   }
 
-  if(nevents == PROCESS_CONF_NUMEVENTS) {
+  if(q->nevents == PROCESS_CONF_NUMEVENTS) {
+    q->stats.dropped++;
 #if DEBUG
-    if(p == PROCESS_BROADCAST) {
+    if(p == PROCESS_BROADCAST || p == PROCESS_SUBSCRIBERS) {
       printf("soft panic: event queue is full when broadcast event %d was posted from %s\n", ev, PROCESS_NAME_STRING(process_current));
     } else {
       printf("soft panic: event queue is full when event %d was posted to %s from %s\n", ev, PROCESS_NAME_STRING(p), PROCESS_NAME_STRING(process_current));
@@ -343,13 +460,17 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
     return PROCESS_ERR_FULL;
   }
 
-  snum = (process_num_events_t)(fevent + nevents) % PROCESS_CONF_NUMEVENTS;
-  events[snum].ev = ev;
-  events[snum].data = data;
-  events[snum].p = p;
+  snum = (process_num_events_t)(q->fevent + q->nevents) % PROCESS_CONF_NUMEVENTS;
+  q->events[snum].ev = ev;
+  q->events[snum].data = data;
+  q->events[snum].p = p;
+  ++q->nevents;
   ++nevents;
 
 #if PROCESS_CONF_STATS
+  if(q->nevents > q->stats.max_events) {
+    q->stats.max_events = q->nevents;
+  }
   if(nevents > process_maxevents) {
     process_maxevents = nevents;
   }
@@ -358,6 +479,41 @@ process_post(struct process *p, process_event_t ev, process_data_t data)
   return PROCESS_ERR_OK;
 }
 /*---------------------------------------------------------------------------*/
+/* Removes the matching events from one queue. The ring is compacted,
+   keeping the order of the remaining events. */
+static void
+queue_cancel(struct event_queue *q, struct process *p, process_event_t ev,
+             process_data_t data)
+{
+  process_num_events_t i, kept, from, to;
+
+  kept = 0;
+  for(i = 0; i < q->nevents; i++) {
+    from = (process_num_events_t)(q->fevent + i) % PROCESS_CONF_NUMEVENTS;
+    if(q->events[from].p == p && q->events[from].ev == ev &&
+       q->events[from].data == data) {
+      continue;
+    }
+    to = (process_num_events_t)(q->fevent + kept) % PROCESS_CONF_NUMEVENTS;
+    q->events[to] = q->events[from];
+    kept++;
+  }
+  nevents -= q->nevents - kept;
+  q->nevents = kept;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_cancel_event(struct process *p, process_event_t ev,
+                     process_data_t data)
+{
+  unsigned char priority;
+
+  /* process_post_priority() may have queued the event in any class */
+  for(priority = 0; priority < PROCESS_CONF_PRIORITIES; priority++) {
+    queue_cancel(&queues[priority], p, ev, data);
+  }
+}
+/*---------------------------------------------------------------------------*/
 void
 process_post_synch(struct process *p, process_event_t ev, process_data_t data)
 {
@@ -367,6 +523,7 @@ process_post_synch(struct process *p, process_event_t ev, process_data_t data)
   process_current = caller;
 }
 /*---------------------------------------------------------------------------*/
+/*---------------------------------------------------------------------------*/
 void
 process_poll(struct process *p)
 {
@@ -385,4 +542,15 @@ process_is_running(struct process *p)
   return p->state != PROCESS_STATE_NONE;
 }
 /*---------------------------------------------------------------------------*/
+void
+process_get_event_stats(unsigned char priority,
+                        struct process_event_stats *stats)
+{
+  if(priority < PROCESS_CONF_PRIORITIES) {
+    *stats = queues[priority].stats;
+  } else {
+    memset(stats, 0, sizeof(*stats));
+  }
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
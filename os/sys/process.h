@@ -88,6 +88,21 @@ typedef unsigned char process_num_events_t;
 #define PROCESS_CONF_NUMEVENTS 32
 #endif /* PROCESS_CONF_NUMEVENTS */
 
+/* The number of event priority classes. Each class has its own queue of
+   PROCESS_CONF_NUMEVENTS events, and events are always taken from the
+   highest non-empty class first. */
+#ifndef PROCESS_CONF_PRIORITIES
+#define PROCESS_CONF_PRIORITIES 1
+#endif /* PROCESS_CONF_PRIORITIES */
+
+/* The number of hash buckets used to look up event subscriptions */
+#ifndef PROCESS_CONF_SUBSCRIPTION_BUCKETS
+#define PROCESS_CONF_SUBSCRIPTION_BUCKETS 4
+#endif /* PROCESS_CONF_SUBSCRIPTION_BUCKETS */
+
+/* The priority class of processes and events unless set otherwise */
+#define PROCESS_PRIORITY_DEFAULT 0
+
 #define PROCESS_EVENT_NONE            0x80
 #define PROCESS_EVENT_INIT            0x81
 #define PROCESS_EVENT_POLL            0x82
@@ -102,6 +117,7 @@ typedef unsigned char process_num_events_t;
 
 #define PROCESS_BROADCAST NULL
 #define PROCESS_ZOMBIE ((struct process *)0x1)
+#define PROCESS_SUBSCRIBERS ((struct process *)0x2)
 
 /**
  * \name Process protothread functions
@@ -323,6 +339,32 @@ struct process {
   PT_THREAD((* thread)(struct pt *, process_event_t, process_data_t));
   struct pt pt;
   unsigned char state, needspoll;
+#if PROCESS_CONF_PRIORITIES > 1
+  unsigned char priority;
+#endif /* PROCESS_CONF_PRIORITIES > 1 */
+};
+
+/**
+ * A subscription of a process to an event posted to
+ * PROCESS_SUBSCRIBERS. The structure is allocated by the caller.
+ */
+struct process_subscription {
+  struct process_subscription *next;
+  struct process *p;
+  process_event_t ev;
+};
+
+/**
+ * Event queue statistics of a priority class.
+ */
+struct process_event_stats {
+  /** The number of events that could not be posted because the queue
+      was full */
+  unsigned long dropped;
+#if PROCESS_CONF_STATS
+  /** The largest number of events waiting at once */
+  process_num_events_t max_events;
+#endif /* PROCESS_CONF_STATS */
 };
 
 /**
@@ -354,16 +396,62 @@ void process_start(struct process *p, process_data_t data);
  *
  * \param data The auxiliary data to be sent with the event
  *
- * \param p The process to which the event should be posted, or
- * PROCESS_BROADCAST if the event should be posted to all processes.
+ * \param p The process to which the event should be posted,
+ * PROCESS_BROADCAST if the event should be posted to all processes, or
+ * PROCESS_SUBSCRIBERS if the event should only be posted to the processes
+ * that subscribed to it.
  *
  * \retval PROCESS_ERR_OK The event could be posted.
  *
  * \retval PROCESS_ERR_FULL The event queue was full and the event could
  * not be posted.
+ *
+ * The event is queued in the priority class of the receiving process,
+ * or PROCESS_PRIORITY_DEFAULT for broadcast events.
  */
 int process_post(struct process *p, process_event_t ev, process_data_t data);
 
+/**
+ * Post an asynchronous event in a given priority class.
+ *
+ * This function is similar to process_post(), but queues the event in
+ * the given priority class regardless of the receiver.
+ *
+ * \param p The process to which the event should be posted,
+ * PROCESS_BROADCAST or PROCESS_SUBSCRIBERS.
+ *
+ * \param ev The event to be posted.
+ *
+ * \param data The auxiliary data to be sent with the event
+ *
+ * \param priority The priority class, from PROCESS_PRIORITY_DEFAULT up
+ * to PROCESS_CONF_PRIORITIES - 1. Higher classes are served first.
+ *
+ * \retval PROCESS_ERR_OK The event could be posted.
+ *
+ * \retval PROCESS_ERR_FULL The queue of the priority class was full and
+ * the event could not be posted.
+ */
+int process_post_priority(struct process *p, process_event_t ev,
+                          process_data_t data, unsigned char priority);
+
+/**
+ * Remove events that are still waiting in the event queues.
+ *
+ * Every queued event that is addressed to the process, has the given
+ * event number and carries the given data pointer is removed without
+ * being delivered, whatever priority class it was queued in. This lets
+ * a module free the object that an already posted event points to.
+ *
+ * \param p A pointer to the process' process structure.
+ *
+ * \param ev The event number.
+ *
+ * \param data The data pointer that was posted with the event.
+ */
+void process_cancel_event(struct process *p, process_event_t ev,
+                          process_data_t data);
+
 /**
  * Post a synchronous event to a process.
  *
@@ -452,6 +540,50 @@ process_current = p
  */
 process_event_t process_alloc_event(void);
 
+/**
+ * Set the priority class of the events posted to a process.
+ *
+ * \param p A pointer to the process' process structure.
+ *
+ * \param priority The priority class, from PROCESS_PRIORITY_DEFAULT up
+ * to PROCESS_CONF_PRIORITIES - 1. Higher classes are served first.
+ */
+void process_set_priority(struct process *p, unsigned char priority);
+
+/**
+ * Subscribe a process to an event.
+ *
+ * Events posted to PROCESS_SUBSCRIBERS are only delivered to the
+ * processes that subscribed to them, without walking the list of all
+ * processes. Subscriptions are dropped when their process exits.
+ *
+ * \param s A pointer to a subscription structure, which must remain
+ * valid until the subscription is dropped.
+ *
+ * \param p A pointer to the process' process structure.
+ *
+ * \param ev The event to subscribe to.
+ */
+void process_subscribe(struct process_subscription *s,
+                       struct process *p, process_event_t ev);
+
+/**
+ * Drop a subscription.
+ *
+ * \param s A pointer to the subscription structure.
+ */
+void process_unsubscribe(struct process_subscription *s);
+
+/**
+ * Get the event queue statistics of a priority class.
+ *
+ * \param priority The priority class.
+ *
+ * \param stats A pointer to the structure where to write the statistics.
+ */
+void process_get_event_stats(unsigned char priority,
+                             struct process_event_stats *stats);
+
 /** @} */
 
 /**
@@ -0,0 +1,18 @@
+#!/bin/sh
+
+TESTNAME=04-test-memb-bitmap
+TEST_CODE_DIR=code-test-memb
+TARGET=test-memb-bitmap
+
+make -C ${TEST_CODE_DIR} clean
+make -C ${TEST_CODE_DIR} ${TARGET}
+${TEST_CODE_DIR}/${TARGET} > ${TESTNAME}.log
+
+if [ $? -eq 0 ]; then
+    echo "${TESTNAME} TEST OK" > ${TESTNAME}.testlog
+    make -C ${TEST_CODE_DIR} clean
+    exit 0
+else
+    echo "${TESTNAME} TEST FAIL" > ${TESTNAME}.testlog
+    exit 1
+fi
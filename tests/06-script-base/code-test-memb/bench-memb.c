@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Microbenchmark for memb_alloc() and memb_free(). Build and run both
+ * the flag array and the bitmap variants with "make bench".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include <lib/memb.h>
+
+#define BLOCK_SIZE 64
+#define NUM_OPS 2000000
+
+typedef struct bench_block {
+  uint8_t data[BLOCK_SIZE];
+} bench_block_t;
+
+MEMB(pool_16, bench_block_t, 16);
+MEMB(pool_64, bench_block_t, 64);
+MEMB(pool_256, bench_block_t, 256);
+MEMB(pool_1024, bench_block_t, 1024);
+
+static void *blocks[1024];
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static int
+bench(struct memb *m)
+{
+  int i;
+  int n;
+  uint64_t start;
+  uint64_t elapsed;
+
+  memb_init(m);
+  srand(m->num);
+
+  /* Keep the pool three quarters full, then free and reallocate
+     random blocks, as a long-running network stack would. */
+  for(n = 0; n < m->num * 3 / 4; n++) {
+    blocks[n] = memb_alloc(m);
+  }
+
+  start = now_ns();
+  for(i = 0; i < NUM_OPS; i++) {
+    int victim = rand() % n;
+    if(memb_free(m, blocks[victim]) != 0) {
+      printf("memb_free failed\n");
+      return -1;
+    }
+    blocks[victim] = memb_alloc(m);
+    if(blocks[victim] == NULL) {
+      printf("memb_alloc failed\n");
+      return -1;
+    }
+  }
+  elapsed = now_ns() - start;
+
+  printf("%s: %4u blocks: %6.1f ns per alloc+free, %d free\n",
+         MEMB_BITMAP ? "bitmap" : "flags ", m->num,
+         (double)elapsed / NUM_OPS, memb_numfree(m));
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+main(void)
+{
+  if(bench(&pool_16) || bench(&pool_64) ||
+     bench(&pool_256) || bench(&pool_1024)) {
+    return -1;
+  }
+  return 0;
+}
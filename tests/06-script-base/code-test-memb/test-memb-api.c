@@ -34,7 +34,7 @@
 
 #include <lib/memb.h>
 
-#define NUM_MEMB_BLOCKS 8
+#define NUM_MEMB_BLOCKS 40
 #define DATA_LEN 128
 #define ONE_BYTE_OFF_ADDR(p) ((uint8_t *)p + 1)
 
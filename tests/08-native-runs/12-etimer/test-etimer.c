@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define NUM_TIMERS    10000
+#define NUM_OPS       100000
+#define CHECK_EVERY   97
+#define NUM_FIRE      200
+#define NUM_CTIMERS   50
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static struct etimer timers[NUM_TIMERS];
+static struct ctimer ctimers[NUM_CTIMERS];
+static int ctimer_fired[NUM_CTIMERS];
+static struct ctimer stale_ctimer;
+static int stale_fired;
+/*---------------------------------------------------------------------------*/
+static bool
+check_next_expiration(void)
+{
+  clock_time_t now = clock_time();
+  clock_time_t min_dist = 0;
+  bool found = false;
+  int i;
+
+  for(i = 0; i < NUM_TIMERS; i++) {
+    if(!etimer_expired(&timers[i])) {
+      clock_time_t dist = etimer_expiration_time(&timers[i]) - now;
+      if(!found || dist < min_dist) {
+        min_dist = dist;
+        found = true;
+      }
+    }
+  }
+
+  /* Timers owned by the rest of the system may expire earlier */
+  if(found && !etimer_pending()) {
+    printf("TEST: etimer_pending() mismatch\n");
+    return false;
+  }
+  if(found && etimer_next_expiration_time() - now > min_dist) {
+    printf("TEST: next expiration %lu, expected at most %lu\n",
+           (unsigned long)etimer_next_expiration_time(),
+           (unsigned long)(now + min_dist));
+    return false;
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static void
+ctimer_callback(void *ptr)
+{
+  ctimer_fired[(struct ctimer *)ptr - ctimers]++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stale_callback(void *ptr)
+{
+  stale_fired++;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(etimer_churn, "Churn 10k event timers");
+UNIT_TEST(etimer_churn)
+{
+  int i;
+  clock_time_t start;
+  unsigned long elapsed;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: etimer backend: %s\n", ETIMER_HEAP ? "heap" : "list");
+
+  start = clock_time();
+  for(i = 0; i < NUM_TIMERS; i++) {
+    etimer_set(&timers[i], CLOCK_SECOND * 60 + random_rand() % 10000);
+  }
+  elapsed = clock_time() - start;
+  printf("TEST: set %u timers in %lu ms\n", NUM_TIMERS, elapsed);
+  UNIT_TEST_ASSERT(check_next_expiration());
+
+  start = clock_time();
+  for(i = 0; i < NUM_OPS; i++) {
+    struct etimer *et = &timers[random_rand() % NUM_TIMERS];
+
+    switch(random_rand() % 4) {
+    case 0:
+      etimer_stop(et);
+      break;
+    case 1:
+      etimer_set(et, CLOCK_SECOND * 60 + random_rand() % 10000);
+      break;
+    case 2:
+      etimer_restart(et);
+      break;
+    default:
+      if(!etimer_expired(et)) {
+        etimer_adjust(et, (int)(random_rand() % 2000) - 1000);
+      }
+      break;
+    }
+    /* Sample the next expiration time as a scheduler would */
+    (void)etimer_next_expiration_time();
+  }
+  elapsed = clock_time() - start;
+  printf("TEST: %u random set/stop/restart/adjust operations in %lu ms\n",
+         NUM_OPS, elapsed);
+  UNIT_TEST_ASSERT(check_next_expiration());
+
+  /* Same again, but check against a linear scan along the way */
+  for(i = 0; i < NUM_OPS / 10; i++) {
+    struct etimer *et = &timers[random_rand() % NUM_TIMERS];
+
+    if(random_rand() & 1) {
+      etimer_stop(et);
+    } else {
+      etimer_set(et, CLOCK_SECOND * 60 + random_rand() % 10000);
+    }
+    if(i % CHECK_EVERY == 0) {
+      UNIT_TEST_ASSERT(check_next_expiration());
+    }
+  }
+
+  /* Stopping a timer that was never set must leave the others alone,
+     even if its memory holds stale pointers into the pending timers */
+  for(i = 0; i < 100; i++) {
+    struct etimer stray;
+
+    memset(&stray, 0, sizeof(stray));
+    stray.p = PROCESS_CURRENT();
+    stray.next = &timers[random_rand() % NUM_TIMERS];
+#if ETIMER_HEAP
+    stray.prev = &timers[random_rand() % NUM_TIMERS];
+    stray.child = &timers[random_rand() % NUM_TIMERS];
+#endif /* ETIMER_HEAP */
+    etimer_stop(&stray);
+  }
+  UNIT_TEST_ASSERT(check_next_expiration());
+
+  start = clock_time();
+  for(i = 0; i < NUM_TIMERS; i++) {
+    etimer_stop(&timers[i]);
+  }
+  elapsed = clock_time() - start;
+  printf("TEST: stopped %u timers in %lu ms\n", NUM_TIMERS, elapsed);
+#if ETIMER_HEAP
+  /* Timers off the heap keep no links into it */
+  for(i = 0; i < NUM_TIMERS; i++) {
+    UNIT_TEST_ASSERT(timers[i].next == NULL && timers[i].prev == NULL &&
+                     timers[i].child == NULL && !timers[i].on_heap);
+  }
+#endif /* ETIMER_HEAP */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static int i;
+  static int fired;
+  static clock_time_t last;
+  static bool in_order;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(etimer_churn);
+
+  /* Let a set of short timers expire and check they fire in order */
+  for(i = 0; i < NUM_FIRE; i++) {
+    etimer_set(&timers[i], 1 + random_rand() % (CLOCK_SECOND / 2));
+  }
+  for(i = 0; i < NUM_CTIMERS; i++) {
+    ctimer_set(&ctimers[i], 1 + random_rand() % (CLOCK_SECOND / 2),
+               ctimer_callback, &ctimers[i]);
+  }
+  /* Stopped callback timers must never fire */
+  for(i = 0; i < NUM_CTIMERS; i += 2) {
+    ctimer_stop(&ctimers[i]);
+  }
+
+  fired = 0;
+  last = 0;
+  in_order = true;
+  while(fired < NUM_FIRE) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER);
+    if(fired > 0 &&
+       (clock_time_t)(etimer_expiration_time(data) - last) >
+       ((clock_time_t)~(clock_time_t)0 >> 1)) {
+      in_order = false;
+    }
+    last = etimer_expiration_time(data);
+    fired++;
+  }
+  printf("TEST: %d timers fired %s\n", fired,
+         in_order ? "in order" : "out of order");
+
+  etimer_set(&timers[0], CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&timers[0]));
+
+  /* Stop a callback timer whose event is already queued and reuse its
+     memory: the queued event must not reach the new contents */
+  for(i = 0; i < 10; i++) {
+    stale_fired = 0;
+    /* Equal expiration times: the first timer set is posted first */
+    etimer_set(&timers[0], 2);
+    ctimer_set(&stale_ctimer, 2, stale_callback, NULL);
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER && data == &timers[0]);
+    if(stale_fired == 0) {
+      ctimer_stop(&stale_ctimer);
+      memset(&stale_ctimer, 0, sizeof(stale_ctimer));
+      stale_ctimer.f = stale_callback;
+      stale_ctimer.p = PROCESS_CURRENT();
+#if ETIMER_HEAP
+      stale_ctimer.active = 1;
+#endif /* ETIMER_HEAP */
+      etimer_set(&timers[0], 2);
+      PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_TIMER &&
+                               data == &timers[0]);
+      if(stale_fired != 0) {
+        printf("TEST: stopped ctimer fired\n");
+        in_order = false;
+      }
+    }
+  }
+
+  for(i = 0; i < NUM_CTIMERS; i++) {
+    if(ctimer_fired[i] != (i & 1)) {
+      printf("TEST: ctimer %d fired %d times\n", i, ctimer_fired[i]);
+      in_order = false;
+    }
+  }
+
+  if(!in_order || UNIT_TEST_RESULT(etimer_churn) != unit_test_success) {
+    printf("=check-me= FAILED\n");
+  }
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
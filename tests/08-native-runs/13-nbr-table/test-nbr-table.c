@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/nbr-table.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+#define NUM_LOOKUPS 1000000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+typedef struct test_nbr {
+  uint32_t id;
+} test_nbr_t;
+
+NBR_TABLE(test_nbr_t, test_nbrs);
+
+static const unsigned steps[] = { 8, 32, 100, 200, NBR_TABLE_MAX_NEIGHBORS };
+/*---------------------------------------------------------------------------*/
+static void
+make_lladdr(linkaddr_t *lladdr, uint32_t id)
+{
+  int i;
+
+  /* Spread neighbor identifiers over the address like EUI-64s do */
+  linkaddr_copy(lladdr, &linkaddr_null);
+  lladdr->u8[0] = 0x02;
+  for(i = 0; i < 4 && i < LINKADDR_SIZE - 1; i++) {
+    lladdr->u8[LINKADDR_SIZE - 1 - i] = id >> (8 * i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static bool
+add_neighbor(uint32_t id)
+{
+  linkaddr_t lladdr;
+  test_nbr_t *nbr;
+
+  make_lladdr(&lladdr, id);
+  nbr = nbr_table_add_lladdr(test_nbrs, &lladdr,
+                             NBR_TABLE_REASON_UNDEFINED, NULL);
+  if(nbr == NULL) {
+    return false;
+  }
+  nbr->id = id;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+find_neighbor(uint32_t id)
+{
+  linkaddr_t lladdr;
+  test_nbr_t *nbr;
+
+  make_lladdr(&lladdr, id);
+  nbr = nbr_table_get_from_lladdr(test_nbrs, &lladdr);
+  return nbr != NULL && nbr->id == id;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(nbr_lookup, "Neighbor lookup cost vs. table size");
+UNIT_TEST(nbr_lookup)
+{
+  unsigned s;
+  uint32_t i;
+  uint32_t count = 0;
+  clock_time_t start;
+  unsigned long elapsed;
+  linkaddr_t lladdr;
+  unsigned found;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: nbr-table with%s hash index\n",
+         NBR_TABLE_WITH_HASH ? "" : "out");
+
+  for(s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+    while(count < steps[s]) {
+      UNIT_TEST_ASSERT(add_neighbor(count));
+      count++;
+    }
+
+    /* Look up a random known neighbor, as done for each frame */
+    found = 0;
+    start = clock_time();
+    for(i = 0; i < NUM_LOOKUPS; i++) {
+      make_lladdr(&lladdr, random_rand() % count);
+      found += nbr_table_get_from_lladdr(test_nbrs, &lladdr) != NULL;
+    }
+    elapsed = clock_time() - start;
+    UNIT_TEST_ASSERT(found == NUM_LOOKUPS);
+    printf("TEST: %3lu neighbors: %5lu ns per hit",
+           (unsigned long)count, elapsed * 1000000 / NUM_LOOKUPS);
+
+    /* Look up unknown neighbors: the worst case for the list */
+    found = 0;
+    start = clock_time();
+    for(i = 0; i < NUM_LOOKUPS; i++) {
+      make_lladdr(&lladdr, 100000 + random_rand());
+      found += nbr_table_get_from_lladdr(test_nbrs, &lladdr) != NULL;
+    }
+    elapsed = clock_time() - start;
+    UNIT_TEST_ASSERT(found == 0);
+    printf(", %5lu ns per miss\n", elapsed * 1000000 / NUM_LOOKUPS);
+  }
+
+  for(i = 0; i < count; i++) {
+    UNIT_TEST_ASSERT(find_neighbor(i));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(nbr_evict, "Neighbor eviction keeps lookups consistent");
+UNIT_TEST(nbr_evict)
+{
+  uint32_t i;
+  uint32_t base = NBR_TABLE_MAX_NEIGHBORS;
+  test_nbr_t *nbr;
+
+  UNIT_TEST_BEGIN();
+
+  /* Lock every other neighbor; only the others may be evicted */
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    UNIT_TEST_ASSERT(find_neighbor(i));
+    if(i % 2 == 0) {
+      linkaddr_t lladdr;
+      make_lladdr(&lladdr, i);
+      nbr = nbr_table_get_from_lladdr(test_nbrs, &lladdr);
+      nbr_table_lock(test_nbrs, nbr);
+    }
+  }
+
+  /* Replace all unlocked neighbors, twice over */
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    UNIT_TEST_ASSERT(add_neighbor(base + i));
+  }
+
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    UNIT_TEST_ASSERT(find_neighbor(i) == (i % 2 == 0));
+  }
+  for(i = 0; i < NBR_TABLE_MAX_NEIGHBORS; i++) {
+    /* Only the last half of the new neighbors survived */
+    UNIT_TEST_ASSERT(find_neighbor(base + i) ==
+                     (i >= NBR_TABLE_MAX_NEIGHBORS / 2));
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  nbr_table_register(test_nbrs, NULL);
+
+  UNIT_TEST_RUN(nbr_lookup);
+  UNIT_TEST_RUN(nbr_evict);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
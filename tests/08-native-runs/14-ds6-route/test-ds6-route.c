@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+#define NUM_NEXTHOPS 16
+#define NUM_PREFIXES 32
+#define NUM_LOOKUPS  200000
+#define NUM_CHECKS   2000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const unsigned steps[] = { 1000, 5000, 10000 - NUM_PREFIXES };
+static uip_ipaddr_t nexthops[NUM_NEXTHOPS];
+/*---------------------------------------------------------------------------*/
+/* Host routes live under fd00::/64, prefix routes under fd01:0:0:N::/64 */
+static void
+host_addr(uip_ipaddr_t *addr, uint32_t id)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0212, 0x7400,
+              id >> 16, id & 0xffff);
+}
+/*---------------------------------------------------------------------------*/
+static void
+prefix_addr(uip_ipaddr_t *addr, uint16_t prefix, uint16_t iid)
+{
+  uip_ip6addr(addr, 0xfd01, 0, 0, prefix, 0, 0, 0, iid);
+}
+/*---------------------------------------------------------------------------*/
+/* Reference longest-prefix match over the route list */
+static uip_ds6_route_t *
+lookup_reference(const uip_ipaddr_t *addr)
+{
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *found = NULL;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if((found == NULL || r->length > found->length) &&
+       uip_ipaddr_prefixcmp(addr, &r->ipaddr, r->length)) {
+      found = r;
+    }
+  }
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_destination(uip_ipaddr_t *addr, uint32_t num_hosts)
+{
+  switch(random_rand() % 4) {
+  case 0:
+    /* Covered by a /64 prefix route only */
+    prefix_addr(addr, random_rand() % NUM_PREFIXES, random_rand());
+    break;
+  case 1:
+    /* No route at all */
+    host_addr(addr, num_hosts + random_rand());
+    addr->u16[0] = UIP_HTONS(0xfd02);
+    break;
+  default:
+    host_addr(addr, random_rand() % num_hosts);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(route_lookup, "Route lookup with 1k-10k routes");
+UNIT_TEST(route_lookup)
+{
+  unsigned s;
+  uint32_t i;
+  uint32_t count = 0;
+  uip_ipaddr_t addr;
+  uip_lladdr_t lladdr;
+  clock_time_t start;
+  unsigned long elapsed;
+  unsigned found;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: routes with%s hash index\n",
+         UIP_DS6_ROUTE_WITH_HASH ? "" : "out");
+
+  for(i = 0; i < NUM_NEXTHOPS; i++) {
+    uip_ip6addr(&nexthops[i], 0xfe80, 0, 0, 0, 0x0212, 0x7400, 0, i + 1);
+    memset(&lladdr, 0, sizeof(lladdr));
+    lladdr.addr[0] = 0x02;
+    lladdr.addr[sizeof(lladdr) - 1] = i + 1;
+    UNIT_TEST_ASSERT(uip_ds6_nbr_add(&nexthops[i], &lladdr, 1,
+                                     NBR_REACHABLE, NBR_TABLE_REASON_UNDEFINED,
+                                     NULL) != NULL);
+  }
+
+  for(i = 0; i < NUM_PREFIXES; i++) {
+    prefix_addr(&addr, i, 0);
+    UNIT_TEST_ASSERT(uip_ds6_route_add(&addr, 64,
+                                       &nexthops[i % NUM_NEXTHOPS]) != NULL);
+  }
+
+  for(s = 0; s < sizeof(steps) / sizeof(steps[0]); s++) {
+    while(count < steps[s]) {
+      host_addr(&addr, count);
+      UNIT_TEST_ASSERT(uip_ds6_route_add(&addr, 128,
+                                         &nexthops[count % NUM_NEXTHOPS]) != NULL);
+      count++;
+    }
+    UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == count + NUM_PREFIXES);
+
+    /* Check against the reference on a sample of destinations */
+    for(i = 0; i < NUM_CHECKS; i++) {
+      random_destination(&addr, count);
+      UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == lookup_reference(&addr));
+    }
+
+    found = 0;
+    start = clock_time();
+    for(i = 0; i < NUM_LOOKUPS; i++) {
+      random_destination(&addr, count);
+      found += uip_ds6_route_lookup(&addr) != NULL;
+    }
+    elapsed = clock_time() - start;
+    printf("TEST: %5u routes: %6lu ns per lookup (%u%% found)\n",
+           uip_ds6_route_num_routes(), elapsed * 1000000 / NUM_LOOKUPS,
+           found * 100 / NUM_LOOKUPS);
+  }
+
+  /* Remove every other host route and check again */
+  for(i = 0; i < count; i += 2) {
+    host_addr(&addr, i);
+    uip_ds6_route_rm(uip_ds6_route_lookup(&addr));
+  }
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == count / 2 + NUM_PREFIXES);
+  for(i = 0; i < count; i++) {
+    host_addr(&addr, i);
+    UNIT_TEST_ASSERT((uip_ds6_route_lookup(&addr) != NULL) == (i % 2 == 1));
+  }
+  for(i = 0; i < NUM_CHECKS; i++) {
+    random_destination(&addr, count);
+    UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == lookup_reference(&addr));
+  }
+
+  /* A re-initialized table must not find any of the old routes */
+  uip_ds6_route_init();
+  UNIT_TEST_ASSERT(uip_ds6_route_num_routes() == 0);
+  for(i = 1; i < count; i += 2) {
+    host_addr(&addr, i);
+    UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == NULL);
+  }
+  prefix_addr(&addr, 0, 0);
+  UNIT_TEST_ASSERT(uip_ds6_route_lookup(&addr) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(route_lookup);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/routing/routing.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/ipv6/uipbuf.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_NODES    1000
+#define FANOUT       4
+#define PAYLOAD_LEN  64
+#define NUM_LOOKUPS  200000
+#define NUM_PACKETS  100000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static uip_ipaddr_t root_addr;
+static uint8_t packet[UIP_BUFSIZE];
+static uint16_t packet_len;
+/*---------------------------------------------------------------------------*/
+/* Nodes share the prefix of the root. Node i is a child of the root if
+ * i < FANOUT, or else of node i / FANOUT - 1. */
+static void
+node_addr(uip_ipaddr_t *addr, int id)
+{
+  if(id < 0) {
+    uip_ipaddr_copy(addr, &root_addr);
+  } else {
+    memcpy(addr, &root_addr, 8);
+    addr->u16[4] = UIP_HTONS(0x0212);
+    addr->u16[5] = UIP_HTONS(0x7400);
+    addr->u16[6] = 0;
+    addr->u16[7] = UIP_HTONS(id + 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+parent_of(int id)
+{
+  return id < FANOUT ? -1 : id / FANOUT - 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Builds a UDP packet to a node and lets the routing protocol insert its
+ * extension headers. The resulting packet is kept in packet[]. */
+static int
+send_to(int id)
+{
+  node_addr(&UIP_IP_BUF->destipaddr, id);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &root_addr);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  memset(UIP_IP_PAYLOAD(0), 0xab, PAYLOAD_LEN);
+  uip_ext_len = 0;
+  uip_len = UIP_IPH_LEN + PAYLOAD_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, PAYLOAD_LEN);
+
+  if(!NETSTACK_ROUTING.ext_header_update()) {
+    return 0;
+  }
+  memcpy(packet, uip_buf, uip_len);
+  packet_len = uip_len;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Sends to a node and checks the source route against the graph: the
+ * first hop is the ancestor right below the root, and the number of
+ * segments is the depth of the node minus one */
+static int
+check_route(int id, const int *parents)
+{
+  int hop = id;
+  int depth = 1;
+  uip_ipaddr_t first_hop;
+  struct uip_routing_hdr *rh_hdr;
+
+  if(!send_to(id)) {
+    return 0;
+  }
+  while(parents[hop] >= 0) {
+    hop = parents[hop];
+    depth++;
+  }
+  node_addr(&first_hop, hop);
+  rh_hdr = (struct uip_routing_hdr *)(packet + UIP_IPH_LEN);
+  return ((struct uip_ip_hdr *)packet)->proto == UIP_PROTO_ROUTING
+    && rh_hdr->next == UIP_PROTO_UDP
+    && rh_hdr->seg_left == depth - 1
+    && uip_ipaddr_cmp(&((struct uip_ip_hdr *)packet)->destipaddr, &first_hop);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(sr_graph, "Source routing with 1000 nodes");
+UNIT_TEST(sr_graph)
+{
+  static int parents[NUM_NODES];
+  static uint8_t reference[UIP_BUFSIZE];
+  uint16_t reference_len;
+  uint32_t i;
+  int id;
+  uip_ipaddr_t addr;
+  uip_ipaddr_t parent;
+  uip_sr_node_t *node;
+  clock_time_t start;
+  unsigned long elapsed;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: graph with%s hash index, %u cached headers\n",
+         UIP_SR_WITH_HASH ? "" : "out", UIP_SR_SRH_CACHE_SIZE);
+
+  for(id = 0; id < NUM_NODES; id++) {
+    parents[id] = parent_of(id);
+    node_addr(&addr, id);
+    node_addr(&parent, parents[id]);
+    UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &addr, &parent, 3600) != NULL);
+  }
+  /* The root is added as the parent of the first node */
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == NUM_NODES + 1);
+
+  /* Every node is found and reachable, unknown addresses are not */
+  for(id = -1; id < NUM_NODES; id++) {
+    node_addr(&addr, id);
+    node = uip_sr_get_node(NULL, &addr);
+    UNIT_TEST_ASSERT(node != NULL);
+    NETSTACK_ROUTING.get_sr_node_ipaddr(&parent, node);
+    UNIT_TEST_ASSERT(uip_ipaddr_cmp(&parent, &addr));
+    UNIT_TEST_ASSERT(uip_sr_is_addr_reachable(NULL, &addr));
+  }
+  node_addr(&addr, NUM_NODES);
+  UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &addr) == NULL);
+
+  /* Source routes match the graph, whether computed or cached */
+  for(i = 0; i < 2; i++) {
+    for(id = 0; id < NUM_NODES; id++) {
+      UNIT_TEST_ASSERT(check_route(id, parents));
+    }
+  }
+
+  /* Moving a subtree changes the routes of all its nodes. Pick the
+   * deepest node below node 1 and make node 1 a child of node 0. */
+  for(id = NUM_NODES - 1; id > 1; id--) {
+    int hop = id;
+    while(hop >= FANOUT) {
+      hop = parents[hop];
+    }
+    if(hop == 1) {
+      break;
+    }
+  }
+  UNIT_TEST_ASSERT(send_to(id));
+  memcpy(reference, packet, packet_len);
+  reference_len = packet_len;
+  parents[1] = 0;
+  node_addr(&addr, 1);
+  node_addr(&parent, 0);
+  UNIT_TEST_ASSERT(uip_sr_update_node(NULL, &addr, &parent, 3600) != NULL);
+  UNIT_TEST_ASSERT(send_to(id));
+  UNIT_TEST_ASSERT(packet_len != reference_len
+                   || memcmp(packet, reference, packet_len) != 0);
+  for(i = 0; i < 2; i++) {
+    for(id = 0; id < NUM_NODES; id++) {
+      UNIT_TEST_ASSERT(check_route(id, parents));
+    }
+  }
+
+  start = clock_time();
+  for(i = 0; i < NUM_LOOKUPS; i++) {
+    node_addr(&addr, random_rand() % NUM_NODES);
+    UNIT_TEST_ASSERT(uip_sr_get_node(NULL, &addr) != NULL);
+  }
+  elapsed = clock_time() - start;
+  printf("TEST: %6lu ns per node lookup\n", elapsed * 1000000 / NUM_LOOKUPS);
+
+  /* A few destinations get most of the traffic */
+  start = clock_time();
+  for(i = 0; i < NUM_PACKETS; i++) {
+    UNIT_TEST_ASSERT(send_to(NUM_NODES - 1 - random_rand() % 8));
+  }
+  elapsed = clock_time() - start;
+  printf("TEST: %6lu ns per source route\n", elapsed * 1000000 / NUM_PACKETS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  NETSTACK_ROUTING.root_start();
+  NETSTACK_ROUTING.get_root_ipaddr(&root_addr);
+
+  UNIT_TEST_RUN(sr_graph);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
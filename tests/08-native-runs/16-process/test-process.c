@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_RECEIVERS   64
+#define NUM_SUBSCRIBERS 2
+#define NUM_POSTS       20000
+#define BATCH           16
+#define LOG_LEN         8
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+PROCESS_THREAD(receiver, ev, data);
+static struct process receivers[NUM_RECEIVERS];
+static struct process_subscription subscriptions[NUM_RECEIVERS];
+static process_event_t test_event;
+static unsigned long received[NUM_RECEIVERS];
+static int delivery_log[LOG_LEN];
+static int log_len;
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(receiver, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == test_event) {
+      int id = PROCESS_CURRENT() - receivers;
+      received[id]++;
+      if(log_len < LOG_LEN) {
+        delivery_log[log_len++] = id;
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+total_received(void)
+{
+  unsigned long total = 0;
+  int i;
+
+  for(i = 0; i < NUM_RECEIVERS; i++) {
+    total += received[i];
+  }
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+/* Runs the queued events until none is left for the receivers. The test
+ * process does not wait for any event, so it is never called here. */
+static void
+run_events(void)
+{
+  while(process_run() > 0);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(priorities, "Event priority classes");
+UNIT_TEST(priorities)
+{
+  struct process_event_stats before;
+  struct process_event_stats after;
+  int full;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  process_set_priority(&receivers[1], 1);
+
+  /* The high priority event is delivered first although posted last */
+  log_len = 0;
+  UNIT_TEST_ASSERT(process_post(&receivers[0], test_event, NULL) == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_post(&receivers[2], test_event, NULL) == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_post(&receivers[1], test_event, NULL) == PROCESS_ERR_OK);
+  run_events();
+  UNIT_TEST_ASSERT(log_len == 3);
+  UNIT_TEST_ASSERT(delivery_log[0] == 1);
+  UNIT_TEST_ASSERT(delivery_log[1] == 0);
+  UNIT_TEST_ASSERT(delivery_log[2] == 2);
+
+  /* Overflowing the default class drops events and counts them, but
+   * leaves room in the high priority class */
+  process_get_event_stats(PROCESS_PRIORITY_DEFAULT, &before);
+  full = 0;
+  for(i = 0; i <= PROCESS_CONF_NUMEVENTS; i++) {
+    full += process_post(&receivers[0], test_event, NULL) == PROCESS_ERR_FULL;
+  }
+  UNIT_TEST_ASSERT(full > 0);
+  UNIT_TEST_ASSERT(process_post(&receivers[1], test_event, NULL) == PROCESS_ERR_OK);
+  process_get_event_stats(PROCESS_PRIORITY_DEFAULT, &after);
+  UNIT_TEST_ASSERT(after.dropped == before.dropped + full);
+  UNIT_TEST_ASSERT(after.max_events == PROCESS_CONF_NUMEVENTS);
+  run_events();
+
+  process_set_priority(&receivers[1], PROCESS_PRIORITY_DEFAULT);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(cancel, "Event cancellation");
+UNIT_TEST(cancel)
+{
+  static int a, b;
+
+  UNIT_TEST_BEGIN();
+
+  /* Only the matching events are removed, from every priority class,
+   * and the others are delivered in order */
+  log_len = 0;
+  UNIT_TEST_ASSERT(process_post(&receivers[0], test_event, &a) == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_post(&receivers[2], test_event, &b) == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_post_priority(&receivers[0], test_event, &a, 1) == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_post(&receivers[3], test_event, &a) == PROCESS_ERR_OK);
+  UNIT_TEST_ASSERT(process_post(&receivers[0], test_event, &b) == PROCESS_ERR_OK);
+  process_cancel_event(&receivers[0], test_event, &a);
+  run_events();
+  UNIT_TEST_ASSERT(log_len == 3);
+  UNIT_TEST_ASSERT(delivery_log[0] == 2);
+  UNIT_TEST_ASSERT(delivery_log[1] == 3);
+  UNIT_TEST_ASSERT(delivery_log[2] == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(subscriptions, "Event subscriptions");
+UNIT_TEST(subscriptions)
+{
+  int i;
+  unsigned long n;
+  clock_time_t start;
+  unsigned long elapsed;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < NUM_SUBSCRIBERS; i++) {
+    process_subscribe(&subscriptions[i], &receivers[i * 8], test_event);
+  }
+
+  /* Only the subscribers receive the event */
+  memset(received, 0, sizeof(received));
+  UNIT_TEST_ASSERT(process_post(PROCESS_SUBSCRIBERS, test_event, NULL) == PROCESS_ERR_OK);
+  run_events();
+  UNIT_TEST_ASSERT(total_received() == NUM_SUBSCRIBERS);
+  for(i = 0; i < NUM_SUBSCRIBERS; i++) {
+    UNIT_TEST_ASSERT(received[i * 8] == 1);
+  }
+
+  /* Broadcast events still reach every process */
+  UNIT_TEST_ASSERT(process_post(PROCESS_BROADCAST, test_event, NULL) == PROCESS_ERR_OK);
+  run_events();
+  UNIT_TEST_ASSERT(total_received() == NUM_SUBSCRIBERS + NUM_RECEIVERS);
+
+  /* Compare the cost of both */
+  memset(received, 0, sizeof(received));
+  start = clock_time();
+  for(n = 0; n < NUM_POSTS; n += BATCH) {
+    for(i = 0; i < BATCH; i++) {
+      process_post(PROCESS_BROADCAST, test_event, NULL);
+    }
+    run_events();
+  }
+  elapsed = clock_time() - start;
+  UNIT_TEST_ASSERT(total_received() == (unsigned long)NUM_POSTS * NUM_RECEIVERS);
+  printf("TEST: %6lu ns per broadcast event\n", elapsed * 1000000 / NUM_POSTS);
+
+  memset(received, 0, sizeof(received));
+  start = clock_time();
+  for(n = 0; n < NUM_POSTS; n += BATCH) {
+    for(i = 0; i < BATCH; i++) {
+      process_post(PROCESS_SUBSCRIBERS, test_event, NULL);
+    }
+    run_events();
+  }
+  elapsed = clock_time() - start;
+  UNIT_TEST_ASSERT(total_received() == (unsigned long)NUM_POSTS * NUM_SUBSCRIBERS);
+  printf("TEST: %6lu ns per subscribed event\n", elapsed * 1000000 / NUM_POSTS);
+
+  /* Unsubscribing and exiting drop subscriptions */
+  process_unsubscribe(&subscriptions[0]);
+  process_exit(&receivers[8]);
+  memset(received, 0, sizeof(received));
+  UNIT_TEST_ASSERT(process_post(PROCESS_SUBSCRIBERS, test_event, NULL) == PROCESS_ERR_OK);
+  run_events();
+  UNIT_TEST_ASSERT(total_received() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  test_event = process_alloc_event();
+  for(i = 0; i < NUM_RECEIVERS; i++) {
+    receivers[i].name = "receiver";
+    receivers[i].thread = process_thread_receiver;
+    process_start(&receivers[i], NULL);
+  }
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(priorities);
+  UNIT_TEST_RUN(cancel);
+  UNIT_TEST_RUN(subscriptions);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
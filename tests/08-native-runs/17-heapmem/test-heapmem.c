@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/heapmem.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_SLOTS 256
+#define NUM_OPS   1000000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static struct {
+  uint8_t *ptr;
+  size_t size;
+} slots[NUM_SLOTS];
+/*---------------------------------------------------------------------------*/
+/* Mostly small objects, with some buffers of a few hundred bytes */
+static size_t
+random_size(void)
+{
+  unsigned r = random_rand() % 100;
+
+  if(r < 70) {
+    return 8 + random_rand() % 56;
+  } else if(r < 95) {
+    return 64 + random_rand() % 192;
+  }
+  return 256 + random_rand() % 768;
+}
+/*---------------------------------------------------------------------------*/
+static int
+slot_intact(int i)
+{
+  size_t j;
+
+  for(j = 0; j < slots[i].size; j++) {
+    if(slots[i].ptr[j] != (uint8_t)i) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(heapmem_stress, "Heap allocator stress");
+UNIT_TEST(heapmem_stress)
+{
+  uint32_t op;
+  int i;
+  size_t size;
+  size_t live;
+  unsigned long failures = 0;
+  clock_time_t start;
+  unsigned long elapsed;
+  heapmem_stats_t stats;
+  void *ptr;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: %s allocator\n", HEAPMEM_CONF_TLSF ? "TLSF" : "first-fit");
+
+  start = clock_time();
+  for(op = 0; op < NUM_OPS; op++) {
+    i = random_rand() % NUM_SLOTS;
+    if(slots[i].ptr == NULL) {
+      size = random_size();
+      slots[i].ptr = heapmem_alloc(size);
+      if(slots[i].ptr == NULL) {
+        failures++;
+        continue;
+      }
+      slots[i].size = size;
+    } else if(random_rand() % 4 == 0) {
+      size = random_size();
+      ptr = heapmem_realloc(slots[i].ptr, size);
+      if(ptr == NULL) {
+        failures++;
+        continue;
+      }
+      slots[i].ptr = ptr;
+      if(size > slots[i].size) {
+        memset(slots[i].ptr + slots[i].size, i, size - slots[i].size);
+      }
+      slots[i].size = size;
+      continue;
+    } else {
+      heapmem_free(slots[i].ptr);
+      slots[i].ptr = NULL;
+      continue;
+    }
+    memset(slots[i].ptr, i, slots[i].size);
+  }
+  elapsed = clock_time() - start;
+
+  live = 0;
+  for(i = 0; i < NUM_SLOTS; i++) {
+    if(slots[i].ptr != NULL) {
+      UNIT_TEST_ASSERT(slot_intact(i));
+      live += slots[i].size;
+    }
+  }
+
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.allocated >= live);
+  UNIT_TEST_ASSERT(stats.allocated + stats.overhead + stats.available
+                   == HEAPMEM_CONF_ARENA_SIZE);
+  printf("TEST: %6lu ns per operation, %lu failed allocations\n",
+         elapsed * 1000000 / NUM_OPS, failures);
+  printf("TEST: %u bytes allocated in %u chunks, %u available, "
+         "largest free %u, fragmentation %u%%\n",
+         (unsigned)stats.allocated, (unsigned)stats.chunks,
+         (unsigned)stats.available, (unsigned)stats.largest_free,
+         stats.fragmentation);
+  for(i = 0; i < HEAPMEM_SIZE_CLASSES; i++) {
+    printf("TEST: class %d: %u allocated, %u free\n", i,
+           (unsigned)stats.allocated_chunks[i], (unsigned)stats.free_chunks[i]);
+  }
+
+  /* Freeing everything leaves a single free block */
+  for(i = 0; i < NUM_SLOTS; i++) {
+    heapmem_free(slots[i].ptr);
+    slots[i].ptr = NULL;
+  }
+  heapmem_stats(&stats);
+  UNIT_TEST_ASSERT(stats.allocated == 0);
+#if HEAPMEM_CONF_TLSF
+  /* Free chunks are merged with the unused end of the heap at once */
+  UNIT_TEST_ASSERT(stats.footprint == 0);
+  UNIT_TEST_ASSERT(stats.fragmentation == 0);
+#endif /* HEAPMEM_CONF_TLSF */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(heapmem_stress);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
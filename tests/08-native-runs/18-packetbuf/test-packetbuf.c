@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/queuebuf.h"
+#include "net/mac/framer/framer-802154.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PAYLOAD_LEN 100
+#define NUM_FRAMES  1000000
+/* Transmissions per forwarded frame, i.e. one retry */
+#define NUM_TX      2
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const linkaddr_t next_hop = { { 1, 2, 3, 4, 5, 6, 7, 8 } };
+/*---------------------------------------------------------------------------*/
+/* Put a frame in the packetbuf, as a radio driver would */
+static void
+receive_frame(uint8_t fill)
+{
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), fill, PAYLOAD_LEN);
+  packetbuf_set_datalen(PAYLOAD_LEN);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &next_hop);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, 1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+holds(const uint8_t *p, uint8_t fill, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    if(p[i] != fill) {
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(queue_sharing, "Queued packets are not modified");
+UNIT_TEST(queue_sharing)
+{
+  struct queuebuf *q;
+  int hdr_len;
+
+  UNIT_TEST_BEGIN();
+
+  receive_frame(0xaa);
+  q = queuebuf_new_from_packetbuf();
+  UNIT_TEST_ASSERT(q != NULL);
+  UNIT_TEST_ASSERT(queuebuf_datalen(q) == PAYLOAD_LEN);
+
+  /* A new packet does not overwrite the queued one */
+  receive_frame(0x55);
+  UNIT_TEST_ASSERT(holds(queuebuf_dataptr(q), 0xaa, PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(holds(packetbuf_dataptr(), 0x55, PAYLOAD_LEN));
+
+  /* Framing the restored packet leaves the queued one untouched */
+  queuebuf_to_packetbuf(q);
+  UNIT_TEST_ASSERT(packetbuf_datalen() == PAYLOAD_LEN);
+  UNIT_TEST_ASSERT(holds(packetbuf_dataptr(), 0xaa, PAYLOAD_LEN));
+  hdr_len = framer_802154.create();
+  UNIT_TEST_ASSERT(hdr_len > 0);
+  UNIT_TEST_ASSERT(packetbuf_totlen() == hdr_len + PAYLOAD_LEN);
+  UNIT_TEST_ASSERT(holds((uint8_t *)packetbuf_hdrptr() + hdr_len,
+                         0xaa, PAYLOAD_LEN));
+  UNIT_TEST_ASSERT(queuebuf_datalen(q) == PAYLOAD_LEN);
+  UNIT_TEST_ASSERT(holds(queuebuf_dataptr(q), 0xaa, PAYLOAD_LEN));
+
+  /* In-place changes need a writable packetbuf */
+  UNIT_TEST_ASSERT(packetbuf_make_writable());
+  memset(packetbuf_dataptr(), 0x11, PAYLOAD_LEN);
+  UNIT_TEST_ASSERT(holds(queuebuf_dataptr(q), 0xaa, PAYLOAD_LEN));
+
+  /* Headers larger than the headroom shift the packet */
+  queuebuf_to_packetbuf(q);
+  packetbuf_set_datalen(PAYLOAD_LEN / 2);
+  UNIT_TEST_ASSERT(packetbuf_hdralloc(PACKETBUF_HEADROOM + 4));
+  UNIT_TEST_ASSERT(packetbuf_totlen() ==
+                   PACKETBUF_HEADROOM + 4 + PAYLOAD_LEN / 2);
+  UNIT_TEST_ASSERT(holds(packetbuf_dataptr(), 0xaa, PAYLOAD_LEN / 2));
+  UNIT_TEST_ASSERT(holds(queuebuf_dataptr(q), 0xaa, PAYLOAD_LEN));
+
+  queuebuf_free(q);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(queue_full, "Full queue");
+UNIT_TEST(queue_full)
+{
+  struct queuebuf *q[QUEUEBUF_NUM];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    receive_frame(i);
+    q[i] = queuebuf_new_from_packetbuf();
+    UNIT_TEST_ASSERT(q[i] != NULL);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == 0);
+
+  /* The packetbuf still has a buffer of its own */
+  receive_frame(0xff);
+  UNIT_TEST_ASSERT(holds(packetbuf_dataptr(), 0xff, PAYLOAD_LEN));
+  for(i = 0; i < QUEUEBUF_NUM; i++) {
+    UNIT_TEST_ASSERT(holds(queuebuf_dataptr(q[i]), i, PAYLOAD_LEN));
+    queuebuf_free(q[i]);
+  }
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(forwarding, "Forwarded frame cost");
+UNIT_TEST(forwarding)
+{
+  struct queuebuf *q;
+  unsigned long frame;
+  unsigned long elapsed;
+  clock_time_t start;
+  int tx;
+  int failures = 0;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: %s packetbuf, %u bytes of headroom\n",
+         PACKETBUF_WITH_POOL ? "pooled" : "copying", PACKETBUF_HEADROOM);
+
+  start = clock_time();
+  for(frame = 0; frame < NUM_FRAMES; frame++) {
+    receive_frame(frame);
+    q = queuebuf_new_from_packetbuf();
+    if(q == NULL) {
+      failures++;
+      continue;
+    }
+    for(tx = 0; tx < NUM_TX; tx++) {
+      queuebuf_to_packetbuf(q);
+      if(framer_802154.create() < 0) {
+        failures++;
+      }
+    }
+    queuebuf_free(q);
+  }
+  elapsed = clock_time() - start;
+
+  UNIT_TEST_ASSERT(failures == 0);
+  UNIT_TEST_ASSERT(queuebuf_numfree() == QUEUEBUF_NUM);
+  printf("TEST: %6lu ns per forwarded frame (%u transmissions)\n",
+         elapsed * 1000000 / NUM_FRAMES, NUM_TX);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(queue_sharing);
+  UNIT_TEST_RUN(queue_full);
+  UNIT_TEST_RUN(forwarding);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* 8 objects of 16 resources, every object also has a parent resource */
+#define NUM_OBJECTS   8
+#define NUM_INSTANCES 16
+#define NUM_RESOURCES (NUM_OBJECTS * (NUM_INSTANCES + 1))
+#define NUM_REQUESTS  200000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static coap_resource_t resources[NUM_RESOURCES];
+static char paths[NUM_RESOURCES][16];
+static coap_endpoint_t client;
+static uint16_t mid;
+static char last_hit;
+static unsigned long hits;
+/*---------------------------------------------------------------------------*/
+#define HANDLER(name, c)                                                \
+  static void                                                           \
+  name(coap_message_t *request, coap_message_t *response,               \
+       uint8_t *buffer, uint16_t preferred_size, int32_t *offset)       \
+  {                                                                     \
+    last_hit = c;                                                       \
+  }
+
+HANDLER(get_a, 'a')
+HANDLER(get_b, 'b')
+HANDLER(get_c, 'c')
+HANDLER(get_d, 'd')
+
+RESOURCE(res_a, "", get_a, NULL, NULL, NULL);
+PARENT_RESOURCE(res_b, "", get_b, NULL, NULL, NULL);
+PARENT_RESOURCE(res_c, "", get_c, NULL, NULL, NULL);
+RESOURCE(res_d, "", get_d, NULL, NULL, NULL);
+/*---------------------------------------------------------------------------*/
+static void
+get_counter(coap_message_t *request, coap_message_t *response,
+            uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  hits++;
+}
+/*---------------------------------------------------------------------------*/
+/* Replay a NON GET for path, return the name of the handler that ran */
+static char
+get(const char *path)
+{
+  coap_message_t request[1];
+  uint8_t buf[64];
+  size_t len;
+
+  coap_init_message(request, COAP_TYPE_NON, COAP_GET, mid++);
+  coap_set_header_uri_path(request, path);
+  len = coap_serialize_message(request, buf);
+  last_hit = 0;
+  coap_receive(&client, buf, len);
+  return last_hit;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(sub_resources, "Sub-resource dispatch");
+UNIT_TEST(sub_resources)
+{
+  UNIT_TEST_BEGIN();
+
+  /* The resource activated first wins */
+  coap_activate_resource(&res_a, "p/q");
+  coap_activate_resource(&res_b, "p");
+  coap_activate_resource(&res_c, "s");
+  coap_activate_resource(&res_d, "s/t");
+
+  UNIT_TEST_ASSERT(get("p/q") == 'a');
+  UNIT_TEST_ASSERT(get("p") == 'b');
+  UNIT_TEST_ASSERT(get("p/q/r") == 'b');
+  UNIT_TEST_ASSERT(get("p/x") == 'b');
+  UNIT_TEST_ASSERT(get("px") == 0);
+  UNIT_TEST_ASSERT(get("s/t") == 'c');
+  UNIT_TEST_ASSERT(get("s/t/u") == 'c');
+  UNIT_TEST_ASSERT(get("q") == 0);
+
+  /* Activating a resource again moves it behind the others */
+  coap_activate_resource(&res_c, "s");
+  UNIT_TEST_ASSERT(get("s/t") == 'd');
+  UNIT_TEST_ASSERT(get("s/t/u") == 'c');
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(dispatch, "Resource dispatch");
+UNIT_TEST(dispatch)
+{
+  static uint8_t requests[4 * NUM_INSTANCES][64];
+  static size_t lengths[4 * NUM_INSTANCES];
+  coap_message_t request[1];
+  char path[32];
+  unsigned long expected = 0;
+  unsigned long elapsed;
+  clock_time_t start;
+  uint8_t buf[64];
+  int i, j, r;
+
+  UNIT_TEST_BEGIN();
+
+  r = 0;
+  for(i = 0; i < NUM_OBJECTS; i++) {
+    for(j = 0; j < NUM_INSTANCES; j++, r++) {
+      snprintf(paths[r], sizeof(paths[r]), "%u/0/%u", 3300 + i, 5700 + j);
+      resources[r].flags = METHOD_GET;
+      resources[r].get_handler = get_counter;
+      coap_activate_resource(&resources[r], paths[r]);
+    }
+    snprintf(paths[r], sizeof(paths[r]), "%u", 3300 + i);
+    resources[r].flags = METHOD_GET | HAS_SUB_RESOURCES;
+    resources[r].get_handler = get_counter;
+    coap_activate_resource(&resources[r], paths[r]);
+    r++;
+  }
+  printf("TEST: %d resources, %u hash buckets\n",
+         NUM_RESOURCES, COAP_RESOURCE_HASH_BUCKETS);
+
+  /* A mix of exact matches on the last objects, sub-resources and misses */
+  for(i = 0; i < 4 * NUM_INSTANCES; i++) {
+    switch(i % 4) {
+    case 0:
+    case 1:
+      snprintf(path, sizeof(path), "%u/0/%u",
+               3300 + NUM_OBJECTS - 1 - i % 2, 5700 + i / 4);
+      break;
+    case 2:
+      snprintf(path, sizeof(path), "%u/1/%u", 3300 + i / 4 % NUM_OBJECTS,
+               5700 + i / 4);
+      break;
+    default:
+      snprintf(path, sizeof(path), "%u/0/%u", 3400, 5700 + i / 4);
+      break;
+    }
+    coap_init_message(request, COAP_TYPE_NON, COAP_GET, 0);
+    coap_set_header_uri_path(request, path);
+    lengths[i] = coap_serialize_message(request, requests[i]);
+  }
+
+  hits = 0;
+  start = clock_time();
+  for(i = 0; i < NUM_REQUESTS; i++) {
+    r = i % (4 * NUM_INSTANCES);
+    memcpy(buf, requests[r], lengths[r]);
+    coap_receive(&client, buf, lengths[r]);
+    if(r % 4 != 3) {
+      expected++;
+    }
+  }
+  elapsed = clock_time() - start;
+
+  UNIT_TEST_ASSERT(hits == expected);
+  printf("TEST: %6lu ns per request\n", elapsed * 1000000 / NUM_REQUESTS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  coap_engine_init();
+  coap_endpoint_parse("coap://[fd00::1]", 16, &client);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(sub_resources);
+  UNIT_TEST_RUN(dispatch);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
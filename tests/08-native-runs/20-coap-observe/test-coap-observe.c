@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "net/ipv6/uip.h"
+#include "net/netstack.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Observers of the sensor, and of unrelated resources */
+#define NUM_OBSERVERS 200
+#define NUM_OTHERS    64
+#define NUM_NOTIFIES  2000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static void get_sensor(coap_message_t *request, coap_message_t *response,
+                       uint8_t *buffer, uint16_t preferred_size,
+                       int32_t *offset);
+static void get_other(coap_message_t *request, coap_message_t *response,
+                      uint8_t *buffer, uint16_t preferred_size,
+                      int32_t *offset);
+
+EVENT_RESOURCE(res_sensor, "title=\"Sensor\";obs", get_sensor, NULL, NULL, NULL, NULL);
+static coap_resource_t res_others[NUM_OTHERS];
+static char other_paths[NUM_OTHERS][16];
+
+static unsigned long handler_calls;
+static unsigned sensor_value;
+
+/* Notifications captured on their way out */
+static unsigned long sent;
+static int check_sent;
+static int bad_sent;
+static uint32_t last_observe[NUM_OBSERVERS];
+static uint16_t mid;
+/*---------------------------------------------------------------------------*/
+static void
+get_sensor(coap_message_t *request, coap_message_t *response,
+           uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  handler_calls++;
+  coap_set_header_content_format(response, TEXT_PLAIN);
+  coap_set_header_max_age(response, 30);
+  coap_set_payload(response, buffer,
+                   snprintf((char *)buffer, preferred_size,
+                            "temperature=%u", sensor_value));
+}
+/*---------------------------------------------------------------------------*/
+static void
+get_other(coap_message_t *request, coap_message_t *response,
+          uint8_t *buffer, uint16_t preferred_size, int32_t *offset)
+{
+  coap_set_payload(response, "other", 5);
+}
+/*---------------------------------------------------------------------------*/
+/* Check every notification leaving the node, then drop it */
+static enum netstack_ip_action
+capture_output(const linkaddr_t *localdest)
+{
+  coap_message_t message[1];
+  uint8_t buf[UIP_BUFSIZE];
+  char expected[32];
+  uint16_t len;
+  unsigned i;
+
+  sent++;
+  if(check_sent) {
+    len = uip_len - UIP_IPUDPH_LEN;
+    memcpy(buf, uip_buf + UIP_IPUDPH_LEN, len);
+    i = (buf[4] << 8) | buf[5];
+    snprintf(expected, sizeof(expected), "temperature=%u", sensor_value);
+    if(coap_parse_message(message, buf, len) != NO_ERROR
+       || message->type != COAP_TYPE_NON
+       || message->code != CONTENT_2_05
+       || message->token_len != 2
+       || i >= NUM_OBSERVERS
+       || UIP_HTONS(UIP_UDP_BUF->destport) != 5000 + i
+       || !coap_is_option(message, COAP_OPTION_OBSERVE)
+       || message->observe != last_observe[i] + 1
+       || message->content_format != TEXT_PLAIN
+       || message->max_age != 30
+       || message->payload_len != strlen(expected)
+       || memcmp(message->payload, expected, message->payload_len) != 0) {
+      bad_sent++;
+    } else {
+      last_observe[i] = message->observe;
+    }
+  }
+  return NETSTACK_IP_DROP;
+}
+static struct netstack_ip_packet_processor capture = {
+  .process_output = capture_output
+};
+/*---------------------------------------------------------------------------*/
+/* Send a NON GET with Observe=0 from the given client port */
+static void
+observe(const char *path, uint16_t port, uint16_t token)
+{
+  coap_message_t request[1];
+  coap_endpoint_t client;
+  uint8_t token_bytes[2] = { token >> 8, token & 0xff };
+  uint8_t buf[64];
+  size_t len;
+
+  coap_endpoint_parse("coap://[fd00::1]", 16, &client);
+  client.port = UIP_HTONS(port);
+  coap_init_message(request, COAP_TYPE_NON, COAP_GET, mid++);
+  coap_set_token(request, token_bytes, 2);
+  coap_set_header_uri_path(request, path);
+  coap_set_header_observe(request, 0);
+  len = coap_serialize_message(request, buf);
+  coap_receive(&client, buf, len);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(notify, "Notifications");
+UNIT_TEST(notify)
+{
+  unsigned long elapsed;
+  clock_time_t start;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < NUM_OTHERS; i++) {
+    snprintf(other_paths[i], sizeof(other_paths[i]), "sensors/%u", i);
+    res_others[i].flags = METHOD_GET | IS_OBSERVABLE;
+    res_others[i].get_handler = get_other;
+    coap_activate_resource(&res_others[i], other_paths[i]);
+    observe(other_paths[i], 6000 + i, i);
+  }
+  for(i = 0; i < NUM_OBSERVERS; i++) {
+    observe("obs", 5000 + i, i);
+    last_observe[i] = 0;
+  }
+  UNIT_TEST_ASSERT(coap_has_observers("obs"));
+  printf("TEST: %u observers of the sensor, %u of other resources, "
+         "%u hash buckets\n", NUM_OBSERVERS, NUM_OTHERS,
+         COAP_OBSERVER_HASH_BUCKETS);
+
+  /* Every observer gets its own token and sequence number */
+  sent = 0;
+  handler_calls = 0;
+  check_sent = 1;
+  for(i = 0; i < 300; i++) {
+    sensor_value = i;
+    coap_notify_observers(&res_sensor);
+  }
+  check_sent = 0;
+  UNIT_TEST_ASSERT(bad_sent == 0);
+  UNIT_TEST_ASSERT(sent == 300 * NUM_OBSERVERS);
+  printf("TEST: %lu handler calls for %lu notifications\n",
+         handler_calls, sent);
+
+  sent = 0;
+  start = clock_time();
+  for(i = 0; i < NUM_NOTIFIES; i++) {
+    coap_notify_observers(&res_sensor);
+  }
+  elapsed = clock_time() - start;
+  UNIT_TEST_ASSERT(sent == NUM_NOTIFIES * NUM_OBSERVERS);
+  printf("TEST: %6lu ns per notification\n",
+         elapsed * 1000000 / NUM_NOTIFIES / NUM_OBSERVERS);
+
+  /* Resources with a single observer each */
+  sent = 0;
+  start = clock_time();
+  for(i = 0; i < 100 * NUM_NOTIFIES; i++) {
+    coap_notify_observers(&res_others[i % NUM_OTHERS]);
+  }
+  elapsed = clock_time() - start;
+  UNIT_TEST_ASSERT(sent == 100 * NUM_NOTIFIES);
+  printf("TEST: %6lu ns per single-observer notification\n",
+         elapsed * 10000 / NUM_NOTIFIES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  coap_engine_init();
+  coap_activate_resource(&res_sensor, "obs");
+  netstack_ip_packet_processor_add(&capture);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(notify);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-chksum.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BUF_LEN     1600
+#define NUM_RANDOM  20000
+/* Bytes summed per kernel and packet size in the benchmark */
+#define BENCH_BYTES (64UL * 1024 * 1024)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+typedef uint16_t (*chksum_add_t)(uint16_t, const uint8_t *, uint16_t);
+
+static const struct {
+  const char *name;
+  chksum_add_t add;
+} kernels[] = {
+  { "bytewise", uip_chksum_add_bytewise },
+  { "acc32", uip_chksum_add_acc32 },
+  { "acc64", uip_chksum_add_acc64 },
+  { "configured", UIP_CHKSUM_ADD },
+};
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+static const uint16_t bench_sizes[] = { 40, 128, 512, 1280 };
+#define NUM_SIZES (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+static uint8_t buf[BUF_LEN];
+static volatile uint16_t sink;
+/*---------------------------------------------------------------------------*/
+static void
+fill_random(uint8_t *p, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    p[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The checksum field value of a buffer, as stored in a packet */
+static uint16_t
+stored_chksum(const uint8_t *p, uint16_t len)
+{
+  return uip_htons(~uip_chksum_add_bytewise(0, p, len));
+}
+/*---------------------------------------------------------------------------*/
+/* 0x0000 and 0xffff are both representations of zero */
+static int
+chksum_equal(uint16_t a, uint16_t b)
+{
+  return a == b || ((a == 0 || a == 0xffff) && (b == 0 || b == 0xffff));
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(equivalence, "Kernels agree with the bytewise sum");
+UNIT_TEST(equivalence)
+{
+  unsigned i;
+  unsigned k;
+  uint16_t offset;
+  uint16_t len;
+  uint16_t sum;
+  uint16_t expected;
+  int mismatches = 0;
+
+  UNIT_TEST_BEGIN();
+
+  fill_random(buf, BUF_LEN);
+  for(i = 0; i < NUM_RANDOM; i++) {
+    /* Every alignment and every length, odd ones included */
+    offset = i % 16;
+    len = (i < 256) ? i : random_rand() % (BUF_LEN - 16);
+    sum = (i & 1) ? random_rand() : 0;
+    expected = uip_chksum_add_bytewise(sum, buf + offset, len);
+    for(k = 1; k < NUM_KERNELS; k++) {
+      if(kernels[k].add(sum, buf + offset, len) != expected) {
+        printf("%s: len %u offset %u sum 0x%04x\n",
+               kernels[k].name, len, offset, sum);
+        mismatches++;
+      }
+    }
+  }
+
+  /* Sums that fold repeatedly, and the all-zero sum */
+  for(i = 0; i < 2; i++) {
+    memset(buf, i ? 0xff : 0x00, BUF_LEN);
+    for(len = 0; len < BUF_LEN; len += 333) {
+      expected = uip_chksum_add_bytewise(0xffff * i, buf + 1, len);
+      for(k = 1; k < NUM_KERNELS; k++) {
+        if(kernels[k].add(0xffff * i, buf + 1, len) != expected) {
+          mismatches++;
+        }
+      }
+    }
+  }
+
+  UNIT_TEST_ASSERT(mismatches == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(incremental, "Incremental checksum update");
+UNIT_TEST(incremental)
+{
+  unsigned i;
+  uint16_t len;
+  uint16_t pos;
+  uint16_t chksum;
+  uint16_t old_word;
+  uint16_t new_word;
+  uint8_t old_addr[16];
+  int mismatches = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 2000; i++) {
+    len = 40 + 2 * (random_rand() % 600);
+    fill_random(buf, len);
+    chksum = stored_chksum(buf, len);
+
+    /* Rewrite a 16-bit field, e.g. a port or a hop limit and next header */
+    pos = 2 * (random_rand() % (len / 2));
+    memcpy(&old_word, buf + pos, 2);
+    new_word = (i % 7) ? random_rand() : old_word ^ 0xffff;
+    memcpy(buf + pos, &new_word, 2);
+    chksum = uip_chksum_update16(chksum, old_word, new_word);
+    if(!chksum_equal(chksum, stored_chksum(buf, len))) {
+      mismatches++;
+    }
+
+    /* Rewrite an IPv6 address */
+    pos = 2 * (random_rand() % ((len - 16) / 2));
+    memcpy(old_addr, buf + pos, 16);
+    fill_random(buf + pos, 16);
+    chksum = uip_chksum_update(chksum, old_addr, buf + pos, 16);
+    if(!chksum_equal(chksum, stored_chksum(buf, len))) {
+      mismatches++;
+    }
+  }
+
+  UNIT_TEST_ASSERT(mismatches == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Checksum throughput");
+UNIT_TEST(benchmark)
+{
+  unsigned k;
+  unsigned s;
+  unsigned long n;
+  unsigned long iterations;
+  unsigned long elapsed;
+  clock_time_t start;
+  uint16_t sum;
+
+  UNIT_TEST_BEGIN();
+
+  fill_random(buf, BUF_LEN);
+  printf("TEST: ns per checksum, packet sizes");
+  for(s = 0; s < NUM_SIZES; s++) {
+    printf(" %6u", bench_sizes[s]);
+  }
+  printf("\n");
+
+  for(k = 0; k < NUM_KERNELS; k++) {
+    printf("TEST: %-10s                  ", kernels[k].name);
+    for(s = 0; s < NUM_SIZES; s++) {
+      iterations = BENCH_BYTES / bench_sizes[s];
+      sum = 0;
+      start = clock_time();
+      for(n = 0; n < iterations; n++) {
+        /* Chain the sums so the calls cannot be hoisted */
+        sum = kernels[k].add(sum, buf + (n & 1), bench_sizes[s]);
+      }
+      elapsed = clock_time() - start;
+      sink = sum;
+      printf(" %6lu", elapsed * 1000000 / iterations);
+    }
+    printf("\n");
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(equivalence);
+  UNIT_TEST_RUN(incremental);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BUF_LEN     1300
+#define NUM_RANDOM  20000
+/* Bytes checksummed per variant and frame size in the benchmark */
+#define BENCH_BYTES (16UL * 1024 * 1024)
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* Largest 802.15.4 frame, and a full IPv6 MTU for 802.15.4g/TSCH */
+static const int bench_sizes[] = { 20, 127, 1280 };
+#define NUM_SIZES (sizeof(bench_sizes) / sizeof(bench_sizes[0]))
+
+static uint8_t buf[BUF_LEN];
+static volatile unsigned short sink;
+/*---------------------------------------------------------------------------*/
+/* The reference: one crc16_add() per byte */
+static unsigned short
+crc16_bitwise(const unsigned char *data, int len, unsigned short acc)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    acc = crc16_add(data[i], acc);
+  }
+  return acc;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(check_value, "CRC16 check value");
+UNIT_TEST(check_value)
+{
+  const unsigned char check[] = "123456789";
+
+  UNIT_TEST_BEGIN();
+
+  /* CRC-16/KERMIT, the 802.15.4 FCS */
+  UNIT_TEST_ASSERT(crc16_bitwise(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc16_data(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc16_data(check, 0, 0x1234) == 0x1234);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(equivalence, "Equivalence with the bitwise CRC16");
+UNIT_TEST(equivalence)
+{
+  unsigned i;
+  int offset;
+  int len;
+  int split;
+  unsigned short acc;
+  unsigned short expected;
+  int mismatches = 0;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < BUF_LEN; i++) {
+    buf[i] = random_rand();
+  }
+
+  for(i = 0; i < NUM_RANDOM; i++) {
+    offset = i % 8;
+    len = (i < 256) ? i : random_rand() % (BUF_LEN - 8);
+    acc = (i & 1) ? random_rand() : 0;
+    expected = crc16_bitwise(buf + offset, len, acc);
+    if(crc16_data(buf + offset, len, acc) != expected) {
+      printf("len %d offset %d acc 0x%04x\n", len, offset, acc);
+      mismatches++;
+    }
+    /* A running CRC over two chunks */
+    split = len ? random_rand() % len : 0;
+    acc = crc16_data(buf + offset, split, acc);
+    if(crc16_data(buf + offset + split, len - split, acc) != expected) {
+      mismatches++;
+    }
+  }
+
+  UNIT_TEST_ASSERT(mismatches == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "CRC16 throughput");
+UNIT_TEST(benchmark)
+{
+  unsigned s;
+  int variant;
+  unsigned long n;
+  unsigned long iterations;
+  unsigned long elapsed;
+  clock_time_t start;
+  unsigned short acc;
+
+  UNIT_TEST_BEGIN();
+
+  printf("TEST: ns per CRC16, frame sizes    ");
+  for(s = 0; s < NUM_SIZES; s++) {
+    printf(" %6d", bench_sizes[s]);
+  }
+  printf("\n");
+
+  for(variant = 0; variant < 2; variant++) {
+    if(variant == 0) {
+      printf("TEST: bitwise                      ");
+    } else {
+      printf("TEST: crc16_data, %u slice(s)       ", CRC16_SLICES);
+    }
+    for(s = 0; s < NUM_SIZES; s++) {
+      iterations = BENCH_BYTES / bench_sizes[s];
+      acc = 0;
+      start = clock_time();
+      for(n = 0; n < iterations; n++) {
+        /* Chain the CRCs so the calls cannot be hoisted */
+        if(variant == 0) {
+          acc = crc16_bitwise(buf, bench_sizes[s], acc);
+        } else {
+          acc = crc16_data(buf, bench_sizes[s], acc);
+        }
+      }
+      elapsed = clock_time() - start;
+      sink = acc;
+      printf(" %6lu", elapsed * 1000000 / iterations);
+    }
+    printf("\n");
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(check_value);
+  UNIT_TEST_RUN(equivalence);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
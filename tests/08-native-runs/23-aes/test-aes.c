@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* A secured 802.15.4 data frame: header, payload and 8-byte MIC */
+#define HDR_LEN     23
+#define PAYLOAD_LEN 96
+#define MIC_LEN     8
+#define NUM_FRAMES  100000
+#define NUM_BLOCKS  1000000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+extern const struct aes_128_driver native_aes_128_driver;
+
+static const struct {
+  const char *name;
+  const struct aes_128_driver *driver;
+} drivers[] = {
+  { "bytewise", &aes_128_driver },
+  { "T-table", &aes_128_ttable_driver },
+  { "native", &native_aes_128_driver },
+};
+#define NUM_DRIVERS (sizeof(drivers) / sizeof(drivers[0]))
+
+/* FIPS-197, appendix C.1 */
+static const uint8_t fips_key[AES_128_KEY_LENGTH] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+static const uint8_t fips_plaintext[AES_128_BLOCK_SIZE] = {
+  0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+  0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+};
+static const uint8_t fips_ciphertext[AES_128_BLOCK_SIZE] = {
+  0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+  0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+};
+
+static volatile uint8_t sink;
+/*---------------------------------------------------------------------------*/
+static void
+fill_random(uint8_t *p, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    p[i] = random_rand();
+  }
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(drivers_agree, "AES-128 drivers agree");
+UNIT_TEST(drivers_agree)
+{
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t expected[8 * AES_128_BLOCK_SIZE];
+  uint8_t blocks[8 * AES_128_BLOCK_SIZE];
+  uint8_t batch[8 * AES_128_BLOCK_SIZE];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  unsigned d;
+  int i;
+  int j;
+
+  UNIT_TEST_BEGIN();
+
+  for(d = 0; d < NUM_DRIVERS; d++) {
+    drivers[d].driver->set_key(fips_key);
+    memcpy(block, fips_plaintext, AES_128_BLOCK_SIZE);
+    drivers[d].driver->encrypt(block);
+    UNIT_TEST_ASSERT(!memcmp(block, fips_ciphertext, AES_128_BLOCK_SIZE));
+  }
+
+  for(i = 0; i < 100; i++) {
+    fill_random(key, sizeof(key));
+    fill_random(expected, sizeof(expected));
+    memcpy(blocks, expected, sizeof(blocks));
+    aes_128_driver.set_key(key);
+    for(j = 0; j < 8; j++) {
+      aes_128_driver.encrypt(expected + j * AES_128_BLOCK_SIZE);
+    }
+
+    for(d = 1; d < NUM_DRIVERS; d++) {
+      memcpy(block, blocks, AES_128_BLOCK_SIZE);
+      drivers[d].driver->set_key(key);
+      drivers[d].driver->encrypt(block);
+      UNIT_TEST_ASSERT(!memcmp(block, expected, AES_128_BLOCK_SIZE));
+    }
+    /* Every batch size, through the configured driver */
+    AES_128.set_key(key);
+    for(j = 1; j <= 8; j++) {
+      memcpy(batch, blocks, sizeof(batch));
+      aes_128_encrypt_blocks(batch, j);
+      UNIT_TEST_ASSERT(!memcmp(batch, expected, j * AES_128_BLOCK_SIZE));
+      UNIT_TEST_ASSERT(!memcmp(batch + j * AES_128_BLOCK_SIZE,
+                               blocks + j * AES_128_BLOCK_SIZE,
+                               (8 - j) * AES_128_BLOCK_SIZE));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(frame_latency, "CCM* frame latency");
+UNIT_TEST(frame_latency)
+{
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+  uint8_t hdr[HDR_LEN];
+  uint8_t payload[PAYLOAD_LEN];
+  uint8_t plaintext[PAYLOAD_LEN];
+  uint8_t mic[MIC_LEN];
+  uint8_t check[MIC_LEN];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  unsigned long i;
+  unsigned long elapsed;
+  clock_time_t start;
+  unsigned d;
+  int failures = 0;
+
+  UNIT_TEST_BEGIN();
+
+  fill_random(key, sizeof(key));
+  fill_random(nonce, sizeof(nonce));
+  fill_random(hdr, sizeof(hdr));
+  fill_random(plaintext, sizeof(plaintext));
+
+  for(d = 0; d < NUM_DRIVERS; d++) {
+    drivers[d].driver->set_key(key);
+    memset(block, 0, sizeof(block));
+    start = clock_time();
+    for(i = 0; i < NUM_BLOCKS; i++) {
+      drivers[d].driver->encrypt(block);
+    }
+    elapsed = clock_time() - start;
+    sink = block[0];
+    printf("TEST: %-8s %6lu ns per block\n", drivers[d].name,
+           elapsed * 1000000 / NUM_BLOCKS);
+  }
+
+  CCM_STAR.set_key(key);
+
+  start = clock_time();
+  for(i = 0; i < NUM_FRAMES; i++) {
+    memcpy(payload, plaintext, PAYLOAD_LEN);
+    nonce[0] = i;
+    CCM_STAR.aead(nonce, payload, PAYLOAD_LEN, hdr, HDR_LEN, mic, MIC_LEN, 1);
+    CCM_STAR.aead(nonce, payload, PAYLOAD_LEN, hdr, HDR_LEN, check, MIC_LEN, 0);
+    if(memcmp(mic, check, MIC_LEN) || memcmp(payload, plaintext, PAYLOAD_LEN)) {
+      failures++;
+    }
+  }
+  elapsed = clock_time() - start;
+
+  UNIT_TEST_ASSERT(failures == 0);
+  printf("TEST: CCM* on the configured driver, %u + %u byte frame: "
+         "%lu ns per encrypt + decrypt\n", HDR_LEN, PAYLOAD_LEN,
+         elapsed * 1000000 / NUM_FRAMES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(drivers_agree);
+  UNIT_TEST_RUN(frame_latency);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
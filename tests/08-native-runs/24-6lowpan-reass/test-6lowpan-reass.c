@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/sicslowpan.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define PAYLOAD_LEN  1000
+#define MAX_FRAMES   16
+#define FRAME_LEN    127
+/* Room left by the 802.15.4 header */
+#define MAC_PAYLOAD  (FRAME_LEN - 25)
+#define NUM_SENDERS  16
+#define NUM_PACKETS  20000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The fragments of one packet, as sent by 6LoWPAN */
+static struct {
+  uint8_t data[FRAME_LEN];
+  uint8_t len;
+} frames[MAX_FRAMES];
+static int num_frames;
+
+static uint8_t payload[PAYLOAD_LEN];
+static unsigned long delivered;
+static unsigned long corrupted;
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(mac_callback_t sent, void *ptr)
+{
+  if(num_frames < MAX_FRAMES) {
+    memcpy(frames[num_frames].data, packetbuf_dataptr(), packetbuf_datalen());
+    frames[num_frames].len = packetbuf_datalen();
+    num_frames++;
+  }
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+packet_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+max_payload(void)
+{
+  return MAC_PAYLOAD;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver capture_mac_driver = {
+  "capture",
+  init,
+  send_packet,
+  packet_input,
+  on,
+  off,
+  max_payload,
+};
+/*---------------------------------------------------------------------------*/
+/* Check and drop the reassembled packets */
+static enum netstack_ip_action
+ip_input(void)
+{
+  if(uip_len == UIP_IPUDPH_LEN + PAYLOAD_LEN &&
+     !memcmp(uip_buf + UIP_IPUDPH_LEN, payload, PAYLOAD_LEN)) {
+    delivered++;
+  } else {
+    corrupted++;
+  }
+  return NETSTACK_IP_DROP;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor packet_processor = {
+  .process_input = ip_input
+};
+/*---------------------------------------------------------------------------*/
+/* Fragment a UDP packet with PAYLOAD_LEN bytes of payload into frames[] */
+static void
+fragment_packet(void)
+{
+  linkaddr_t dest = { { 2, 2, 2, 2, 2, 2, 2, 2 } };
+  int i;
+
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = i * 7;
+  }
+
+  memset(uip_buf, 0, UIP_IPUDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_create_linklocal_prefix(&UIP_IP_BUF->srcipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, (uip_lladdr_t *)&linkaddr_node_addr);
+  uip_create_linklocal_prefix(&UIP_IP_BUF->destipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->destipaddr, (uip_lladdr_t *)&dest);
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->srcport = UIP_HTONS(5683);
+  UIP_UDP_BUF->destport = UIP_HTONS(5683);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  memcpy(uip_buf + UIP_IPUDPH_LEN, payload, PAYLOAD_LEN);
+  uip_len = UIP_IPUDPH_LEN + PAYLOAD_LEN;
+  UIP_UDP_BUF->udpchksum = 0;
+  UIP_UDP_BUF->udpchksum = ~(uip_udpchksum());
+
+  num_frames = 0;
+  NETSTACK_NETWORK.output(&dest);
+}
+/*---------------------------------------------------------------------------*/
+/* Receive fragment f of the packet from the node with the given id */
+static void
+receive_frame(int f, uint8_t sender_id)
+{
+  linkaddr_t sender = { { 1, 1, 1, 1, 1, 1, 1, sender_id } };
+
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), frames[f].data, frames[f].len);
+  packetbuf_set_datalen(frames[f].len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(in_order, "In-order reassembly");
+UNIT_TEST(in_order)
+{
+  struct sicslowpan_reass_stats stats;
+  struct sicslowpan_reass_stats after;
+  int f;
+
+  UNIT_TEST_BEGIN();
+
+  fragment_packet();
+  UNIT_TEST_ASSERT(num_frames > 2 && num_frames < MAX_FRAMES);
+
+  delivered = 0;
+  for(f = 0; f < num_frames; f++) {
+    receive_frame(f, 1);
+  }
+  UNIT_TEST_ASSERT(delivered == 1);
+
+  /* Retransmitted fragments are ignored */
+  receive_frame(0, 1);
+  for(f = 1; f < num_frames - 1; f++) {
+    receive_frame(f, 1);
+    receive_frame(f, 1);
+  }
+  UNIT_TEST_ASSERT(delivered == 1);
+  receive_frame(num_frames - 1, 1);
+  UNIT_TEST_ASSERT(delivered == 2);
+
+  sicslowpan_get_reass_stats(&stats);
+  UNIT_TEST_ASSERT(stats.reassembled == 2);
+  UNIT_TEST_ASSERT(stats.duplicates == num_frames - 2);
+  UNIT_TEST_ASSERT(corrupted == 0);
+
+  /* A fragment starting past the end of the datagram is rejected, not
+     taken for a duplicate, and drops the reassembly it claims to be
+     part of */
+  receive_frame(0, 1);
+  frames[MAX_FRAMES - 1] = frames[1];
+  frames[MAX_FRAMES - 1].data[SICSLOWPAN_FRAGN_HDR_LEN - 1] = 0xf0;
+  receive_frame(MAX_FRAMES - 1, 1);
+  sicslowpan_get_reass_stats(&after);
+  UNIT_TEST_ASSERT(after.invalid == stats.invalid + 1);
+  UNIT_TEST_ASSERT(after.duplicates == stats.duplicates);
+  receive_frame(1, 1);
+  sicslowpan_get_reass_stats(&after);
+  UNIT_TEST_ASSERT(after.no_session == stats.no_session + 1);
+  UNIT_TEST_ASSERT(delivered == 2);
+
+  /* Extraneous bytes at the end of the last fragment are ignored */
+  UNIT_TEST_ASSERT(frames[num_frames - 1].len + 8 <= FRAME_LEN);
+  frames[MAX_FRAMES - 1] = frames[num_frames - 1];
+  memset(frames[MAX_FRAMES - 1].data + frames[MAX_FRAMES - 1].len, 0xaa, 8);
+  frames[MAX_FRAMES - 1].len += 8;
+  for(f = 0; f < num_frames - 1; f++) {
+    receive_frame(f, 1);
+  }
+  receive_frame(MAX_FRAMES - 1, 1);
+  UNIT_TEST_ASSERT(delivered == 3);
+  UNIT_TEST_ASSERT(corrupted == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(interleaved, "Interleaved reassemblies");
+UNIT_TEST(interleaved)
+{
+  int f;
+  int s;
+
+  UNIT_TEST_BEGIN();
+
+  /* All senders start, then their fragments arrive in reverse order */
+  delivered = 0;
+  for(s = 0; s < NUM_SENDERS; s++) {
+    receive_frame(0, s + 1);
+  }
+  for(f = num_frames - 1; f > 0; f--) {
+    for(s = 0; s < NUM_SENDERS; s++) {
+      receive_frame(f, s + 1);
+    }
+  }
+  printf("TEST: %u reassembly contexts, %u interleaved senders: "
+         "%lu packets delivered\n", SICSLOWPAN_CONF_REASS_CONTEXTS,
+         NUM_SENDERS, delivered);
+#if SICSLOWPAN_CONF_REASS_CONTEXTS >= NUM_SENDERS
+  UNIT_TEST_ASSERT(delivered == NUM_SENDERS);
+#endif /* SICSLOWPAN_CONF_REASS_CONTEXTS >= NUM_SENDERS */
+  UNIT_TEST_ASSERT(corrupted == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(no_context, "Reassembly contexts exhausted");
+UNIT_TEST(no_context)
+{
+  struct sicslowpan_reass_stats before;
+  struct sicslowpan_reass_stats after;
+  int s;
+
+  UNIT_TEST_BEGIN();
+
+  sicslowpan_get_reass_stats(&before);
+  /* Leave every context waiting for its second fragment */
+  for(s = 0; s <= SICSLOWPAN_CONF_REASS_CONTEXTS; s++) {
+    receive_frame(0, s + 1);
+  }
+  receive_frame(1, SICSLOWPAN_CONF_REASS_CONTEXTS + 1);
+  sicslowpan_get_reass_stats(&after);
+  UNIT_TEST_ASSERT(after.no_context == before.no_context + 1);
+  UNIT_TEST_ASSERT(after.no_session == before.no_session + 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(timeout, "Reassembly timeout");
+UNIT_TEST(timeout)
+{
+  struct sicslowpan_reass_stats before;
+  struct sicslowpan_reass_stats after;
+  int f;
+
+  UNIT_TEST_BEGIN();
+
+  /* The contexts left by no_context have expired */
+  sicslowpan_get_reass_stats(&before);
+  delivered = 0;
+  for(f = 0; f < num_frames; f++) {
+    receive_frame(f, 1);
+  }
+  sicslowpan_get_reass_stats(&after);
+  UNIT_TEST_ASSERT(delivered == 1);
+  UNIT_TEST_ASSERT(after.timed_out ==
+                   before.timed_out + SICSLOWPAN_CONF_REASS_CONTEXTS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Reassembly cost");
+UNIT_TEST(benchmark)
+{
+  unsigned long n;
+  unsigned long elapsed;
+  clock_time_t start;
+  int f;
+
+  UNIT_TEST_BEGIN();
+
+  delivered = 0;
+  start = clock_time();
+  for(n = 0; n < NUM_PACKETS; n++) {
+    for(f = 0; f < num_frames; f++) {
+      receive_frame(f, 1 + n % NUM_SENDERS);
+    }
+  }
+  elapsed = clock_time() - start;
+
+  UNIT_TEST_ASSERT(delivered == NUM_PACKETS);
+  printf("TEST: %lu ns per %u-fragment packet\n",
+         elapsed * 1000000 / NUM_PACKETS, num_frames);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+
+  PROCESS_BEGIN();
+
+  netstack_ip_packet_processor_add(&packet_processor);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(in_order);
+  UNIT_TEST_RUN(interleaved);
+  UNIT_TEST_RUN(no_context);
+
+  /* Let the reassemblies started by no_context expire */
+  etimer_set(&et, (SICSLOWPAN_REASS_MAXAGE + 1) * CLOCK_SECOND / 16);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(timeout);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
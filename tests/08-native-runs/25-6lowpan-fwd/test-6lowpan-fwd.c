@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/ipv6/sicslowpan.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* A 1 KB IPv6 packet */
+#define PACKET_LEN   1024
+#define PAYLOAD_LEN  (PACKET_LEN - UIP_IPUDPH_LEN)
+#define MAX_FRAMES   16
+#define FRAME_LEN    127
+/* Room left by the 802.15.4 header */
+#define MAC_HDR_LEN  25
+#define MAC_PAYLOAD  (FRAME_LEN - MAC_HDR_LEN)
+/* Airtime of a byte at 250 kbit/s, and PHY header length */
+#define BYTE_US      32
+#define PHY_HDR_LEN  6
+#define HOPS         6
+#define NUM_PACKETS  20000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The frames sent by 6LoWPAN */
+static struct {
+  uint8_t data[FRAME_LEN];
+  uint8_t len;
+  uint8_t network_id;
+} frames[MAX_FRAMES], received[MAX_FRAMES];
+static int num_frames;
+static int num_received;
+
+static const linkaddr_t prev_hop = { { 1, 1, 1, 1, 1, 1, 1, 1 } };
+static const linkaddr_t next_hop = { { 2, 2, 2, 2, 2, 2, 2, 2 } };
+static uip_ipaddr_t src_addr;
+static uip_ipaddr_t dest_addr;
+
+static uint8_t payload[PAYLOAD_LEN];
+static unsigned long delivered;
+static unsigned long corrupted;
+static int mac_payload = MAC_PAYLOAD;
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(mac_callback_t sent, void *ptr)
+{
+  if(num_frames < MAX_FRAMES) {
+    memcpy(frames[num_frames].data, packetbuf_dataptr(), packetbuf_datalen());
+    frames[num_frames].len = packetbuf_datalen();
+    frames[num_frames].network_id = packetbuf_attr(PACKETBUF_ATTR_NETWORK_ID);
+  }
+  num_frames++;
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+packet_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+max_payload(void)
+{
+  return mac_payload;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver capture_mac_driver = {
+  "capture",
+  init,
+  send_packet,
+  packet_input,
+  on,
+  off,
+  max_payload,
+};
+/*---------------------------------------------------------------------------*/
+/* Check and drop the packets delivered to this node; let the IP layer
+   forward the others */
+static enum netstack_ip_action
+ip_input(void)
+{
+  if(!uip_ds6_is_my_addr(&UIP_IP_BUF->destipaddr)) {
+    return NETSTACK_IP_PROCESS;
+  }
+  if(uip_len == PACKET_LEN &&
+     !memcmp(uip_buf + UIP_IPUDPH_LEN, payload, PAYLOAD_LEN)) {
+    delivered++;
+  } else {
+    corrupted++;
+  }
+  return NETSTACK_IP_DROP;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor packet_processor = {
+  .process_input = ip_input
+};
+/*---------------------------------------------------------------------------*/
+/* Fragment a 1 KB UDP packet from src_addr to dest_addr, as sent by the
+   previous hop, into received[] */
+static void
+fragment_packet(void)
+{
+  linkaddr_t dest;
+  int i;
+
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    payload[i] = i * 7;
+  }
+
+  memset(uip_buf, 0, UIP_IPUDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &src_addr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &dest_addr);
+  uipbuf_set_len_field(UIP_IP_BUF, PACKET_LEN - UIP_IPH_LEN);
+  UIP_UDP_BUF->srcport = UIP_HTONS(5683);
+  UIP_UDP_BUF->destport = UIP_HTONS(5683);
+  UIP_UDP_BUF->udplen = UIP_HTONS(PACKET_LEN - UIP_IPH_LEN);
+  memcpy(uip_buf + UIP_IPUDPH_LEN, payload, PAYLOAD_LEN);
+  uip_len = PACKET_LEN;
+  UIP_UDP_BUF->udpchksum = 0;
+  UIP_UDP_BUF->udpchksum = ~(uip_udpchksum());
+
+  num_frames = 0;
+  linkaddr_copy(&dest, &linkaddr_node_addr);
+  NETSTACK_NETWORK.output(&dest);
+  memcpy(received, frames, sizeof(frames));
+  num_received = num_frames;
+}
+/*---------------------------------------------------------------------------*/
+/* Receive a frame from the given neighbor */
+static void
+receive_frame(const uint8_t *data, uint8_t len, const linkaddr_t *sender)
+{
+  packetbuf_clear();
+  memcpy(packetbuf_dataptr(), data, len);
+  packetbuf_set_datalen(len);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, sender);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+  NETSTACK_NETWORK.input();
+}
+/*---------------------------------------------------------------------------*/
+/* Relay the packet, and return after how many received fragments the
+   relay started to send */
+static int
+relay_packet(void)
+{
+  int lag;
+  int f;
+
+  num_frames = 0;
+  lag = 0;
+  for(f = 0; f < num_received; f++) {
+    receive_frame(received[f].data, received[f].len, &prev_hop);
+    if(lag == 0 && num_frames > 0) {
+      lag = f + 1;
+    }
+  }
+  return lag;
+}
+/*---------------------------------------------------------------------------*/
+static int lag;
+static unsigned long frame_us;
+
+UNIT_TEST_REGISTER(relay, "Relay a fragmented packet");
+UNIT_TEST(relay)
+{
+  uip_ipaddr_t next_hop_addr;
+  int f;
+
+  UNIT_TEST_BEGIN();
+
+  /* This node routes towards next_hop */
+  uip_create_linklocal_prefix(&next_hop_addr);
+  uip_ds6_set_addr_iid(&next_hop_addr, (uip_lladdr_t *)&next_hop);
+  UNIT_TEST_ASSERT(uip_ds6_nbr_add(&next_hop_addr, (uip_lladdr_t *)&next_hop,
+                                   1, NBR_REACHABLE,
+                                   NBR_TABLE_REASON_UNDEFINED, NULL) != NULL);
+  UNIT_TEST_ASSERT(uip_ds6_defrt_add(&next_hop_addr, 0) != NULL);
+
+  uip_ip6addr(&src_addr, 0xfd00, 0, 0, 0, 0x201, 0x101, 0x101, 0x101);
+  uip_ip6addr(&dest_addr, 0xfd00, 0, 0, 0, 0x203, 0x303, 0x303, 0x303);
+  fragment_packet();
+  UNIT_TEST_ASSERT(num_received > 2 && num_received < MAX_FRAMES);
+
+  lag = relay_packet();
+  UNIT_TEST_ASSERT(lag > 0);
+  UNIT_TEST_ASSERT(num_frames >= num_received);
+#if SICSLOWPAN_CONF_FRAG_FORWARDING
+  UNIT_TEST_ASSERT(lag == 1);
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+  /* Every relayed fragment is classed on the upper-layer protocol */
+  for(f = 0; f < num_frames; f++) {
+    UNIT_TEST_ASSERT(frames[f].network_id == UIP_PROTO_UDP);
+  }
+
+  /* The next hop reassembles the relayed fragments */
+  uip_ds6_addr_add(&dest_addr, 0, ADDR_MANUAL);
+  delivered = 0;
+  for(f = 0; f < num_frames; f++) {
+    receive_frame(frames[f].data, frames[f].len, &linkaddr_node_addr);
+  }
+  uip_ds6_addr_rm(uip_ds6_addr_lookup(&dest_addr));
+  UNIT_TEST_ASSERT(delivered == 1);
+  UNIT_TEST_ASSERT(corrupted == 0);
+
+  frame_us = 0;
+  for(f = 0; f < num_frames; f++) {
+    frame_us += (PHY_HDR_LEN + MAC_HDR_LEN + frames[f].len) * BYTE_US;
+  }
+  frame_us /= num_frames;
+
+#if SICSLOWPAN_CONF_FRAG_FORWARDING
+  /* Retransmitted fragments do not retire the relay before the last
+     fragment, and the relay leaves uip_buf free */
+  uip_len = 0;
+  receive_frame(received[0].data, received[0].len, &prev_hop);
+  UNIT_TEST_ASSERT(uip_len == 0);
+  for(f = 1; f < num_received - 1; f++) {
+    receive_frame(received[f].data, received[f].len, &prev_hop);
+    receive_frame(received[f].data, received[f].len, &prev_hop);
+  }
+  num_frames = 0;
+  receive_frame(received[num_received - 1].data,
+                received[num_received - 1].len, &prev_hop);
+  UNIT_TEST_ASSERT(num_frames == 1);
+
+  /* A first fragment whose headers do not fit the next hop is left in
+     packetbuf as received, and the packet is forwarded by the IP layer
+     once reassembled */
+  mac_payload = 8;
+  num_frames = 0;
+  receive_frame(received[0].data, received[0].len, &prev_hop);
+  mac_payload = MAC_PAYLOAD;
+  UNIT_TEST_ASSERT(num_frames == 0);
+  UNIT_TEST_ASSERT(linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_SENDER), &prev_hop));
+  UNIT_TEST_ASSERT(packetbuf_datalen() == received[0].len);
+  UNIT_TEST_ASSERT(!memcmp(packetbuf_dataptr(), received[0].data, received[0].len));
+  for(f = 1; f < num_received; f++) {
+    receive_frame(received[f].data, received[f].len, &prev_hop);
+  }
+  UNIT_TEST_ASSERT(num_frames >= num_received);
+#endif /* SICSLOWPAN_CONF_FRAG_FORWARDING */
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Relay latency");
+UNIT_TEST(benchmark)
+{
+  unsigned long n;
+  unsigned long elapsed;
+  unsigned long cpu_us;
+  clock_time_t start;
+
+  UNIT_TEST_BEGIN();
+
+  start = clock_time();
+  for(n = 0; n < NUM_PACKETS; n++) {
+    relay_packet();
+    UNIT_TEST_ASSERT(num_frames >= num_received);
+  }
+  elapsed = clock_time() - start;
+  cpu_us = elapsed * 1000 / NUM_PACKETS;
+
+  /* Each relay waits for lag fragments before sending; the last one
+     then follows the first through the remaining hops */
+  printf("TEST: %s: a relay starts sending after %d of %d fragments, "
+         "%lu ns of CPU per %u-byte packet\n",
+         SICSLOWPAN_CONF_FRAG_FORWARDING ? "fragment forwarding" : "reassembly",
+         lag, num_received, elapsed * 1000000 / NUM_PACKETS, PACKET_LEN);
+  printf("TEST: %u-hop latency at 250 kbit/s: %lu us\n", HOPS,
+         ((HOPS - 1) * lag + num_received) * frame_us + (HOPS - 1) * cpu_us);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  netstack_ip_packet_processor_add(&packet_processor);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(relay);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* An Orchestra-like schedule with cells negotiated by 6P */
+#define EB_SF_SIZE      397
+#define UNICAST_SF_SIZE 17
+#define COMMON_SF_SIZE  31
+#define SIXP_SF_SIZE    101
+#define SIXP_NEIGHBORS  64
+#define NUM_QUERIES     200000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* What the schedule needs from the rest of TSCH */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+struct tsch_link *current_link;
+static int locked;
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_queue_nbr_packet_count(const struct tsch_neighbor *n)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* The time to the next occurrence of a link, from a walk through all links */
+static uint16_t
+time_to_next_link(struct tsch_asn_t *asn)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+  uint16_t timeslot;
+  uint16_t time;
+  uint16_t best = 0xffff;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    timeslot = TSCH_ASN_MOD(*asn, sf->size);
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      time = l->timeslot > timeslot ? l->timeslot - timeslot
+        : sf->size.val + l->timeslot - timeslot;
+      if(time < best) {
+        best = time;
+      }
+    }
+  }
+  return best;
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_addr(linkaddr_t *addr, int n)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 1;
+  addr->u8[LINKADDR_SIZE - 1] = n + 1;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(selection, "Next active link selection");
+UNIT_TEST(selection)
+{
+  struct tsch_slotframe *sf0;
+  struct tsch_slotframe *sf1;
+  struct tsch_link *rx;
+  struct tsch_link *tx;
+  struct tsch_link *other;
+  struct tsch_link *l;
+  struct tsch_link *backup;
+  struct tsch_asn_t asn;
+  uint16_t offset;
+  linkaddr_t addr;
+
+  UNIT_TEST_BEGIN();
+
+  tsch_schedule_init();
+  sf0 = tsch_schedule_add_slotframe(0, 10);
+  sf1 = tsch_schedule_add_slotframe(1, 7);
+  UNIT_TEST_ASSERT(sf0 != NULL && sf1 != NULL);
+  neighbor_addr(&addr, 0);
+
+  /* Added out of timeslot order */
+  other = tsch_schedule_add_link(sf0, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                                 &addr, 8, 0, 1);
+  rx = tsch_schedule_add_link(sf0, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                              &addr, 3, 0, 1);
+  tx = tsch_schedule_add_link(sf1, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                              &addr, 3, 0, 1);
+
+  /* ASN 0: timeslot 3 of both slotframes. The Tx link wins, the Rx
+     link is the backup */
+  TSCH_ASN_INIT(asn, 0, 0);
+  l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+  UNIT_TEST_ASSERT(l == tx && backup == rx && offset == 3);
+
+  /* ASN 4: timeslot 8 of the first slotframe comes before timeslot 3
+     of the second, in the next slotframe iteration */
+  TSCH_ASN_INIT(asn, 0, 4);
+  l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+  UNIT_TEST_ASSERT(l == other && backup == NULL && offset == 4);
+
+  /* ASN 5: at timeslot 5 of the first slotframe, the next link is at 8 */
+  tsch_schedule_remove_link(sf1, tx);
+  TSCH_ASN_INIT(asn, 0, 5);
+  l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+  UNIT_TEST_ASSERT(l == other && offset == 3);
+
+  /* ASN 9: wraps around to timeslot 3 */
+  TSCH_ASN_INIT(asn, 0, 9);
+  l = tsch_schedule_get_next_active_link(&asn, &offset, &backup);
+  UNIT_TEST_ASSERT(l == rx && offset == 4);
+
+  /* Two Rx links at the same time: the lower slotframe handle wins */
+  l = tsch_schedule_add_link(sf1, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             &addr, 2, 0, 1);
+  TSCH_ASN_INIT(asn, 0, 20);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &offset, &backup) == rx);
+  UNIT_TEST_ASSERT(offset == 3);
+
+  UNIT_TEST_ASSERT(tsch_schedule_remove_all_slotframes());
+  TSCH_ASN_INIT(asn, 0, 0);
+  UNIT_TEST_ASSERT(tsch_schedule_get_next_active_link(&asn, &offset, &backup) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_large_schedule(void)
+{
+  struct tsch_slotframe *sf;
+  linkaddr_t addr;
+  int n;
+
+  tsch_schedule_init();
+
+  /* EB slotframe: one Tx link, one Rx link per neighbor */
+  sf = tsch_schedule_add_slotframe(0, EB_SF_SIZE);
+  if(tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_ADVERTISING_ONLY,
+                            &tsch_broadcast_address, 0, 0, 1) == NULL) {
+    return 0;
+  }
+  for(n = 0; n < SIXP_NEIGHBORS; n++) {
+    neighbor_addr(&addr, n);
+    tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_ADVERTISING_ONLY,
+                           &addr, (n * 37 + 1) % EB_SF_SIZE, 1, 0);
+  }
+
+  /* Common shared slotframe */
+  sf = tsch_schedule_add_slotframe(1, COMMON_SF_SIZE);
+  tsch_schedule_add_link(sf, LINK_OPTION_RX | LINK_OPTION_TX | LINK_OPTION_SHARED,
+                         LINK_TYPE_ADVERTISING, &tsch_broadcast_address, 0, 0, 1);
+
+  /* Receiver-based unicast slotframe */
+  sf = tsch_schedule_add_slotframe(2, UNICAST_SF_SIZE);
+  for(n = 0; n < UNICAST_SF_SIZE; n++) {
+    tsch_schedule_add_link(sf, LINK_OPTION_TX | LINK_OPTION_SHARED,
+                           LINK_TYPE_NORMAL, &tsch_broadcast_address, n, 2, 0);
+  }
+
+  /* 6P: Tx and Rx cells with every neighbor */
+  sf = tsch_schedule_add_slotframe(3, SIXP_SF_SIZE);
+  for(n = 0; n < SIXP_NEIGHBORS; n++) {
+    neighbor_addr(&addr, n);
+    tsch_schedule_add_link(sf, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                           &addr, (n * 13) % SIXP_SF_SIZE, 3 + n % 8, 0);
+    tsch_schedule_add_link(sf, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                           &addr, (n * 13 + 5) % SIXP_SF_SIZE, 3 + n % 8, 0);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int num_links;
+
+UNIT_TEST_REGISTER(large, "Large schedule");
+UNIT_TEST(large)
+{
+  struct tsch_slotframe *sf;
+  struct tsch_link *l;
+  struct tsch_asn_t asn;
+  uint16_t offset;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(create_large_schedule());
+  num_links = 0;
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    num_links += list_length(sf->links_list);
+  }
+
+  /* The selected link is at the earliest time, and is at that time */
+  TSCH_ASN_INIT(asn, 0, 0);
+  for(i = 0; i < 5000; i++) {
+    l = tsch_schedule_get_next_active_link(&asn, &offset, NULL);
+    UNIT_TEST_ASSERT(l != NULL);
+    UNIT_TEST_ASSERT(offset == time_to_next_link(&asn));
+    sf = tsch_schedule_get_slotframe_by_handle(l->slotframe_handle);
+    UNIT_TEST_ASSERT(TSCH_ASN_MOD(asn, sf->size) == (l->timeslot + sf->size.val - offset) % sf->size.val);
+    TSCH_ASN_INC(asn, offset);
+  }
+
+  /* Remove half of the 6P cells and check again */
+  sf = tsch_schedule_get_slotframe_by_handle(3);
+  for(i = 0; i < SIXP_NEIGHBORS; i++) {
+    tsch_schedule_remove_link(sf, list_head(sf->links_list));
+  }
+  for(i = 0; i < 5000; i++) {
+    l = tsch_schedule_get_next_active_link(&asn, &offset, NULL);
+    UNIT_TEST_ASSERT(l != NULL && offset == time_to_next_link(&asn));
+    TSCH_ASN_INC(asn, 1);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Next active link cost");
+UNIT_TEST(benchmark)
+{
+  struct tsch_asn_t asn;
+  struct tsch_link *backup;
+  uint16_t offset;
+  clock_time_t start;
+  unsigned long elapsed;
+  unsigned long found;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(create_large_schedule());
+
+  found = 0;
+  TSCH_ASN_INIT(asn, 0, 0);
+  start = clock_time();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    if(tsch_schedule_get_next_active_link(&asn, &offset, &backup) != NULL) {
+      found++;
+    }
+    TSCH_ASN_INC(asn, 1);
+  }
+  elapsed = clock_time() - start;
+  UNIT_TEST_ASSERT(found == NUM_QUERIES);
+
+  printf("TEST: %s, %d links in 4 slotframes: %lu ns per next active link\n",
+         TSCH_SCHEDULE_WITH_INDEX ? "indexed" : "list walk", num_links,
+         elapsed * 1000000 / NUM_QUERIES);
+
+  start = clock_time();
+  for(i = 0; i < 20; i++) {
+    UNIT_TEST_ASSERT(create_large_schedule());
+  }
+  elapsed = clock_time() - start;
+  printf("TEST: %lu us to build the schedule\n", elapsed * 1000 / 20);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(selection);
+  UNIT_TEST_RUN(large);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
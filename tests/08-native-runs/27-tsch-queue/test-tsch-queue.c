@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "lib/random.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_NEIGHBORS 200
+#define NUM_STEPS     50000
+#define NUM_QUERIES   200000
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* What the queues need from the rest of TSCH */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+struct tsch_asn_t tsch_current_asn;
+int tsch_is_coordinator;
+static int locked;
+/*---------------------------------------------------------------------------*/
+int
+tsch_is_locked(void)
+{
+  return locked;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_get_lock(void)
+{
+  if(locked) {
+    return 0;
+  }
+  locked = 1;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_release_lock(void)
+{
+  locked = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_neighbor *neighbors[NUM_NEIGHBORS];
+static struct tsch_link shared_link;
+static struct tsch_link dedicated_link;
+
+static void
+neighbor_addr(linkaddr_t *addr, int n)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 1;
+  addr->u8[LINKADDR_SIZE - 2] = n >> 8;
+  addr->u8[LINKADDR_SIZE - 1] = n + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* As the schedule does when adding or removing Tx links */
+static void
+set_tx_links_count(struct tsch_neighbor *n, uint8_t count)
+{
+  n->tx_links_count = count;
+#if TSCH_QUEUE_WITH_READY_SET
+  tsch_queue_update_ready_set(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+}
+/*---------------------------------------------------------------------------*/
+static void
+init_queues(void)
+{
+  linkaddr_t addr;
+  int n;
+
+  /* Flush the queues of the previous test */
+  tsch_queue_reset();
+  tsch_queue_init();
+  for(n = 0; n < NUM_NEIGHBORS; n++) {
+    neighbor_addr(&addr, n);
+    neighbors[n] = tsch_queue_add_nbr(&addr);
+    set_tx_links_count(neighbors[n], 0);
+  }
+  linkaddr_copy(&shared_link.addr, &tsch_broadcast_address);
+  shared_link.link_options = LINK_OPTION_TX | LINK_OPTION_SHARED;
+  linkaddr_copy(&dedicated_link.addr, &tsch_broadcast_address);
+  dedicated_link.link_options = LINK_OPTION_TX;
+}
+/*---------------------------------------------------------------------------*/
+static struct tsch_packet *
+add_packet(const struct tsch_neighbor *n, uint8_t proto)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom("payload", 7);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+  packetbuf_set_attr(PACKETBUF_ATTR_NETWORK_ID, proto);
+  return tsch_queue_add_packet(tsch_queue_get_nbr_address(n), 8, NULL, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* The packet picked for a broadcast link, from a walk through all
+   neighbors in table order */
+static struct tsch_packet *
+reference_packet_for_any(struct tsch_neighbor **nbr, struct tsch_link *link)
+{
+  struct tsch_neighbor *best = NULL;
+  struct tsch_packet *p;
+  int n;
+
+  for(n = 0; n < NUM_NEIGHBORS; n++) {
+    if(neighbors[n]->tx_links_count == 0
+       && tsch_queue_get_packet_for_nbr(neighbors[n], link) != NULL
+       && (best == NULL || neighbors[n] < best)) {
+      best = neighbors[n];
+    }
+  }
+  p = tsch_queue_get_packet_for_nbr(best, link);
+  *nbr = best;
+  return p;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(selection, "Packet selection for broadcast links");
+UNIT_TEST(selection)
+{
+  struct tsch_neighbor *n;
+  struct tsch_neighbor *ref_n;
+  struct tsch_packet *p;
+  struct tsch_packet *ref_p;
+  struct tsch_link *link;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  init_queues();
+  random_init(1);
+  for(i = 0; i < NUM_STEPS; i++) {
+    switch(random_rand() % 4) {
+    case 0:
+      /* Queue a packet */
+      n = neighbors[random_rand() % NUM_NEIGHBORS];
+      if(tsch_queue_nbr_packet_count(n) < TSCH_QUEUE_NUM_CONTROL_PER_NEIGHBOR - 1
+         && tsch_queue_global_packet_count() < QUEUEBUF_CONF_NUM - 1) {
+        UNIT_TEST_ASSERT(add_packet(n, random_rand() % 3 ? UIP_PROTO_UDP : UIP_PROTO_ICMP6) != NULL);
+      }
+      break;
+    case 1:
+      /* Add or remove a Tx link to a neighbor */
+      n = neighbors[random_rand() % NUM_NEIGHBORS];
+      set_tx_links_count(n, !n->tx_links_count);
+      break;
+    default:
+      /* A broadcast slot */
+      link = random_rand() % 4 ? &shared_link : &dedicated_link;
+      ref_p = reference_packet_for_any(&ref_n, link);
+      n = NULL;
+      p = tsch_queue_get_unicast_packet_for_any(&n, link);
+      UNIT_TEST_ASSERT(p == ref_p);
+      if(p != NULL) {
+        UNIT_TEST_ASSERT(n == ref_n);
+        p->transmissions++;
+        if(!tsch_queue_packet_sent(n, p, link,
+                                   random_rand() % 2 ? MAC_TX_OK : MAC_TX_NOACK)) {
+          tsch_queue_free_packet(p);
+        }
+      }
+      if(link == &shared_link) {
+        tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+      }
+      break;
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(priority, "Control frames first");
+UNIT_TEST(priority)
+{
+  const struct tsch_queue_class_stats *stats;
+  struct tsch_neighbor *n;
+  struct tsch_packet *data;
+  struct tsch_packet *control;
+  struct tsch_packet *keepalive;
+
+  UNIT_TEST_BEGIN();
+
+  init_queues();
+  tsch_queue_reset_class_stats();
+  n = neighbors[0];
+  set_tx_links_count(n, 1);
+  TSCH_ASN_INIT(tsch_current_asn, 0, 100);
+
+  data = add_packet(n, UIP_PROTO_UDP);
+  UNIT_TEST_ASSERT(tsch_queue_get_packet_for_nbr(n, &dedicated_link) == data);
+
+  /* An RPL message queued while the data packet is being sent */
+  TSCH_ASN_INC(tsch_current_asn, 2);
+  control = add_packet(n, UIP_PROTO_ICMP6);
+  UNIT_TEST_ASSERT(control != NULL && tsch_queue_nbr_packet_count(n) == 2);
+  UNIT_TEST_ASSERT(tsch_queue_get_packet_for_nbr(n, &dedicated_link) == control);
+
+  /* The data packet is the one removed on success */
+  TSCH_ASN_INC(tsch_current_asn, 8);
+  data->transmissions++;
+  UNIT_TEST_ASSERT(!tsch_queue_packet_sent(n, data, &dedicated_link, MAC_TX_OK));
+  tsch_queue_free_packet(data);
+  UNIT_TEST_ASSERT(tsch_queue_get_packet_for_nbr(n, &dedicated_link) == control);
+
+  /* Keepalives (empty frames) are control frames too */
+  data = add_packet(n, UIP_PROTO_UDP);
+  packetbuf_clear();
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+  keepalive = tsch_queue_add_packet(tsch_queue_get_nbr_address(n), 8, NULL, NULL);
+  UNIT_TEST_ASSERT(tsch_queue_remove_packet_from_queue(n) == control);
+  UNIT_TEST_ASSERT(tsch_queue_remove_packet_from_queue(n) == keepalive);
+  UNIT_TEST_ASSERT(tsch_queue_remove_packet_from_queue(n) == data);
+  UNIT_TEST_ASSERT(tsch_queue_is_empty(n));
+  tsch_queue_free_packet(control);
+  tsch_queue_free_packet(keepalive);
+  tsch_queue_free_packet(data);
+
+  stats = tsch_queue_get_class_stats(TSCH_QUEUE_CLASS_DATA);
+  UNIT_TEST_ASSERT(stats->dequeued == 1 && stats->delay_sum == 10 && stats->delay_max == 10);
+  stats = tsch_queue_get_class_stats(TSCH_QUEUE_CLASS_CONTROL);
+  UNIT_TEST_ASSERT(stats->dequeued == 0);
+  UNIT_TEST_ASSERT(tsch_queue_get_class_stats(TSCH_QUEUE_NUM_CLASSES) == NULL);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(benchmark, "Packet selection cost");
+UNIT_TEST(benchmark)
+{
+  struct tsch_neighbor *n;
+  clock_time_t start;
+  unsigned long elapsed;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Packets for every neighbor, all in backoff but the last one */
+  init_queues();
+  for(i = 0; i < NUM_NEIGHBORS; i++) {
+    UNIT_TEST_ASSERT(add_packet(neighbors[i], UIP_PROTO_UDP) != NULL);
+    if(i < NUM_NEIGHBORS - 1) {
+      tsch_queue_backoff_inc(neighbors[i]);
+    }
+  }
+
+  start = clock_time();
+  for(i = 0; i < NUM_QUERIES; i++) {
+    n = NULL;
+    UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) != NULL);
+  }
+  elapsed = clock_time() - start;
+  UNIT_TEST_ASSERT(n == neighbors[NUM_NEIGHBORS - 1]);
+
+  printf("TEST: %s, %d neighbors: %lu ns per packet selection\n",
+         TSCH_QUEUE_WITH_READY_SET ? "ready set" : "table walk", NUM_NEIGHBORS,
+         elapsed * 1000000 / NUM_QUERIES);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(selection);
+  UNIT_TEST_RUN(priority);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/mac/csma/csma.h"
+#include "net/mac/framer/frame802154.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/* A bulk transfer to one neighbor, with up to WINDOW packets queued */
+#define NUM_PACKETS     500
+#define NUM_BROADCASTS  8
+#define WINDOW          16
+#define PAYLOAD_LEN     100
+
+/* IEEE 802.15.4 O-QPSK: 32 us per byte, PHY header, turnaround and ack */
+#define AIRTIME_US(len) (((len) + 6) * 32 + 192 + (11 * 32 + 192))
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* What the radio saw */
+static uint8_t frame[127];
+static unsigned short frame_len;
+static int ack_pending;
+static uint8_t ack_seqno;
+static unsigned long frames;
+static unsigned long pending_frames;
+static unsigned long pending_broadcasts;
+static unsigned pending_run;
+static unsigned max_pending_run;
+static int last_pending;
+static int out_of_order;
+static int last_seqno = -1;
+
+/* What the MAC reported */
+static unsigned long queued;
+static unsigned long sent_ok;
+static unsigned long sent_failed;
+static clock_time_t elapsed;
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  frame_len = MIN(payload_len, sizeof(frame));
+  memcpy(frame, payload, frame_len);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Every unicast frame is acked, after the time it takes on air */
+static int
+transmit(unsigned short transmit_len)
+{
+  int pending = (frame[0] >> 4) & 1;
+  int ack_request = (frame[0] >> 5) & 1;
+
+  usleep(AIRTIME_US(frame_len));
+  frames++;
+  last_pending = pending;
+  if(ack_request) {
+    ack_pending = 1;
+    ack_seqno = frame[2];
+    if(last_seqno != -1 && frame[2] != (uint8_t)(last_seqno + 1)
+       && !(frame[2] == 1 && last_seqno == 0xff)) {
+      out_of_order++;
+    }
+    last_seqno = frame[2];
+    if(pending) {
+      pending_frames++;
+      pending_run++;
+      max_pending_run = MAX(max_pending_run, pending_run);
+    } else {
+      pending_run = 0;
+    }
+  } else if(pending) {
+    pending_broadcasts++;
+  }
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  prepare(payload, payload_len);
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  uint8_t *ack = buf;
+
+  if(!ack_pending || buf_len < CSMA_ACK_LEN) {
+    return 0;
+  }
+  ack_pending = 0;
+  ack[0] = FRAME802154_ACKFRAME;
+  ack[1] = 0;
+  ack[2] = ack_seqno;
+  return CSMA_ACK_LEN;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return ack_pending;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  if(param == RADIO_CONST_MAX_PAYLOAD_LEN) {
+    *value = sizeof(frame);
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver test_radio_driver = {
+  init,
+  prepare,
+  transmit,
+  send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  on,
+  off,
+  get_value,
+  set_value,
+  get_object,
+  set_object
+};
+/*---------------------------------------------------------------------------*/
+static void
+packet_sent(void *ptr, int status, int transmissions)
+{
+  if(status == MAC_TX_OK) {
+    sent_ok++;
+  } else {
+    sent_failed++;
+  }
+  process_poll(&test_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(const linkaddr_t *dest)
+{
+  uint8_t payload[PAYLOAD_LEN];
+
+  memset(payload, queued, sizeof(payload));
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, dest);
+  queued++;
+  NETSTACK_MAC.send(packet_sent, NULL);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bulk, "Bulk transfer");
+UNIT_TEST(bulk)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(sent_ok == NUM_PACKETS + NUM_BROADCASTS && sent_failed == 0);
+  UNIT_TEST_ASSERT(frames == NUM_PACKETS + NUM_BROADCASTS);
+  UNIT_TEST_ASSERT(out_of_order == 0);
+  /* Nothing announced after the last frame, and never on broadcast */
+  UNIT_TEST_ASSERT(!last_pending && pending_broadcasts == 0);
+  if(CSMA_BURST_LIMIT > 1) {
+    UNIT_TEST_ASSERT(pending_frames > 0 && max_pending_run < CSMA_BURST_LIMIT);
+  } else {
+    UNIT_TEST_ASSERT(pending_frames == 0);
+  }
+
+  printf("TEST: burst limit %u, %u packets of %u bytes: %lu kbit/s, "
+         "%lu%% of frames with frame pending\n",
+         CSMA_BURST_LIMIT, NUM_PACKETS, PAYLOAD_LEN,
+         (unsigned long)NUM_PACKETS * PAYLOAD_LEN * 8 * CLOCK_SECOND / 1000 / MAX(elapsed, 1),
+         pending_frames * 100 / NUM_PACKETS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static linkaddr_t dest;
+  static clock_time_t start;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  memset(&dest, 0, sizeof(dest));
+  dest.u8[0] = 2;
+
+  start = clock_time();
+  while(sent_ok + sent_failed < NUM_PACKETS) {
+    while(queued < NUM_PACKETS && queued - sent_ok - sent_failed < WINDOW) {
+      send_packet(&dest);
+    }
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+  elapsed = clock_time() - start;
+
+  /* Broadcasts are never sent in bursts */
+  while(queued < NUM_PACKETS + NUM_BROADCASTS) {
+    send_packet(&linkaddr_null);
+  }
+  while(sent_ok + sent_failed < NUM_PACKETS + NUM_BROADCASTS) {
+    PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  }
+
+  UNIT_TEST_RUN(bulk);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,492 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/nullnet/nullnet.h"
+#include "net/mac/csma/csma.h"
+#include "net/mac/framer/frame802154.h"
+#include "dev/nullradio.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+/* A radio with a small RX FIFO, receiving bursts of frames faster than a
+   driver reading one frame per scheduler round can drain it */
+#define RX_FIFO_FRAMES  4
+#define NUM_BURSTS      200
+#define BURST_LEN       3
+#define PAYLOAD_LEN     40
+
+PROCESS(test_process, "test");
+PROCESS(rx_process, "RX");
+PROCESS(rx_interrupt_process, "RX interrupt");
+AUTOSTART_PROCESSES(&test_process);
+
+static struct {
+  uint8_t data[127];
+  unsigned short len;
+  radio_value_t rssi;
+} fifo[RX_FIFO_FRAMES];
+static unsigned fifo_head;
+static unsigned fifo_count;
+static unsigned long fifo_drops;
+
+/* How the RX process reads the radio */
+static int rx_batched;
+static unsigned long rx_rounds;
+
+/* What nullnet received */
+static unsigned long received;
+static unsigned long received_bad_rssi;
+static uint8_t seqno;
+
+/* Results of both runs */
+static unsigned long single_received;
+static unsigned long single_drops;
+static unsigned long batch_received;
+static unsigned long batch_drops;
+/*---------------------------------------------------------------------------*/
+static int
+fifo_push(const uint8_t *data, unsigned short len, radio_value_t rssi)
+{
+  unsigned slot;
+
+  if(fifo_count == RX_FIFO_FRAMES) {
+    fifo_drops++;
+    return 0;
+  }
+  slot = (fifo_head + fifo_count) % RX_FIFO_FRAMES;
+  memcpy(fifo[slot].data, data, len);
+  fifo[slot].len = len;
+  fifo[slot].rssi = rssi;
+  fifo_count++;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static unsigned
+fifo_pop(void)
+{
+  unsigned slot = fifo_head;
+  fifo_head = (fifo_head + 1) % RX_FIFO_FRAMES;
+  fifo_count--;
+  return slot;
+}
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit(unsigned short transmit_len)
+{
+  return transmit_len > 0 ? RADIO_TX_OK : RADIO_TX_ERR;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  prepare(payload, payload_len);
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  unsigned slot;
+
+  if(fifo_count == 0) {
+    return 0;
+  }
+  slot = fifo_pop();
+  if(fifo[slot].len > buf_len) {
+    return 0;
+  }
+  memcpy(buf, fifo[slot].data, fifo[slot].len);
+  packetbuf_set_attr(PACKETBUF_ATTR_RSSI, fifo[slot].rssi);
+  return fifo[slot].len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  return fifo_count > 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  if(param == RADIO_CONST_MAX_PAYLOAD_LEN) {
+    *value = sizeof(fifo[0].data);
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+/* Frames are handed over in place; their slots are only reused by the RX
+   interrupt process, i.e. after the reader yields */
+static int
+read_batch(struct radio_rx_frame *frames, int count)
+{
+  unsigned slot;
+  int i;
+
+  for(i = 0; i < count && fifo_count > 0; i++) {
+    slot = fifo_pop();
+    frames[i].data = fifo[slot].data;
+    frames[i].len = fifo[slot].len;
+    frames[i].rssi = fifo[slot].rssi;
+    frames[i].link_quality = 0;
+  }
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_batch(struct radio_tx_frame *frames, int count)
+{
+  int i;
+
+  for(i = 0; i < count; i++) {
+    frames[i].result = send(frames[i].payload, frames[i].payload_len);
+    if(frames[i].result != RADIO_TX_OK) {
+      return i + 1;
+    }
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver test_radio_driver = {
+  init,
+  prepare,
+  transmit,
+  send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  on,
+  off,
+  get_value,
+  set_value,
+  get_object,
+  set_object,
+  read_batch,
+  send_batch
+};
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(const void *data, uint16_t len,
+               const linkaddr_t *src, const linkaddr_t *dest)
+{
+  received++;
+  if(packetbuf_attr(PACKETBUF_ATTR_RSSI) != (uint16_t)(-40 - len)) {
+    received_bad_rssi++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Push a data frame from a neighbor into the RX FIFO, its RSSI derived
+   from its payload length */
+static int
+push_frame(const linkaddr_t *dest, unsigned short payload_len)
+{
+  frame802154_t params;
+  uint8_t buf[127];
+  int hdr_len;
+
+  memset(&params, 0, sizeof(params));
+  params.fcf.frame_type = FRAME802154_DATAFRAME;
+  params.fcf.frame_version = FRAME802154_IEEE802154_2006;
+  params.fcf.src_addr_mode = FRAME802154_LONGADDRMODE;
+  params.seq = seqno++;
+  params.dest_pid = frame802154_get_pan_id();
+  params.src_pid = frame802154_get_pan_id();
+  if(linkaddr_cmp(dest, &linkaddr_null)) {
+    params.fcf.dest_addr_mode = FRAME802154_SHORTADDRMODE;
+    params.dest_addr[0] = 0xff;
+    params.dest_addr[1] = 0xff;
+  } else {
+    params.fcf.dest_addr_mode = FRAME802154_LONGADDRMODE;
+    memcpy(params.dest_addr, dest, LINKADDR_SIZE);
+  }
+  params.src_addr[0] = 0x42;
+  params.src_addr[7] = 0x01;
+
+  hdr_len = frame802154_create(&params, buf);
+  memset(buf + hdr_len, 0xaa, payload_len);
+  return fifo_push(buf, hdr_len + payload_len, -40 - payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+push_ack(void)
+{
+  uint8_t ack[CSMA_ACK_LEN] = { FRAME802154_ACKFRAME, 0, 0 };
+
+  fifo_push(ack, sizeof(ack), 0);
+}
+/*---------------------------------------------------------------------------*/
+/* Reads the radio once per poll, as radio drivers do */
+PROCESS_THREAD(rx_process, ev, data)
+{
+  int len;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    rx_rounds++;
+    if(rx_batched) {
+      netstack_radio_input();
+    } else {
+      packetbuf_clear();
+      len = NETSTACK_RADIO.read(packetbuf_dataptr(), PACKETBUF_SIZE);
+      if(len > 0) {
+        packetbuf_set_datalen(len);
+        NETSTACK_MAC.input();
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/* Receives a burst of frames every scheduler round, and polls the RX process */
+PROCESS_THREAD(rx_interrupt_process, ev, data)
+{
+  static int burst;
+  static linkaddr_t other;
+  int i;
+
+  PROCESS_BEGIN();
+
+  linkaddr_copy(&other, &linkaddr_node_addr);
+  other.u8[0] ^= 0x80;
+
+  process_poll(PROCESS_CURRENT());
+  for(burst = 0; burst < NUM_BURSTS; burst++) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    for(i = 0; i < BURST_LEN; i++) {
+      switch(i % 3) {
+      case 0:
+        push_frame(&linkaddr_node_addr, PAYLOAD_LEN);
+        break;
+      case 1:
+        push_frame(&linkaddr_null, PAYLOAD_LEN + 1);
+        break;
+      default:
+        /* Overheard unicast to another node */
+        push_frame(&other, PAYLOAD_LEN + 2);
+        break;
+      }
+    }
+    process_poll(&rx_process);
+    process_poll(PROCESS_CURRENT());
+  }
+  /* Let the RX process drain the FIFO */
+  while(fifo_count > 0) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    process_poll(&rx_process);
+    process_poll(PROCESS_CURRENT());
+  }
+  process_poll(&test_process);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(batch_filter, "Batched input and early filtering");
+UNIT_TEST(batch_filter)
+{
+  linkaddr_t other;
+  int count;
+
+  UNIT_TEST_BEGIN();
+
+  linkaddr_copy(&other, &linkaddr_node_addr);
+  other.u8[0] ^= 0x80;
+
+  received = 0;
+  received_bad_rssi = 0;
+  fifo_drops = 0;
+  UNIT_TEST_ASSERT(push_frame(&linkaddr_node_addr, 10));
+  push_ack();
+  UNIT_TEST_ASSERT(push_frame(&other, 11));
+  UNIT_TEST_ASSERT(push_frame(&linkaddr_null, 12));
+  UNIT_TEST_ASSERT(!push_frame(&linkaddr_node_addr, 13) && fifo_drops == 1);
+
+  /* One batch of the whole FIFO, only the frames for us reach nullnet */
+  count = netstack_radio_input();
+  UNIT_TEST_ASSERT(count == RX_FIFO_FRAMES);
+  UNIT_TEST_ASSERT(fifo_count == 0);
+  UNIT_TEST_ASSERT(received == 2 && received_bad_rssi == 0);
+
+  UNIT_TEST_ASSERT(netstack_radio_input() == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(send_batch, "Batched transmit");
+UNIT_TEST(send_batch)
+{
+  static const uint8_t payload[10];
+  struct radio_tx_frame frames[3];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < 3; i++) {
+    frames[i].payload = payload;
+    frames[i].payload_len = sizeof(payload);
+    frames[i].result = -1;
+  }
+  UNIT_TEST_ASSERT(NETSTACK_RADIO.send_batch(frames, 3) == 3);
+  UNIT_TEST_ASSERT(frames[2].result == RADIO_TX_OK);
+
+  /* Stops at the first failure */
+  frames[1].payload_len = 0;
+  frames[2].result = -1;
+  UNIT_TEST_ASSERT(NETSTACK_RADIO.send_batch(frames, 3) == 2);
+  UNIT_TEST_ASSERT(frames[0].result == RADIO_TX_OK);
+  UNIT_TEST_ASSERT(frames[1].result == RADIO_TX_ERR);
+  UNIT_TEST_ASSERT(frames[2].result == -1);
+
+  /* The null radio transmits everything */
+  frames[1].payload_len = sizeof(payload);
+  UNIT_TEST_ASSERT(nullradio_driver.send_batch(frames, 3) == 3);
+  UNIT_TEST_ASSERT(nullradio_driver.read_batch(NULL, 0) == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(bursts, "Bursty reception");
+UNIT_TEST(bursts)
+{
+  UNIT_TEST_BEGIN();
+
+  /* Two thirds of the frames are for us */
+  UNIT_TEST_ASSERT(single_drops > 0 && single_received < NUM_BURSTS * 2);
+  UNIT_TEST_ASSERT(batch_drops == 0);
+  UNIT_TEST_ASSERT(batch_received == NUM_BURSTS * 2);
+  UNIT_TEST_ASSERT(received_bad_rssi == 0);
+
+  printf("TEST: %u bursts of %u frames, %u-frame RX FIFO: "
+         "one frame per round %lu dropped, batched %lu dropped\n",
+         NUM_BURSTS, BURST_LEN, RX_FIFO_FRAMES, single_drops, batch_drops);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  nullnet_set_input_callback(input_callback);
+
+  UNIT_TEST_RUN(batch_filter);
+  UNIT_TEST_RUN(send_batch);
+
+  process_start(&rx_process, NULL);
+
+  rx_batched = 0;
+  received = 0;
+  fifo_drops = 0;
+  process_start(&rx_interrupt_process, NULL);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  single_received = received;
+  single_drops = fifo_drops;
+
+  rx_batched = 1;
+  received = 0;
+  fifo_drops = 0;
+  process_start(&rx_interrupt_process, NULL);
+  PROCESS_WAIT_EVENT_UNTIL(ev == PROCESS_EVENT_POLL);
+  batch_received = received;
+  batch_drops = fifo_drops;
+
+  UNIT_TEST_RUN(bursts);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,68 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+IPADDR=fd00::302:304:506:708
+PORT=4000
+TOTAL=65536
+
+rm -f $BASENAME.log
+STATUS=0
+declare -A TIME
+
+# Measure bulk TCP throughput with one segment in flight (the classic
+# uIP behavior) and with a four-segment send window
+for WINDOW in 1 4; do
+  echo "Starting native node, send window $WINDOW"
+  make -C $BASENAME clean > /dev/null
+  make -C $BASENAME DEFINES=UIP_CONF_TCP_SEND_WINDOW=$WINDOW > make.log 2> make.err
+  sudo $BASENAME/tcp-window.native > node.log 2> node.err &
+  CPID=$!
+  sleep 2
+  # Make sure the node is reached over the tun interface
+  sudo ip -6 route replace $IPADDR/128 dev tun0
+
+  echo "Receiving $TOTAL bytes"
+  $BASENAME/tcp-window-client.py $IPADDR $PORT $TOTAL | tee -a $BASENAME.log
+  if [ ${PIPESTATUS[0]} -ne 0 ] ; then
+    STATUS=1
+  fi
+
+  echo "Closing native node"
+  # SIGTERM lets the node flush its output before exiting
+  kill_bg $CPID 15
+  sleep 1
+  TIME[$WINDOW]=$(grep -a "TEST:" node.log | sed 's/.* in \([0-9]*\) ms/\1/')
+  cat node.log >> $BASENAME.log
+done
+
+echo "Send window 1: ${TIME[1]} ms, send window 4: ${TIME[4]} ms"
+if [ -z "${TIME[1]}" ] || [ -z "${TIME[4]}" ] || [ ${TIME[4]} -ge ${TIME[1]} ] ; then
+  STATUS=1
+fi
+
+if [ $STATUS -eq 0 ] ; then
+  printf "%-32s TEST OK\n" "$BASENAME" | tee $BASENAME.testlog;
+else
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== node.log ====" ; cat node.log;
+  echo "==== node.err ====" ; cat node.err;
+  echo "==== $BASENAME.log ====" ; cat $BASENAME.log;
+
+  printf "%-32s TEST FAIL\n" "$BASENAME" | tee $BASENAME.testlog;
+fi
+
+make -C $BASENAME clean > /dev/null
+rm make.log
+rm make.err
+rm node.log
+rm node.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,26 @@
+#!/usr/bin/env python3
+# Connects to the tcp-window node, receives the test pattern until the
+# node closes the connection and prints the throughput.
+import socket
+import sys
+import time
+
+addr, port, total = sys.argv[1], int(sys.argv[2]), int(sys.argv[3])
+
+s = socket.create_connection((addr, port), timeout=60)
+start = time.time()
+received = 0
+ok = True
+while True:
+    data = s.recv(65536)
+    if not data:
+        break
+    if data != bytes((received + i) & 0xff for i in range(len(data))):
+        ok = False
+    received += len(data)
+elapsed = time.time() - start
+
+print("Received %d bytes in %.2f s (%.1f kB/s)%s" %
+      (received, elapsed, received / elapsed / 1000,
+       "" if ok else ", wrong data"))
+sys.exit(0 if ok and received == total else 1)
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Bulk TCP sender for measuring uIP throughput over the native tun
+ * interface. The node listens on TCP_WINDOW_PORT and sends
+ * TCP_WINDOW_TOTAL bytes of a known pattern to every client that
+ * connects, and then closes the connection.
+ *
+ * To get the round-trip times of a multi-hop 6LoWPAN network, the
+ * node uses delay_net_driver, which holds every outgoing packet for
+ * TCP_WINDOW_DELAY before passing it on to the tun interface.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/ipv6/tcp-socket.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TCP_WINDOW_PORT  4000
+#define TCP_WINDOW_TOTAL (64 * 1024UL)
+
+#ifdef TCP_WINDOW_CONF_DELAY
+#define TCP_WINDOW_DELAY TCP_WINDOW_CONF_DELAY
+#else
+#define TCP_WINDOW_DELAY (CLOCK_SECOND / 5)
+#endif
+
+#define DELAY_SLOTS 16
+
+extern const struct network_driver tun6_net_driver;
+
+static struct {
+  struct timer due;
+  uint16_t len;
+  uint8_t data[UIP_BUFSIZE];
+} delay_line[DELAY_SLOTS];
+static uint8_t delay_head, delay_count;
+static struct ctimer delay_timer;
+
+static struct tcp_socket sock;
+static uint8_t inputbuf[64];
+static uint8_t outputbuf[8 * 1024];
+static unsigned long queued;
+static clock_time_t start;
+
+PROCESS(tcp_window_process, "TCP window");
+AUTOSTART_PROCESSES(&tcp_window_process);
+/*---------------------------------------------------------------------------*/
+static void
+delay_release(void *ptr)
+{
+  uint16_t len;
+
+  /* Nothing else uses uip_buf between events, so it can be borrowed
+     to hand the packet to the tun driver. */
+  len = uip_len;
+  while(delay_count > 0 && timer_expired(&delay_line[delay_head].due)) {
+    memcpy(uip_buf, delay_line[delay_head].data, delay_line[delay_head].len);
+    uip_len = delay_line[delay_head].len;
+    tun6_net_driver.output(NULL);
+    delay_head = (delay_head + 1) % DELAY_SLOTS;
+    delay_count--;
+  }
+  uip_len = len;
+  if(delay_count > 0) {
+    ctimer_set(&delay_timer, timer_remaining(&delay_line[delay_head].due),
+               delay_release, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+delay_init(void)
+{
+  tun6_net_driver.init();
+}
+/*---------------------------------------------------------------------------*/
+static void
+delay_input(void)
+{
+  tun6_net_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+delay_output(const linkaddr_t *localdest)
+{
+  uint8_t slot;
+
+  if(delay_count == DELAY_SLOTS) {
+    /* The link is congested; drop the packet. */
+    return 0;
+  }
+  slot = (delay_head + delay_count) % DELAY_SLOTS;
+  timer_set(&delay_line[slot].due, TCP_WINDOW_DELAY);
+  delay_line[slot].len = uip_len;
+  memcpy(delay_line[slot].data, uip_buf, uip_len);
+  if(delay_count++ == 0) {
+    ctimer_set(&delay_timer, TCP_WINDOW_DELAY, delay_release, NULL);
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+const struct network_driver delay_net_driver = {
+  "delay",
+  delay_init,
+  delay_input,
+  delay_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+fill(struct tcp_socket *s)
+{
+  uint8_t chunk[128];
+  int i, len;
+
+  while(queued < TCP_WINDOW_TOTAL && tcp_socket_max_sendlen(s) > 0) {
+    len = MIN(sizeof(chunk), TCP_WINDOW_TOTAL - queued);
+    len = MIN(len, tcp_socket_max_sendlen(s));
+    for(i = 0; i < len; i++) {
+      chunk[i] = (uint8_t)(queued + i);
+    }
+    queued += tcp_socket_send(s, chunk, len);
+  }
+  if(queued == TCP_WINDOW_TOTAL) {
+    tcp_socket_close(s);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+input(struct tcp_socket *s, void *ptr, const uint8_t *data, int len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+event(struct tcp_socket *s, void *ptr, tcp_socket_event_t ev)
+{
+  clock_time_t elapsed;
+
+  switch(ev) {
+  case TCP_SOCKET_CONNECTED:
+    printf("Connected, send window %u segments\n", UIP_TCP_SEND_WINDOW);
+    queued = 0;
+    start = clock_time();
+    fill(s);
+    break;
+  case TCP_SOCKET_DATA_SENT:
+    if(tcp_socket_queuelen(s) == 0 && queued == TCP_WINDOW_TOTAL) {
+      elapsed = clock_time() - start;
+      printf("TEST: window %u: %lu bytes in %lu ms\n",
+             UIP_TCP_SEND_WINDOW, queued,
+             (unsigned long)(elapsed * 1000 / CLOCK_SECOND));
+    }
+    fill(s);
+    break;
+  case TCP_SOCKET_CLOSED:
+  case TCP_SOCKET_TIMEDOUT:
+  case TCP_SOCKET_ABORTED:
+    printf("Connection closed (%d)\n", ev);
+    break;
+  default:
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tcp_window_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  tcp_socket_register(&sock, NULL, inputbuf, sizeof(inputbuf),
+                      outputbuf, sizeof(outputbuf), input, event);
+  tcp_socket_listen(&sock, TCP_WINDOW_PORT);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/tcpip.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BASE_PORT    5000
+#define PEER_PORT    7000
+#define PAYLOAD_LEN  16
+#define NUM_PACKETS  1000000
+#define NUM_ALLOCS   100000
+
+PROCESS(test_process, "test");
+PROCESS(rx_process, "rx");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The number of datagrams delivered to each UDP connection */
+static unsigned long received[UIP_UDP_CONNS];
+static unsigned long aborted;
+
+static struct uip_udp_conn *conns[UIP_UDP_CONNS];
+static int num_conns;
+
+static uip_ipaddr_t peer_addr;
+static uip_ipaddr_t own_addr;
+static uint8_t packet[UIP_IPTCPH_LEN + PAYLOAD_LEN];
+static uint16_t packet_len;
+/*---------------------------------------------------------------------------*/
+static void
+make_ip_header(uint8_t proto, uint16_t payload_len)
+{
+  memset(uip_buf, 0, UIP_IPTCPH_LEN + PAYLOAD_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = proto;
+  UIP_IP_BUF->ttl = 64;
+  uipbuf_set_len_field(UIP_IP_BUF, payload_len);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &peer_addr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &own_addr);
+  uip_ext_len = 0;
+  uip_len = UIP_IPH_LEN + payload_len;
+}
+/*---------------------------------------------------------------------------*/
+/* Prepare a UDP datagram to a local port, checksummed unless
+   checksum is false */
+static void
+make_udp(uint16_t port, bool checksum)
+{
+  make_ip_header(UIP_PROTO_UDP, UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->srcport = UIP_HTONS(PEER_PORT);
+  UIP_UDP_BUF->destport = uip_htons(port);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  memset(uip_buf + UIP_IPUDPH_LEN, 0xa5, PAYLOAD_LEN);
+  if(checksum) {
+    UIP_UDP_BUF->udpchksum = ~uip_udpchksum();
+  }
+  packet_len = uip_len;
+  memcpy(packet, uip_buf, packet_len);
+}
+/*---------------------------------------------------------------------------*/
+/* Prepare a TCP reset from the peer for a local port */
+static void
+make_tcp_reset(uint16_t lport, uint16_t rport)
+{
+  make_ip_header(UIP_PROTO_TCP, UIP_TCPH_LEN);
+  UIP_TCP_BUF->srcport = uip_htons(rport);
+  UIP_TCP_BUF->destport = lport;
+  UIP_TCP_BUF->tcpoffset = 5 << 4;
+  UIP_TCP_BUF->flags = 0x04 | 0x10;
+  UIP_TCP_BUF->tcpchksum = ~uip_tcpchksum();
+  packet_len = uip_len;
+  memcpy(packet, uip_buf, packet_len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_packet(void)
+{
+  memcpy(uip_buf, packet, packet_len);
+  uip_len = packet_len;
+  uip_ext_len = 0;
+  uip_input();
+  /* Drop any ICMPv6 error or TCP reset produced in response */
+  uipbuf_clear();
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+total_received(void)
+{
+  unsigned long total;
+  int i;
+
+  total = 0;
+  for(i = 0; i < UIP_UDP_CONNS; i++) {
+    total += received[i];
+  }
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+ports_unique(void)
+{
+  int i, j;
+
+  for(i = 0; i < UIP_UDP_CONNS; i++) {
+    if(uip_udp_conns[i].lport == 0) {
+      continue;
+    }
+    for(j = i + 1; j < UIP_UDP_CONNS; j++) {
+      if(uip_udp_conns[i].lport == uip_udp_conns[j].lport) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+/* Open all remaining UDP connections from the receiver process, bound
+   to consecutive ports */
+static void
+open_conns(void)
+{
+  struct uip_udp_conn *c;
+
+  PROCESS_CONTEXT_BEGIN(&rx_process);
+  num_conns = 0;
+  while((c = udp_new(NULL, 0, &received[num_conns])) != NULL) {
+    udp_bind(c, UIP_HTONS(BASE_PORT + num_conns));
+    conns[num_conns++] = c;
+  }
+  PROCESS_CONTEXT_END(&rx_process);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(udp_demux, "UDP demultiplexing");
+UNIT_TEST_REGISTER(port_alloc, "Ephemeral port allocation");
+UNIT_TEST_REGISTER(tcp_demux, "TCP demultiplexing");
+UNIT_TEST_REGISTER(benchmark, "Demultiplexing benchmark");
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(udp_demux)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  open_conns();
+  UNIT_TEST_ASSERT(num_conns > UIP_UDP_CONNS / 2);
+  UNIT_TEST_ASSERT(ports_unique());
+
+  /* Every bound port gets its own datagrams */
+  for(i = 0; i < num_conns; i++) {
+    make_udp(BASE_PORT + i, true);
+    input_packet();
+    UNIT_TEST_ASSERT(received[i] == 1);
+  }
+  UNIT_TEST_ASSERT(total_received() == num_conns);
+
+  /* Nothing is delivered to unbound ports */
+  make_udp(BASE_PORT + num_conns, true);
+  input_packet();
+  make_udp(BASE_PORT - 1, true);
+  input_packet();
+  UNIT_TEST_ASSERT(total_received() == num_conns);
+
+  /* A connection restricted to another remote port is skipped */
+  conns[0]->rport = UIP_HTONS(PEER_PORT + 1);
+  make_udp(BASE_PORT, true);
+  input_packet();
+  UNIT_TEST_ASSERT(received[0] == 1);
+  conns[0]->rport = 0;
+
+  /* Rebinding moves the connection to its new port */
+  udp_bind(conns[1], UIP_HTONS(BASE_PORT - 1));
+  make_udp(BASE_PORT + 1, true);
+  input_packet();
+  UNIT_TEST_ASSERT(received[1] == 1);
+  make_udp(BASE_PORT - 1, true);
+  input_packet();
+  UNIT_TEST_ASSERT(received[1] == 2);
+
+  /* A removed connection gets nothing */
+  uip_udp_remove(conns[2]);
+  make_udp(BASE_PORT + 2, true);
+  input_packet();
+  UNIT_TEST_ASSERT(received[2] == 1);
+
+  /* Of two connections on the same port, the first one in the table
+     wins */
+  udp_bind(conns[2], UIP_HTONS(BASE_PORT + 3));
+  make_udp(BASE_PORT + 3, true);
+  input_packet();
+  UNIT_TEST_ASSERT(received[2] == 2);
+  UNIT_TEST_ASSERT(received[3] == 1);
+  udp_bind(conns[2], UIP_HTONS(BASE_PORT + 2));
+  udp_bind(conns[1], UIP_HTONS(BASE_PORT + 1));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(port_alloc)
+{
+  struct uip_udp_conn *c;
+  int i, freed;
+
+  UNIT_TEST_BEGIN();
+
+  /* The table is full */
+  PROCESS_CONTEXT_BEGIN(&rx_process);
+  c = udp_new(NULL, 0, NULL);
+  PROCESS_CONTEXT_END(&rx_process);
+  UNIT_TEST_ASSERT(c == NULL);
+
+  /* Free every other connection and take them again with ephemeral
+     ports */
+  freed = 0;
+  for(i = 0; i < num_conns; i += 2) {
+    uip_udp_remove(conns[i]);
+    freed++;
+  }
+  PROCESS_CONTEXT_BEGIN(&rx_process);
+  for(i = 0; i < freed; i++) {
+    c = udp_new(NULL, 0, NULL);
+    UNIT_TEST_ASSERT(c != NULL);
+    UNIT_TEST_ASSERT(c->lport != 0);
+  }
+  c = udp_new(NULL, 0, NULL);
+  PROCESS_CONTEXT_END(&rx_process);
+  UNIT_TEST_ASSERT(c == NULL);
+  UNIT_TEST_ASSERT(ports_unique());
+
+  /* A free connection bound directly is not handed out again */
+  uip_udp_remove(conns[0]);
+  uip_udp_remove(conns[1]);
+  udp_bind(conns[1], UIP_HTONS(BASE_PORT + 1));
+  PROCESS_CONTEXT_BEGIN(&rx_process);
+  c = udp_new(NULL, 0, NULL);
+  UNIT_TEST_ASSERT(c == conns[0]);
+  c = udp_new(NULL, 0, NULL);
+  PROCESS_CONTEXT_END(&rx_process);
+  UNIT_TEST_ASSERT(c == NULL);
+  UNIT_TEST_ASSERT(ports_unique());
+
+  /* Reopen the connections on their original ports */
+  for(i = 0; i < num_conns; i++) {
+    uip_udp_remove(conns[i]);
+  }
+  memset(received, 0, sizeof(received));
+  open_conns();
+  UNIT_TEST_ASSERT(ports_unique());
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(tcp_demux)
+{
+  struct uip_conn *c[UIP_TCP_CONNS];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  PROCESS_CONTEXT_BEGIN(&rx_process);
+  for(i = 0; i < UIP_TCP_CONNS; i++) {
+    c[i] = tcp_connect(&peer_addr, UIP_HTONS(PEER_PORT + i), NULL);
+  }
+  PROCESS_CONTEXT_END(&rx_process);
+  for(i = 0; i < UIP_TCP_CONNS; i++) {
+    UNIT_TEST_ASSERT(c[i] != NULL);
+    UNIT_TEST_ASSERT(c[i]->tcpstateflags == UIP_SYN_SENT);
+  }
+
+  /* A reset from the wrong remote port leaves the connection alone */
+  make_tcp_reset(c[0]->lport, PEER_PORT + 1);
+  input_packet();
+  UNIT_TEST_ASSERT(aborted == 0);
+  UNIT_TEST_ASSERT(c[0]->tcpstateflags == UIP_SYN_SENT);
+
+  /* Each reset aborts its own connection only */
+  for(i = 0; i < UIP_TCP_CONNS; i++) {
+    make_tcp_reset(c[i]->lport, PEER_PORT + i);
+    input_packet();
+    UNIT_TEST_ASSERT(aborted == i + 1);
+    UNIT_TEST_ASSERT(c[i]->tcpstateflags == UIP_CLOSED);
+    if(i + 1 < UIP_TCP_CONNS) {
+      UNIT_TEST_ASSERT(c[i + 1]->tcpstateflags == UIP_SYN_SENT);
+    }
+  }
+
+  /* Closed connections are reused with fresh ports */
+  PROCESS_CONTEXT_BEGIN(&rx_process);
+  c[0] = tcp_connect(&peer_addr, UIP_HTONS(PEER_PORT), NULL);
+  PROCESS_CONTEXT_END(&rx_process);
+  UNIT_TEST_ASSERT(c[0] != NULL);
+  make_tcp_reset(c[0]->lport, PEER_PORT);
+  input_packet();
+  UNIT_TEST_ASSERT(aborted == UIP_TCP_CONNS + 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(benchmark)
+{
+  clock_time_t start, demux_time, alloc_time;
+  struct uip_udp_conn *c;
+  unsigned long i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Datagrams to the port bound last, the worst case for a scan of
+     the table. Checksums are left out to time the lookup itself. */
+  make_udp(BASE_PORT + num_conns - 1, false);
+  start = clock_time();
+  for(i = 0; i < NUM_PACKETS; i++) {
+    input_packet();
+  }
+  demux_time = clock_time() - start;
+  UNIT_TEST_ASSERT(received[num_conns - 1] == NUM_PACKETS);
+
+  /* Free and take one connection while the others hold their ports */
+  start = clock_time();
+  for(i = 0; i < NUM_ALLOCS; i++) {
+    uip_udp_remove(conns[0]);
+    PROCESS_CONTEXT_BEGIN(&rx_process);
+    c = udp_new(NULL, 0, &received[0]);
+    PROCESS_CONTEXT_END(&rx_process);
+    UNIT_TEST_ASSERT(c == conns[0]);
+  }
+  alloc_time = clock_time() - start;
+
+  printf("TEST: %d UDP conns, demux %lu ns/packet, "
+         "udp_new %lu ns/call (hash %d)\n",
+         num_conns,
+         (unsigned long)(demux_time * 1000000UL / CLOCK_SECOND) /
+         (NUM_PACKETS / 1000),
+         (unsigned long)(alloc_time * 1000000UL / CLOCK_SECOND) /
+         (NUM_ALLOCS / 1000),
+         UIP_CONN_WITH_HASH);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rx_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == tcpip_event) {
+      if(uip_newdata() && data != NULL) {
+        (*(unsigned long *)data)++;
+      } else if(uip_aborted()) {
+        aborted++;
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  process_start(&rx_process, NULL);
+
+  uip_ip6addr(&peer_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+  uip_ipaddr_copy(&own_addr, &uip_ds6_get_link_local(-1)->ipaddr);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(udp_demux);
+  UNIT_TEST_RUN(port_alloc);
+  UNIT_TEST_RUN(tcp_demux);
+  UNIT_TEST_RUN(benchmark);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/tcpip.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LOCAL_PORT   5000
+#define PEER_PORT    7000
+#define PAYLOAD_LEN  1000
+/* Fragmentable part: the UDP header and payload */
+#define FRAG_PART    (UIP_UDPH_LEN + PAYLOAD_LEN)
+#define FRAG_LEN     400
+#define NUM_FRAGS    ((FRAG_PART + FRAG_LEN - 1) / FRAG_LEN)
+/* One flow per reassembly context */
+#define NUM_FLOWS    UIP_REASS_CONTEXTS
+
+PROCESS(test_process, "test");
+PROCESS(rx_process, "rx");
+AUTOSTART_PROCESSES(&test_process);
+
+/* A fragmented datagram, identified by its source and fragment ID */
+struct flow {
+  uip_ipaddr_t src;
+  uint32_t id;
+  uint8_t packet[UIP_IPUDPH_LEN + PAYLOAD_LEN];
+  unsigned long delivered;
+};
+
+/* Pairs of flows share a source with different IDs, and flows of
+   different pairs share IDs */
+static struct flow flows[NUM_FLOWS];
+/* A flow that finds no free context */
+static struct flow extra_flow;
+
+static uip_ipaddr_t own_addr;
+static unsigned long corrupted;
+/*---------------------------------------------------------------------------*/
+static uint8_t
+payload_byte(const struct flow *f, int i)
+{
+  return f->src.u8[15] * 16 + f->id + i;
+}
+/*---------------------------------------------------------------------------*/
+/* Build the complete datagram of a flow, with its UDP checksum */
+static void
+init_flow(struct flow *f, uint8_t src, uint32_t id)
+{
+  int i;
+
+  uip_ip6addr(&f->src, 0xfe80, 0, 0, 0, 0, 0, 0, src);
+  f->id = id;
+  f->delivered = 0;
+
+  memset(uip_buf, 0, UIP_IPUDPH_LEN);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uipbuf_set_len_field(UIP_IP_BUF, FRAG_PART);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &f->src);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &own_addr);
+  UIP_UDP_BUF->srcport = UIP_HTONS(PEER_PORT);
+  UIP_UDP_BUF->destport = UIP_HTONS(LOCAL_PORT);
+  UIP_UDP_BUF->udplen = UIP_HTONS(FRAG_PART);
+  for(i = 0; i < PAYLOAD_LEN; i++) {
+    uip_buf[UIP_IPUDPH_LEN + i] = payload_byte(f, i);
+  }
+  uip_ext_len = 0;
+  uip_len = UIP_IPUDPH_LEN + PAYLOAD_LEN;
+  UIP_UDP_BUF->udpchksum = ~uip_udpchksum();
+  memcpy(f->packet, uip_buf, uip_len);
+}
+/*---------------------------------------------------------------------------*/
+/* Feed fragment n of a flow to the IP layer */
+static void
+input_fragment(const struct flow *f, int n)
+{
+  struct uip_frag_hdr *frag;
+  uint16_t offset;
+  uint16_t len;
+
+  offset = n * FRAG_LEN;
+  len = MIN(FRAG_LEN, FRAG_PART - offset);
+
+  memcpy(uip_buf, f->packet, UIP_IPH_LEN);
+  UIP_IP_BUF->proto = UIP_PROTO_FRAG;
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_FRAGH_LEN + len);
+  frag = (struct uip_frag_hdr *)&uip_buf[UIP_IPH_LEN];
+  frag->next = UIP_PROTO_UDP;
+  frag->res = 0;
+  frag->offsetresmore = uip_htons(offset | (n < NUM_FRAGS - 1 ? 1 : 0));
+  frag->id = f->id;
+  memcpy(&uip_buf[UIP_IPH_LEN + UIP_FRAGH_LEN],
+         &f->packet[UIP_IPH_LEN + offset], len);
+  uip_ext_len = 0;
+  uip_len = UIP_IPH_LEN + UIP_FRAGH_LEN + len;
+  uip_input();
+  uipbuf_clear();
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_flow(const struct flow *f)
+{
+  int n;
+
+  for(n = 0; n < NUM_FRAGS; n++) {
+    input_fragment(f, n);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static unsigned long
+total_delivered(void)
+{
+  unsigned long total;
+  int i;
+
+  total = 0;
+  for(i = 0; i < NUM_FLOWS; i++) {
+    total += flows[i].delivered;
+  }
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(in_order, "Single flow");
+UNIT_TEST_REGISTER(interleaved, "Interleaved flows");
+UNIT_TEST_REGISTER(no_context, "All contexts in use");
+UNIT_TEST_REGISTER(timeout, "Reassembly timeout");
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(in_order)
+{
+  UNIT_TEST_BEGIN();
+
+  input_flow(&flows[0]);
+  UNIT_TEST_ASSERT(flows[0].delivered == 1);
+  UNIT_TEST_ASSERT(corrupted == 0);
+
+  /* Fragments in reverse order */
+  input_fragment(&flows[0], 2);
+  input_fragment(&flows[0], 1);
+  UNIT_TEST_ASSERT(flows[0].delivered == 1);
+  input_fragment(&flows[0], 0);
+  UNIT_TEST_ASSERT(flows[0].delivered == 2);
+  UNIT_TEST_ASSERT(corrupted == 0);
+  UNIT_TEST_ASSERT(uip_stat.ip.reassdrop == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(interleaved)
+{
+  int i, n;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < NUM_FLOWS; i++) {
+    flows[i].delivered = 0;
+  }
+
+  /* Round-robin over the flows, every other flow in reverse order */
+  for(n = 0; n < NUM_FRAGS; n++) {
+    for(i = 0; i < NUM_FLOWS; i++) {
+      input_fragment(&flows[i], i & 1 ? NUM_FRAGS - 1 - n : n);
+    }
+  }
+  for(i = 0; i < NUM_FLOWS; i++) {
+    UNIT_TEST_ASSERT(flows[i].delivered == 1);
+  }
+  UNIT_TEST_ASSERT(corrupted == 0);
+  UNIT_TEST_ASSERT(uip_stat.ip.reassdrop == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(no_context)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Occupy every context, then send a complete extra datagram */
+  for(i = 0; i < NUM_FLOWS; i++) {
+    flows[i].delivered = 0;
+    input_fragment(&flows[i], 0);
+  }
+  input_flow(&extra_flow);
+  UNIT_TEST_ASSERT(extra_flow.delivered == 0);
+  UNIT_TEST_ASSERT(uip_stat.ip.reassdrop == NUM_FRAGS);
+
+  /* The flows holding a context are not disturbed. The last one is
+     left unfinished to time out. */
+  for(i = 0; i < NUM_FLOWS - 1; i++) {
+    input_fragment(&flows[i], 1);
+    input_fragment(&flows[i], 2);
+    UNIT_TEST_ASSERT(flows[i].delivered == 1);
+  }
+  UNIT_TEST_ASSERT(flows[NUM_FLOWS - 1].delivered == 0);
+  UNIT_TEST_ASSERT(corrupted == 0);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(timeout)
+{
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* The context left by no_context has expired */
+  UNIT_TEST_ASSERT(uip_stat.ip.reasstimeout == 1);
+
+  /* All contexts are free again */
+  for(i = 0; i < NUM_FLOWS; i++) {
+    flows[i].delivered = 0;
+    input_fragment(&flows[i], 0);
+  }
+  input_fragment(&flows[NUM_FLOWS - 1], 2);
+  input_fragment(&flows[NUM_FLOWS - 1], 1);
+  UNIT_TEST_ASSERT(flows[NUM_FLOWS - 1].delivered == 1);
+  for(i = 0; i < NUM_FLOWS - 1; i++) {
+    input_fragment(&flows[i], 1);
+    input_fragment(&flows[i], 2);
+  }
+  UNIT_TEST_ASSERT(total_delivered() == NUM_FLOWS);
+  UNIT_TEST_ASSERT(corrupted == 0);
+  UNIT_TEST_ASSERT(uip_stat.ip.reassdrop == NUM_FRAGS);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rx_process, ev, data)
+{
+  static struct uip_udp_conn *conn;
+  struct flow *f;
+  int i;
+
+  PROCESS_BEGIN();
+
+  conn = udp_new(NULL, 0, NULL);
+  udp_bind(conn, UIP_HTONS(LOCAL_PORT));
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == tcpip_event && uip_newdata()) {
+      f = NULL;
+      for(i = 0; i < NUM_FLOWS; i++) {
+        if(uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &flows[i].src) &&
+           !memcmp(&flows[i].packet[UIP_IPUDPH_LEN], uip_appdata,
+                   PAYLOAD_LEN)) {
+          f = &flows[i];
+        }
+      }
+      if(uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &extra_flow.src)) {
+        f = &extra_flow;
+      }
+      if(f != NULL && uip_datalen() == PAYLOAD_LEN) {
+        f->delivered++;
+      } else {
+        corrupted++;
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+  int i;
+
+  PROCESS_BEGIN();
+
+  process_start(&rx_process, NULL);
+
+  uip_ipaddr_copy(&own_addr, &uip_ds6_get_link_local(-1)->ipaddr);
+  for(i = 0; i < NUM_FLOWS; i++) {
+    init_flow(&flows[i], 1 + i / 2, 1 + (i & 1));
+  }
+  init_flow(&extra_flow, 0x99, 1);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(in_order);
+  UNIT_TEST_RUN(interleaved);
+  UNIT_TEST_RUN(no_context);
+
+  /* Let the reassembly left by no_context expire */
+  etimer_set(&et, (UIP_REASS_MAXAGE + 1) * CLOCK_SECOND);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(timeout);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-nd6.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-packetqueue.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_SENT 32
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+/* The UDP packets sent, as the last byte of the destination address
+   and a sequence number */
+static struct {
+  uint8_t dest;
+  uint8_t seq;
+} sent[MAX_SENT];
+static int num_sent;
+
+static uint8_t next_seq;
+static uip_ipaddr_t own_addr;
+/*---------------------------------------------------------------------------*/
+static enum netstack_ip_action
+ip_output(const linkaddr_t *localdest)
+{
+  if(UIP_IP_BUF->proto == UIP_PROTO_UDP && num_sent < MAX_SENT) {
+    sent[num_sent].dest = UIP_IP_BUF->destipaddr.u8[15];
+    sent[num_sent].seq = uip_buf[UIP_IPUDPH_LEN];
+    num_sent++;
+  }
+  return NETSTACK_IP_DROP;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor packet_processor = {
+  .process_output = ip_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+set_neighbor_addr(uip_ipaddr_t *addr, uint8_t n)
+{
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0, 0, 0, n);
+}
+/*---------------------------------------------------------------------------*/
+/* Send a UDP datagram to neighbor n; returns its sequence number */
+static uint8_t
+send_udp(uint8_t n)
+{
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &own_addr);
+  set_neighbor_addr(&UIP_IP_BUF->destipaddr, n);
+  UIP_UDP_BUF->srcport = UIP_HTONS(5000);
+  UIP_UDP_BUF->destport = UIP_HTONS(5000);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + 1);
+  UIP_UDP_BUF->udpchksum = 0;
+  uip_buf[UIP_IPUDPH_LEN] = ++next_seq;
+  uip_len = UIP_IPUDPH_LEN + 1;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  tcpip_ipv6_output();
+  return next_seq;
+}
+/*---------------------------------------------------------------------------*/
+/* Receive a solicited Neighbor Advertisement from neighbor n */
+static void
+receive_na(uint8_t n)
+{
+  uip_nd6_na *na;
+  uint8_t *opt;
+
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = UIP_ND6_HOP_LIMIT;
+  set_neighbor_addr(&UIP_IP_BUF->srcipaddr, n);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &own_addr);
+  UIP_ICMP_BUF->type = ICMP6_NA;
+  UIP_ICMP_BUF->icode = 0;
+  na = (uip_nd6_na *)&uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN];
+  na->flagsreserved = UIP_ND6_NA_FLAG_SOLICITED | UIP_ND6_NA_FLAG_OVERRIDE;
+  set_neighbor_addr(&na->tgtipaddr, n);
+  opt = &uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN];
+  memset(opt, 0, UIP_ND6_OPT_LLAO_LEN);
+  opt[UIP_ND6_OPT_TYPE_OFFSET] = UIP_ND6_OPT_TLLAO;
+  opt[UIP_ND6_OPT_LEN_OFFSET] = UIP_ND6_OPT_LLAO_LEN >> 3;
+  opt[UIP_ND6_OPT_DATA_OFFSET + UIP_LLADDR_LEN - 1] = n;
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN +
+    UIP_ND6_OPT_LLAO_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(in_order, "Queued packets sent in order");
+UNIT_TEST_REGISTER(shared_pool, "Pool shared by neighbors");
+UNIT_TEST_REGISTER(timeout_start, "Queue packets to age out");
+UNIT_TEST_REGISTER(timeout, "Queued packets age out");
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(in_order)
+{
+  struct uip_packetqueue_stats stats;
+  uint8_t first;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  num_sent = 0;
+  first = send_udp(2);
+  for(i = 1; i < UIP_PACKETQUEUE_MAX_PER_HANDLE; i++) {
+    send_udp(2);
+  }
+  /* One more than the neighbor may hold */
+  send_udp(2);
+  UNIT_TEST_ASSERT(num_sent == 0);
+  uip_packetqueue_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.queued == UIP_PACKETQUEUE_MAX_PER_HANDLE);
+  UNIT_TEST_ASSERT(stats.handle_full == 1);
+
+  receive_na(2);
+  UNIT_TEST_ASSERT(num_sent == UIP_PACKETQUEUE_MAX_PER_HANDLE);
+  for(i = 0; i < num_sent; i++) {
+    UNIT_TEST_ASSERT(sent[i].dest == 2);
+    UNIT_TEST_ASSERT(sent[i].seq == first + i);
+  }
+
+  /* The neighbor is reachable now */
+  send_udp(2);
+  UNIT_TEST_ASSERT(num_sent == UIP_PACKETQUEUE_MAX_PER_HANDLE + 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(shared_pool)
+{
+  struct uip_packetqueue_stats before;
+  struct uip_packetqueue_stats after;
+  uint8_t first3, first4;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  uip_packetqueue_get_stats(&before);
+  num_sent = 0;
+  first3 = send_udp(3);
+  for(i = 1; i < UIP_PACKETQUEUE_MAX_PER_HANDLE; i++) {
+    send_udp(3);
+  }
+  first4 = send_udp(4);
+  for(i = 1; i < UIP_PACKETQUEUE_MAX_PER_HANDLE; i++) {
+    send_udp(4);
+  }
+  uip_packetqueue_get_stats(&after);
+  UNIT_TEST_ASSERT(after.queued - before.queued == UIP_PACKETQUEUE_SIZE);
+  UNIT_TEST_ASSERT(after.no_buffer - before.no_buffer ==
+                   2 * UIP_PACKETQUEUE_MAX_PER_HANDLE - UIP_PACKETQUEUE_SIZE);
+
+  /* The second neighbor got what was left of the pool */
+  receive_na(4);
+  UNIT_TEST_ASSERT(num_sent ==
+                   UIP_PACKETQUEUE_SIZE - UIP_PACKETQUEUE_MAX_PER_HANDLE);
+  for(i = 0; i < num_sent; i++) {
+    UNIT_TEST_ASSERT(sent[i].dest == 4);
+    UNIT_TEST_ASSERT(sent[i].seq == first4 + i);
+  }
+
+  num_sent = 0;
+  receive_na(3);
+  UNIT_TEST_ASSERT(num_sent == UIP_PACKETQUEUE_MAX_PER_HANDLE);
+  for(i = 0; i < num_sent; i++) {
+    UNIT_TEST_ASSERT(sent[i].dest == 3);
+    UNIT_TEST_ASSERT(sent[i].seq == first3 + i);
+  }
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(timeout_start)
+{
+  uip_ipaddr_t addr;
+
+  UNIT_TEST_BEGIN();
+
+  send_udp(5);
+  send_udp(5);
+
+  /* Packets are discarded with their neighbor */
+  send_udp(6);
+  set_neighbor_addr(&addr, 6);
+  uip_ds6_nbr_rm(uip_ds6_nbr_lookup(&addr));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(timeout)
+{
+  struct uip_packetqueue_stats stats;
+
+  UNIT_TEST_BEGIN();
+
+  uip_packetqueue_get_stats(&stats);
+  UNIT_TEST_ASSERT(stats.timed_out == 2);
+  UNIT_TEST_ASSERT(stats.discarded == 1);
+
+  num_sent = 0;
+  receive_na(5);
+  UNIT_TEST_ASSERT(num_sent == 0);
+  send_udp(5);
+  UNIT_TEST_ASSERT(num_sent == 1);
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  static struct etimer et;
+
+  PROCESS_BEGIN();
+
+  netstack_ip_packet_processor_add(&packet_processor);
+  uip_ipaddr_copy(&own_addr, &uip_ds6_get_link_local(-1)->ipaddr);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(in_order);
+  UNIT_TEST_RUN(shared_pool);
+  UNIT_TEST_RUN(timeout_start);
+
+  /* Let the packets queued by timeout_start age out */
+  etimer_set(&et, UIP_DS6_NBR_PACKET_LIFETIME * 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  UNIT_TEST_RUN(timeout);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
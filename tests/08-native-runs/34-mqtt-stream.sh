@@ -0,0 +1,79 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+IPADDR=fd00::302:304:506:708
+PORT=1884
+COUNT=8
+SIZE=4096
+RX_COUNT=4
+RX_SIZE=3000
+
+rm -f $BASENAME.log
+STATUS=0
+declare -A TIME
+
+# Measure MQTT publish throughput with the payload copied into the
+# output buffer and with the payload sent straight from the application,
+# and check the streamed receive path in both builds
+for ZERO_COPY in 0 1; do
+  echo "Starting broker stand-in"
+  $BASENAME/mqtt-broker.py $PORT $COUNT $SIZE $RX_COUNT $RX_SIZE > broker.log 2>&1 &
+  BPID=$!
+
+  echo "Starting native node, zero copy $ZERO_COPY"
+  make -C $BASENAME clean > /dev/null
+  make -C $BASENAME DEFINES=MQTT_CONF_ZERO_COPY=$ZERO_COPY > make.log 2> make.err
+  sudo $BASENAME/mqtt-stream.native > node.log 2> node.err &
+  CPID=$!
+  sleep 1
+  # Make sure the node is reached over the tun interface
+  sudo ip -6 route replace $IPADDR/128 dev tun0
+
+  wait $BPID
+  if [ $? -ne 0 ] ; then
+    STATUS=1
+  fi
+  cat broker.log | tee -a $BASENAME.log
+
+  echo "Closing native node"
+  # SIGTERM lets the node flush its output before exiting
+  kill_bg $CPID 15
+  sleep 1
+  TIME[$ZERO_COPY]=$(grep -a "TEST:" node.log | sed 's/.* in \([0-9]*\) ms/\1/')
+  if ! grep -aq "RECEIVE: $RX_COUNT messages, $((RX_COUNT * RX_SIZE)) bytes, pattern ok" node.log ; then
+    STATUS=1
+  fi
+  cat node.log >> $BASENAME.log
+done
+
+# The timings depend on the host: report them, but only the data checks
+# decide the outcome
+echo "Copy: ${TIME[0]} ms, zero copy: ${TIME[1]} ms"
+
+if [ $STATUS -eq 0 ] ; then
+  printf "%-32s TEST OK\n" "$BASENAME" | tee $BASENAME.testlog;
+else
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== node.log ====" ; cat node.log;
+  echo "==== node.err ====" ; cat node.err;
+  echo "==== $BASENAME.log ====" ; cat $BASENAME.log;
+
+  printf "%-32s TEST FAIL\n" "$BASENAME" | tee $BASENAME.testlog;
+fi
+
+make -C $BASENAME clean > /dev/null
+rm make.log
+rm make.err
+rm node.log
+rm node.err
+rm broker.log
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
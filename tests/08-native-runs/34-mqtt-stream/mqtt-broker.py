@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+# A stand-in for an MQTT broker, just enough for the mqtt-stream node:
+# accepts one client, checks the messages it publishes and then sends
+# it a few large messages of its own.
+import socket
+import struct
+import sys
+import time
+
+port, count, size, rx_count, rx_size = (int(a) for a in sys.argv[1:6])
+
+
+def recv_exact(c, n):
+    data = b""
+    while len(data) < n:
+        chunk = c.recv(n - len(data))
+        if not chunk:
+            raise EOFError
+        data += chunk
+    return data
+
+
+def recv_packet(c):
+    fhdr = recv_exact(c, 1)[0]
+    length, shift = 0, 0
+    while True:
+        b = recv_exact(c, 1)[0]
+        length |= (b & 0x7f) << shift
+        shift += 7
+        if not b & 0x80:
+            break
+    return fhdr, recv_exact(c, length)
+
+
+def recv_publish(c):
+    while True:
+        fhdr, body = recv_packet(c)
+        if fhdr & 0xf0 != 0xc0:
+            return fhdr, body
+        # PINGREQ
+        c.sendall(bytes([0xd0, 0]))
+
+
+def encode_length(n):
+    out = bytearray()
+    while True:
+        b, n = n & 0x7f, n >> 7
+        out.append(b | (0x80 if n else 0))
+        if not n:
+            return bytes(out)
+
+
+def pattern(n):
+    return bytes(i & 0xff for i in range(n))
+
+
+srv = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+srv.bind(("::", port))
+srv.listen(1)
+srv.settimeout(30)
+c, _ = srv.accept()
+c.settimeout(60)
+
+fhdr, body = recv_packet(c)
+if fhdr & 0xf0 != 0x10:
+    sys.exit("expected CONNECT, got %02x" % fhdr)
+version = body[6]
+c.sendall(bytes([0x20, 3, 0, 0, 0]) if version == 5 else
+          bytes([0x20, 2, 0, 0]))
+
+ok = True
+received = 0
+start = None
+for n in range(count):
+    fhdr, body = recv_publish(c)
+    if start is None:
+        start = time.time()
+    topic_len = (body[0] << 8) | body[1]
+    payload = body[2 + topic_len:]
+    if version == 5:
+        payload = payload[1:]
+    if (fhdr & 0xf0 != 0x30 or len(payload) != size or
+            payload[:16] != b"%015u\0" % n or payload[16:] != pattern(size - 16)):
+        ok = False
+    received += len(payload)
+elapsed = time.time() - start
+print("Broker got %d messages, %d bytes in %.2f s%s" %
+      (count, received, elapsed, "" if ok else ", wrong data"))
+
+topic = b"stream/down"
+props = b"\0" if version == 5 else b""
+for n in range(rx_count):
+    vhdr = bytes([0, len(topic)]) + topic + props
+    payload = pattern(rx_size)
+    c.sendall(bytes([0x30]) + encode_length(len(vhdr) + len(payload)) +
+              vhdr + payload)
+
+# The node disconnects once it has read everything. Give it a moment to
+# do so and then reset the connection, so that no state is left behind
+# for the next run, which uses the same port numbers.
+c.settimeout(5)
+try:
+    while c.recv(4096):
+        pass
+except (socket.timeout, ConnectionError):
+    pass
+c.setsockopt(socket.SOL_SOCKET, socket.SO_LINGER, struct.pack("ii", 1, 0))
+c.close()
+sys.exit(0 if ok else 1)
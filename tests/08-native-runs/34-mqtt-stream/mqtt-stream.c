@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * MQTT publish and receive throughput over the native tun interface.
+ *
+ * The node connects to the broker stand-in, mqtt-broker.py, and publishes
+ * MQTT_STREAM_COUNT messages of MQTT_STREAM_SIZE bytes each, gathered
+ * from a small header and a large body with mqtt_publish_frags(). The
+ * broker then sends messages back, which the node reads through the
+ * stream callback and checks against the test pattern.
+ *
+ * As in the tcp-window test, the node uses delay_net_driver to get the
+ * round-trip times of a multi-hop network.
+ */
+
+#include "contiki.h"
+#include "contiki-net.h"
+#include "mqtt.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define MQTT_STREAM_BROKER  "fd00::1"
+#define MQTT_STREAM_PORT    1884
+#define MQTT_STREAM_COUNT   8
+#define MQTT_STREAM_SIZE    4096
+#define MQTT_STREAM_HDR_LEN 16
+#define MQTT_STREAM_RX_COUNT 4
+
+#ifdef MQTT_STREAM_CONF_DELAY
+#define MQTT_STREAM_DELAY MQTT_STREAM_CONF_DELAY
+#else
+#define MQTT_STREAM_DELAY (CLOCK_SECOND / 20)
+#endif
+
+#define DELAY_SLOTS 16
+
+extern const struct network_driver tun6_net_driver;
+
+static struct {
+  struct timer due;
+  uint16_t len;
+  uint8_t data[UIP_BUFSIZE];
+} delay_line[DELAY_SLOTS];
+static uint8_t delay_head, delay_count;
+static struct ctimer delay_timer;
+
+static struct mqtt_connection conn;
+static uint8_t header[MQTT_STREAM_HDR_LEN];
+static uint8_t body[MQTT_STREAM_SIZE - MQTT_STREAM_HDR_LEN];
+static const struct mqtt_payload_frag frags[] = {
+  { header, sizeof(header) },
+  { body, sizeof(body) },
+};
+static unsigned long rx_bytes;
+static unsigned rx_messages;
+static uint8_t rx_ok = 1;
+
+PROCESS(mqtt_stream_process, "MQTT stream");
+AUTOSTART_PROCESSES(&mqtt_stream_process);
+/*---------------------------------------------------------------------------*/
+static void
+delay_release(void *ptr)
+{
+  uint16_t len;
+
+  /* Nothing else uses uip_buf between events, so it can be borrowed
+     to hand the packet to the tun driver. */
+  len = uip_len;
+  while(delay_count > 0 && timer_expired(&delay_line[delay_head].due)) {
+    memcpy(uip_buf, delay_line[delay_head].data, delay_line[delay_head].len);
+    uip_len = delay_line[delay_head].len;
+    tun6_net_driver.output(NULL);
+    delay_head = (delay_head + 1) % DELAY_SLOTS;
+    delay_count--;
+  }
+  uip_len = len;
+  if(delay_count > 0) {
+    ctimer_set(&delay_timer, timer_remaining(&delay_line[delay_head].due),
+               delay_release, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+delay_init(void)
+{
+  tun6_net_driver.init();
+}
+/*---------------------------------------------------------------------------*/
+static void
+delay_input(void)
+{
+  tun6_net_driver.input();
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+delay_output(const linkaddr_t *localdest)
+{
+  uint8_t slot;
+
+  if(delay_count == DELAY_SLOTS) {
+    /* The link is congested; drop the packet. */
+    return 0;
+  }
+  slot = (delay_head + delay_count) % DELAY_SLOTS;
+  timer_set(&delay_line[slot].due, MQTT_STREAM_DELAY);
+  delay_line[slot].len = uip_len;
+  memcpy(delay_line[slot].data, uip_buf, uip_len);
+  if(delay_count++ == 0) {
+    ctimer_set(&delay_timer, MQTT_STREAM_DELAY, delay_release, NULL);
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+const struct network_driver delay_net_driver = {
+  "delay",
+  delay_init,
+  delay_input,
+  delay_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+stream_callback(struct mqtt_connection *m, struct mqtt_message *msg)
+{
+  uint16_t offset;
+  uint16_t i;
+
+  /* The broker fills every payload with the same pattern as the body of
+     the messages published by the node */
+  offset = msg->payload_length - msg->payload_left -
+    msg->payload_chunk_length;
+  for(i = 0; i < msg->payload_chunk_length; i++) {
+    if(msg->payload_chunk[i] != (uint8_t)(offset + i)) {
+      rx_ok = 0;
+    }
+  }
+  rx_bytes += msg->payload_chunk_length;
+  if(msg->payload_left == 0) {
+    rx_messages++;
+    process_poll(&mqtt_stream_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
+{
+  if(event == MQTT_EVENT_DISCONNECTED) {
+    printf("Disconnected\n");
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mqtt_stream_process, ev, data)
+{
+  static struct etimer et;
+  static uint16_t sent;
+  static clock_time_t start;
+  uint16_t i;
+
+  PROCESS_BEGIN();
+
+  for(i = 0; i < sizeof(body); i++) {
+    body[i] = (uint8_t)i;
+  }
+
+  mqtt_register(&conn, &mqtt_stream_process, "mqtt-stream", mqtt_event,
+                UIP_TCP_MSS);
+  mqtt_set_stream_callback(&conn, stream_callback);
+  conn.auto_reconnect = 0;
+
+  /* Let the tun interface come up */
+  etimer_set(&et, CLOCK_SECOND * 3);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+#if MQTT_5
+  mqtt_connect(&conn, MQTT_STREAM_BROKER, MQTT_STREAM_PORT, 60, 1,
+               MQTT_PROP_LIST_NONE);
+#else
+  mqtt_connect(&conn, MQTT_STREAM_BROKER, MQTT_STREAM_PORT, 60, 1);
+#endif
+  PROCESS_WAIT_EVENT_UNTIL(mqtt_ready(&conn));
+
+  printf("Connected, zero copy %u\n", MQTT_ZERO_COPY);
+  start = clock_time();
+  for(sent = 0; sent < MQTT_STREAM_COUNT; sent++) {
+    snprintf((char *)header, sizeof(header), "%015u", sent);
+#if MQTT_5
+    mqtt_publish_frags(&conn, NULL, "stream/up", frags, 2, MQTT_QOS_LEVEL_0,
+                       MQTT_RETAIN_OFF, 0, MQTT_TOPIC_ALIAS_OFF,
+                       MQTT_PROP_LIST_NONE);
+#else
+    mqtt_publish_frags(&conn, NULL, "stream/up", frags, 2, MQTT_QOS_LEVEL_0,
+                       MQTT_RETAIN_OFF);
+#endif
+    PROCESS_WAIT_EVENT_UNTIL(mqtt_ready(&conn));
+  }
+  printf("TEST: zero copy %u: %lu bytes in %lu ms\n", MQTT_ZERO_COPY,
+         (unsigned long)MQTT_STREAM_COUNT * MQTT_STREAM_SIZE,
+         (unsigned long)((clock_time() - start) * 1000 / CLOCK_SECOND));
+
+  /* The broker sends its messages once it has got all of ours */
+  etimer_set(&et, CLOCK_SECOND * 10);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et) ||
+                           rx_messages == MQTT_STREAM_RX_COUNT);
+  printf("RECEIVE: %u messages, %lu bytes, %s\n", rx_messages, rx_bytes,
+         rx_ok ? "pattern ok" : "wrong data");
+
+#if MQTT_5
+  mqtt_disconnect(&conn, MQTT_PROP_LIST_NONE);
+#else
+  mqtt_disconnect(&conn);
+#endif
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
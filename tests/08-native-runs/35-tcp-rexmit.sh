@@ -0,0 +1,3 @@
+#!/bin/bash
+
+./run-one.sh 35-tcp-rexmit
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+/*
+ * Unit tests for the sequence number handling of the uIP send window:
+ * cumulative acknowledgements after a retransmission time-out, and a
+ * close while data is still in flight. The remote host is played by
+ * feeding segments straight to uip_input() and reading the replies
+ * back from uip_buf.
+ */
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/tcpip.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LOCAL_PORT  5000
+#define PEER_PORT   7000
+#define PEER_ISS    1000UL
+#define SEGMENT_LEN 100
+
+#define FLAG_FIN 0x01
+#define FLAG_SYN 0x02
+#define FLAG_ACK 0x10
+
+PROCESS(test_process, "test");
+PROCESS(app_process, "app");
+AUTOSTART_PROCESSES(&test_process);
+
+static uip_ipaddr_t peer_addr;
+static uip_ipaddr_t own_addr;
+
+/* What the application does on its next callback */
+static uint16_t send_len;
+static bool close_now;
+static uint8_t app_data[SEGMENT_LEN];
+
+/* What the application has seen */
+static struct uip_conn *conn;
+static unsigned long acked_total;
+
+/* The reply to the last segment, if any */
+static bool out_valid;
+static uint8_t out_flags;
+static uint32_t out_seqno;
+static uint16_t out_datalen;
+
+static uint32_t local_iss;
+/*---------------------------------------------------------------------------*/
+static void
+put32(uint8_t *p, uint32_t v)
+{
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+get32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+    ((uint32_t)p[2] << 8) | p[3];
+}
+/*---------------------------------------------------------------------------*/
+/* Record the segment that uIP left in uip_buf, and clear it */
+static void
+take_output(void)
+{
+  out_valid = uip_len > 0;
+  if(out_valid) {
+    out_flags = UIP_TCP_BUF->flags;
+    out_seqno = get32(UIP_TCP_BUF->seqno);
+    out_datalen = uip_len - UIP_IPH_LEN - (UIP_TCP_BUF->tcpoffset >> 4) * 4;
+  }
+  uipbuf_clear();
+}
+/*---------------------------------------------------------------------------*/
+/* Feed a segment without data from the remote host to uIP. A SYN
+   carries an MSS option, as uIP only sets the MSS from the option. */
+static void
+input_segment(uint8_t flags, uint32_t seqno, uint32_t ackno)
+{
+  uint16_t optlen;
+
+  optlen = (flags & FLAG_SYN) ? 4 : 0;
+  memset(uip_buf, 0, UIP_IPTCPH_LEN + optlen);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_TCP;
+  UIP_IP_BUF->ttl = 64;
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_TCPH_LEN + optlen);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &peer_addr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &own_addr);
+  UIP_TCP_BUF->srcport = UIP_HTONS(PEER_PORT);
+  UIP_TCP_BUF->destport = UIP_HTONS(LOCAL_PORT);
+  put32(UIP_TCP_BUF->seqno, seqno);
+  put32(UIP_TCP_BUF->ackno, ackno);
+  UIP_TCP_BUF->tcpoffset = ((UIP_TCPH_LEN + optlen) / 4) << 4;
+  UIP_TCP_BUF->flags = flags;
+  UIP_TCP_BUF->wnd[0] = 0xff;
+  UIP_TCP_BUF->wnd[1] = 0xff;
+  if(optlen > 0) {
+    uip_buf[UIP_IPTCPH_LEN] = 2;
+    uip_buf[UIP_IPTCPH_LEN + 1] = 4;
+    uip_buf[UIP_IPTCPH_LEN + 2] = UIP_TCP_MSS >> 8;
+    uip_buf[UIP_IPTCPH_LEN + 3] = UIP_TCP_MSS & 0xff;
+  }
+  uip_ext_len = 0;
+  uip_len = UIP_IPTCPH_LEN + optlen;
+  UIP_TCP_BUF->tcpchksum = ~uip_tcpchksum();
+  uip_input();
+  take_output();
+}
+/*---------------------------------------------------------------------------*/
+/* Acknowledge everything up to len bytes of data from the node */
+static void
+input_ack(uint32_t len)
+{
+  input_segment(FLAG_ACK, PEER_ISS + 1, local_iss + 1 + len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+poll_app(uint16_t len)
+{
+  send_len = len;
+  uip_poll_conn(conn);
+  send_len = 0;
+  take_output();
+}
+/*---------------------------------------------------------------------------*/
+/* Set up a connection from the remote host. The node sends its first
+   segment as soon as the connection is established. */
+static bool
+open_conn(void)
+{
+  conn = NULL;
+  acked_total = 0;
+  close_now = false;
+
+  input_segment(FLAG_SYN, PEER_ISS, 0);
+  if(!out_valid || out_flags != (FLAG_SYN | FLAG_ACK)) {
+    return false;
+  }
+  local_iss = out_seqno;
+
+  send_len = SEGMENT_LEN;
+  input_ack(0);
+  return conn != NULL && conn->tcpstateflags == UIP_ESTABLISHED &&
+    out_valid && out_seqno == local_iss + 1 && out_datalen == SEGMENT_LEN;
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(ack_after_rto, "ACK of data sent before an RTO");
+UNIT_TEST_REGISTER(close_in_flight, "Close with data in flight");
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(ack_after_rto)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(open_conn());
+
+  /* Two more segments go after the first one */
+  poll_app(SEGMENT_LEN);
+  UNIT_TEST_ASSERT(out_valid && out_seqno == local_iss + 1 + SEGMENT_LEN);
+  poll_app(SEGMENT_LEN);
+  UNIT_TEST_ASSERT(out_valid &&
+                   out_seqno == local_iss + 1 + 2 * SEGMENT_LEN);
+
+  /* The time-out sends the first segment again */
+  conn->timer = 0;
+  send_len = SEGMENT_LEN;
+  uip_periodic_conn(conn);
+  take_output();
+  UNIT_TEST_ASSERT(out_valid && out_seqno == local_iss + 1);
+  UNIT_TEST_ASSERT(out_datalen == SEGMENT_LEN);
+
+  /* The ACK of all three segments sent before the time-out arrives
+     late: it still acknowledges all of them */
+  send_len = 0;
+  input_ack(3 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(acked_total == 3 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(get32(conn->snd_nxt) == local_iss + 1 + 3 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(uip_outstanding(conn) == 0);
+
+  /* New data goes after the acknowledged data */
+  poll_app(SEGMENT_LEN);
+  UNIT_TEST_ASSERT(out_valid &&
+                   out_seqno == local_iss + 1 + 3 * SEGMENT_LEN);
+
+  /* ACKs beyond what was ever sent are ignored */
+  input_ack(5 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(acked_total == 3 * SEGMENT_LEN);
+  input_ack(4 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(acked_total == 4 * SEGMENT_LEN);
+  conn->tcpstateflags = UIP_CLOSED;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST(close_in_flight)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(open_conn());
+  poll_app(SEGMENT_LEN);
+  UNIT_TEST_ASSERT(out_valid);
+
+  /* Closing with two segments in flight does not send the FIN yet */
+  close_now = true;
+  poll_app(0);
+  UNIT_TEST_ASSERT(!out_valid);
+  UNIT_TEST_ASSERT(conn->tcpstateflags == UIP_ESTABLISHED);
+
+  /* Nor does a partial acknowledgement */
+  input_ack(SEGMENT_LEN);
+  UNIT_TEST_ASSERT(acked_total == SEGMENT_LEN);
+  UNIT_TEST_ASSERT(!out_valid || !(out_flags & FLAG_FIN));
+  UNIT_TEST_ASSERT(conn->tcpstateflags == UIP_ESTABLISHED);
+
+  /* Once all data is acknowledged, the FIN follows it */
+  input_ack(2 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(acked_total == 2 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(out_valid && (out_flags & FLAG_FIN));
+  UNIT_TEST_ASSERT(out_seqno == local_iss + 1 + 2 * SEGMENT_LEN);
+  UNIT_TEST_ASSERT(conn->tcpstateflags == UIP_FIN_WAIT_1);
+
+  /* The ACK of the FIN completes our half of the close */
+  input_ack(2 * SEGMENT_LEN + 1);
+  UNIT_TEST_ASSERT(conn->tcpstateflags == UIP_FIN_WAIT_2);
+  conn->tcpstateflags = UIP_CLOSED;
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(app_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  tcp_listen(UIP_HTONS(LOCAL_PORT));
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == tcpip_event) {
+      if(uip_connected()) {
+        conn = uip_conn;
+      }
+      if(uip_acked()) {
+        acked_total += uip_ackedlen();
+      }
+      if(close_now) {
+        uip_close();
+      } else if(send_len > 0 && (uip_connected() || uip_acked() ||
+                                 uip_poll() || uip_rexmit())) {
+        uip_send(app_data, send_len);
+      }
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  process_start(&app_process, NULL);
+
+  uip_ip6addr(&peer_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+  uip_ipaddr_copy(&own_addr, &uip_ds6_get_link_local(-1)->ipaddr);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(ack_after_rto);
+  UNIT_TEST_RUN(close_in_flight);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
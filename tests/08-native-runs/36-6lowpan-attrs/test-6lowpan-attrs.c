@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "unit-test.h"
+#include <stdio.h>
+#include <string.h>
+
+PROCESS(test_process, "test");
+AUTOSTART_PROCESSES(&test_process);
+
+static const linkaddr_t dest = { { 2, 2, 2, 2, 2, 2, 2, 2 } };
+
+/* The attributes of the last packet sent by 6LoWPAN */
+static uint16_t network_id;
+static uint16_t channel;
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(mac_callback_t sent, void *ptr)
+{
+  network_id = packetbuf_attr(PACKETBUF_ATTR_NETWORK_ID);
+  channel = packetbuf_attr(PACKETBUF_ATTR_CHANNEL);
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+packet_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+max_payload(void)
+{
+  return 127 - 25;
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+const struct mac_driver capture_mac_driver = {
+  "capture",
+  init,
+  send_packet,
+  packet_input,
+  on,
+  off,
+  max_payload,
+};
+/*---------------------------------------------------------------------------*/
+/* The channel attribute is only set while a sniffer is registered */
+static void
+sniffer_input(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+sniffer_output(int mac_status)
+{
+}
+/*---------------------------------------------------------------------------*/
+NETSTACK_SNIFFER(sniffer, sniffer_input, sniffer_output);
+/*---------------------------------------------------------------------------*/
+/* Builds a link-local packet in uip_buf with an upper-layer header of
+   the given protocol and length behind a hop-by-hop header, as RPL
+   sends them, and returns the upper-layer header */
+static uint8_t *
+build_packet(uint8_t proto, uint16_t len)
+{
+  struct uip_ext_hdr *hbh;
+
+  memset(uip_buf, 0, UIP_IPH_LEN + 8 + len);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_HBHO;
+  UIP_IP_BUF->ttl = 64;
+  uip_create_linklocal_prefix(&UIP_IP_BUF->srcipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, (uip_lladdr_t *)&linkaddr_node_addr);
+  uip_create_linklocal_prefix(&UIP_IP_BUF->destipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->destipaddr, (uip_lladdr_t *)&dest);
+  uipbuf_set_len_field(UIP_IP_BUF, 8 + len);
+  hbh = (struct uip_ext_hdr *)UIP_IP_PAYLOAD(0);
+  hbh->next = proto;
+  hbh->len = 0;
+  /* PadN over the rest of the header */
+  ((uint8_t *)hbh)[2] = UIP_EXT_HDR_OPT_PADN;
+  ((uint8_t *)hbh)[3] = 4;
+  uip_len = UIP_IPH_LEN + 8 + len;
+  return UIP_IP_PAYLOAD(8);
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(icmp6, "ICMPv6 behind a hop-by-hop header");
+UNIT_TEST(icmp6)
+{
+  struct uip_icmp_hdr *icmp;
+
+  UNIT_TEST_BEGIN();
+
+  icmp = (struct uip_icmp_hdr *)build_packet(UIP_PROTO_ICMP6, 8);
+  icmp->type = ICMP6_RPL;
+  icmp->icode = 0x02; /* DAO */
+
+  network_id = 0;
+  channel = 0;
+  NETSTACK_NETWORK.output(&dest);
+  UNIT_TEST_ASSERT(network_id == UIP_PROTO_ICMP6);
+  UNIT_TEST_ASSERT(channel == (ICMP6_RPL << 8 | 0x02));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+UNIT_TEST_REGISTER(udp, "UDP behind a hop-by-hop header");
+UNIT_TEST(udp)
+{
+  struct uip_udp_hdr *udp;
+
+  UNIT_TEST_BEGIN();
+
+  udp = (struct uip_udp_hdr *)build_packet(UIP_PROTO_UDP, UIP_UDPH_LEN);
+  udp->srcport = UIP_HTONS(5683);
+  udp->destport = UIP_HTONS(5684);
+  udp->udplen = UIP_HTONS(UIP_UDPH_LEN);
+
+  network_id = 0;
+  channel = 0;
+  NETSTACK_NETWORK.output(&dest);
+  UNIT_TEST_ASSERT(network_id == UIP_PROTO_UDP);
+  UNIT_TEST_ASSERT(channel == MIN(udp->srcport, udp->destport));
+
+  UNIT_TEST_END();
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  netstack_sniffer_add(&sniffer);
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(icmp6);
+  UNIT_TEST_RUN(udp);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
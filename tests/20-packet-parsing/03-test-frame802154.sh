@@ -0,0 +1,42 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Test basename
+BASENAME=03-test-frame802154
+
+# Example code directory
+CODE_DIR=frame802154-index
+CODE=frame802154-index
+
+echo "Building native node"
+make -C $CODE_DIR TARGET=native > make.log 2> make.err
+
+# Compare the frame index with the reference parsers on fuzzed frames,
+# then benchmark both on valid frames
+$CMD_TIMEOUT -k 1s 120s $CODE_DIR/$CODE.native > $CODE.log 2> $CODE.err
+EXIT_CODE=$?
+echo "exit code:" $EXIT_CODE
+
+if [ $EXIT_CODE -ne 0 ]; then
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== $CODE.log ====" ; cat $CODE.log;
+  echo "==== $CODE.err ====" ; cat $CODE.err;
+
+  printf "%-32s TEST FAIL\n" "$CODE" | tee $BASENAME.testlog;
+else
+  grep -a "Fuzzed\|TEST:" $CODE.log
+  printf "%-32s TEST OK\n" "$CODE" | tee $BASENAME.testlog;
+fi
+
+rm make.log
+rm make.err
+rm $CODE.log
+rm $CODE.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,637 @@
+/*
+ * Copyright (c) 2026, Contiki-NG contributors.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   Equivalence and performance test of the single-pass 802.15.4 frame
+ *   index against frame802154_parse() and
+ *   frame802154e_parse_information_elements(). Valid beacons, enhanced
+ *   ACKs and data frames are generated, randomly mutated, and parsed both
+ *   ways; the results must be identical. The TSCH EB and EACK parsers,
+ *   which use the index, are checked against the same parsers built on
+ *   frame802154_parse().
+ */
+
+#include "contiki.h"
+#include "net/mac/framer/frame802154.h"
+#include "net/mac/framer/frame802154e-ie.h"
+#include "net/mac/tsch/tsch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FUZZ_ITERATIONS  300000
+#define BENCH_ITERATIONS 500000
+#define MAX_FRAME_LEN    127
+/* frame802154_parse() may read past the end of truncated frames */
+#define FRAME_BUF_SIZE   256
+
+enum frame_kind { FRAME_EB, FRAME_EACK, FRAME_DATA, FRAME_RANDOM, NUM_FRAME_KINDS };
+
+static uint8_t frame_buf[FRAME_BUF_SIZE];
+static uint32_t rnd_state = 0x2545f491;
+static unsigned long num_headers;
+static unsigned long num_ie_lists;
+static unsigned long num_tsch_frames;
+static unsigned long num_failures;
+static volatile int sink;
+
+/* What the TSCH packet parsers need from the rest of TSCH */
+const linkaddr_t tsch_eb_address = { { 0, 0, 0, 0, 0, 0, 0, 0 } };
+struct tsch_asn_t tsch_current_asn;
+uint8_t tsch_join_priority;
+/*---------------------------------------------------------------------------*/
+PROCESS(frame802154_index_process, "802.15.4 frame index test");
+AUTOSTART_PROCESSES(&frame802154_index_process);
+/*---------------------------------------------------------------------------*/
+static uint32_t
+rnd(void)
+{
+  rnd_state ^= rnd_state << 13;
+  rnd_state ^= rnd_state >> 17;
+  rnd_state ^= rnd_state << 5;
+  return rnd_state;
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_bytes(uint8_t *buf, int len)
+{
+  while(len-- > 0) {
+    *buf++ = rnd();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+random_header(frame802154_t *p, uint8_t frame_type, uint8_t version)
+{
+  memset(p, 0, sizeof(*p));
+  p->fcf.frame_type = frame_type;
+  p->fcf.frame_version = version;
+  p->fcf.frame_pending = rnd() & 1;
+  p->fcf.ack_required = rnd() & 1;
+  p->fcf.panid_compression = rnd() & 1;
+  p->fcf.dest_addr_mode = rnd() & 3;
+  p->fcf.src_addr_mode = rnd() & 3;
+  if(version == FRAME802154_IEEE802154_2015) {
+    p->fcf.sequence_number_suppression = (rnd() & 3) == 0;
+  }
+  p->seq = rnd();
+  p->dest_pid = rnd() & 1 ? 0xabcd : rnd();
+  p->src_pid = rnd() & 1 ? p->dest_pid : rnd();
+  random_bytes(p->dest_addr, 8);
+  random_bytes(p->src_addr, 8);
+  if((rnd() & 3) == 0) {
+    p->fcf.security_enabled = 1;
+    p->aux_hdr.security_control.security_level = rnd() & 7;
+    p->aux_hdr.security_control.key_id_mode = rnd() & 3;
+    p->aux_hdr.security_control.frame_counter_suppression = rnd() & 1;
+    p->aux_hdr.security_control.frame_counter_size = rnd() & 1;
+    p->aux_hdr.frame_counter.u32 = rnd();
+    random_bytes(p->aux_hdr.key_source.u8, 8);
+    p->aux_hdr.key_index = rnd();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A TSCH Enhanced Beacon, with the IEs of tsch_packet_create_eb() */
+static int
+create_eb(uint8_t *buf)
+{
+  frame802154_t p;
+  struct ieee802154_ies ies;
+  int len;
+  int mlme_start;
+  int i;
+
+  random_header(&p, FRAME802154_BEACONFRAME, FRAME802154_IEEE802154_2015);
+  p.fcf.ie_list_present = 1;
+  p.fcf.security_enabled = 0;
+  len = frame802154_create(&p, buf);
+
+  memset(&ies, 0, sizeof(ies));
+  len += frame80215e_create_ie_header_list_termination_1(buf + len, MAX_FRAME_LEN - len, &ies);
+  mlme_start = len;
+  len += 2;
+
+  ies.ie_asn.ls4b = rnd();
+  ies.ie_asn.ms1b = rnd();
+  ies.ie_join_priority = rnd() & 0x7f;
+  len += frame80215e_create_ie_tsch_synchronization(buf + len, MAX_FRAME_LEN - len, &ies);
+
+  ies.ie_tsch_timeslot_id = rnd() & 1;
+  for(i = 0; i < tsch_ts_elements_count; i++) {
+    ies.ie_tsch_timeslot[i] = rnd();
+  }
+  len += frame80215e_create_ie_tsch_timeslot(buf + len, MAX_FRAME_LEN - len, &ies);
+
+  ies.ie_tsch_slotframe_and_link.num_slotframes = 1;
+  ies.ie_tsch_slotframe_and_link.slotframe_handle = rnd();
+  ies.ie_tsch_slotframe_and_link.slotframe_size = rnd();
+  ies.ie_tsch_slotframe_and_link.num_links = rnd() % (FRAME802154E_IE_MAX_LINKS + 1);
+  for(i = 0; i < ies.ie_tsch_slotframe_and_link.num_links; i++) {
+    ies.ie_tsch_slotframe_and_link.links[i].timeslot = rnd();
+    ies.ie_tsch_slotframe_and_link.links[i].channel_offset = rnd();
+    ies.ie_tsch_slotframe_and_link.links[i].link_options = rnd();
+  }
+  len += frame80215e_create_ie_tsch_slotframe_and_link(buf + len, MAX_FRAME_LEN - len, &ies);
+
+  ies.ie_channel_hopping_sequence_id = rnd() & 1;
+  ies.ie_hopping_sequence_len = 1 + rnd() % sizeof(ies.ie_hopping_sequence_list);
+  random_bytes(ies.ie_hopping_sequence_list, ies.ie_hopping_sequence_len);
+  len += frame80215e_create_ie_tsch_channel_hopping_sequence(buf + len, MAX_FRAME_LEN - len, &ies);
+
+  ies.ie_mlme_len = len - mlme_start - 2;
+  frame80215e_create_ie_mlme(buf + mlme_start, 2, &ies);
+
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+/* An Enhanced ACK, with the IEs of tsch_packet_create_eack() */
+static int
+create_eack(uint8_t *buf)
+{
+  frame802154_t p;
+  struct ieee802154_ies ies;
+  int len;
+
+  random_header(&p, FRAME802154_ACKFRAME, FRAME802154_IEEE802154_2015);
+  p.fcf.ie_list_present = 1;
+  len = frame802154_create(&p, buf);
+
+  memset(&ies, 0, sizeof(ies));
+  ies.ie_time_correction = (int16_t)(rnd() % 4096) - 2048;
+  ies.ie_is_nack = rnd() & 1;
+  len += frame80215e_create_ie_header_ack_nack_time_correction(buf + len, MAX_FRAME_LEN - len, &ies);
+  if(rnd() & 1) {
+    len += frame80215e_create_ie_header_list_termination_2(buf + len, MAX_FRAME_LEN - len, &ies);
+    random_bytes(buf + len, 8);
+    len += 8;
+  }
+
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_data(uint8_t *buf)
+{
+  frame802154_t p;
+  int len;
+
+  random_header(&p, rnd() & 7, rnd() & 3);
+  len = frame802154_create(&p, buf);
+  random_bytes(buf + len, rnd() % 64);
+  return len + rnd() % 64;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mutate(uint8_t *buf, int len)
+{
+  int n = 1 + rnd() % 3;
+
+  while(n-- > 0) {
+    switch(rnd() % 4) {
+    case 0: /* Flip a bit */
+      if(len > 0) {
+        buf[rnd() % len] ^= 1 << (rnd() & 7);
+      }
+      break;
+    case 1: /* Overwrite a byte */
+      if(len > 0) {
+        buf[rnd() % len] = rnd();
+      }
+      break;
+    case 2: /* Truncate */
+      len = len > 0 ? rnd() % len : 0;
+      break;
+    case 3: /* Extend */
+      random_bytes(buf + len, MAX_FRAME_LEN - len);
+      len += rnd() % (MAX_FRAME_LEN - len + 1);
+      break;
+    }
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_frame(uint8_t *buf, enum frame_kind kind)
+{
+  memset(buf, 0, FRAME_BUF_SIZE);
+  switch(kind) {
+  case FRAME_EB:
+    return create_eb(buf);
+  case FRAME_EACK:
+    return create_eack(buf);
+  case FRAME_DATA:
+    return create_data(buf);
+  default:
+    random_bytes(buf, MAX_FRAME_LEN);
+    return rnd() % (MAX_FRAME_LEN + 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+report_failure(const char *what, const uint8_t *buf, int len, int r1, int r2)
+{
+  int i;
+
+  if(num_failures++ < 10) {
+    printf("FAIL %s (%d vs %d), frame:", what, r1, r2);
+    for(i = 0; i < len; i++) {
+      printf(" %02x", buf[i]);
+    }
+    printf("\n");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Parse a frame with both parsers and compare the outcomes */
+static void
+check_frame(const uint8_t *buf, int len)
+{
+  frame802154_t f1;
+  frame802154_t f2;
+  frame802154_index_t idx;
+  struct ieee802154_ies ies1;
+  struct ieee802154_ies ies2;
+  struct ieee802154_ie_index ie_idx;
+  int r1, r2;
+
+  memset(&f1, 0x5a, sizeof(f1));
+  memset(&f2, 0x5a, sizeof(f2));
+  r1 = frame802154_parse((uint8_t *)buf, len, &f1);
+  r2 = frame802154_parse_index(buf, len, &idx);
+  if(r1 != r2) {
+    report_failure("header length", buf, len, r1, r2);
+    return;
+  }
+  if(r1 == 0) {
+    return;
+  }
+  num_headers++;
+  frame802154_index_to_frame(buf, &idx, &f2);
+  if(memcmp(&f1, &f2, sizeof(f1)) != 0) {
+    report_failure("header fields", buf, len, r1, r2);
+    return;
+  }
+
+  if(!f1.fcf.ie_list_present) {
+    return;
+  }
+  memset(&ies1, 0x5a, sizeof(ies1));
+  memset(&ies2, 0x5a, sizeof(ies2));
+  r1 = frame802154e_parse_information_elements(buf + r2, len - r2, &ies1);
+  r2 = frame802154e_index_information_elements(buf + idx.hdr_len,
+                                               len - idx.hdr_len, &ie_idx);
+  if(r1 != r2) {
+    report_failure("IE list length", buf, len, r1, r2);
+    return;
+  }
+  if(r1 < 0) {
+    return;
+  }
+  num_ie_lists++;
+  r2 = frame802154e_ie_index_decode(buf + idx.hdr_len, &ie_idx, &ies2);
+  if(r1 != r2 || memcmp(&ies1, &ies2, sizeof(ies1)) != 0) {
+    report_failure("IE fields", buf, len, r1, r2);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* tsch_packet_parse_eb() as it was before it used the frame index */
+static int
+reference_parse_eb(const uint8_t *buf, int buf_size,
+                   frame802154_t *frame, struct ieee802154_ies *ies,
+                   uint8_t *hdr_len)
+{
+  uint8_t curr_len = 0;
+  int ret;
+
+  if((ret = frame802154_parse((uint8_t *)buf, buf_size, frame)) == 0) {
+    return 0;
+  }
+  if(frame->fcf.frame_version < FRAME802154_IEEE802154_2015
+     || frame->fcf.frame_type != FRAME802154_BEACONFRAME) {
+    return 0;
+  }
+  *hdr_len = ret;
+  curr_len += ret;
+  memset(ies, 0, sizeof(struct ieee802154_ies));
+  ies->ie_join_priority = 0xff;
+  if(frame->fcf.ie_list_present) {
+    if((ret = frame802154e_parse_information_elements(buf + curr_len, buf_size - curr_len, ies)) == -1) {
+      return 0;
+    }
+    curr_len += ret;
+  }
+  *hdr_len += ies->ie_payload_ie_offset;
+  return curr_len;
+}
+/*---------------------------------------------------------------------------*/
+/* tsch_packet_parse_eack() as it was before it used the frame index. An
+   ACK without a sequence number is rejected, rather than compared with
+   whatever was in the frame structure */
+static int
+reference_parse_eack(const uint8_t *buf, int buf_size, uint8_t seqno,
+                     frame802154_t *frame, struct ieee802154_ies *ies,
+                     uint8_t *hdr_len)
+{
+  uint8_t curr_len = 0;
+  int ret;
+  linkaddr_t dest;
+
+  if((ret = frame802154_parse((uint8_t *)buf, buf_size, frame)) < 3) {
+    return 0;
+  }
+  *hdr_len = ret;
+  curr_len += ret;
+  if(frame->fcf.sequence_number_suppression || seqno != frame->seq) {
+    return 0;
+  }
+  if(frame802154_check_dest_panid(frame) == 0) {
+    return 0;
+  }
+  if(frame802154_extract_linkaddr(frame, NULL, &dest) == 0 ||
+     (!linkaddr_cmp(&dest, &linkaddr_node_addr)
+      && !linkaddr_cmp(&dest, &linkaddr_null))) {
+    return 0;
+  }
+  memset(ies, 0, sizeof(struct ieee802154_ies));
+  if(frame->fcf.ie_list_present) {
+    if((ret = frame802154e_parse_information_elements(buf + curr_len, buf_size - curr_len, ies)) == -1) {
+      return 0;
+    }
+    curr_len += ret;
+  }
+  *hdr_len += ies->ie_payload_ie_offset;
+  return curr_len;
+}
+/*---------------------------------------------------------------------------*/
+/* Parse a frame with the TSCH parsers and their references */
+static void
+check_tsch_frame(const uint8_t *buf, int len)
+{
+  frame802154_t f1;
+  frame802154_t f2;
+  struct ieee802154_ies ies1;
+  struct ieee802154_ies ies2;
+  uint8_t hdr_len1;
+  uint8_t hdr_len2;
+  uint8_t seqno;
+  int r1, r2;
+
+  memset(&f1, 0x5a, sizeof(f1));
+  memset(&f2, 0x5a, sizeof(f2));
+  r1 = reference_parse_eb(buf, len, &f1, &ies1, &hdr_len1);
+  r2 = tsch_packet_parse_eb(buf, len, &f2, &ies2, &hdr_len2, 1);
+  if(r1 != r2) {
+    report_failure("EB length", buf, len, r1, r2);
+    return;
+  }
+  if(r1 > 0) {
+    num_tsch_frames++;
+    if(memcmp(&f1, &f2, sizeof(f1)) != 0 ||
+       memcmp(&ies1, &ies2, sizeof(ies1)) != 0 || hdr_len1 != hdr_len2) {
+      report_failure("EB fields", buf, len, r1, r2);
+      return;
+    }
+  }
+
+  /* Mostly the expected sequence number, sometimes another one */
+  seqno = len > 2 ? buf[2] : 0;
+  if((rnd() & 7) == 0) {
+    seqno++;
+  }
+  memset(&f1, 0x5a, sizeof(f1));
+  memset(&f2, 0x5a, sizeof(f2));
+  r1 = reference_parse_eack(buf, len, seqno, &f1, &ies1, &hdr_len1);
+  r2 = tsch_packet_parse_eack(buf, len, seqno, &f2, &ies2, &hdr_len2);
+  if(r1 != r2) {
+    report_failure("EACK length", buf, len, r1, r2);
+    return;
+  }
+  if(r1 > 0) {
+    num_tsch_frames++;
+    /* Only the time correction IE is decoded */
+    if(memcmp(&f1, &f2, sizeof(f1)) != 0 ||
+       ies1.ie_time_correction != ies2.ie_time_correction ||
+       ies1.ie_is_nack != ies2.ie_is_nack || hdr_len1 != hdr_len2) {
+      report_failure("EACK fields", buf, len, r1, r2);
+      return;
+    }
+    /* Without a frame structure to fill, the result is the same */
+    r2 = tsch_packet_parse_eack(buf, len, seqno, NULL, &ies2, &hdr_len2);
+    if(r1 != r2 || ies1.ie_time_correction != ies2.ie_time_correction ||
+       hdr_len1 != hdr_len2) {
+      report_failure("EACK without frame", buf, len, r1, r2);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+fuzz(void)
+{
+  int i;
+  int len;
+
+  for(i = 0; i < FUZZ_ITERATIONS; i++) {
+    len = create_frame(frame_buf, rnd() % NUM_FRAME_KINDS);
+    if(rnd() & 3) {
+      len = mutate(frame_buf, len);
+    }
+    check_frame(frame_buf, len);
+    check_tsch_frame(frame_buf, len);
+  }
+  printf("Fuzzed %d frames: %lu valid headers, %lu valid IE lists, "
+         "%lu TSCH EBs and EACKs, %lu failures\n",
+         FUZZ_ITERATIONS, num_headers, num_ie_lists, num_tsch_frames,
+         num_failures);
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static void
+benchmark(const char *name, const uint8_t *buf, int len)
+{
+  frame802154_t frame;
+  frame802154_index_t idx;
+  struct ieee802154_ies ies;
+  struct ieee802154_ie_index ie_idx;
+  const struct ieee802154_ie_ref *ref;
+  uint64_t start;
+  uint64_t parse_ns;
+  uint64_t decode_ns;
+  uint64_t lazy_ns;
+  int i;
+  int r;
+
+  /* Two-pass parsing, as done by tsch_packet_parse_eb() and _eack() */
+  start = now_ns();
+  for(i = 0; i < BENCH_ITERATIONS; i++) {
+    r = frame802154_parse((uint8_t *)buf, len, &frame);
+    if(frame.fcf.ie_list_present) {
+      r += frame802154e_parse_information_elements(buf + r, len - r, &ies);
+    }
+    sink = r + frame.seq + ies.ie_join_priority;
+  }
+  parse_ns = now_ns() - start;
+
+  /* Single-pass index, then decoding of everything */
+  start = now_ns();
+  for(i = 0; i < BENCH_ITERATIONS; i++) {
+    r = frame802154_parse_index(buf, len, &idx);
+    if(idx.fcf.ie_list_present) {
+      r += frame802154e_index_information_elements(buf + r, len - r, &ie_idx);
+      frame802154e_ie_index_decode(buf + idx.hdr_len, &ie_idx, &ies);
+    }
+    frame802154_index_to_frame(buf, &idx, &frame);
+    sink = r + frame.seq + ies.ie_join_priority;
+  }
+  decode_ns = now_ns() - start;
+
+  /* Single-pass index, then lazy decoding of the fields TSCH checks first:
+   * sequence number, destination PAN ID and sync or time correction IE */
+  start = now_ns();
+  for(i = 0; i < BENCH_ITERATIONS; i++) {
+    r = frame802154_parse_index(buf, len, &idx);
+    if(idx.fcf.ie_list_present) {
+      r += frame802154e_index_information_elements(buf + r, len - r, &ie_idx);
+      ref = frame802154e_ie_index_find(&ie_idx, IEEE802154_IE_KIND_MLME_SHORT,
+                                       MLME_SHORT_IE_TSCH_SYNCHRONIZATION);
+      if(ref == NULL) {
+        ref = frame802154e_ie_index_find(&ie_idx, IEEE802154_IE_KIND_HEADER,
+                                         HEADER_IE_ACK_NACK_TIME_CORRECTION);
+      }
+      frame802154e_ie_index_decode_ie(buf + idx.hdr_len, ref, &ies);
+    }
+    sink = r + buf[idx.seq_offset] + frame802154_index_get_dest_pid(buf, &idx)
+      + ies.ie_join_priority;
+  }
+  lazy_ns = now_ns() - start;
+
+  printf("TEST: %-5s (%3d bytes) parse %4lu ns, index+decode %4lu ns, index+lazy %4lu ns\n",
+         name, len,
+         (unsigned long)(parse_ns / BENCH_ITERATIONS),
+         (unsigned long)(decode_ns / BENCH_ITERATIONS),
+         (unsigned long)(lazy_ns / BENCH_ITERATIONS));
+}
+/*---------------------------------------------------------------------------*/
+static void
+benchmark_kind(const char *name, enum frame_kind kind)
+{
+  static uint8_t buf[FRAME_BUF_SIZE];
+  frame802154_t frame;
+  int len;
+
+  /* Pick a frame that parses, with all its optional parts */
+  do {
+    len = create_frame(buf, kind);
+  } while(frame802154_parse(buf, len, &frame) == 0
+          || frame.fcf.security_enabled
+          || frame.fcf.dest_addr_mode != FRAME802154_LONGADDRMODE
+          || (kind == FRAME_EB && len < 80));
+  benchmark(name, buf, len);
+}
+/*---------------------------------------------------------------------------*/
+/* Time the TSCH parsers against their references, on a frame that both
+   accept */
+static void
+benchmark_tsch(const char *name, enum frame_kind kind)
+{
+  static uint8_t buf[FRAME_BUF_SIZE];
+  frame802154_t frame;
+  struct ieee802154_ies ies;
+  uint8_t hdr_len;
+  uint64_t start;
+  uint64_t ref_ns;
+  uint64_t tsch_ns;
+  int len;
+  int r;
+  int i;
+
+  do {
+    len = create_frame(buf, kind);
+    if(kind == FRAME_EB) {
+      r = reference_parse_eb(buf, len, &frame, &ies, &hdr_len);
+    } else {
+      r = reference_parse_eack(buf, len, buf[2], &frame, &ies, &hdr_len);
+    }
+  } while(r == 0 || frame.fcf.security_enabled);
+
+  start = now_ns();
+  for(i = 0; i < BENCH_ITERATIONS; i++) {
+    if(kind == FRAME_EB) {
+      r = reference_parse_eb(buf, len, &frame, &ies, &hdr_len);
+    } else {
+      r = reference_parse_eack(buf, len, buf[2], &frame, &ies, &hdr_len);
+    }
+    sink = r + ies.ie_time_correction + ies.ie_join_priority;
+  }
+  ref_ns = now_ns() - start;
+
+  /* As called by TSCH: without decoding the EACK header fields */
+  start = now_ns();
+  for(i = 0; i < BENCH_ITERATIONS; i++) {
+    if(kind == FRAME_EB) {
+      r = tsch_packet_parse_eb(buf, len, &frame, &ies, &hdr_len, 1);
+    } else {
+      r = tsch_packet_parse_eack(buf, len, buf[2], NULL, &ies, &hdr_len);
+    }
+    sink = r + ies.ie_time_correction + ies.ie_join_priority;
+  }
+  tsch_ns = now_ns() - start;
+
+  printf("TEST: %-5s (%3d bytes) reference %4lu ns, tsch_packet_parse %4lu ns\n",
+         name, len,
+         (unsigned long)(ref_ns / BENCH_ITERATIONS),
+         (unsigned long)(tsch_ns / BENCH_ITERATIONS));
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(frame802154_index_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  fuzz();
+
+  benchmark_kind("EB", FRAME_EB);
+  benchmark_kind("EACK", FRAME_EACK);
+  benchmark_kind("data", FRAME_DATA);
+  benchmark_tsch("EB", FRAME_EB);
+  benchmark_tsch("EACK", FRAME_EACK);
+
+  exit(num_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/